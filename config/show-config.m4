@@ -34,9 +34,12 @@ AC_DEFUN([AX_SHOW_CONFIGURATION],
     echo -e \\\tMPI home:                ${MPI_HOME}
   fi
   
-  # Tree DSBCAN is available if Synapse is 
-  TREEDBSCAN_ENABLED="${synapse_enabled:-no}"
+  # Tree DSBCAN is available if CGAL is, the MRNet version if Synapse also is
+  TREEDBSCAN_ENABLED="${cgal_enabled:-no}"
   echo TREEDBSCAN enabled: ${TREEDBSCAN_ENABLED}
+  if test "x${TREEDBSCAN_ENABLED}" = "xyes"; then
+    echo -e \\\tMRNet version:           ${synapse_enabled:-no}
+  fi
   if test "x${TREEDBSCAN_ENABLED}" = "xyes"; then
     echo ""
     echo -e -- MPFR flags --
@@ -51,8 +54,10 @@ AC_DEFUN([AX_SHOW_CONFIGURATION],
     echo -e \\\tCGAL_CPPFLAGS:           ${CGAL_CPPFLAGS}
     echo -e \\\tCGAL_LIBSDIR:            ${CGAL_LIBSDIR}
     echo -e \\\tCGAL_LIBS:               ${CGAL_LIBS}
-    echo -e -- Synapse flags --
-    echo -e \\\tSynapse config script: "${SYNAPSE_HOME}/bin/synapse-config"
+    if test "x${synapse_enabled}" = "xyes"; then
+      echo -e -- Synapse flags --
+      echo -e \\\tSynapse config script: "${SYNAPSE_HOME}/bin/synapse-config"
+    fi
     echo ""
   fi
 
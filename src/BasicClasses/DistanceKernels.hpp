@@ -0,0 +1,234 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _DISTANCEKERNELS_HPP_
+#define _DISTANCEKERNELS_HPP_
+
+#include <cstddef>
+
+/*
+ * Squared Euclidean distance kernels. The coordinates of both points are
+ * read through a stride, so they serve the contiguous points of the ANN
+ * structures (stride 1) as well as the rows of the column-major blocks
+ * used by 'Point'.
+ *
+ * Common dimension counts (up to 8) are dispatched to kernels fully unrolled
+ * at compile time, which add the dimensions in the same order as a plain
+ * loop, so the results are bit-identical to the original code. Larger
+ * counts use four independent partial sums the compiler can vectorize.
+ *
+ * All kernels are templates on the coordinate type and accumulate in it,
+ * so single precision coordinates (see '--enable-single-precision') fit
+ * twice the values on each vector operation.
+ *
+ * Range tests should compare squared distances against the squared radius
+ * and leave the square root for the values actually reported.
+ */
+
+/* Adds the squared differences of dimensions [Dimension, Dimensions) */
+template <typename T, size_t Dimensions, size_t Dimension>
+struct SquaredDistanceTerms
+{
+  static inline void Add(T&       Sum,
+                         const T* A,
+                         size_t   StrideA,
+                         const T* B,
+                         size_t   StrideB)
+  {
+    T Diff = A[Dimension*StrideA] - B[Dimension*StrideB];
+    Sum += Diff*Diff;
+
+    SquaredDistanceTerms<T, Dimensions, Dimension+1>::Add(Sum, A, StrideA, B, StrideB);
+  }
+};
+
+template <typename T, size_t Dimensions>
+struct SquaredDistanceTerms<T, Dimensions, Dimensions>
+{
+  static inline void Add(T&, const T*, size_t, const T*, size_t) {}
+};
+
+template <size_t Dimensions>
+struct SquaredDistanceKernel
+{
+  template <typename T>
+  static inline T Compute(const T* A,
+                          size_t   StrideA,
+                          const T* B,
+                          size_t   StrideB)
+  {
+    T Sum = 0;
+
+    SquaredDistanceTerms<T, Dimensions, 0>::Add(Sum, A, StrideA, B, StrideB);
+
+    return Sum;
+  }
+};
+
+/* Fallback for any dimension count */
+template <typename T>
+inline T GenericSquaredDistance(const T* A,
+                                size_t   StrideA,
+                                const T* B,
+                                size_t   StrideB,
+                                size_t   Dimensions)
+{
+  T      Sum[4] = { 0, 0, 0, 0 };
+  size_t i      = 0;
+
+  for (; i + 4 <= Dimensions; i += 4)
+  {
+    for (size_t j = 0; j < 4; j++)
+    {
+      T Diff = A[(i+j)*StrideA] - B[(i+j)*StrideB];
+      Sum[j] += Diff*Diff;
+    }
+  }
+
+  for (; i < Dimensions; i++)
+  {
+    T Diff = A[i*StrideA] - B[i*StrideB];
+    Sum[0] += Diff*Diff;
+  }
+
+  return (Sum[0] + Sum[1]) + (Sum[2] + Sum[3]);
+}
+
+template <typename T>
+inline T SquaredEuclideanDistance(const T* A,
+                                  size_t   StrideA,
+                                  const T* B,
+                                  size_t   StrideB,
+                                  size_t   Dimensions)
+{
+  switch (Dimensions)
+  {
+    case 1:
+      return SquaredDistanceKernel<1>::Compute(A, StrideA, B, StrideB);
+    case 2:
+      return SquaredDistanceKernel<2>::Compute(A, StrideA, B, StrideB);
+    case 3:
+      return SquaredDistanceKernel<3>::Compute(A, StrideA, B, StrideB);
+    case 4:
+      return SquaredDistanceKernel<4>::Compute(A, StrideA, B, StrideB);
+    case 5:
+      return SquaredDistanceKernel<5>::Compute(A, StrideA, B, StrideB);
+    case 6:
+      return SquaredDistanceKernel<6>::Compute(A, StrideA, B, StrideB);
+    case 7:
+      return SquaredDistanceKernel<7>::Compute(A, StrideA, B, StrideB);
+    case 8:
+      return SquaredDistanceKernel<8>::Compute(A, StrideA, B, StrideB);
+    default:
+      return GenericSquaredDistance(A, StrideA, B, StrideB, Dimensions);
+  }
+}
+
+/* Contiguous points */
+template <typename T>
+inline T SquaredEuclideanDistance(const T* A,
+                                  const T* B,
+                                  size_t   Dimensions)
+{
+  return SquaredEuclideanDistance(A, 1, B, 1, Dimensions);
+}
+
+/* One-to-many loop, with the kernel chosen once for the whole batch */
+template <size_t Dimensions, typename T>
+inline void SquaredDistancesBatch(const T*        Query,
+                                  size_t          QueryStride,
+                                  const T* const* Targets,
+                                  size_t          TargetsStride,
+                                  size_t          Count,
+                                  T*              Result)
+{
+  for (size_t i = 0; i < Count; i++)
+  {
+    Result[i] = SquaredDistanceKernel<Dimensions>::Compute(Query,
+                                                           QueryStride,
+                                                           Targets[i],
+                                                           TargetsStride);
+  }
+}
+
+/*
+ * Squared distances from 'Query' to each of the 'Count' points whose first
+ * coordinate is pointed by 'Targets', all of them sharing 'TargetsStride'
+ */
+template <typename T>
+inline void SquaredEuclideanDistances(const T*        Query,
+                                      size_t          QueryStride,
+                                      const T* const* Targets,
+                                      size_t          TargetsStride,
+                                      size_t          Count,
+                                      size_t          Dimensions,
+                                      T*              Result)
+{
+  switch (Dimensions)
+  {
+    case 2:
+      SquaredDistancesBatch<2>(Query, QueryStride, Targets, TargetsStride, Count, Result);
+      break;
+    case 3:
+      SquaredDistancesBatch<3>(Query, QueryStride, Targets, TargetsStride, Count, Result);
+      break;
+    case 4:
+      SquaredDistancesBatch<4>(Query, QueryStride, Targets, TargetsStride, Count, Result);
+      break;
+    case 5:
+      SquaredDistancesBatch<5>(Query, QueryStride, Targets, TargetsStride, Count, Result);
+      break;
+    case 6:
+      SquaredDistancesBatch<6>(Query, QueryStride, Targets, TargetsStride, Count, Result);
+      break;
+    case 7:
+      SquaredDistancesBatch<7>(Query, QueryStride, Targets, TargetsStride, Count, Result);
+      break;
+    case 8:
+      SquaredDistancesBatch<8>(Query, QueryStride, Targets, TargetsStride, Count, Result);
+      break;
+    default:
+      for (size_t i = 0; i < Count; i++)
+      {
+        Result[i] = SquaredEuclideanDistance(Query,
+                                             QueryStride,
+                                             Targets[i],
+                                             TargetsStride,
+                                             Dimensions);
+      }
+      break;
+  }
+}
+
+#endif // _DISTANCEKERNELS_HPP_
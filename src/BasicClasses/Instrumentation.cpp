@@ -0,0 +1,639 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "Instrumentation.hpp"
+#include "ParallelFor.hpp"
+#include "Timer.hpp"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <sys/time.h>
+
+#include <algorithm>
+using std::sort;
+using std::stable_sort;
+
+#include <map>
+using std::map;
+
+#include <set>
+using std::set;
+
+#include <utility>
+using std::pair;
+using std::make_pair;
+
+#include <vector>
+using std::vector;
+
+using cepba_tools::instrumentation;
+using cepba_tools::counter_id;
+using cepba_tools::trace_event;
+using cepba_tools::phase_summary;
+using cepba_tools::Timer;
+
+#define PHASE_SEPARATOR '/'
+
+typedef unsigned long long counter_t;
+
+struct phase_stats
+{
+  counter_t calls;
+  counter_t microseconds;
+  counter_t first_seen; /* Global order of the first end, to sort siblings */
+};
+
+struct open_phase
+{
+  string       path;
+  unsigned int id; /* Timeline id, only set while tracing */
+  Timer        timer;
+
+  open_phase(void): id(0) {}
+};
+
+struct thread_stats
+{
+  string                   base; /* Phase inherited from the parent thread */
+  unsigned int             base_id;
+  unsigned int             slot;
+  vector<counter_t>        counters;
+  vector<counter_t>        traced; /* Counter values already in the timeline */
+  vector<open_phase>       stack;
+  map<string, phase_stats> phases;
+  vector<trace_event>      events;
+
+  thread_stats(void): base_id(0), slot(0) {}
+
+  void merge(const thread_stats& other);
+};
+
+void thread_stats::merge(const thread_stats& other)
+{
+  map<string, phase_stats>::const_iterator it;
+
+  if (other.counters.size() > counters.size())
+  {
+    counters.resize(other.counters.size(), 0);
+  }
+
+  for (size_t i = 0; i < other.counters.size(); i++)
+  {
+    counters[i] += other.counters[i];
+  }
+
+  for (it = other.phases.begin(); it != other.phases.end(); ++it)
+  {
+    map<string, phase_stats>::iterator current = phases.find(it->first);
+
+    if (current == phases.end())
+    {
+      phases.insert(*it);
+    }
+    else
+    {
+      current->second.calls        += it->second.calls;
+      current->second.microseconds += it->second.microseconds;
+
+      if (it->second.first_seen < current->second.first_seen)
+      {
+        current->second.first_seen = it->second.first_seen;
+      }
+    }
+  }
+
+  events.insert(events.end(), other.events.begin(), other.events.end());
+}
+
+/* The registry state. The thread-specific pointer is defined last so its
+ * clean-up at exit runs while the rest of the registry is still alive */
+static boost::mutex            registry_mutex;
+static vector<string>          counter_names;
+static map<string, counter_id> counter_ids;
+static set<thread_stats*>      live_threads;
+static thread_stats            finished_threads;
+static counter_t               phases_seen = 0;
+static bool                    trace_enabled = false;
+static counter_t               trace_origin  = 0;
+static vector<string>          trace_phase_paths;
+static map<string, unsigned>   trace_phase_ids;
+
+static counter_t trace_time(void)
+{
+  struct timeval now;
+
+  gettimeofday(&now, 0);
+
+  return ((counter_t) now.tv_sec*1000000 + now.tv_usec)*1000 - trace_origin;
+}
+
+static unsigned int trace_phase_id(const string& path)
+{
+  boost::mutex::scoped_lock          lock(registry_mutex);
+  map<string, unsigned>::iterator    it = trace_phase_ids.find(path);
+
+  if (it != trace_phase_ids.end())
+  {
+    return it->second;
+  }
+
+  trace_phase_paths.push_back(path);
+  trace_phase_ids[path] = (unsigned) (trace_phase_paths.size() - 1);
+
+  return (unsigned) (trace_phase_paths.size() - 1);
+}
+
+/* Appends to 'events' the counter increments of 'stats' not yet traced */
+static void trace_counters(const thread_stats&  stats,
+                           vector<counter_t>&   traced,
+                           counter_t            time,
+                           vector<trace_event>& events)
+{
+  if (traced.size() < stats.counters.size())
+  {
+    traced.resize(stats.counters.size(), 0);
+  }
+
+  for (size_t i = 0; i < stats.counters.size(); i++)
+  {
+    if (stats.counters[i] > traced[i])
+    {
+      trace_event counter;
+
+      counter.time   = time;
+      counter.thread = stats.slot;
+      counter.type   = (unsigned int) i + 1;
+      counter.value  = stats.counters[i] - traced[i];
+
+      events.push_back(counter);
+      traced[i] = stats.counters[i];
+    }
+  }
+}
+
+/* Traces the pending counters and the change of the active phase */
+static void trace_phase(thread_stats* stats, unsigned long long value)
+{
+  trace_event phase;
+
+  phase.time   = trace_time();
+  phase.thread = stats->slot;
+  phase.type   = 0;
+  phase.value  = value;
+
+  trace_counters(*stats, stats->traced, phase.time, stats->events);
+  stats->events.push_back(phase);
+}
+
+static bool sort_by_time(const trace_event& a, const trace_event& b)
+{
+  if (a.time != b.time)
+  {
+    return a.time < b.time;
+  }
+
+  return a.thread < b.thread;
+}
+
+static void retire_thread(thread_stats* stats)
+{
+  if (trace_enabled && !stats->base.empty())
+  {
+    trace_phase(stats, 0);
+  }
+  else if (trace_enabled)
+  {
+    trace_counters(*stats, stats->traced, trace_time(), stats->events);
+  }
+
+  boost::mutex::scoped_lock lock(registry_mutex);
+
+  finished_threads.merge(*stats);
+  live_threads.erase(stats);
+
+  delete stats;
+}
+
+static boost::thread_specific_ptr<thread_stats> current_thread(&retire_thread);
+
+static thread_stats* local_stats(void)
+{
+  thread_stats* stats = current_thread.get();
+
+  if (stats == NULL)
+  {
+    stats = new thread_stats();
+
+    {
+      boost::mutex::scoped_lock lock(registry_mutex);
+      live_threads.insert(stats);
+    }
+
+    current_thread.reset(stats);
+  }
+
+  return stats;
+}
+
+static string json_string(const string& value)
+{
+  string result = "\"";
+
+  for (size_t i = 0; i < value.size(); i++)
+  {
+    if (value[i] == '"' || value[i] == '\\')
+    {
+      result += '\\';
+    }
+    result += value[i];
+  }
+
+  return result + "\"";
+}
+
+static bool sort_by_first_seen(const pair<string, phase_stats>& a,
+                               const pair<string, phase_stats>& b)
+{
+  return a.second.first_seen < b.second.first_seen;
+}
+
+/* Children of 'parent' ("" for the root) in the order they first ended */
+static void child_phases(const map<string, phase_stats>&     phases,
+                         const string&                       parent,
+                         vector<pair<string, phase_stats> >& children)
+{
+  map<string, phase_stats>::const_iterator it;
+  string                                   prefix = (parent.empty() ? "" : parent + PHASE_SEPARATOR);
+
+  /* Children are the paths that extend the parent with exactly one name */
+  for (it = phases.lower_bound(prefix); it != phases.end(); ++it)
+  {
+    if (it->first.compare(0, prefix.size(), prefix) != 0)
+    {
+      break;
+    }
+
+    if (it->first.find(PHASE_SEPARATOR, prefix.size()) == string::npos)
+    {
+      children.push_back(*it);
+    }
+  }
+
+  sort(children.begin(), children.end(), sort_by_first_seen);
+}
+
+/* Appends the subtree of 'parent' to 'summaries', parents first */
+static void collect_phases(const map<string, phase_stats>& phases,
+                           const string&                   parent,
+                           vector<phase_summary>&          summaries)
+{
+  vector<pair<string, phase_stats> > children;
+
+  child_phases(phases, parent, children);
+
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    phase_summary summary;
+
+    summary.path    = children[i].first;
+    summary.calls   = children[i].second.calls;
+    summary.seconds = children[i].second.microseconds/1e6;
+
+    summaries.push_back(summary);
+    collect_phases(phases, children[i].first, summaries);
+  }
+}
+
+/* Writes the children of 'parent' ("" for the root) and their subtrees */
+static void write_phases(FILE*                           channel,
+                         const map<string, phase_stats>& phases,
+                         const string&                   parent,
+                         int                             indent)
+{
+  vector<pair<string, phase_stats> >      children;
+  map<string, phase_stats>::const_iterator it;
+  string                                   prefix = (parent.empty() ? "" : parent + PHASE_SEPARATOR);
+
+  child_phases(phases, parent, children);
+
+  fprintf(channel, "[");
+
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    counter_t children_time = 0;
+    string    path          = children[i].first;
+    string    child_prefix  = path + PHASE_SEPARATOR;
+
+    for (it = phases.lower_bound(child_prefix); it != phases.end(); ++it)
+    {
+      if (it->first.compare(0, child_prefix.size(), child_prefix) != 0)
+      {
+        break;
+      }
+
+      if (it->first.find(PHASE_SEPARATOR, child_prefix.size()) == string::npos)
+      {
+        children_time += it->second.microseconds;
+      }
+    }
+
+    const phase_stats& stats = children[i].second;
+    counter_t          self  = (stats.microseconds > children_time ?
+                                stats.microseconds - children_time : 0);
+
+    fprintf(channel, "%s\n%*s{ \"name\": %s, \"calls\": %llu, ",
+            (i > 0 ? "," : ""),
+            indent + 2, "",
+            json_string(path.substr(prefix.size())).c_str(),
+            stats.calls);
+
+    fprintf(channel, "\"seconds\": %.6f, \"self_seconds\": %.6f, \"phases\": ",
+            stats.microseconds/1e6,
+            self/1e6);
+
+    write_phases(channel, phases, path, indent + 2);
+
+    fprintf(channel, " }");
+  }
+
+  if (children.size() > 0)
+  {
+    fprintf(channel, "\n%*s", indent, "");
+  }
+
+  fprintf(channel, "]");
+}
+
+bool instrumentation::enabled = false;
+
+counter_id instrumentation::counter(const char* name)
+{
+  boost::mutex::scoped_lock          lock(registry_mutex);
+  map<string, counter_id>::iterator  it = counter_ids.find(name);
+
+  if (it != counter_ids.end())
+  {
+    return it->second;
+  }
+
+  counter_names.push_back(name);
+  counter_ids[name] = (counter_id) (counter_names.size() - 1);
+
+  return (counter_id) (counter_names.size() - 1);
+}
+
+void instrumentation::thread_add(counter_id id, unsigned long long amount)
+{
+  thread_stats* stats = local_stats();
+
+  if (id >= stats->counters.size())
+  {
+    stats->counters.resize(id + 1, 0);
+  }
+
+  stats->counters[id] += amount;
+}
+
+void instrumentation::phase_begin(const char* name)
+{
+  thread_stats* stats;
+  open_phase    phase;
+
+  if (!enabled)
+  {
+    return;
+  }
+
+  stats = local_stats();
+
+  phase.path = (stats->stack.empty() ? stats->base : stats->stack.back().path);
+
+  if (phase.path.empty())
+  {
+    phase.path = name;
+  }
+  else
+  {
+    phase.path = phase.path + PHASE_SEPARATOR + name;
+  }
+
+  if (trace_enabled)
+  {
+    phase.id = trace_phase_id(phase.path);
+    trace_phase(stats, phase.id + 1);
+  }
+
+  stats->stack.push_back(phase);
+  stats->stack.back().timer.begin();
+}
+
+void instrumentation::phase_end(void)
+{
+  thread_stats* stats = current_thread.get();
+
+  if (stats == NULL || stats->stack.empty())
+  {
+    return;
+  }
+
+  open_phase&                        phase   = stats->stack.back();
+  Timer::diff_type                   elapsed = phase.timer.end();
+  map<string, phase_stats>::iterator it      = stats->phases.find(phase.path);
+
+  if (it == stats->phases.end())
+  {
+    phase_stats new_phase;
+
+    new_phase.calls        = 0;
+    new_phase.microseconds = 0;
+
+    {
+      boost::mutex::scoped_lock lock(registry_mutex);
+      new_phase.first_seen = phases_seen++;
+    }
+
+    it = stats->phases.insert(make_pair(phase.path, new_phase)).first;
+  }
+
+  it->second.calls        += 1;
+  it->second.microseconds += elapsed;
+
+  stats->stack.pop_back();
+
+  if (trace_enabled)
+  {
+    if (!stats->stack.empty())
+    {
+      trace_phase(stats, stats->stack.back().id + 1);
+    }
+    else
+    {
+      trace_phase(stats, (stats->base.empty() ? 0 : stats->base_id + 1));
+    }
+  }
+}
+
+string instrumentation::current_phase(void)
+{
+  thread_stats* stats;
+
+  if (!enabled || (stats = current_thread.get()) == NULL)
+  {
+    return string("");
+  }
+
+  return (stats->stack.empty() ? stats->base : stats->stack.back().path);
+}
+
+void instrumentation::inherit_phase(const string& path, unsigned int thread)
+{
+  thread_stats* stats;
+
+  if (!enabled || (path.empty() && !trace_enabled))
+  {
+    return;
+  }
+
+  stats       = local_stats();
+  stats->slot = thread;
+  stats->base = path;
+
+  if (trace_enabled && !path.empty())
+  {
+    stats->base_id = trace_phase_id(path);
+    trace_phase(stats, stats->base_id + 1);
+  }
+}
+
+void instrumentation::start_trace(void)
+{
+  trace_origin  = 0;
+  trace_origin  = trace_time();
+  trace_enabled = true;
+  enabled       = true;
+}
+
+bool instrumentation::tracing(void)
+{
+  return trace_enabled;
+}
+
+void instrumentation::trace_events(vector<trace_event>& events,
+                                   vector<string>&      phases,
+                                   vector<string>&      counters)
+{
+  boost::mutex::scoped_lock    lock(registry_mutex);
+  counter_t                    now = trace_time();
+  set<thread_stats*>::iterator it;
+
+  events = finished_threads.events;
+
+  for (it = live_threads.begin(); it != live_threads.end(); ++it)
+  {
+    vector<counter_t> traced = (*it)->traced;
+
+    events.insert(events.end(), (*it)->events.begin(), (*it)->events.end());
+    trace_counters(*(*it), traced, now, events);
+  }
+
+  stable_sort(events.begin(), events.end(), sort_by_time);
+
+  phases   = trace_phase_paths;
+  counters = counter_names;
+}
+
+void instrumentation::phases(vector<phase_summary>& summaries)
+{
+  boost::mutex::scoped_lock    lock(registry_mutex);
+  thread_stats                 merged = finished_threads;
+  set<thread_stats*>::iterator it;
+
+  for (it = live_threads.begin(); it != live_threads.end(); ++it)
+  {
+    merged.merge(*(*it));
+  }
+
+  summaries.clear();
+  collect_phases(merged.phases, "", summaries);
+}
+
+bool instrumentation::write_json(string file_name,
+                                 string tool_name)
+{
+  FILE* channel = fopen(file_name.c_str(), "w");
+
+  if (channel == NULL)
+  {
+    return false;
+  }
+
+  write_json(channel, tool_name);
+
+  return (fclose(channel) == 0);
+}
+
+void instrumentation::write_json(FILE*  channel,
+                                 string tool_name)
+{
+  boost::mutex::scoped_lock    lock(registry_mutex);
+  thread_stats                 merged = finished_threads;
+  set<thread_stats*>::iterator it;
+
+  for (it = live_threads.begin(); it != live_threads.end(); ++it)
+  {
+    merged.merge(*(*it));
+  }
+
+  merged.counters.resize(counter_names.size(), 0);
+
+  fprintf(channel, "{\n");
+  fprintf(channel, "  \"tool\": %s,\n", json_string(tool_name).c_str());
+  fprintf(channel, "  \"threads\": %u,\n", cepba_tools::parallel_threads());
+  fprintf(channel, "  \"phases\": ");
+  write_phases(channel, merged.phases, "", 2);
+  fprintf(channel, ",\n");
+  fprintf(channel, "  \"counters\": {");
+
+  for (size_t i = 0; i < counter_names.size(); i++)
+  {
+    fprintf(channel, "%s\n    %s: %llu",
+            (i > 0 ? "," : ""),
+            json_string(counter_names[i]).c_str(),
+            merged.counters[i]);
+  }
+
+  fprintf(channel, "%s}\n", (counter_names.size() > 0 ? "\n  " : ""));
+  fprintf(channel, "}\n");
+}
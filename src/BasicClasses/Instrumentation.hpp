@@ -0,0 +1,168 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _INSTRUMENTATION_HPP_
+#define _INSTRUMENTATION_HPP_
+
+#include <cstdio>
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+namespace cepba_tools
+{
+  /*
+    Registry of nested phase scopes and named counters, used to see where the
+    time goes in a whole analysis without an external profiler.
+
+    Phases are kept on a per-thread stack, so a phase opened while another
+    one is active is accounted as its child. The workers of 'parallel_for'
+    hang their phases from the active phase of the caller, so the times of
+    a phase run on several threads add up and can exceed its parent time.
+
+    Counters are registered once by name and incremented through their id on
+    per-thread slots, without any locking. Hot loops should accumulate
+    locally and add the total once per call.
+
+    Both are merged across threads, including the ones that already finished,
+    when the registry is written. Nothing is recorded unless 'enabled' is set.
+
+    Once 'start_trace' is called, each thread also keeps the timeline of its
+    phase changes, with the counter increments accumulated between them, so
+    the run can be written as a trace and inspected with Paraver.
+  */
+
+  typedef unsigned int counter_id;
+
+  /* Merged time of a phase, identified by its path from the root phase */
+  struct phase_summary
+  {
+    string             path;    // Names of the enclosing phases, '/' separated
+    unsigned long long calls;
+    double             seconds; // Summed across the threads that ran it
+  };
+
+  /* A phase change or counter increment of the timeline */
+  struct trace_event
+  {
+    unsigned long long time;   // Nanoseconds since 'start_trace'
+    unsigned int       thread; // 0 for the main thread, 'parallel_for' index otherwise
+    unsigned int       type;   // 0 for phase changes, counter id + 1 for counters
+    unsigned long long value;  // Active phase id + 1 (0 for none) or increment
+  };
+
+  class instrumentation
+  {
+    public:
+
+      static bool enabled;
+
+      // Id of the counter 'name', registering it on its first use
+      static counter_id counter(const char* name);
+
+      static void add(counter_id id, unsigned long long amount = 1)
+      {
+        if (enabled)
+        {
+          thread_add(id, amount);
+        }
+      }
+
+      static void phase_begin(const char* name);
+
+      static void phase_end(void);
+
+      // Path of the active phase of the calling thread ("" if none)
+      static string current_phase(void);
+
+      // Hang the phases of a thread with no active phase from 'path', and
+      // identify it as 'thread' in the timeline
+      static void inherit_phase(const string& path, unsigned int thread = 0);
+
+      // Enable the registry and start keeping the timeline
+      static void start_trace(void);
+
+      static bool tracing(void);
+
+      // Timeline of all threads sorted by time. Phase ids index 'phases' and
+      // counter ids index 'counters'
+      static void trace_events(vector<trace_event>& events,
+                               vector<string>&      phases,
+                               vector<string>&      counters);
+
+      // Merged phases of all threads, each one followed by its children in
+      // the same order as the JSON document
+      static void phases(vector<phase_summary>& summaries);
+
+      // Write the merged phases tree and counters as a JSON document
+      static bool write_json(string file_name,
+                             string tool_name);
+
+      static void write_json(FILE*  channel,
+                             string tool_name);
+
+    private:
+      static void thread_add(counter_id id, unsigned long long amount);
+  };
+
+  /* Phase that lasts the lifetime of the object */
+  class phase_scope
+  {
+    public:
+      phase_scope(const char* name)
+      {
+        active = instrumentation::enabled;
+
+        if (active)
+        {
+          instrumentation::phase_begin(name);
+        }
+      }
+
+      ~phase_scope(void)
+      {
+        if (active)
+        {
+          instrumentation::phase_end();
+        }
+      }
+
+    private:
+      bool active;
+  };
+}
+
+#endif // _INSTRUMENTATION_HPP_
@@ -0,0 +1,75 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "ParallelFor.hpp"
+
+#include <boost/thread/tss.hpp>
+
+static unsigned int requested_threads = 0;
+
+static boost::thread_specific_ptr<bool> parallel_region;
+
+unsigned int cepba_tools::parallel_threads(void)
+{
+  unsigned int threads = requested_threads;
+
+  if (threads == 0)
+  {
+    threads = boost::thread::hardware_concurrency();
+  }
+
+  return (threads == 0 ? 1 : threads);
+}
+
+void cepba_tools::set_parallel_threads(unsigned int threads)
+{
+  requested_threads = threads;
+}
+
+bool cepba_tools::in_parallel_region(void)
+{
+  return (parallel_region.get() != NULL && *parallel_region);
+}
+
+void cepba_tools::set_parallel_region(bool active)
+{
+  if (parallel_region.get() == NULL)
+  {
+    parallel_region.reset(new bool(active));
+  }
+  else
+  {
+    *parallel_region = active;
+  }
+}
@@ -0,0 +1,150 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _PARALLELFOR_HPP_
+#define _PARALLELFOR_HPP_
+
+#include <cstddef>
+#include <string>
+
+#include <boost/thread.hpp>
+
+#include "Instrumentation.hpp"
+
+namespace cepba_tools
+{
+  /*
+    Fork-join execution of loops over an index range. The range is split in
+    as many contiguous chunks as threads are available (never smaller than
+    'min_chunk' items), and the functor is invoked once per chunk as
+
+      task(chunk_begin, chunk_end, thread_index)
+
+    The first chunk runs on the calling thread. 'thread_index' is always
+    lower than 'parallel_threads()', so reductions can be accumulated on
+    per-thread slots and merged by the caller afterwards. The workers
+    inherit the instrumentation phase active on the calling thread, and
+    appear in its timeline as 'thread_index'.
+
+    Loops started from inside a chunk (e.g. a clustering run on each item of
+    an outer loop) run entirely on the thread of that chunk, so the outer
+    loop alone decides the number of threads.
+  */
+
+  // Number of threads used by 'parallel_for' (hardware concurrency by default)
+  unsigned int parallel_threads(void);
+
+  // Set the number of threads. 0 means hardware concurrency
+  void set_parallel_threads(unsigned int threads);
+
+  // True on a thread running a chunk of a 'parallel_for'
+  bool in_parallel_region(void);
+
+  void set_parallel_region(bool active);
+
+  template <typename Task>
+  void parallel_chunk(Task*        task,
+                      size_t       begin,
+                      size_t       end,
+                      unsigned int thread_index,
+                      std::string  phase)
+  {
+    instrumentation::inherit_phase(phase, thread_index);
+    set_parallel_region(true);
+
+    (*task)(begin, end, thread_index);
+  }
+
+  template <typename Task>
+  unsigned int parallel_for(Task&  task,
+                            size_t begin,
+                            size_t end,
+                            size_t min_chunk = 1)
+  {
+    size_t       items   = (end > begin ? end - begin : 0);
+    size_t       threads = parallel_threads();
+
+    if (min_chunk == 0)
+    {
+      min_chunk = 1;
+    }
+
+    if (items/min_chunk < threads)
+    {
+      threads = items/min_chunk;
+    }
+
+    if (threads <= 1 || in_parallel_region())
+    {
+      if (items > 0)
+      {
+        task(begin, end, 0);
+      }
+      return 1;
+    }
+
+    boost::thread_group workers;
+    std::string         phase = instrumentation::current_phase();
+    size_t              chunk = items/threads;
+    size_t              extra = items%threads;
+    size_t              first_end;
+    size_t              current;
+
+    first_end = begin + chunk + (extra > 0 ? 1 : 0);
+    current   = first_end;
+
+    for (size_t i = 1; i < threads; i++)
+    {
+      size_t chunk_end = current + chunk + (i < extra ? 1 : 0);
+
+      workers.add_thread(new boost::thread(&parallel_chunk<Task>,
+                                           &task,
+                                           current,
+                                           chunk_end,
+                                           (unsigned int) i,
+                                           phase));
+      current = chunk_end;
+    }
+
+    set_parallel_region(true);
+    task(begin, first_end, 0);
+    set_parallel_region(false);
+
+    workers.join_all();
+
+    return (unsigned int) threads;
+  }
+}
+
+#endif
@@ -0,0 +1,162 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "ProgressReporter.hpp"
+#include "SystemMessages.hpp"
+
+#include <boost/thread.hpp>
+
+using cepba_tools::ProgressReporter;
+using cepba_tools::system_messages;
+
+unsigned int ProgressReporter::refresh_period = 200;
+
+ProgressReporter::ProgressReporter(const char*   message,
+                                   size_t        total,
+                                   progress_type type,
+                                   FILE*         channel)
+: message(message), total(total), type(type), channel(channel),
+  current(0), finished(false), reporter(NULL)
+{
+  start();
+}
+
+ProgressReporter::ProgressReporter(string        message,
+                                   size_t        total,
+                                   progress_type type,
+                                   FILE*         channel)
+: message(message), total(total), type(type), channel(channel),
+  current(0), finished(false), reporter(NULL)
+{
+  start();
+}
+
+ProgressReporter::~ProgressReporter(void)
+{
+  /* Loops left on error do not print the final message */
+  stop();
+}
+
+void ProgressReporter::end(void)
+{
+  if (!stop())
+  {
+    return;
+  }
+
+  /* Last update not rendered yet */
+  render(current.load(boost::memory_order_relaxed));
+
+  if (type == percentage)
+  {
+    system_messages::show_percentage_end(message.c_str(), channel);
+  }
+  else
+  {
+    system_messages::show_progress_end(message.c_str(), (int) total, channel);
+  }
+}
+
+bool ProgressReporter::stop(void)
+{
+  if (finished.exchange(true))
+  {
+    return false;
+  }
+
+  if (reporter != NULL)
+  {
+    reporter->interrupt();
+    reporter->join();
+    delete reporter;
+    reporter = NULL;
+  }
+
+  return true;
+}
+
+void ProgressReporter::start(void)
+{
+  render(0);
+
+  /* No output, no need of a reporter thread */
+  if (!system_messages::verbose && !system_messages::paraver_verbosity)
+  {
+    return;
+  }
+
+  reporter = new boost::thread(&ProgressReporter::reporter_loop, this);
+}
+
+void ProgressReporter::render(size_t value)
+{
+  if (type == percentage)
+  {
+    system_messages::show_percentage_progress(message.c_str(),
+                                              (int) value,
+                                              channel);
+  }
+  else
+  {
+    system_messages::show_progress(message.c_str(),
+                                   (int) value,
+                                   (int) total,
+                                   channel);
+  }
+}
+
+void ProgressReporter::reporter_loop(void)
+{
+  size_t last_rendered = 0;
+
+  try
+  {
+    while (!finished.load(boost::memory_order_acquire))
+    {
+      boost::this_thread::sleep(boost::posix_time::milliseconds(refresh_period));
+
+      size_t value = current.load(boost::memory_order_relaxed);
+
+      if (value != last_rendered)
+      {
+        render(value);
+        last_rendered = value;
+      }
+    }
+  }
+  catch (boost::thread_interrupted&)
+  {
+    /* 'end' was called */
+  }
+}
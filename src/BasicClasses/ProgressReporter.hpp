@@ -0,0 +1,116 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _PROGRESSREPORTER_HPP_
+#define _PROGRESSREPORTER_HPP_
+
+#include <cstdio>
+#include <string>
+using std::string;
+
+#include <boost/atomic.hpp>
+
+namespace boost
+{
+  class thread;
+}
+
+namespace cepba_tools
+{
+  /*
+    Progress reporting for hot loops. The loop just bumps a relaxed atomic
+    counter ('increment' or 'update'), so it is cheap and safe to be shared
+    by several threads. When there is any output to show, a background thread
+    renders the counter every 'refresh_period' milliseconds using the
+    'system_messages' progress messages. 'end' stops the reporter and prints
+    the final message; the destructor just stops it.
+  */
+  class ProgressReporter {
+
+    public:
+      typedef enum { items, percentage } progress_type;
+
+      static unsigned int refresh_period;
+
+      ProgressReporter(const char*   message,
+                       size_t        total,
+                       progress_type type    = items,
+                       FILE*         channel = stdout);
+
+      ProgressReporter(string        message,
+                       size_t        total,
+                       progress_type type    = items,
+                       FILE*         channel = stdout);
+
+      ~ProgressReporter(void);
+
+      // Add 'amount' items to the progress
+      void increment(size_t amount = 1)
+      {
+        current.fetch_add(amount, boost::memory_order_relaxed);
+      }
+
+      // Set the current progress (items or percentage)
+      void update(size_t value)
+      {
+        current.store(value, boost::memory_order_relaxed);
+      }
+
+      // Stop the reporter and print the final message
+      void end(void);
+
+    private:
+      string                message;
+      size_t                total;
+      progress_type         type;
+      FILE*                 channel;
+
+      boost::atomic<size_t> current;
+      boost::atomic<bool>   finished;
+      boost::thread*        reporter;
+
+      void start(void);
+
+      bool stop(void);
+
+      void render(size_t value);
+
+      void reporter_loop(void);
+
+      ProgressReporter(const ProgressReporter&);
+      ProgressReporter& operator= (const ProgressReporter&);
+  };
+}
+
+#endif
@@ -192,7 +192,7 @@ void system_messages::show_progress(const char* message,
   {
     int current_percentage, real_percentage;
 
-    current_percentage = (100*current)/total;
+    current_percentage = (int) ((100.0*current)/total);
 
     if (current_percentage < 0)
       real_percentage = 0;
@@ -201,14 +201,6 @@ void system_messages::show_progress(const char* message,
     else
      real_percentage = current_percentage;
 
-    if (real_percentage % 10 == 0 && real_percentage != 100 &&
-        real_percentage > system_messages::last_percentage_written)
-    {
-      fprintf(channel, " %03d%%", real_percentage);
-      fflush(channel);
-      system_messages::last_percentage_written = real_percentage;
-    }
-
     if(!system_messages::progress_ongoing)
     {
       fprintf(channel, "%s %03d%%", message, real_percentage);
@@ -218,13 +210,7 @@ void system_messages::show_progress(const char* message,
     }
     else
     {
-      if (real_percentage % 10 == 0 && real_percentage != 100 &&
-          real_percentage > system_messages::last_percentage_written)
-      {
-        fprintf(channel, " %03d%%", real_percentage);
-        fflush(channel);
-        system_messages::last_percentage_written = real_percentage;
-      }
+      system_messages::write_pending_percentages(real_percentage, channel);
     }
 
     return;
@@ -241,7 +227,7 @@ void system_messages::show_progress(const char* message,
     {
       int current_percentage, real_percentage;
 
-      current_percentage = (100*current)/total;
+      current_percentage = (int) ((100.0*current)/total);
 
       if (current_percentage < 0)
         real_percentage = 0;
@@ -267,19 +253,34 @@ void system_messages::show_progress(const char* message,
         }
         else
         {
-          if (real_percentage % 10 == 0 && real_percentage != 100 &&
-              real_percentage > system_messages::last_percentage_written)
-          {
-            fprintf(channel, " %03d%%", real_percentage);
-            fflush(channel);
-            system_messages::last_percentage_written = real_percentage;
-          }
+          system_messages::write_pending_percentages(real_percentage, channel);
         }
       }
     }
   }
 }
 
+/* Writes the tens not yet written up to 'real_percentage', so the output is
+ * the same regardless of how often the progress is updated */
+void system_messages::write_pending_percentages(int   real_percentage,
+                                                FILE* channel)
+{
+  bool written = false;
+
+  while (system_messages::last_percentage_written+10 <= real_percentage &&
+         system_messages::last_percentage_written+10 <  100)
+  {
+    system_messages::last_percentage_written += 10;
+    fprintf(channel, " %03d%%", system_messages::last_percentage_written);
+    written = true;
+  }
+
+  if (written)
+  {
+    fflush(channel);
+  }
+}
+
 void system_messages::show_progress_end(string message,
                                         int    total,
                                         FILE*  channel)
@@ -347,14 +348,6 @@ void system_messages::show_percentage_progress(const char* message,
 
   if (system_messages::paraver_verbosity)
   {
-    if (real_percentage % 10 == 0 && real_percentage != 100 &&
-        real_percentage > system_messages::last_percentage_written)
-    {
-      fprintf(channel, " %03d%%", real_percentage);
-      fflush(channel);
-      system_messages::last_percentage_written = real_percentage;
-    }
-
     if(!system_messages::percentage_ongoing)
     {
       fprintf(channel, "%s %03d%%", message, real_percentage);
@@ -364,13 +357,7 @@ void system_messages::show_percentage_progress(const char* message,
     }
     else
     {
-      if (real_percentage % 10 == 0 && real_percentage != 100 &&
-          real_percentage > system_messages::last_percentage_written)
-      {
-        fprintf(channel, " %03d%%", real_percentage);
-        fflush(channel);
-        system_messages::last_percentage_written = real_percentage;
-      }
+      system_messages::write_pending_percentages(real_percentage, channel);
     }
 
     return;
@@ -402,13 +389,7 @@ void system_messages::show_percentage_progress(const char* message,
         }
         else
         {
-          if (real_percentage % 10 == 0 && real_percentage != 100 &&
-              real_percentage > system_messages::last_percentage_written)
-          {
-            fprintf(channel, " %03d%%", real_percentage);
-            fflush(channel);
-            system_messages::last_percentage_written = real_percentage;
-          }
+          system_messages::write_pending_percentages(real_percentage, channel);
         }
       }
     }
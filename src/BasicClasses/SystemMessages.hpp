@@ -132,6 +132,10 @@ namespace cepba_tools
       static void show_timer(const char*      message,
                              Timer::diff_type Time,
                              FILE*            channel = stdout);
+
+    private:
+      static void write_pending_percentages(int   real_percentage,
+                                            FILE* channel);
   };
 }
 
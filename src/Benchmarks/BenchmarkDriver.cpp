@@ -0,0 +1,400 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include <types.h>
+
+#include <libTraceClustering.hpp>
+#include <MirkinDistance.hpp>
+
+#include <Timer.hpp>
+using cepba_tools::Timer;
+#include <ParallelFor.hpp>
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::phase_summary;
+#include <FileNameManipulator.hpp>
+using cepba_tools::FileNameManipulator;
+
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+
+#include <algorithm>
+
+#include <unistd.h>
+#include <getopt.h>
+
+#include <iostream>
+#include <iomanip>
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::fixed;
+using std::setprecision;
+
+#include <fstream>
+using std::ifstream;
+using std::ofstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+struct globalArgs_t {
+  string       ClusteringDefinitionXML;
+  string       InputTraceName;
+  string       OutputPrefix;
+  string       ResultsFileName;
+  string       Label;
+  string       ReferenceData;
+  bool         Refinement;
+  bool         Reconstruct;
+  unsigned int Threads;
+} globalArgs;
+
+#define ABOUT \
+"BenchmarkDriver version 1.0\n"\
+"(c) CEPBA-Tools - Barcelona Supercomputing Center\n"\
+"Times each phase of a complete analysis with 'libTraceClustering', down to\n"\
+"the phases the library registers internally\n"
+
+#define HELP \
+"Usage: BenchmarkDriver [options] -d <clustering_def.xml> -i <input_trace> -o <output_prefix>\n"\
+"  -r <results_csv> : File where the phase times are appended (default: bench_results.csv)\n"\
+"  -l <label>       : Label of this run in the results file, e.g. the commit (default: none)\n"\
+"  -R               : Run a cluster refinement analysis instead of a single DBSCAN\n"\
+"  -x               : Skip the trace reconstruction\n"\
+"  -c <data_csv>    : Report the partition differences against the data file\n"\
+"                     of a reference run, e.g. a double precision build\n"\
+"  -j <threads>     : Number of threads used by the library (all cores by default)\n"\
+"  -h               : Print this help\n"
+
+void PrintUsage(void)
+{
+  cout << ABOUT;
+  cout << HELP;
+}
+
+void ReadArgs(int argc, char *argv[])
+{
+  int opt = 0;
+
+  if (argc == 1)
+  {
+    PrintUsage();
+    exit(EXIT_SUCCESS);
+  }
+
+  globalArgs.ResultsFileName = "bench_results.csv";
+  globalArgs.Label           = "none";
+  globalArgs.ReferenceData   = "";
+  globalArgs.Refinement      = false;
+  globalArgs.Reconstruct     = true;
+  globalArgs.Threads         = 0;
+
+  while( (opt = getopt( argc, argv, "d:i:o:r:l:Rxc:j:h")) != -1 )
+  {
+    switch( opt )
+    {
+      case 'd':
+        globalArgs.ClusteringDefinitionXML = string(optarg);
+        break;
+
+      case 'i':
+        globalArgs.InputTraceName = string(optarg);
+        break;
+
+      case 'o':
+        globalArgs.OutputPrefix = string(optarg);
+        break;
+
+      case 'r':
+        globalArgs.ResultsFileName = string(optarg);
+        break;
+
+      case 'l':
+        globalArgs.Label = string(optarg);
+        break;
+
+      case 'R':
+        globalArgs.Refinement = true;
+        break;
+
+      case 'x':
+        globalArgs.Reconstruct = false;
+        break;
+
+      case 'c':
+        globalArgs.ReferenceData = string(optarg);
+        break;
+
+      case 'j':
+        if (atoi(optarg) <= 0)
+        {
+          cerr << "Number of threads must be positive ('-j')" << endl << endl;
+          PrintUsage();
+          exit(EXIT_FAILURE);
+        }
+        globalArgs.Threads = atoi(optarg);
+        break;
+
+      case 'h':   /* fall-through is intentional */
+      case '?':
+        PrintUsage();
+        exit (EXIT_SUCCESS);
+
+      default:
+        cerr << "Wrong parameter!" << endl << endl;
+        PrintUsage ();
+        exit(EXIT_FAILURE);
+        break;
+    }
+  }
+
+  if (globalArgs.ClusteringDefinitionXML.length() == 0 ||
+      globalArgs.InputTraceName.length() == 0 ||
+      globalArgs.OutputPrefix.length() == 0)
+  {
+    cerr << "You must specify the clustering definition, the input trace and the output prefix" << endl << endl;
+    PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Closes the phase opened by the driver, aborting the run if it failed */
+void CheckPhase(bool Result, const char *Phase, libTraceClustering &Clustering)
+{
+  instrumentation::phase_end();
+
+  if (!Result)
+  {
+    cerr << "Error in phase '" << Phase << "': " << Clustering.GetErrorMessage() << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * Appends one row per phase to the results file, writing the header first if
+ * the file is new. Phases are the ones of the instrumentation registry: the
+ * driver phases and, under them, the ones registered by the library, named
+ * by their full path (e.g. 'cluster/cluster_analysis/clustering'). Times of
+ * phases run on several threads are summed, so they can exceed their parent.
+ * Rows keep the label so the results of several commits can be accumulated
+ * on the same file
+ */
+bool WriteResults(Timer::diff_type Total)
+{
+  bool                  NewFile;
+  ofstream              Results;
+  vector<phase_summary> Phases;
+  string   Mode  = (globalArgs.Refinement ? "refinement" : "dbscan");
+  string   Trace = FileNameManipulator(globalArgs.InputTraceName, "prv").GetChoppedFileName();
+
+  if (Trace.rfind('/') != string::npos)
+  {
+    Trace = Trace.substr(Trace.rfind('/')+1);
+  }
+
+  NewFile = !ifstream(globalArgs.ResultsFileName.c_str()).good();
+
+  Results.open(globalArgs.ResultsFileName.c_str(), std::ios_base::app);
+  if (!Results)
+  {
+    cerr << "Unable to open results file '" << globalArgs.ResultsFileName;
+    cerr << "': " << strerror(errno) << endl;
+    return false;
+  }
+
+  if (NewFile)
+  {
+    Results << "# Label,Trace,Mode,Threads,Phase,Seconds" << endl;
+  }
+
+  instrumentation::phases(Phases);
+
+  phase_summary TotalPhase;
+  TotalPhase.path    = "total";
+  TotalPhase.calls   = 1;
+  TotalPhase.seconds = Total / 1e6;
+  Phases.push_back(TotalPhase);
+
+  Results << fixed << setprecision(6);
+  cout    << fixed << setprecision(6);
+  for (size_t i = 0; i < Phases.size(); i++)
+  {
+    size_t Depth = std::count(Phases[i].path.begin(), Phases[i].path.end(), '/');
+    string Name  = Phases[i].path.substr(Phases[i].path.rfind('/')+1);
+
+    Results << globalArgs.Label << ",";
+    Results << Trace << ",";
+    Results << Mode << ",";
+    Results << cepba_tools::parallel_threads() << ",";
+    Results << Phases[i].path << ",";
+    Results << Phases[i].seconds << endl;
+
+    cout << string(2*Depth, ' ') << std::left << std::setw(32-2*Depth) << Name;
+    cout << std::right << std::setw(12) << Phases[i].seconds << " s";
+    if (Phases[i].calls > 1)
+    {
+      cout << " (" << Phases[i].calls << " calls)";
+    }
+    cout << endl;
+  }
+
+  return true;
+}
+
+/**
+ * Compares the partition just written with the one of a reference run over
+ * the same trace. Any difference is reported, but it is not an error
+ */
+bool ComparePartitions(void)
+{
+  MirkinDistance Comparison;
+  bool           UseNoise = true;
+  double         Distance, AdjustedRandIndex, NormalizedMutualInformation;
+  string         DataFileName = globalArgs.OutputPrefix+".DATA.csv";
+
+  if (!Comparison.GetIndices(globalArgs.ReferenceData,
+                             DataFileName,
+                             UseNoise,
+                             Distance,
+                             AdjustedRandIndex,
+                             NormalizedMutualInformation))
+  {
+    cerr << "Error comparing partitions: " << Comparison.GetLastError() << endl;
+    return false;
+  }
+
+  cout << "Partition against " << globalArgs.ReferenceData << ": ";
+
+  if (Distance == 0.0)
+  {
+    cout << "identical" << endl;
+  }
+  else
+  {
+    cout << fixed << setprecision(6);
+    cout << "DIFFERENT (Mirkin distance " << Distance;
+    cout << ", adjusted Rand index " << AdjustedRandIndex;
+    cout << ", NMI " << NormalizedMutualInformation << ")" << endl;
+  }
+
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  Timer         Total;
+  unsigned char Flags;
+
+  ReadArgs(argc, argv);
+
+  if (globalArgs.Threads > 0)
+  {
+    cepba_tools::set_parallel_threads(globalArgs.Threads);
+  }
+
+  /* The breakdown of the phases is taken from the registry */
+  instrumentation::enabled = true;
+
+  libTraceClustering Clustering (false);
+
+  FileNameManipulator NameManipulator(globalArgs.InputTraceName, "prv");
+
+  Flags = (globalArgs.Refinement ? CLUSTERING_REFINEMENT : CLUSTERING);
+
+  Total.begin();
+
+  instrumentation::phase_begin("init");
+  CheckPhase(Clustering.InitTraceClustering(globalArgs.ClusteringDefinitionXML,
+                                            NameManipulator.GetChoppedFileName()+".pcf",
+                                            false,
+                                            false,
+                                            Flags|PLOTS),
+             "init", Clustering);
+
+  /* Parse, burst extraction and normalization */
+  instrumentation::phase_begin("extract");
+  CheckPhase(Clustering.ExtractData(globalArgs.InputTraceName, false, 0, string("")),
+             "extract", Clustering);
+
+  if (globalArgs.Refinement)
+  {
+    instrumentation::phase_begin("refinement");
+    CheckPhase(Clustering.ClusterRefinementAnalysis(true,
+                                                    false,
+                                                    globalArgs.OutputPrefix),
+               "refinement", Clustering);
+  }
+  else
+  {
+    /* Clustering, classification and statistics */
+    instrumentation::phase_begin("cluster");
+    CheckPhase(Clustering.ClusterAnalysis(), "cluster", Clustering);
+  }
+
+  instrumentation::phase_begin("sequence_score");
+  CheckPhase(Clustering.ComputeSequenceScore(globalArgs.OutputPrefix, false),
+             "sequence_score", Clustering);
+
+  instrumentation::phase_begin("flush");
+  CheckPhase(Clustering.FlushData(globalArgs.OutputPrefix) &&
+             Clustering.FlushClustersInformation(globalArgs.OutputPrefix+".clusters_info.csv"),
+             "flush", Clustering);
+
+  if (globalArgs.Reconstruct)
+  {
+    instrumentation::phase_begin("reconstruct");
+    CheckPhase(Clustering.ReconstructInputTrace(globalArgs.OutputPrefix+".prv",
+                                                false,
+                                                false),
+               "reconstruct", Clustering);
+  }
+
+  if (!WriteResults(Total.end()))
+  {
+    exit(EXIT_FAILURE);
+  }
+
+  if (globalArgs.ReferenceData.length() > 0 && !ComparePartitions())
+  {
+    exit(EXIT_FAILURE);
+  }
+
+  exit(EXIT_SUCCESS);
+}
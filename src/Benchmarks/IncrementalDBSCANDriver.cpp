@@ -0,0 +1,439 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include <types.h>
+
+#include <libClustering.hpp>
+#include <IncrementalDBSCAN.hpp>
+
+#include <Timer.hpp>
+using cepba_tools::Timer;
+
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+
+#include <unistd.h>
+#include <getopt.h>
+
+#include <iostream>
+#include <iomanip>
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::fixed;
+using std::setprecision;
+
+#include <string>
+using std::string;
+
+#include <sstream>
+using std::ostringstream;
+
+#include <vector>
+using std::vector;
+
+#include <map>
+using std::map;
+
+struct globalArgs_t {
+  size_t       Points;
+  size_t       BatchSize;
+  unsigned int Clusters;
+  double       Noise;
+  double       Spread;
+  unsigned int Dimensions;
+  double       Eps;
+  int          MinPoints;
+  unsigned int Seed;
+  size_t       ReportEvery;
+  bool         Compare;
+  double       MaxGrowth;
+} globalArgs;
+
+#define ABOUT \
+"IncrementalDBSCANDriver version 1.0\n"\
+"(c) CEPBA-Tools - Barcelona Supercomputing Center\n"\
+"Feeds a synthetic stream of bursts to the incremental DBSCAN of 'libClustering'\n"\
+"in batches, and times each batch\n"
+
+#define HELP \
+"Usage: IncrementalDBSCANDriver [options]\n"\
+"  -n <points>    : Total points of the stream (default: 100000)\n"\
+"  -b <batch>     : Points per batch (default: 1000)\n"\
+"  -k <clusters>  : Number of clusters of the stream (default: 4)\n"\
+"  -p <noise>     : Fraction of noise points (default: 0.05)\n"\
+"  -w <spread>    : Standard deviation of each cluster (default: 0.01)\n"\
+"  -m <dims>      : Dimensions of the points (default: 2)\n"\
+"  -e <eps>       : DBSCAN epsilon (default: 0.01)\n"\
+"  -M <minpoints> : DBSCAN min points (default: 10)\n"\
+"  -s <seed>      : Random seed (default: 1)\n"\
+"  -r <batches>   : Batches between partition reports (default: 10)\n"\
+"  -c             : Compare the final partition against a batch DBSCAN\n"\
+"  -g <ratio>     : Fail if the last quarter of the batches takes more than\n"\
+"                   <ratio> times the first quarter (default: no check)\n"\
+"  -h             : Print this help\n"
+
+void PrintUsage(void)
+{
+  cout << ABOUT;
+  cout << HELP;
+}
+
+void ReadArgs(int argc, char *argv[])
+{
+  int opt = 0;
+
+  globalArgs.Points      = 100000;
+  globalArgs.BatchSize   = 1000;
+  globalArgs.Clusters    = 4;
+  globalArgs.Noise       = 0.05;
+  globalArgs.Spread      = 0.01;
+  globalArgs.Dimensions  = 2;
+  globalArgs.Eps         = 0.01;
+  globalArgs.MinPoints   = 10;
+  globalArgs.Seed        = 1;
+  globalArgs.ReportEvery = 10;
+  globalArgs.Compare     = false;
+  globalArgs.MaxGrowth   = 0;
+
+  while( (opt = getopt( argc, argv, "n:b:k:p:w:m:e:M:s:r:cg:h")) != -1 )
+  {
+    switch( opt )
+    {
+      case 'n':
+        globalArgs.Points = strtoul(optarg, NULL, 10);
+        break;
+
+      case 'b':
+        globalArgs.BatchSize = strtoul(optarg, NULL, 10);
+        break;
+
+      case 'k':
+        globalArgs.Clusters = atoi(optarg);
+        break;
+
+      case 'p':
+        globalArgs.Noise = atof(optarg);
+        break;
+
+      case 'w':
+        globalArgs.Spread = atof(optarg);
+        break;
+
+      case 'm':
+        globalArgs.Dimensions = atoi(optarg);
+        break;
+
+      case 'e':
+        globalArgs.Eps = atof(optarg);
+        break;
+
+      case 'M':
+        globalArgs.MinPoints = atoi(optarg);
+        break;
+
+      case 's':
+        globalArgs.Seed = atoi(optarg);
+        break;
+
+      case 'r':
+        globalArgs.ReportEvery = strtoul(optarg, NULL, 10);
+        break;
+
+      case 'c':
+        globalArgs.Compare = true;
+        break;
+
+      case 'g':
+        globalArgs.MaxGrowth = atof(optarg);
+        break;
+
+      case 'h':   /* fall-through is intentional */
+      case '?':
+        PrintUsage();
+        exit (EXIT_SUCCESS);
+
+      default:
+        cerr << "Wrong parameter!" << endl << endl;
+        PrintUsage ();
+        exit(EXIT_FAILURE);
+        break;
+    }
+  }
+
+  if (globalArgs.BatchSize == 0 || globalArgs.Clusters == 0 ||
+      globalArgs.Dimensions == 0 || globalArgs.Eps <= 0 ||
+      globalArgs.MinPoints <= 0)
+  {
+    cerr << "Batch size, clusters, dimensions, epsilon and min points must be positive" << endl << endl;
+    PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Same stream shape as 'SyntheticTraceGenerator': bursts cycle through the
+ * clusters, whose centers are spread differently on each dimension, and a
+ * fraction of them are uniform noise */
+class BurstsStream
+{
+  private:
+    unsigned short RandomState[3];
+    size_t         Burst;
+
+  public:
+    BurstsStream(void)
+    {
+      RandomState[0] = (unsigned short) globalArgs.Seed;
+      RandomState[1] = 0;
+      RandomState[2] = 0;
+      Burst          = 0;
+    }
+
+    Point* Next(void)
+    {
+      vector<double> Metrics (globalArgs.Dimensions);
+
+      if (erand48(RandomState) < globalArgs.Noise)
+      {
+        for (unsigned int i = 0; i < globalArgs.Dimensions; i++)
+        {
+          Metrics[i] = erand48(RandomState);
+        }
+      }
+      else
+      {
+        unsigned int Cluster = Burst % globalArgs.Clusters;
+
+        for (unsigned int i = 0; i < globalArgs.Dimensions; i++)
+        {
+          unsigned int Slot   = (Cluster * (2*i+1)) % globalArgs.Clusters;
+          double       Center = (Slot + 0.5) / globalArgs.Clusters;
+
+          Metrics[i] = Center + globalArgs.Spread * Gaussian();
+        }
+      }
+
+      Burst++;
+
+      return new Point(Metrics);
+    }
+
+  private:
+    double Gaussian(void)
+    {
+      double U1 = erand48(RandomState);
+      double U2 = erand48(RandomState);
+
+      if (U1 < 1e-12)
+        U1 = 1e-12;
+
+      return sqrt(-2.0 * log(U1)) * cos(2.0 * M_PI * U2);
+    }
+};
+
+/**
+ * Runs a batch DBSCAN over all the points and checks the incremental result
+ * against it. Cores and noise do not depend on the order of the points, so
+ * both must match exactly, as must the number of clusters. A border point
+ * reachable from several clusters can legitimately be assigned to any of
+ * them, so those points are only reported
+ */
+bool CompareWithBatchDBSCAN(const vector<const Point*>& Points,
+                            Partition&                  IncrementalPartition)
+{
+  libClustering       BatchClustering;
+  map<string, string> Parameters;
+  Partition           BatchPartition;
+  ostringstream       Converter;
+  Timer               T;
+
+  Converter << setprecision(17) << globalArgs.Eps;
+  Parameters["epsilon"] = Converter.str();
+  Converter.str("");
+  Converter << globalArgs.MinPoints;
+  Parameters["min_points"] = Converter.str();
+
+  T.begin();
+  if (!BatchClustering.InitClustering("DBSCAN", Parameters) ||
+      !BatchClustering.ExecuteClustering(Points, BatchPartition))
+  {
+    cerr << "Error running the batch DBSCAN: " << BatchClustering.GetErrorMessage() << endl;
+    return false;
+  }
+  cout << "Batch DBSCAN: " << T.end() / 1e6 << " s" << endl;
+
+  vector<cluster_id_t>& Batch       = BatchPartition.GetAssignmentVector();
+  vector<cluster_id_t>& Incremental = IncrementalPartition.GetAssignmentVector();
+  size_t                NoiseDifferences = 0, Reassigned = 0;
+  map<cluster_id_t, map<cluster_id_t, size_t> > Overlap;
+
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    if ((Batch[i] == NOISE_CLUSTERID) != (Incremental[i] == NOISE_CLUSTERID))
+    {
+      NoiseDifferences++;
+    }
+    else if (Batch[i] != NOISE_CLUSTERID)
+    {
+      Overlap[Incremental[i]][Batch[i]]++;
+    }
+  }
+
+  /* Points out of the main batch cluster of each incremental cluster */
+  map<cluster_id_t, map<cluster_id_t, size_t> >::iterator ClusterIt;
+  for (ClusterIt = Overlap.begin(); ClusterIt != Overlap.end(); ++ClusterIt)
+  {
+    map<cluster_id_t, size_t>::iterator MatchIt;
+    size_t                              Total = 0, Main = 0;
+
+    for (MatchIt = ClusterIt->second.begin(); MatchIt != ClusterIt->second.end(); ++MatchIt)
+    {
+      Total += MatchIt->second;
+      Main   = (MatchIt->second > Main ? MatchIt->second : Main);
+    }
+
+    Reassigned += Total - Main;
+  }
+
+  cout << "Clusters: batch " << BatchPartition.NumberOfClusters();
+  cout << ", incremental " << IncrementalPartition.NumberOfClusters() << endl;
+  cout << "Noise differences: " << NoiseDifferences << endl;
+  cout << "Borders in another cluster: " << Reassigned << endl;
+
+  return (NoiseDifferences == 0 &&
+          BatchPartition.NumberOfClusters() == IncrementalPartition.NumberOfClusters());
+}
+
+/**
+ * Checks that the batches do not get slower as the stream grows. Quarters
+ * of the stream are compared instead of single batches, which are too short
+ * to be timed reliably and also pay for the occasional rebuilds
+ */
+bool CheckGrowth(const vector<double>& BatchSeconds)
+{
+  size_t Quarter = (BatchSeconds.size() + 3) / 4;
+  double First = 0, Last = 0;
+
+  for (size_t i = 0; i < Quarter; i++)
+  {
+    First += BatchSeconds[i];
+    Last  += BatchSeconds[BatchSeconds.size() - Quarter + i];
+  }
+
+  cout << "Last/first quarter time: " << setprecision(2) << Last / First << endl;
+
+  if (Last > globalArgs.MaxGrowth * First)
+  {
+    cerr << "Batches got " << Last / First << " times slower (maximum ";
+    cerr << globalArgs.MaxGrowth << ")" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  vector<const Point*> Points;
+  Partition            CurrentPartition;
+  Timer                T;
+  vector<double>       BatchSeconds;
+  double               TotalSeconds = 0;
+  size_t               Batches      = 0;
+
+  ReadArgs(argc, argv);
+
+  BurstsStream      Stream;
+  IncrementalDBSCAN Clustering (globalArgs.Eps, globalArgs.MinPoints);
+
+  Points.reserve(globalArgs.Points);
+
+  cout << "# Batch,Points,Cores,Batch seconds,Clusters" << endl;
+
+  while (Points.size() < globalArgs.Points)
+  {
+    vector<const Point*> Batch;
+
+    while (Batch.size() < globalArgs.BatchSize && Points.size() < globalArgs.Points)
+    {
+      Batch.push_back(Stream.Next());
+      Points.push_back(Batch.back());
+    }
+
+    T.begin();
+    if (!Clustering.AddPoints(Batch))
+    {
+      cerr << "Error adding batch " << Batches << ": " << Clustering.GetLastError() << endl;
+      exit(EXIT_FAILURE);
+    }
+    double Seconds = T.end() / 1e6;
+
+    BatchSeconds.push_back(Seconds);
+    TotalSeconds += Seconds;
+    Batches++;
+
+    if (Batches % globalArgs.ReportEvery == 0 || Points.size() == globalArgs.Points)
+    {
+      Clustering.GetPartition(CurrentPartition);
+
+      cout << Batches << "," << Points.size() << "," << Clustering.GetCoresCount() << ",";
+      cout << fixed << setprecision(6) << Seconds << ",";
+      cout << CurrentPartition.NumberOfClusters() << endl;
+    }
+  }
+
+  cout << "Incremental DBSCAN: " << TotalSeconds << " s" << endl;
+
+  Clustering.GetPartition(CurrentPartition);
+
+  bool Result = true;
+  if (globalArgs.Compare)
+  {
+    Result = CompareWithBatchDBSCAN(Points, CurrentPartition);
+  }
+
+  if (globalArgs.MaxGrowth > 0 && !CheckGrowth(BatchSeconds))
+  {
+    Result = false;
+  }
+
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    delete Points[i];
+  }
+
+  return (Result ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,568 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include <types.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+
+#include <unistd.h>
+#include <getopt.h>
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <queue>
+using std::priority_queue;
+
+#include <functional>
+using std::greater;
+
+#include <utility>
+using std::pair;
+using std::make_pair;
+
+/* Event types of the counters written in the bursts */
+#define INSTRUCTIONS_EVENT 42000050
+#define CYCLES_EVENT       42000059
+#define EXTRA_METRIC_EVENT 42000100
+
+/* Ranges of the planted clusters: instructions in [10^6, 10^9], IPC in
+ * [0.25, 2.75], extra counters from 10^-3 to 1 per instruction */
+#define MIN_LOG_INSTRUCTIONS 6.0
+#define MAX_LOG_INSTRUCTIONS 9.0
+#define MIN_IPC              0.25
+#define MAX_IPC              2.75
+#define MIN_LOG_RATIO        -3.0
+#define MAX_LOG_RATIO        0.0
+
+/* Spread of the clusters, relative to each range */
+#define CLUSTER_SPREAD 0.003
+
+/* Clock frequency used to translate cycles to nanoseconds */
+#define CYCLES_PER_NS 2.0
+
+/* Paraver states */
+#define RUNNING_STATE 1
+#define MPI_STATE     3
+
+struct globalArgs_t {
+  string       OutputPrefix;
+  unsigned int Tasks;
+  unsigned int Threads;
+  unsigned int Bursts;
+  unsigned int Clusters;
+  double       Noise;
+  unsigned int Metrics;
+  unsigned int Seed;
+  double       Epsilon;
+  unsigned int MinPoints;
+} globalArgs;
+
+#define ABOUT \
+"SyntheticTraceGenerator version 1.0\n"\
+"(c) CEPBA-Tools - Barcelona Supercomputing Center\n"\
+"Generates Paraver traces with planted clusters of CPU bursts\n"
+
+#define HELP \
+"Usage: SyntheticTraceGenerator [options] -o <output_prefix>\n"\
+"  -t <tasks>    : Number of tasks (default: 16)\n"\
+"  -h <threads>  : Number of threads per task (default: 1)\n"\
+"  -b <bursts>   : Bursts per thread (default: 1000)\n"\
+"  -k <clusters> : Number of planted clusters (default: 4)\n"\
+"  -n <ratio>    : Ratio of noise bursts, between 0 and 1 (default: 0.05)\n"\
+"  -m <metrics>  : Number of clustering metrics, at least 2 (default: 2)\n"\
+"  -s <seed>     : Random seed (default: 1)\n"\
+"  -e <eps>      : DBSCAN epsilon written in the XML (default: 0.02)\n"\
+"  -p <points>   : DBSCAN min_points written in the XML (default: 10)\n"\
+"  -?            : Print this help\n"\
+"Writes <output_prefix>.prv/.pcf/.row and the clustering definition\n"\
+"<output_prefix>.xml to analyse it\n"
+
+void PrintUsage(void)
+{
+  cout << ABOUT;
+  cout << HELP;
+}
+
+bool ReadUnsigned(const char *Value, unsigned int &Result, unsigned int Min)
+{
+  char *End;
+  long  Read = strtol(Value, &End, 10);
+
+  if (*End != '\0' || Read < (long) Min)
+  {
+    return false;
+  }
+
+  Result = (unsigned int) Read;
+  return true;
+}
+
+void ReadArgs(int argc, char *argv[])
+{
+  int  opt = 0;
+  bool OutputPresent = false;
+  bool Correct       = true;
+
+  if (argc == 1)
+  {
+    PrintUsage();
+    exit(EXIT_SUCCESS);
+  }
+
+  globalArgs.Tasks     = 16;
+  globalArgs.Threads   = 1;
+  globalArgs.Bursts    = 1000;
+  globalArgs.Clusters  = 4;
+  globalArgs.Noise     = 0.05;
+  globalArgs.Metrics   = 2;
+  globalArgs.Seed      = 1;
+  globalArgs.Epsilon   = 0.02;
+  globalArgs.MinPoints = 10;
+
+  while( (opt = getopt( argc, argv, "o:t:h:b:k:n:m:s:e:p:?")) != -1 )
+  {
+    switch( opt )
+    {
+      case 'o':
+        globalArgs.OutputPrefix = string(optarg);
+        OutputPresent           = true;
+        break;
+
+      case 't':
+        Correct = ReadUnsigned(optarg, globalArgs.Tasks, 1);
+        break;
+
+      case 'h':
+        Correct = ReadUnsigned(optarg, globalArgs.Threads, 1);
+        break;
+
+      case 'b':
+        Correct = ReadUnsigned(optarg, globalArgs.Bursts, 1);
+        break;
+
+      case 'k':
+        Correct = ReadUnsigned(optarg, globalArgs.Clusters, 1);
+        break;
+
+      case 'n':
+        globalArgs.Noise = atof(optarg);
+        Correct          = (globalArgs.Noise >= 0.0 && globalArgs.Noise <= 1.0);
+        break;
+
+      case 'm':
+        Correct = ReadUnsigned(optarg, globalArgs.Metrics, 2);
+        break;
+
+      case 's':
+        Correct = ReadUnsigned(optarg, globalArgs.Seed, 0);
+        break;
+
+      case 'e':
+        globalArgs.Epsilon = atof(optarg);
+        Correct            = (globalArgs.Epsilon > 0.0);
+        break;
+
+      case 'p':
+        Correct = ReadUnsigned(optarg, globalArgs.MinPoints, 1);
+        break;
+
+      case '?':
+        PrintUsage();
+        exit (EXIT_SUCCESS);
+
+      default:
+        Correct = false;
+        break;
+    }
+
+    if (!Correct)
+    {
+      cerr << "Wrong value for parameter '-" << (char) opt << "'" << endl << endl;
+      PrintUsage();
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (!OutputPresent)
+  {
+    cerr << "You must specify the output prefix ('-o')" << endl << endl;
+    PrintUsage();
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * Bursts of a single thread. The sequence of clusters is the same on every
+ * thread (one burst of each cluster per iteration), so the sequence score
+ * has a meaningful alignment, while the values and the noise bursts depend
+ * on the seed of each thread.
+ */
+class ThreadBursts
+{
+  private:
+    unsigned int   Task;
+    unsigned int   Thread;
+    unsigned int   CPU;
+    unsigned short RandomState[3];
+    unsigned int   Burst;
+    UINT64         Time;
+
+  public:
+    ThreadBursts(unsigned int Task, unsigned int Thread)
+    : Task(Task), Thread(Thread)
+    {
+      CPU = (Task-1)*globalArgs.Threads + Thread;
+      Reset();
+    }
+
+    void Reset(void)
+    {
+      RandomState[0] = (unsigned short) globalArgs.Seed;
+      RandomState[1] = (unsigned short) Task;
+      RandomState[2] = (unsigned short) Thread;
+      Burst          = 0;
+      Time           = 1000;
+    }
+
+    bool Finished(void) const { return Burst >= globalArgs.Bursts; }
+
+    UINT64 GetTime(void) const { return Time; }
+
+    /* Writes the next burst: running state, counters and the following
+     * MPI state. Without an output file it just advances the time */
+    void Next(FILE *Output)
+    {
+      vector<double> Metrics (globalArgs.Metrics);
+      double         Instructions, IPC, Cycles;
+      UINT64         Duration, Gap;
+
+      if (erand48(RandomState) < globalArgs.Noise)
+      {
+        for (unsigned int i = 0; i < globalArgs.Metrics; i++)
+        {
+          Metrics[i] = erand48(RandomState);
+        }
+      }
+      else
+      {
+        unsigned int Cluster = Burst % globalArgs.Clusters;
+
+        for (unsigned int i = 0; i < globalArgs.Metrics; i++)
+        {
+          /* Spread the centers differently on each metric */
+          unsigned int Slot = (Cluster * (2*i+1)) % globalArgs.Clusters;
+          double       Center = (Slot + 0.5) / globalArgs.Clusters;
+
+          Metrics[i] = Center + CLUSTER_SPREAD * Gaussian();
+        }
+      }
+
+      Instructions = pow(10.0, Scale(Metrics[0], MIN_LOG_INSTRUCTIONS, MAX_LOG_INSTRUCTIONS));
+      IPC          = Scale(Metrics[1], MIN_IPC, MAX_IPC);
+      Cycles       = Instructions / IPC;
+      Duration     = (UINT64) (Cycles / CYCLES_PER_NS) + 10;
+      Gap          = 500 + (UINT64) (erand48(RandomState) * 5000);
+
+      if (Output != NULL)
+      {
+        fprintf(Output, "1:%u:1:%u:%u:%llu:%llu:%d\n",
+                CPU, Task, Thread,
+                (unsigned long long) Time,
+                (unsigned long long) (Time + Duration),
+                RUNNING_STATE);
+
+        fprintf(Output, "2:%u:1:%u:%u:%llu:%d:%llu:%d:%llu",
+                CPU, Task, Thread,
+                (unsigned long long) (Time + Duration),
+                INSTRUCTIONS_EVENT, (unsigned long long) Instructions,
+                CYCLES_EVENT,       (unsigned long long) Cycles);
+
+        for (unsigned int i = 2; i < globalArgs.Metrics; i++)
+        {
+          double Ratio = pow(10.0, Scale(Metrics[i], MIN_LOG_RATIO, MAX_LOG_RATIO));
+
+          fprintf(Output, ":%d:%llu",
+                  EXTRA_METRIC_EVENT + i,
+                  (unsigned long long) (Instructions * Ratio));
+        }
+        fprintf(Output, "\n");
+
+        fprintf(Output, "1:%u:1:%u:%u:%llu:%llu:%d\n",
+                CPU, Task, Thread,
+                (unsigned long long) (Time + Duration),
+                (unsigned long long) (Time + Duration + Gap),
+                MPI_STATE);
+      }
+
+      Time += Duration + Gap;
+      Burst++;
+    }
+
+  private:
+    double Scale(double Value, double Min, double Max)
+    {
+      if (Value < 0.0)
+        Value = 0.0;
+      if (Value > 1.0)
+        Value = 1.0;
+
+      return Min + Value * (Max - Min);
+    }
+
+    double Gaussian(void)
+    {
+      double U1 = erand48(RandomState);
+      double U2 = erand48(RandomState);
+
+      if (U1 < 1e-12)
+        U1 = 1e-12;
+
+      return sqrt(-2.0 * log(U1)) * cos(2.0 * M_PI * U2);
+    }
+};
+
+bool WriteTrace(vector<ThreadBursts> &Threads)
+{
+  string FileName = globalArgs.OutputPrefix + ".prv";
+  FILE  *Output;
+  UINT64 EndTime = 0;
+  char   Date[64];
+  time_t Now = time(NULL);
+
+  typedef pair<UINT64, size_t> pending_t;
+  priority_queue<pending_t, vector<pending_t>, greater<pending_t> > Pending;
+
+  /* First pass to know the final time, required in the header */
+  for (size_t i = 0; i < Threads.size(); i++)
+  {
+    while (!Threads[i].Finished())
+    {
+      Threads[i].Next(NULL);
+    }
+
+    if (Threads[i].GetTime() > EndTime)
+    {
+      EndTime = Threads[i].GetTime();
+    }
+    Threads[i].Reset();
+  }
+
+  if ((Output = fopen(FileName.c_str(), "w")) == NULL)
+  {
+    cerr << "Unable to open output trace '" << FileName << "': " << strerror(errno) << endl;
+    return false;
+  }
+
+  strftime(Date, sizeof(Date), "%d/%m/%y at %H:%M", localtime(&Now));
+
+  fprintf(Output, "#Paraver (%s):%llu_ns:1(%u):1:%u(",
+          Date,
+          (unsigned long long) EndTime,
+          globalArgs.Tasks * globalArgs.Threads,
+          globalArgs.Tasks);
+
+  for (unsigned int i = 0; i < globalArgs.Tasks; i++)
+  {
+    fprintf(Output, "%s%u:1", (i == 0 ? "" : ","), globalArgs.Threads);
+  }
+  fprintf(Output, "),0\n");
+
+  /* Merge the bursts of all threads in time order */
+  for (size_t i = 0; i < Threads.size(); i++)
+  {
+    Pending.push(make_pair(Threads[i].GetTime(), i));
+  }
+
+  while (!Pending.empty())
+  {
+    size_t Current = Pending.top().second;
+    Pending.pop();
+
+    Threads[Current].Next(Output);
+
+    if (!Threads[Current].Finished())
+    {
+      Pending.push(make_pair(Threads[Current].GetTime(), Current));
+    }
+  }
+
+  if (fclose(Output) != 0)
+  {
+    cerr << "Error writing output trace '" << FileName << "': " << strerror(errno) << endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool WritePCF(void)
+{
+  string FileName = globalArgs.OutputPrefix + ".pcf";
+  FILE  *Output;
+
+  if ((Output = fopen(FileName.c_str(), "w")) == NULL)
+  {
+    cerr << "Unable to open PCF file '" << FileName << "': " << strerror(errno) << endl;
+    return false;
+  }
+
+  fprintf(Output, "STATES\n");
+  fprintf(Output, "%d    Running\n", RUNNING_STATE);
+  fprintf(Output, "%d    Blocked\n", MPI_STATE);
+  fprintf(Output, "\n\n");
+
+  fprintf(Output, "EVENT_TYPE\n");
+  fprintf(Output, "7  %d PAPI_TOT_INS\n", INSTRUCTIONS_EVENT);
+  fprintf(Output, "7  %d PAPI_TOT_CYC\n", CYCLES_EVENT);
+  for (unsigned int i = 2; i < globalArgs.Metrics; i++)
+  {
+    fprintf(Output, "7  %d METRIC_%u\n", EXTRA_METRIC_EVENT + i, i);
+  }
+  fprintf(Output, "\n");
+
+  fclose(Output);
+  return true;
+}
+
+bool WriteROW(void)
+{
+  string FileName = globalArgs.OutputPrefix + ".row";
+  FILE  *Output;
+
+  if ((Output = fopen(FileName.c_str(), "w")) == NULL)
+  {
+    cerr << "Unable to open ROW file '" << FileName << "': " << strerror(errno) << endl;
+    return false;
+  }
+
+  fprintf(Output, "LEVEL CPU SIZE %u\n", globalArgs.Tasks * globalArgs.Threads);
+  for (unsigned int i = 1; i <= globalArgs.Tasks * globalArgs.Threads; i++)
+  {
+    fprintf(Output, "%u.synthetic\n", i);
+  }
+  fprintf(Output, "\n");
+
+  fprintf(Output, "LEVEL NODE SIZE 1\n");
+  fprintf(Output, "synthetic\n");
+
+  fclose(Output);
+  return true;
+}
+
+bool WriteClusteringDefinition(void)
+{
+  string FileName = globalArgs.OutputPrefix + ".xml";
+  FILE  *Output;
+
+  if ((Output = fopen(FileName.c_str(), "w")) == NULL)
+  {
+    cerr << "Unable to open XML file '" << FileName << "': " << strerror(errno) << endl;
+    return false;
+  }
+
+  fprintf(Output, "<clustering_definition use_duration=\"no\" apply_log=\"yes\" normalize_data=\"yes\" duration_filter=\"0\" threshold_filter=\"0\">\n");
+  fprintf(Output, "  <clustering_algorithm name=\"DBSCAN\">\n");
+  fprintf(Output, "    <epsilon>%g</epsilon>\n", globalArgs.Epsilon);
+  fprintf(Output, "    <min_points>%u</min_points>\n", globalArgs.MinPoints);
+  fprintf(Output, "  </clustering_algorithm>\n");
+  fprintf(Output, "  <clustering_parameters>\n");
+  fprintf(Output, "    <single_event apply_log=\"yes\" name=\"PAPI_TOT_INS\">\n");
+  fprintf(Output, "      <event_type>%d</event_type>\n", INSTRUCTIONS_EVENT);
+  fprintf(Output, "      <factor>1.0</factor>\n");
+  fprintf(Output, "    </single_event>\n");
+  fprintf(Output, "    <mixed_events apply_log=\"no\" name=\"IPC\" operation=\"/\">\n");
+  fprintf(Output, "      <event_type_a>%d</event_type_a>\n", INSTRUCTIONS_EVENT);
+  fprintf(Output, "      <event_type_b>%d</event_type_b>\n", CYCLES_EVENT);
+  fprintf(Output, "      <factor>1.0</factor>\n");
+  fprintf(Output, "    </mixed_events>\n");
+  for (unsigned int i = 2; i < globalArgs.Metrics; i++)
+  {
+    fprintf(Output, "    <mixed_events apply_log=\"yes\" name=\"METRIC_%u_PER_INS\" operation=\"/\">\n", i);
+    fprintf(Output, "      <event_type_a>%d</event_type_a>\n", EXTRA_METRIC_EVENT + i);
+    fprintf(Output, "      <event_type_b>%d</event_type_b>\n", INSTRUCTIONS_EVENT);
+    fprintf(Output, "      <factor>1.0</factor>\n");
+    fprintf(Output, "    </mixed_events>\n");
+  }
+  fprintf(Output, "  </clustering_parameters>\n");
+  fprintf(Output, "  <extrapolation_parameters all_counters=\"yes\"/>\n");
+  fprintf(Output, "  <output_plots all_plots=\"no\">\n");
+  fprintf(Output, "    <plot_definition raw_metrics=\"yes\">\n");
+  fprintf(Output, "      <x_metric title=\"IPC\">IPC</x_metric>\n");
+  fprintf(Output, "      <y_metric title=\"Instructions Completed\">PAPI_TOT_INS</y_metric>\n");
+  fprintf(Output, "    </plot_definition>\n");
+  fprintf(Output, "  </output_plots>\n");
+  fprintf(Output, "</clustering_definition>\n");
+
+  fclose(Output);
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  vector<ThreadBursts> Threads;
+
+  ReadArgs(argc, argv);
+
+  for (unsigned int Task = 1; Task <= globalArgs.Tasks; Task++)
+  {
+    for (unsigned int Thread = 1; Thread <= globalArgs.Threads; Thread++)
+    {
+      Threads.push_back(ThreadBursts(Task, Thread));
+    }
+  }
+
+  if (!WriteTrace(Threads) ||
+      !WritePCF() ||
+      !WriteROW() ||
+      !WriteClusteringDefinition())
+  {
+    exit(EXIT_FAILURE);
+  }
+
+  exit(EXIT_SUCCESS);
+}
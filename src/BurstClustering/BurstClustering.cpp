@@ -42,6 +42,9 @@ using cepba_tools::system_messages;
 using cepba_tools::FileNameManipulator;
 #include <Timer.hpp>
 using cepba_tools::Timer;
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+#include <SelfProfilePRVGenerator.hpp>
 
 #include <iostream>
 using std::cout;
@@ -86,6 +89,7 @@ set<unsigned int> EventsToParse;
 
 bool   SampleData;
 size_t MaxSamples  = 20000;
+bool   StreamingSampling = false;
 
 string ClusterSequencesFileName;
 bool   GenerateClusterSequences = false;
@@ -111,9 +115,20 @@ bool   PrintRefinementSteps     = false;
 
 bool   PrintTiming = false;
 
+string StatsJSONFileName;
+bool   WriteStatsJSON = false;
+string SelfTraceFileName;
+bool   WriteSelfTrace = false;
+
 bool   UseSemanticValue        = false;
 bool   ApplyLogToSemanticValue = false;
 
+bool               WindowsAnalysis      = false;
+size_t             WindowsCount         = 0;
+unsigned long long WindowLength         = 0;
+double             WindowsMatchDistance = 0.05;
+string             OutputWindowsInformationFileName;
+
 #define HELP \
 "%s v%s (%s %s)\n"\
 "(c) BSC Tools - Barcelona Supercomputing Center\n"\
@@ -137,8 +152,12 @@ bool   ApplyLogToSemanticValue = false;
 "                              list define an entry/exit of a region (independently)\n"\
 "                              from its value\n"\
 "\n"\
-"  -m <max_number_bursts>      Sample the data set up to the maximum number of\n"\
+"  -m[s] <max_number_bursts>   Sample the data set up to the maximum number of\n"\
 "                              bursts (default: 20000) \n"\
+"                              If 's' option is included the sample is selected\n"\
+"                              while reading the input, keeping in memory just\n"\
+"                              the sampled bursts. The rest are written to a\n"\
+"                              temporary '.spill' file next to the output\n"\
 "\n"\
 "  -a[f]                       Generate a file containing the cluster sequences\n"\
 "                              (using 'f' generates a FASTA aminoacid sequences)\n"\
@@ -164,6 +183,25 @@ bool   ApplyLogToSemanticValue = false;
 "\n"\
 "  -t                          Print accurate timming of the analysis steps\n"\
 "\n"\
+"  --stats-json <file>         Write the time spent on each phase of the\n"\
+"                              analysis and the work counters of the main\n"\
+"                              algorithms to a JSON file\n"\
+"\n"\
+"  --self-trace <file.prv>     Write a Paraver trace of the analysis itself,\n"\
+"                              with the phases run by each thread and the\n"\
+"                              work counters of the main algorithms\n"\
+"\n"\
+"  --windows <count>           Split the bursts in the given number of time\n"\
+"  --window-length <time>      windows (or in windows of the given length)\n"\
+"                              and cluster each window in parallel. Clusters\n"\
+"                              of adjacent windows are matched by their\n"\
+"                              centroids, and the clusters present on each\n"\
+"                              window are written to a 'windows_info' file\n"\
+"\n"\
+"  --window-match <distance>   Maximum distance between the centroids of two\n"\
+"                              clusters of adjacent windows to consider them\n"\
+"                              the same cluster (default: 0.05)\n"\
+"\n"\
 "  -c[l]                       Use the semantic value of the regions when using\n"\
 "                              a Paraver semantic CSV file a Paraver trace\n"\
 "                              inputs (using 'l', the algorithm apply a\n"\
@@ -197,8 +235,10 @@ void GetEventParsingParameters(char*);
 void PrintUsage(char* ApplicationName)
 {
   cout << "Usage: " << ApplicationName << " [-s] -d <clustering_def.xml> ";
-  cout << "[-m [max_number_bursts]] [-a[f]] [-r<d|a>[p] [<min_points>,<max_eps>,<min_eps>,<steps>]";
-  cout << "[-t] [-c[l]] -i <input_file> -o[s] <output_file>" << endl;
+  cout << "[-m[s] [max_number_bursts]] [-a[f]] [-r<d|a>[p] [<min_points>,<max_eps>,<min_eps>,<steps>]";
+  cout << "[-t] [--stats-json <file>] [--self-trace <file.prv>] ";
+  cout << "[--windows <count> | --window-length <time>] [--window-match <distance>] ";
+  cout << "[-c[l]] -i <input_file> -o[s] <output_file>" << endl;
 }
 
 void ReadArgs(int argc, char *argv[])
@@ -296,6 +336,11 @@ void ReadArgs(int argc, char *argv[])
         case 'm':
           SampleData = true;
 
+          if (argv[j][2] == 's')
+          {
+            StreamingSampling = true;
+          }
+
           j++;
           if (argv[j][0] != '-')
           {
@@ -380,6 +425,74 @@ void ReadArgs(int argc, char *argv[])
         case 't':
           PrintTiming = true;
           break;
+        case '-':
+          if (strcmp(argv[j], "--stats-json") == 0)
+          {
+            j++;
+            StatsJSONFileName = argv[j];
+            WriteStatsJSON    = true;
+            break;
+          }
+
+          if (strcmp(argv[j], "--self-trace") == 0)
+          {
+            j++;
+            SelfTraceFileName = argv[j];
+            WriteSelfTrace    = true;
+            break;
+          }
+
+          if (strcmp(argv[j], "--windows") == 0 ||
+              strcmp(argv[j], "--window-length") == 0)
+          {
+            char*              err;
+            unsigned long long Value;
+
+            j++;
+            Value = strtoull(argv[j], &err, 0);
+
+            if (*err || Value == 0)
+            {
+              cerr << "Error on time windows (\'" << argv[j-1] << "\'): Incorrect value ";
+              cerr << "(" << argv[j] << ")" << endl;
+              exit (EXIT_FAILURE);
+            }
+
+            if (strcmp(argv[j-1], "--windows") == 0)
+            {
+              WindowsCount = (size_t) Value;
+              WindowLength = 0;
+            }
+            else
+            {
+              WindowLength = Value;
+              WindowsCount = 0;
+            }
+
+            WindowsAnalysis = true;
+            break;
+          }
+
+          if (strcmp(argv[j], "--window-match") == 0)
+          {
+            char* err;
+
+            j++;
+            WindowsMatchDistance = strtod(argv[j], &err);
+
+            if (*err || WindowsMatchDistance < 0)
+            {
+              cerr << "Error on time windows match distance (\'--window-match\'): ";
+              cerr << "Incorrect value (" << argv[j] << ")" << endl;
+              exit (EXIT_FAILURE);
+            }
+            break;
+          }
+
+          cerr << "**** INVALID PARAMETER " << argv[j] << " **** " << endl << endl;
+          PrintUsage(argv[0]);
+          exit(EXIT_FAILURE);
+          break;
         case 'c':
           UseSemanticValue = true;
 
@@ -416,6 +529,13 @@ void ReadArgs(int argc, char *argv[])
     exit (EXIT_FAILURE);
   }
 
+  if (WindowsAnalysis && (ClusteringRefinement || SampleData))
+  {
+    cerr << "Time windows analysis can not be combined with a refinement ";
+    cerr << "(\'-r\') or a sampling (\'-m\')" << endl;
+    exit (EXIT_FAILURE);
+  }
+
   if (UseSemanticValue && !InputSemanticCSVRead)
   {
     system_messages::information("You can't use the semantic value as dimension if no Semantic CSV is given");
@@ -605,6 +725,7 @@ void CheckFileNames()
 
     OutputDataFileNamePrefix           = NameManipulator.GetChoppedFileName();
     OutputClustersInformationFileName  = NameManipulator.AppendStringAndExtension("clusters_info", "csv");
+    OutputWindowsInformationFileName   = NameManipulator.AppendStringAndExtension("windows_info", "csv");
     // ClusterSequencesFileName           = NameManipulator.AppendString("seq");
     ClusterSequencesFileName           = NameManipulator.GetChoppedFileName();
 
@@ -637,6 +758,12 @@ int main(int argc, char *argv[])
   libTraceClustering Clustering = libTraceClustering(Verbose, ParaverVerbosity);
 
   system_messages::print_timers = PrintTiming;
+  instrumentation::enabled      = WriteStatsJSON;
+
+  if (WriteSelfTrace)
+  {
+    instrumentation::start_trace();
+  }
 
   CheckFileNames();
 
@@ -675,6 +802,15 @@ int main(int argc, char *argv[])
    ***************************************************************************/
   system_messages::information("** DATA EXTRACTION **\n");
 
+  if (SampleData && StreamingSampling)
+  {
+    if (!Clustering.SetStreamingSampling(OutputDataFileNamePrefix + ".spill"))
+    {
+      cerr << "Error setting up streaming sampling: " << Clustering.GetErrorMessage() << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+
   T.begin();
   if (UseParaverEventParsing)
   {
@@ -752,7 +888,17 @@ int main(int argc, char *argv[])
       Clustering.SetDBSCANParameters(Eps, MinPoints);
     }
 
-    if (!Clustering.ClusterAnalysis())
+    if (WindowsAnalysis)
+    {
+      if (!Clustering.ClusterWindowsAnalysis(WindowsCount,
+                                             WindowLength,
+                                             WindowsMatchDistance))
+      {
+        cerr << "Error clustering data: " << Clustering.GetErrorMessage() << endl;
+        exit (EXIT_FAILURE);
+      }
+    }
+    else if (!Clustering.ClusterAnalysis())
     {
       cerr << "Error clustering data: " << Clustering.GetErrorMessage() << endl;
       exit (EXIT_FAILURE);
@@ -794,6 +940,19 @@ int main(int argc, char *argv[])
     exit (EXIT_FAILURE);
   }
 
+  /****************************************************************************
+   * TIME WINDOWS INFORMATION FLUSH
+   ***************************************************************************/
+  if (WindowsAnalysis)
+  {
+    system_messages::information("** GENERATING TIME WINDOWS INFORMATION FILE **\n");
+    if (!Clustering.FlushWindowsInformation(OutputWindowsInformationFileName))
+    {
+      cerr << "Error writing time windows information file: " << Clustering.GetErrorMessage() << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+
   /****************************************************************************
    * GNUPlot SCRIPTs GENERATION
    ***************************************************************************/
@@ -825,5 +984,31 @@ int main(int argc, char *argv[])
     system_messages::show_timer("Trace reconstruction time:", T.end());
   }
 
+  if (WriteStatsJSON)
+  {
+    if (!instrumentation::write_json(StatsJSONFileName, "BurstClustering"))
+    {
+      cerr << "Error writing statistics file " << StatsJSONFileName << ": ";
+      cerr << strerror(errno) << endl;
+      exit (EXIT_FAILURE);
+    }
+
+    system_messages::silent_information("Statistics written: "+StatsJSONFileName+"\n");
+  }
+
+  if (WriteSelfTrace)
+  {
+    SelfProfilePRVGenerator SelfTrace(SelfTraceFileName, "BurstClustering");
+
+    if (!SelfTrace.Run())
+    {
+      cerr << "Error writing self-profiling trace " << SelfTraceFileName << ": ";
+      cerr << SelfTrace.GetLastError() << endl;
+      exit (EXIT_FAILURE);
+    }
+
+    system_messages::silent_information("Self-profiling trace written: "+SelfTraceFileName+"\n");
+  }
+
   exit(EXIT_SUCCESS);
 }
@@ -79,6 +79,11 @@ bool              UseParaverEventParsing = false;
 bool              ConsecutiveEvts        = false;
 set<unsigned int> EventsToParse;
 
+bool              UseTraceSelection      = false;
+set<task_id_t>    SelectedTasks;
+timestamp_t       SelectionBegin         = 0;
+timestamp_t       SelectionEnd           = (timestamp_t) -1;
+
 #define HELP \
 "%s v%s (%s %s)\n"\
 "(c) BSC Tools - Barcelona Supercomputing Center\n"\
@@ -106,6 +111,15 @@ set<unsigned int> EventsToParse;
 "  -m <eigen_matrix_file>     CSV file containing an eigenvectors matrix to\n"\
 "                             transform the original space\n"\
 "\n"\
+"  -w <begin>:<end>           When using an input Paraver trace, only extract\n"\
+"                             the bursts entirely in this time window (trace\n"\
+"                             time units). The trace index (.idx) is used to\n"\
+"                             skip the rest of the trace\n"\
+"\n"\
+"  -t Task1,Task2,...         When using an input Paraver trace, only extract\n"\
+"                             the bursts of these tasks (1-based, as shown\n"\
+"                             by Paraver)\n"\
+"\n"\
 "\n"\
 "  -i <input_file | semantic_timeline.csv,tracefile.prv >\n"\
 "\n"\
@@ -123,10 +137,15 @@ set<unsigned int> EventsToParse;
 
 void GetEventParsingParameters(char* EventParsingArgs);
 
+void GetTimeWindowParameters(char* TimeWindowArgs);
+
+void GetTasksParameters(char* TasksArgs);
+
 void PrintUsage(char* ApplicationName)
 {
   cout << "Usage: " << ApplicationName << " -d <clustering_def.xml>";
-  cout << "[-x] [-m <eigen_matrix_file>] -i <input_trace>" << endl;
+  cout << "[-x] [-m <eigen_matrix_file>] [-w <begin>:<end>] [-t Task1,Task2,...] ";
+  cout << "-i <input_trace>" << endl;
 }
 
 void ReadArgs(int argc, char *argv[])
@@ -223,6 +242,16 @@ void ReadArgs(int argc, char *argv[])
           j++;
           GetEventParsingParameters(argv[j]);
           break;
+        case 'w':
+          UseTraceSelection = true;
+          j++;
+          GetTimeWindowParameters(argv[j]);
+          break;
+        case 't':
+          UseTraceSelection = true;
+          j++;
+          GetTasksParameters(argv[j]);
+          break;
 
         /*
         case 'g':
@@ -299,6 +328,53 @@ void GetEventParsingParameters(char* EventParsingArgs)
   cout << endl;
 }
 
+void GetTimeWindowParameters(char* TimeWindowArgs)
+{
+  char* err;
+
+  SelectionBegin = strtoull(TimeWindowArgs, &err, 0);
+  if (*err != ':')
+  {
+    cerr << "Error on time window parameters (\'-w\'): expected <begin>:<end> ";
+    cerr << "(" << TimeWindowArgs << ")" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  SelectionEnd = strtoull(err+1, &err, 0);
+  if (*err || SelectionEnd < SelectionBegin)
+  {
+    cerr << "Error on time window parameters (\'-w\'): incorrect window ";
+    cerr << "(" << TimeWindowArgs << ")" << endl;
+    exit (EXIT_FAILURE);
+  }
+}
+
+void GetTasksParameters(char* TasksArgs)
+{
+  char* err;
+
+  string       ArgsString (TasksArgs);
+  stringstream ArgsStream (ArgsString);
+  string       Buffer;
+
+  while(std::getline(ArgsStream, Buffer, ','))
+  {
+    unsigned long CurrentTask;
+
+    CurrentTask = strtoul(Buffer.c_str(), &err, 0);
+    if (*err || CurrentTask == 0)
+    {
+      cerr << "Error on tasks selection parameters (\'-t\'): Incorrect task ";
+      cerr << "(" << Buffer << ")" << endl;
+      exit (EXIT_FAILURE);
+    }
+    else
+    { /* Tasks are 0-based internally */
+      SelectedTasks.insert((task_id_t) CurrentTask-1);
+    }
+  }
+}
+
 void GenerateOutputFileNamePrefix()
 {
   string OutputFileExtension;
@@ -347,6 +423,13 @@ int main(int argc, char *argv[])
     exit (EXIT_FAILURE);
   }
 
+  if (UseTraceSelection &&
+      !Clustering.SetTraceSelection(SelectedTasks, SelectionBegin, SelectionEnd))
+  {
+    cerr << "Error selecting trace tasks and time: " << Clustering.GetErrorMessage() << endl;
+    exit (EXIT_FAILURE);
+  }
+
   if (UseParaverEventParsing)
   {
     if (!Clustering.ExtractData(InputTraceName, false, 0, EventsToParse)) // false -> No Samplig , 0 -> Max Samples
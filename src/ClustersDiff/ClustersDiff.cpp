@@ -42,6 +42,7 @@ using cepba_tools::system_messages;
 using cepba_tools::FileNameManipulator;
 #include <Timer.hpp>
 using cepba_tools::Timer;
+#include <ParallelFor.hpp>
 
 
 #include <cstring>
@@ -78,6 +79,8 @@ struct globalArgs_t {
   string ClustersFile2;
   bool   ClustersFile2Present;
   bool   UseNoise;
+  bool   AllIndices;
+  int    Threads;
 } globalArgs;
 
 #define ABOUT \
@@ -88,6 +91,8 @@ struct globalArgs_t {
 #define HELP \
 "Usage: ClustersDiff [options] -1 <clusters_csv_file1> -2 <clusters_csv_file2>\n"\
 "  -n  : Consider points classified as noise to compute the distance\n"\
+"  -a  : Also print the adjusted Rand index and the normalized mutual information\n"\
+"  -j <threads> : Number of threads used to parse the files (all cores by default)\n"\
 "  -v  : Verbose mode\n"\
 "  -h  : Print this help\n"
 
@@ -115,9 +120,11 @@ void ReadArgs(int argc, char *argv[])
   globalArgs.ClustersFile2        = "";
   globalArgs.ClustersFile2Present = false;
   globalArgs.UseNoise             = false;
+  globalArgs.AllIndices           = false;
+  globalArgs.Threads              = 0;
 
 
-  while( (opt = getopt( argc, argv, "1:2:nvh")) != -1 )
+  while( (opt = getopt( argc, argv, "1:2:naj:vh")) != -1 )
   {
     switch( opt )
     {
@@ -135,6 +142,20 @@ void ReadArgs(int argc, char *argv[])
         globalArgs.UseNoise = true;
         break;
 
+      case 'a':
+        globalArgs.AllIndices = true;
+        break;
+
+      case 'j':
+        globalArgs.Threads = atoi(optarg);
+        if (globalArgs.Threads <= 0)
+        {
+          cerr << "Number of threads must be positive ('-j')" << endl << endl;
+          PrintUsage();
+          exit(EXIT_FAILURE);
+        }
+        break;
+
       case 'v':
         globalArgs.verbosity = true;
         break;
@@ -178,19 +199,27 @@ int main(int argc, char *argv[])
   Timer          T;
   MirkinDistance DistanceCalculator;
   double         Distance;
+  double         AdjustedRandIndex;
+  double         NormalizedMutualInformation;
 
   ReadArgs(argc, argv);
 
+  cepba_tools::set_parallel_threads(globalArgs.Threads);
 
-  if (!DistanceCalculator.GetMirkinDistance(globalArgs.ClustersFile1,
-                                            globalArgs.ClustersFile2,
-                                            globalArgs.UseNoise,
-                                            Distance))
+  if (!DistanceCalculator.GetIndices(globalArgs.ClustersFile1,
+                                     globalArgs.ClustersFile2,
+                                     globalArgs.UseNoise,
+                                     Distance,
+                                     AdjustedRandIndex,
+                                     NormalizedMutualInformation))
   {
     cerr << DistanceCalculator.GetLastError() << endl;
     exit(EXIT_FAILURE);
   }
 
+  cout << fixed;
+  cout << setprecision(6);
+
   if (system_messages::verbose)
   {
     cout << "Mirkin Distance ";
@@ -198,15 +227,23 @@ int main(int argc, char *argv[])
     if (globalArgs.UseNoise)
       cout << "(with NOISE points) ";
 
-    cout << fixed;
-    cout << setprecision(6);
     cout << "= " << Distance << endl;
+
+    if (globalArgs.AllIndices)
+    {
+      cout << "Adjusted Rand Index = " << AdjustedRandIndex << endl;
+      cout << "Normalized Mutual Information = " << NormalizedMutualInformation << endl;
+    }
   }
   else
   {
-    cout << fixed;
-    cout << setprecision(6);
-    cout << Distance << endl;
+    cout << Distance;
+
+    if (globalArgs.AllIndices)
+    {
+      cout << " " << AdjustedRandIndex << " " << NormalizedMutualInformation;
+    }
+    cout << endl;
   }
 
   exit(EXIT_SUCCESS);
@@ -37,271 +37,549 @@
 #include <trace_clustering_types.h>
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
+#include <ParallelFor.hpp>
 
 #include <cerrno>
 #include <cstring>
+#include <cmath>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <iostream>
-#include <iterator>
 
 #include <sstream>
 using std::ostringstream;
-using std::istringstream;
 using std::endl;
 
-#include <limits>
-using std::numeric_limits;
-
 #include <algorithm>
-using std::set_intersection;
+using std::sort;
+using std::make_pair;
+
+/* Noise points are excluded from the comparison unless requested */
+static inline bool IsNoise(cluster_id_t ID)
+{
+  return (ID - PARAVER_OFFSET == NOISE_CLUSTERID);
+}
+
+/* Number of pairs that can be formed with 'n' elements */
+static inline double Pairs(size_t n)
+{
+  return ((double) n * (double) (n - (n > 0 ? 1 : 0))) / 2.0;
+}
+
+/* Functor to parse blocks of lines of a CSV file through 'parallel_for'.
+ * Each block starts at the beginning of a line and only the first field
+ * (instance) and the last one (cluster ID) of every line are decoded */
+class PartitionParsingTask
+{
+  private:
+    vector<const char*>            &Starts;
+    vector<vector<assignment_t> >  &Blocks;
+    vector<int>                    &Failed;
+
+  public:
+    PartitionParsingTask(vector<const char*>           &Starts,
+                         vector<vector<assignment_t> > &Blocks,
+                         vector<int>                   &Failed)
+    : Starts(Starts), Blocks(Blocks), Failed(Failed)
+    {}
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        if (!ParseBlock(Starts[i], Starts[i+1], Blocks[i]))
+        {
+          Failed[i] = 1;
+        }
+      }
+    }
+
+  private:
+    bool ParseBlock(const char *Current, const char *Stop, vector<assignment_t> &Block)
+    {
+      while (Current < Stop)
+      {
+        const char  *EndOfLine = (const char*) memchr(Current, '\n', Stop - Current);
+        const char  *LineEnd;
+        const char  *Field;
+        instance_t   Instance  = 0;
+        cluster_id_t ClusterID = 0;
+        bool         Negative  = false;
+
+        if (EndOfLine == NULL)
+        {
+          EndOfLine = Stop;
+        }
+
+        LineEnd = EndOfLine;
+        if (LineEnd > Current && LineEnd[-1] == '\r')
+        {
+          LineEnd--;
+        }
+
+        if (LineEnd == Current)
+        {
+          Current = EndOfLine + 1;
+          continue;
+        }
+
+        /* First field: instance */
+        Field = Current;
+        while (Field < LineEnd && *Field == ' ')
+        {
+          Field++;
+        }
+        if (Field == LineEnd || *Field < '0' || *Field > '9')
+        {
+          return false;
+        }
+        while (Field < LineEnd && *Field >= '0' && *Field <= '9')
+        {
+          Instance = Instance*10 + (*Field - '0');
+          Field++;
+        }
+
+        /* Last field: cluster ID */
+        Field = LineEnd;
+        while (Field > Current && Field[-1] != ',')
+        {
+          Field--;
+        }
+        if (Field == Current)
+        {
+          return false;
+        }
+        while (Field < LineEnd && *Field == ' ')
+        {
+          Field++;
+        }
+        if (Field < LineEnd && *Field == '-')
+        {
+          Negative = true;
+          Field++;
+        }
+        if (Field == LineEnd || *Field < '0' || *Field > '9')
+        {
+          return false;
+        }
+        while (Field < LineEnd && *Field >= '0' && *Field <= '9')
+        {
+          ClusterID = ClusterID*10 + (*Field - '0');
+          Field++;
+        }
+
+        Block.push_back(make_pair(Instance, (cluster_id_t) (Negative ? -ClusterID : ClusterID)));
+
+        Current = EndOfLine + 1;
+      }
+
+      return true;
+    }
+};
 
 bool MirkinDistance::GetMirkinDistance(string  ClustersFileName1,
                                        string  ClustersFileName2,
                                        bool&   UseNoise,
                                        double& Distance)
 {
-  ostringstream Messages;
+  this->ClustersFileName1 = ClustersFileName1;
+  this->ClustersFileName2 = ClustersFileName2;
+  this->UseNoise          = UseNoise;
 
-  map<cluster_id_t, vector<instance_t> >           ClustersSet1;
-  map<cluster_id_t, vector<instance_t> >::iterator ClustersSet1It;
+  if (!BuildContingencyTable())
+  {
+    return false;
+  }
 
-  map<cluster_id_t, vector<instance_t> >           ClustersSet2;
-  map<cluster_id_t, vector<instance_t> >::iterator ClustersSet2It;
+  Distance = ComputeMirkinDistance();
 
-  size_t C1Sum = 0, C2Sum = 0, C1C2Sum = 0, n = 0;
+  return true;
+}
 
+bool MirkinDistance::GetIndices(string  ClustersFileName1,
+                                string  ClustersFileName2,
+                                bool    UseNoise,
+                                double& Distance,
+                                double& AdjustedRandIndex,
+                                double& NormalizedMutualInformation)
+{
   this->ClustersFileName1 = ClustersFileName1;
   this->ClustersFileName2 = ClustersFileName2;
+  this->UseNoise          = UseNoise;
+
+  if (!BuildContingencyTable())
+  {
+    return false;
+  }
+
+  Distance                    = ComputeMirkinDistance();
+  AdjustedRandIndex           = ComputeAdjustedRandIndex();
+  NormalizedMutualInformation = ComputeNormalizedMutualInformation();
+
+  return true;
+}
+
+/* Loads both partitions and counts, in a single pass over the instances
+ * sorted, the size of every cluster and of every pair of clusters sharing
+ * instances */
+bool MirkinDistance::BuildContingencyTable(void)
+{
+  ostringstream        Messages;
+  vector<assignment_t> Assignments1;
+  vector<assignment_t> Assignments2;
+  size_t               i = 0, j = 0;
+
+  ClustersSizes1.clear();
+  ClustersSizes2.clear();
+  Table.clear();
 
   system_messages::information("**** Parsing input files ****\n");
 
-  /* Populate the sets representing each partition */
-  if (!GenerateSets(ClustersSet1, ClustersSet2))
+  if (!LoadPartition(ClustersFileName1, Assignments1) ||
+      !LoadPartition(ClustersFileName2, Assignments2))
   {
     return false;
   }
 
-  /* Compute the distance */
-  for (ClustersSet1It  = ClustersSet1.begin();
-       ClustersSet1It != ClustersSet1.end();
-       ++ClustersSet1It)
+  for (i = 0; i < Assignments1.size(); i++)
   {
-    if (UseNoise || ClustersSet1It->first-PARAVER_OFFSET != NOISE_CLUSTERID)
-    {
-      C1Sum += (ClustersSet1It->second.size() * ClustersSet1It->second.size());
-      n += ClustersSet1It->second.size();
-    }
+    ClustersSizes1[Assignments1[i].second]++;
   }
 
-  Messages << "C Sum            = " << C1Sum << " (" << ClustersSet1.size() << ")" << endl;
-  system_messages::information(Messages.str());
-
-  for (ClustersSet2It  = ClustersSet2.begin();
-       ClustersSet2It != ClustersSet2.end();
-       ++ClustersSet2It)
+  for (j = 0; j < Assignments2.size(); j++)
   {
-    if (UseNoise || ClustersSet2It->first-PARAVER_OFFSET != NOISE_CLUSTERID)
-    {
-      C2Sum += (ClustersSet2It->second.size() * ClustersSet2It->second.size());
-    }
+    ClustersSizes2[Assignments2[j].second]++;
   }
 
-  /* DEBUG */
-  Messages.str("");
-  Messages << "C' Sum           = " << C2Sum << " (" << ClustersSet2.size() << ")" << endl;
-  system_messages::information(Messages.str());
-
-  for (ClustersSet1It  = ClustersSet1.begin();
-       ClustersSet1It != ClustersSet1.end();
-       ++ClustersSet1It)
+  i = 0;
+  j = 0;
+  while (i < Assignments1.size() && j < Assignments2.size())
   {
-    for (ClustersSet2It  = ClustersSet2.begin();
-         ClustersSet2It != ClustersSet2.end();
-         ++ClustersSet2It)
+    if (Assignments1[i].first < Assignments2[j].first)
     {
-      cluster_id_t C1Id = ClustersSet1It->first-PARAVER_OFFSET;
-      cluster_id_t C2Id = ClustersSet2It->first-PARAVER_OFFSET;
-
-      vector<instance_t>& C1n = ClustersSet1It->second;
-      vector<instance_t>& C2n = ClustersSet2It->second;
-
-      vector<instance_t> Intersection;
-
-      /* DEBUG
-      Messages.str("");
-      Messages << "C Cluster " << ClustersSet1It->first << " Size  = " << C1n.size() << " | ";
-      Messages << "C' Cluster " << ClustersSet2It->first << " Size = " << C2n.size() << " | ";
-      system_messages::information(Messages.str());
-      */
-      if (UseNoise || (C1Id != NOISE_CLUSTERID && C2Id != NOISE_CLUSTERID))
-      {
-        set_intersection(C1n.begin(), C1n.end(),
-                         C2n.begin(), C2n.end(),
-                         std::inserter(Intersection, Intersection.begin()));
-
-        C1C2Sum += (Intersection.size() * Intersection.size());
-      }
-
-      /* DEBUG
-      Messages << "Intersection size = " << Intersection.size() << endl;
-      system_messages::information(Messages.str());
-      */
+      i++;
+    }
+    else if (Assignments2[j].first < Assignments1[i].first)
+    {
+      j++;
+    }
+    else
+    {
+      Table[make_pair(Assignments1[i].second, Assignments2[j].second)]++;
+      i++;
+      j++;
     }
   }
 
-  /* DEBUG */
-  Messages.str("");
-  Messages << "Intersection Sum = " << C1C2Sum << endl;
+  Messages << "Contingency table: " << ClustersSizes1.size() << "x";
+  Messages << ClustersSizes2.size() << " clusters, ";
+  Messages << Table.size() << " non-empty intersections" << endl;
   system_messages::information(Messages.str());
 
-  Distance = (C1Sum + C2Sum - (2*C1C2Sum)) / (double) (n*n);
-
   return true;
 }
 
-bool MirkinDistance::GenerateSets(map<cluster_id_t, vector<instance_t> >& ClustersSet1,
-                                  map<cluster_id_t, vector<instance_t> >& ClustersSet2)
+/* Maps the CSV file and parses it in parallel blocks. The resulting
+ * assignments are sorted by instance */
+bool MirkinDistance::LoadPartition(string               &FileName,
+                                   vector<assignment_t> &Assignments)
 {
-  ostringstream      ErrorMessage;
-  string             Line;
-  vector<string>     Record;
-
-  ifstream::pos_type FirstPos;
-  ifstream::pos_type EndPos;
-
-  ClustersFile1.open(ClustersFileName1.c_str(), ifstream::in);
-
-  if (ClustersFile1.fail())
+  ostringstream ErrorMessage;
+  struct stat   Info;
+  int           fd;
+  const char   *Data;
+  const char   *Body;
+  const char   *End;
+
+  fd = open(FileName.c_str(), O_RDONLY);
+  if (fd < 0)
   {
-    ErrorMessage << "Unable to open file " << ClustersFileName1;
+    ErrorMessage << "Unable to open file " << FileName;
     SetError(true);
-    SetErrorMessage(ErrorMessage.str().c_str(),
-                    strerror(errno));
+    SetErrorMessage(ErrorMessage.str().c_str(), strerror(errno));
     return false;
   }
 
-  ClustersFile2.open(ClustersFileName2.c_str(), ifstream::in);
-  if (ClustersFile2.fail())
+  if (fstat(fd, &Info) != 0 || Info.st_size == 0)
   {
-    ErrorMessage << "Unable to open file " << ClustersFileName2;
+    ErrorMessage << "Error reading header of file " << FileName;
     SetError(true);
-    SetErrorMessage(ErrorMessage.str().c_str(),
-                    strerror(errno));
+    SetErrorMessage(ErrorMessage.str().c_str(), strerror(errno));
+    close(fd);
     return false;
   }
 
-  /* Check both headers */
-  getline(ClustersFile1, Line);
-  if (!ClustersFile1.good())
+  Data = (const char*) mmap(NULL, Info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (Data == (const char*) MAP_FAILED)
   {
-    ErrorMessage << "Error reading header of file " << ClustersFileName1;
+    ErrorMessage << "Unable to map file " << FileName;
     SetError(true);
-    SetErrorMessage(ErrorMessage.str().c_str(),
-                    strerror(errno));
+    SetErrorMessage(ErrorMessage.str().c_str(), strerror(errno));
     return false;
   }
+  madvise((void*) Data, Info.st_size, MADV_SEQUENTIAL);
 
-  PopulateRecord(Record, Line, ',');
-  if (!CheckHeader (Record, ClustersFileName1))
-    return false;
+  End  = Data + Info.st_size;
+  Body = (const char*) memchr(Data, '\n', Info.st_size);
+  Body = (Body == NULL ? End : Body + 1);
 
-  getline(ClustersFile2, Line);
-  if (!ClustersFile1.good())
+  /* Check the header */
+  vector<string> Record;
+  PopulateRecord(Record, string(Data, Body - Data), ',');
+  if (!CheckHeader(Record, FileName))
   {
-    ErrorMessage << "Error reading header of file " << ClustersFileName2;
-    SetError(true);
-    SetErrorMessage(ErrorMessage.str().c_str(),
-                    strerror(errno));
+    munmap((void*) Data, Info.st_size);
     return false;
   }
 
-  PopulateRecord(Record, Line, ',');
-  if (!CheckHeader (Record, ClustersFileName2))
-    return false;
+  /* Split the body in blocks starting at line boundaries */
+  size_t BodySize  = End - Body;
+  size_t NumBlocks = BodySize / PARTITION_PARSING_MIN_BLOCK;
 
+  if (NumBlocks > 4*cepba_tools::parallel_threads())
+  {
+    NumBlocks = 4*cepba_tools::parallel_threads();
+  }
+  if (NumBlocks == 0)
+  {
+    NumBlocks = 1;
+  }
+
+  vector<const char*> Starts (NumBlocks+1, Body);
+  for (size_t k = 1; k < NumBlocks; k++)
+  {
+    const char *Start = Body + (BodySize / NumBlocks) * k;
+
+    if (Start < Starts[k-1])
+    {
+      Start = Starts[k-1];
+    }
 
+    if (Start > Body && Start[-1] != '\n')
+    {
+      Start = (const char*) memchr(Start, '\n', End - Start);
+      Start = (Start == NULL ? End : Start + 1);
+    }
+    Starts[k] = Start;
+  }
+  Starts[NumBlocks] = End;
 
-  /* Load partition from file 1 */
+  vector<vector<assignment_t> > Blocks (NumBlocks);
+  vector<int>                   Failed (NumBlocks, 0);
+  PartitionParsingTask          Task (Starts, Blocks, Failed);
 
-  FirstPos = ClustersFile1.tellg();
-  ClustersFile1.seekg(0, ifstream::end);
-  EndPos = ClustersFile1.tellg();
-  ClustersFile1.seekg(FirstPos);
+  cepba_tools::parallel_for(Task, 0, NumBlocks);
 
-  system_messages::show_percentage_progress("Loading file "+ClustersFileName1,
-                                            0);
+  munmap((void*) Data, Info.st_size);
 
-  while(getline(ClustersFile1, Line)  && ClustersFile1.good())
+  size_t TotalAssignments = 0;
+  for (size_t k = 0; k < NumBlocks; k++)
   {
-    cluster_id_t CurrentClusterId;
-    instance_t   CurrentInstance;
+    if (Failed[k])
+    {
+      ErrorMessage << "Error while loading " << FileName << ": wrong line format";
+      SetError(true);
+      SetErrorMessage(ErrorMessage.str());
+      return false;
+    }
+    TotalAssignments += Blocks[k].size();
+  }
 
-    PopulateRecord (Record, Line, ',');
+  Assignments.clear();
+  Assignments.reserve(TotalAssignments);
+  for (size_t k = 0; k < NumBlocks; k++)
+  {
+    Assignments.insert(Assignments.end(), Blocks[k].begin(), Blocks[k].end());
+    vector<assignment_t>().swap(Blocks[k]);
+  }
 
-    istringstream(Record[Record.size()-1]) >> CurrentClusterId;
-    istringstream(Record[0])               >> CurrentInstance;
+  /* Files are usually sorted by instance already */
+  for (size_t k = 1; k < Assignments.size(); k++)
+  {
+    if (Assignments[k].first < Assignments[k-1].first)
+    {
+      sort(Assignments.begin(), Assignments.end());
+      break;
+    }
+  }
 
-    ClustersSet1[CurrentClusterId].push_back(CurrentInstance);
+  ostringstream Messages;
+  Messages << "Loaded " << Assignments.size() << " points from '" << FileName << "'" << endl;
+  system_messages::information(Messages.str());
 
-    int Percentage = static_cast<int>(ClustersFile1.tellg()) * 100 / EndPos;
+  return true;
+}
 
-    system_messages::show_percentage_progress("Loading file '"+ClustersFileName1+"'",
-                                              Percentage);
-  }
+/* Mirkin distance. As in the original pairwise intersection, the cluster
+ * sizes come from each whole partition, noise excluded if requested */
+double MirkinDistance::ComputeMirkinDistance(void)
+{
+  ostringstream Messages;
+  double        C1Sum = 0, C2Sum = 0, C1C2Sum = 0, n = 0;
 
-  if (!ClustersFile1.eof())
+  map<cluster_id_t, size_t>::iterator SizesIt;
+  contingency_t::iterator             TableIt;
+
+  for (SizesIt = ClustersSizes1.begin(); SizesIt != ClustersSizes1.end(); ++SizesIt)
   {
-    ErrorMessage << "Error while loading " << ClustersFileName1;
-    SetError(true);
-    SetErrorMessage(ErrorMessage.str().c_str(),
-                    strerror(errno));
-    return false;
+    if (UseNoise || !IsNoise(SizesIt->first))
+    {
+      C1Sum += (double) SizesIt->second * (double) SizesIt->second;
+      n     += SizesIt->second;
+    }
   }
 
-  system_messages::show_percentage_end("Loading file '"+ClustersFileName1+"'");
+  Messages << "C Sum            = " << C1Sum << " (" << ClustersSizes1.size() << ")" << endl;
+  system_messages::information(Messages.str());
 
-  /* Load partition from file 2 */
+  for (SizesIt = ClustersSizes2.begin(); SizesIt != ClustersSizes2.end(); ++SizesIt)
+  {
+    if (UseNoise || !IsNoise(SizesIt->first))
+    {
+      C2Sum += (double) SizesIt->second * (double) SizesIt->second;
+    }
+  }
 
-  FirstPos = ClustersFile2.tellg();
-  ClustersFile2.seekg(0, ifstream::end);
-  EndPos = ClustersFile2.tellg();
-  ClustersFile2.seekg(FirstPos);
+  Messages.str("");
+  Messages << "C' Sum           = " << C2Sum << " (" << ClustersSizes2.size() << ")" << endl;
+  system_messages::information(Messages.str());
 
-  system_messages::show_percentage_progress("Loading file '"+ClustersFileName2+"'",
-                                            0);
+  for (TableIt = Table.begin(); TableIt != Table.end(); ++TableIt)
+  {
+    if (UseNoise || (!IsNoise(TableIt->first.first) && !IsNoise(TableIt->first.second)))
+    {
+      C1C2Sum += (double) TableIt->second * (double) TableIt->second;
+    }
+  }
 
-  while(getline(ClustersFile2, Line)  && ClustersFile2.good())
+  Messages.str("");
+  Messages << "Intersection Sum = " << C1C2Sum << endl;
+  system_messages::information(Messages.str());
+
+  if (n == 0)
   {
-    cluster_id_t CurrentClusterId;
-    instance_t   CurrentInstance;
+    return 0.0;
+  }
 
-    PopulateRecord (Record, Line, ',');
+  return (C1Sum + C2Sum - (2*C1C2Sum)) / (n*n);
+}
 
-    istringstream(Record[Record.size()-1]) >> CurrentClusterId;
-    istringstream(Record[0])               >> CurrentInstance;
+/* Adjusted Rand index (Hubert and Arabie) over the instances present in both
+ * partitions */
+double MirkinDistance::ComputeAdjustedRandIndex(void)
+{
+  map<cluster_id_t, size_t> Rows, Columns;
+  size_t                    n = 0;
+  double                    Index = 0, RowsPairs = 0, ColumnsPairs = 0;
+  double                    Expected, Maximum;
 
-    ClustersSet2[CurrentClusterId].push_back(CurrentInstance);
+  map<cluster_id_t, size_t>::iterator SizesIt;
+  contingency_t::iterator             TableIt;
 
-    int Percentage = static_cast<int>(ClustersFile2.tellg()) * 100 / EndPos;
+  for (TableIt = Table.begin(); TableIt != Table.end(); ++TableIt)
+  {
+    if (UseNoise || (!IsNoise(TableIt->first.first) && !IsNoise(TableIt->first.second)))
+    {
+      Index                          += Pairs(TableIt->second);
+      Rows[TableIt->first.first]     += TableIt->second;
+      Columns[TableIt->first.second] += TableIt->second;
+      n                              += TableIt->second;
+    }
+  }
 
-    system_messages::show_percentage_progress("Loading file '"+ClustersFileName2+"'",
-                                              Percentage);
+  for (SizesIt = Rows.begin(); SizesIt != Rows.end(); ++SizesIt)
+  {
+    RowsPairs += Pairs(SizesIt->second);
   }
 
-  if (!ClustersFile2.eof())
+  for (SizesIt = Columns.begin(); SizesIt != Columns.end(); ++SizesIt)
   {
-    ErrorMessage << "Error while loading " << ClustersFileName2;
-    SetError(true);
-    SetErrorMessage(ErrorMessage.str().c_str(),
-                    strerror(errno));
-    return false;
+    ColumnsPairs += Pairs(SizesIt->second);
   }
 
-  system_messages::show_percentage_end("Loading file '"+ClustersFileName2+"'");
+  if (n < 2)
+  {
+    return 1.0;
+  }
 
-  return true;
+  Expected = (RowsPairs * ColumnsPairs) / Pairs(n);
+  Maximum  = (RowsPairs + ColumnsPairs) / 2.0;
+
+  if (Maximum == Expected)
+  {
+    return 1.0;
+  }
+
+  return (Index - Expected) / (Maximum - Expected);
 }
 
+/* Mutual information normalized by the geometric mean of both entropies,
+ * over the instances present in both partitions */
+double MirkinDistance::ComputeNormalizedMutualInformation(void)
+{
+  map<cluster_id_t, size_t> Rows, Columns;
+  double                    n = 0;
+  double                    Information = 0, RowsEntropy = 0, ColumnsEntropy = 0;
+
+  map<cluster_id_t, size_t>::iterator SizesIt;
+  contingency_t::iterator             TableIt;
+
+  for (TableIt = Table.begin(); TableIt != Table.end(); ++TableIt)
+  {
+    if (UseNoise || (!IsNoise(TableIt->first.first) && !IsNoise(TableIt->first.second)))
+    {
+      Rows[TableIt->first.first]     += TableIt->second;
+      Columns[TableIt->first.second] += TableIt->second;
+      n                              += TableIt->second;
+    }
+  }
+
+  if (n == 0)
+  {
+    return 0.0;
+  }
+
+  for (TableIt = Table.begin(); TableIt != Table.end(); ++TableIt)
+  {
+    if (UseNoise || (!IsNoise(TableIt->first.first) && !IsNoise(TableIt->first.second)))
+    {
+      double Cell = TableIt->second;
+
+      Information += (Cell/n) * log((n*Cell) /
+                                    ((double) Rows[TableIt->first.first] *
+                                     (double) Columns[TableIt->first.second]));
+    }
+  }
+
+  for (SizesIt = Rows.begin(); SizesIt != Rows.end(); ++SizesIt)
+  {
+    RowsEntropy -= (SizesIt->second/n) * log(SizesIt->second/n);
+  }
+
+  for (SizesIt = Columns.begin(); SizesIt != Columns.end(); ++SizesIt)
+  {
+    ColumnsEntropy -= (SizesIt->second/n) * log(SizesIt->second/n);
+  }
+
+  if (RowsEntropy == 0 && ColumnsEntropy == 0)
+  {
+    return 1.0;
+  }
+
+  if (RowsEntropy == 0 || ColumnsEntropy == 0)
+  {
+    return 0.0;
+  }
+
+  return Information / sqrt(RowsEntropy * ColumnsEntropy);
+}
 
 void MirkinDistance::PopulateRecord(vector<string> &Record,
                                     const string   &Line,
@@ -42,25 +42,34 @@ using cepba_tools::Error;
 #include <string>
 using std::string;
 
-#include <fstream>
-using std::ifstream;
-
 #include <vector>
 using std::vector;
 
 #include <map>
 using std::map;
 
-#include <set>
-using std::set;
+#include <utility>
+using std::pair;
+
+/* Minimum size of the blocks of a CSV file parsed by each thread */
+#define PARTITION_PARSING_MIN_BLOCK (1024*1024)
+
+/* Assignment of an instance to a cluster, as read from a CSV file */
+typedef pair<instance_t, cluster_id_t> assignment_t;
+
+/* Sparse contingency table of two partitions, indexed by the cluster pair */
+typedef map<pair<cluster_id_t, cluster_id_t>, size_t> contingency_t;
 
 class MirkinDistance: public Error
 {
-  string   ClustersFileName1;
-  ifstream ClustersFile1;
+  string ClustersFileName1;
+  string ClustersFileName2;
+  bool   UseNoise;
 
-  string   ClustersFileName2;
-  ifstream ClustersFile2;
+  /* Cluster sizes of each partition, and intersections of both */
+  map<cluster_id_t, size_t> ClustersSizes1;
+  map<cluster_id_t, size_t> ClustersSizes2;
+  contingency_t             Table;
 
   public:
 
@@ -68,10 +77,26 @@ class MirkinDistance: public Error
                            string  ClustersFileName2,
                            bool&   UseNoise,
                            double& Distance);
+
+    bool GetIndices(string  ClustersFileName1,
+                    string  ClustersFileName2,
+                    bool    UseNoise,
+                    double& Distance,
+                    double& AdjustedRandIndex,
+                    double& NormalizedMutualInformation);
+
   private:
 
-    bool GenerateSets(map<cluster_id_t, vector<instance_t> >& ClustersSet1,
-                      map<cluster_id_t, vector<instance_t> >& ClustersSet2);
+    bool BuildContingencyTable(void);
+
+    bool LoadPartition(string               &FileName,
+                       vector<assignment_t> &Assignments);
+
+    double ComputeMirkinDistance(void);
+
+    double ComputeAdjustedRandIndex(void);
+
+    double ComputeNormalizedMutualInformation(void);
 
     void PopulateRecord(vector<string> &Record,
                         const string   &Line,
@@ -0,0 +1,349 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "DataFilesMerge.h"
+
+#include <ParallelFor.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Portion of an input file to be copied to a given offset of the output file.
+ */
+typedef struct
+{
+  size_t Input;
+  off_t  Source;
+  off_t  Target;
+  size_t Length;
+} DataBlock;
+
+
+/**
+ * Reads exactly Length bytes from the given offset, retrying short reads.
+ *
+ * @return True if all bytes were read, false otherwise.
+ */
+static bool ReadAt(int fd, char *Buffer, size_t Length, off_t Offset)
+{
+  while (Length > 0)
+  {
+    ssize_t Done = pread(fd, Buffer, Length, Offset);
+
+    if (Done < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (Done <= 0)
+    {
+      return false;
+    }
+
+    Buffer += Done;
+    Offset += Done;
+    Length -= Done;
+  }
+  return true;
+}
+
+
+/**
+ * Writes exactly Length bytes at the given offset, retrying short writes.
+ *
+ * @return True if all bytes were written, false otherwise.
+ */
+static bool WriteAt(int fd, const char *Buffer, size_t Length, off_t Offset)
+{
+  while (Length > 0)
+  {
+    ssize_t Done = pwrite(fd, Buffer, Length, Offset);
+
+    if (Done < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (Done <= 0)
+    {
+      return false;
+    }
+
+    Buffer += Done;
+    Offset += Done;
+    Length -= Done;
+  }
+  return true;
+}
+
+
+/**
+ * Computes the length of the header line of a file, including its line
+ * break. Files without any line break are considered to be all header.
+ *
+ * @return True if the file could be read, false otherwise.
+ */
+static bool HeaderLength(int fd, off_t Size, off_t &Length)
+{
+  char Buffer[4096];
+
+  Length = 0;
+  while (Length < Size)
+  {
+    size_t Chunk = sizeof(Buffer);
+
+    if ((off_t) Chunk > Size - Length)
+    {
+      Chunk = (size_t) (Size - Length);
+    }
+
+    if (!ReadAt(fd, Buffer, Chunk, Length))
+    {
+      return false;
+    }
+
+    char *NewLine = (char*) memchr(Buffer, '\n', Chunk);
+    if (NewLine != NULL)
+    {
+      Length += (NewLine - Buffer) + 1;
+      return true;
+    }
+    Length += Chunk;
+  }
+  return true;
+}
+
+
+/**
+ * Functor to copy the data blocks through 'parallel_for'.
+ */
+class BlocksCopyTask
+{
+  private:
+    vector<int>       &Inputs;
+    int                Output;
+    vector<DataBlock> &Blocks;
+    vector<int>       &Failed;
+
+  public:
+    BlocksCopyTask(vector<int>       &Inputs,
+                   int                Output,
+                   vector<DataBlock> &Blocks,
+                   vector<int>       &Failed)
+    : Inputs(Inputs), Output(Output), Blocks(Blocks), Failed(Failed)
+    {}
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      vector<char> Buffer (DATA_FILES_MERGE_BLOCK_SIZE);
+
+      for (size_t i = Begin; i < End; i++)
+      {
+        DataBlock &Block = Blocks[i];
+
+        if (!ReadAt(Inputs[Block.Input], &Buffer[0], Block.Length, Block.Source) ||
+            !WriteAt(Output, &Buffer[0], Block.Length, Block.Target))
+        {
+          Failed[Thread] = 1;
+          return;
+        }
+      }
+    }
+};
+
+
+/**
+ * Closes all the file descriptors opened during the merge.
+ */
+static void CloseAll(vector<int> &Inputs, int Output)
+{
+  for (size_t i = 0; i < Inputs.size(); i++)
+  {
+    close(Inputs[i]);
+  }
+
+  if (Output >= 0)
+  {
+    close(Output);
+  }
+}
+
+
+/**
+ * Concatenates the data files of the back-ends into the final data file,
+ * keeping only the header line of the first one. Lines are kept in the same
+ * order as a serial concatenation would produce.
+ *
+ * @param InputFileNames Data files to merge, in order.
+ * @param OutputFileName Name of the resulting data file.
+ * @param ErrorMessage   Description of the problem, if any.
+ *
+ * @return True if the output file was written correctly, false otherwise.
+ */
+bool MergeDataFiles(vector<string> &InputFileNames,
+                    string          OutputFileName,
+                    string         &ErrorMessage)
+{
+  vector<int>       Inputs;
+  vector<DataBlock> Blocks;
+  vector<off_t>     MissingNewLines;
+  off_t             Header = 0;
+  off_t             Offset = 0;
+  int               Output = -1;
+
+  if (InputFileNames.size() == 0)
+  {
+    ErrorMessage = "no data files to merge";
+    return false;
+  }
+
+  /* Compute where each input file body goes in the output file */
+  for (size_t i = 0; i < InputFileNames.size(); i++)
+  {
+    struct stat Info;
+    off_t       Skip;
+    int         fd = open(InputFileNames[i].c_str(), O_RDONLY);
+
+    if (fd < 0)
+    {
+      ErrorMessage = "unable to open data file '"+InputFileNames[i]+"': "+strerror(errno);
+      CloseAll(Inputs, Output);
+      return false;
+    }
+    Inputs.push_back(fd);
+
+    if (fstat(fd, &Info) != 0 || !HeaderLength(fd, Info.st_size, Skip))
+    {
+      ErrorMessage = "unable to read data file '"+InputFileNames[i]+"': "+strerror(errno);
+      CloseAll(Inputs, Output);
+      return false;
+    }
+
+    if (i == 0)
+    {
+      Header = Skip;
+      Offset = Skip;
+    }
+
+    for (off_t Source = Skip; Source < Info.st_size; )
+    {
+      DataBlock Block;
+
+      Block.Input  = i;
+      Block.Source = Source;
+      Block.Target = Offset;
+      Block.Length = DATA_FILES_MERGE_BLOCK_SIZE;
+      if ((off_t) Block.Length > Info.st_size - Source)
+      {
+        Block.Length = (size_t) (Info.st_size - Source);
+      }
+      Blocks.push_back(Block);
+
+      Source += Block.Length;
+      Offset += Block.Length;
+    }
+
+    /* Keep the lines of consecutive files apart */
+    if (Info.st_size > Skip)
+    {
+      char Last;
+
+      if (!ReadAt(fd, &Last, 1, Info.st_size - 1))
+      {
+        ErrorMessage = "unable to read data file '"+InputFileNames[i]+"': "+strerror(errno);
+        CloseAll(Inputs, Output);
+        return false;
+      }
+
+      if (Last != '\n')
+      {
+        MissingNewLines.push_back(Offset);
+        Offset++;
+      }
+    }
+  }
+
+  Output = open(OutputFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (Output < 0 || ftruncate(Output, Offset) != 0)
+  {
+    ErrorMessage = "unable to create output file '"+OutputFileName+"': "+strerror(errno);
+    CloseAll(Inputs, Output);
+    return false;
+  }
+
+  /* Header of the first file */
+  if (Header > 0)
+  {
+    vector<char> Buffer (Header);
+
+    if (!ReadAt(Inputs[0], &Buffer[0], Header, 0) ||
+        !WriteAt(Output, &Buffer[0], Header, 0))
+    {
+      ErrorMessage = "unable to write output file '"+OutputFileName+"': "+strerror(errno);
+      CloseAll(Inputs, Output);
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < MissingNewLines.size(); i++)
+  {
+    if (!WriteAt(Output, "\n", 1, MissingNewLines[i]))
+    {
+      ErrorMessage = "unable to write output file '"+OutputFileName+"': "+strerror(errno);
+      CloseAll(Inputs, Output);
+      return false;
+    }
+  }
+
+  /* Bodies of all files */
+  vector<int>    Failed (cepba_tools::parallel_threads(), 0);
+  BlocksCopyTask Task (Inputs, Output, Blocks, Failed);
+  cepba_tools::parallel_for(Task, 0, Blocks.size());
+
+  for (size_t i = 0; i < Failed.size(); i++)
+  {
+    if (Failed[i])
+    {
+      ErrorMessage = "unable to copy data blocks to output file '"+OutputFileName+"'";
+      CloseAll(Inputs, Output);
+      return false;
+    }
+  }
+
+  CloseAll(Inputs, Output);
+  return true;
+}
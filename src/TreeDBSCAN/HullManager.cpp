@@ -34,12 +34,16 @@
 
 #include "HullManager.h"
 #include "TDBSCANTags.h"
+#include "WireFormat.h"
 #include "Utils.h"
 
+#include <iostream>
+#include <stdlib.h>
+
 #include <cstring>
 
 const char *HullFormatString     = "%ld %ld %d %d %ald %ald %alf";
-const char *AllHullsFormatString = "%ald %ald %ad %ad %ald %ald %alf";
+const char *AllHullsFormatString = "%auc";
 const char *AllSentFormatString  = "";
 
 HullManager::HullManager(void) { }
@@ -83,42 +87,24 @@ HullModel* HullManager::Unpack(PACKET_PTR InputPacket)
 }
 
 
+/**
+ * Front-end, filter and back-end call to receive a set of hulls encoded in a
+ * single MRNet packet (see WireFormat.h).
+ */
 void HullManager::Unpack(PACKET_PTR InputPacket, vector<HullModel *> &HullsList)
 {
-  int        NumberOfHulls=0;
-  long long *DensityArray=NULL, *TotalTimeArray=NULL;
-  int       *NumberOfPointsArray=NULL, *NumberOfDimensionsArray=NULL;
-  long long *InstancesArray=NULL, *NeighbourhoodSizesArray=NULL;
-  double    *DimensionsValuesArray=NULL;
-  int        TotalNumberOfPoints=0, TotalDimensionsValues=0;
-
-
-  PACKET_unpack(InputPacket, AllHullsFormatString,
-    &DensityArray, &NumberOfHulls,
-    &TotalTimeArray, &NumberOfHulls,
-    &NumberOfPointsArray, &NumberOfHulls,
-    &NumberOfDimensionsArray, &NumberOfHulls,
-    &InstancesArray, &TotalNumberOfPoints,
-    &NeighbourhoodSizesArray, &TotalNumberOfPoints,
-    &DimensionsValuesArray, &TotalDimensionsValues);
-
-  int idx1=0, idx2=0;
-
-  for (int i=0; i<NumberOfHulls; i++)
+  unsigned char *Buffer     = NULL;
+  int            BufferSize = 0;
+
+  PACKET_unpack(InputPacket, AllHullsFormatString, &Buffer, &BufferSize);
+
+  if (!DecodeHulls(Buffer, BufferSize, HullsList))
   {
-    HullModel *Hull = new HullModel(DensityArray[i],
-                                    TotalTimeArray[i],
-                                    NumberOfPointsArray[i],
-                                    NumberOfDimensionsArray[i],
-                                    &InstancesArray[idx1],
-                                    &NeighbourhoodSizesArray[idx1],
-                                    &DimensionsValuesArray[idx2]);
-
-    HullsList.push_back( Hull );
-
-    idx1 += NumberOfPointsArray[i];
-    idx2 += NumberOfPointsArray[i] * NumberOfDimensionsArray[i];
+    std::cerr << "ERROR: HullManager::Unpack: Wrong hulls set received" << std::endl;
+    exit(EXIT_FAILURE);
   }
+
+  xfree(Buffer);
 }
 
 
@@ -141,47 +127,20 @@ void HullManager::Serialize(STREAM *OutputStream, vector<HullModel*> &HullsList)
   SerializeDone(OutputStream);
 }
 
+/**
+ * Back-end call to send a list of hulls through the given stream, all of
+ * them encoded in a single packet.
+ * @param OutputStream The MRNet stream.
+ * @param HullsList A vector of hulls to send.
+ */
 void HullManager::SerializeAll(STREAM *OutputStream, vector<HullModel*> &HullsList)
 {
-  int        NumberOfHulls           = 0;
-  long long *DensityArray            = NULL;
-  long long *TotalTimeArray          = NULL;
-  int       *NumberOfPointsArray     = NULL;
-  int       *NumberOfDimensionsArray = NULL;
-  int        TotalNumberOfPoints     = 0;
-  long long *InstancesArray          = NULL;
-  long long *NeighbourhoodSizesArray = NULL;
-  int        TotalDimensionsValues   = 0;
-  double    *DimensionsValuesArray   = NULL;
-
-  SerializeAll(HullsList,
-               NumberOfHulls,
-               DensityArray,
-               TotalTimeArray,
-               NumberOfPointsArray,
-               NumberOfDimensionsArray,
-               TotalNumberOfPoints,
-               InstancesArray,
-               NeighbourhoodSizesArray,
-               TotalDimensionsValues,
-               DimensionsValuesArray);
+  vector<unsigned char> Buffer;
+
+  Encode(HullsList, Buffer);
 
   STREAM_send(OutputStream, TAG_ALL_HULLS, AllHullsFormatString,
-    DensityArray,            NumberOfHulls,
-    TotalTimeArray,          NumberOfHulls,
-    NumberOfPointsArray,     NumberOfHulls,
-    NumberOfDimensionsArray, NumberOfHulls,
-    InstancesArray,          TotalNumberOfPoints,
-    NeighbourhoodSizesArray, TotalNumberOfPoints,
-    DimensionsValuesArray,   TotalDimensionsValues);
-
-  xfree(DensityArray);
-  xfree(TotalTimeArray);
-  xfree(NumberOfPointsArray);
-  xfree(NumberOfDimensionsArray);
-  xfree(InstancesArray);
-  xfree(NeighbourhoodSizesArray);
-  xfree(DimensionsValuesArray);
+    &Buffer[0], (int) Buffer.size());
 
   SerializeDone(OutputStream);
 }
@@ -254,39 +213,25 @@ void HullManager::Serialize(int StreamID, vector<PacketPtr> &OutputPackets, vect
   SerializeDone(StreamID, OutputPackets);
 }
 
+/**
+ * Filter call to prepare a single output packet with all the given hulls.
+ * @param StreamID The stream ID where the packet will be sent.
+ * @param OutputPackets Queue of output packets that has to be filled (by reference).
+ * @param HullsList A vector of hulls to send.
+ */
 void HullManager::SerializeAll(int StreamID, vector<PacketPtr> &OutputPackets, vector<HullModel*> &HullsList)
 {
-  int        NumberOfHulls           = 0;
-  long long *DensityArray            = NULL;
-  long long *TotalTimeArray     = NULL;
-  int       *NumberOfPointsArray     = NULL;
-  int       *NumberOfDimensionsArray = NULL;
-  int        TotalNumberOfPoints     = 0;
-  long long *InstancesArray          = NULL;
-  long long *NeighbourhoodSizesArray = NULL;
-  int        TotalDimensionsValues   = 0;
-  double    *DimensionsValuesArray   = NULL;
-
-  SerializeAll(HullsList,
-               NumberOfHulls,
-               DensityArray,
-               TotalTimeArray,
-               NumberOfPointsArray,
-               NumberOfDimensionsArray,
-               TotalNumberOfPoints,
-               InstancesArray,
-               NeighbourhoodSizesArray,
-               TotalDimensionsValues,
-               DimensionsValuesArray);
+  vector<unsigned char> Buffer;
+  unsigned char        *PacketBuffer = NULL;
+
+  Encode(HullsList, Buffer);
+
+  /* The packet frees the data once sent */
+  PacketBuffer = (unsigned char *)malloc(Buffer.size());
+  memcpy(PacketBuffer, &Buffer[0], Buffer.size());
 
   PacketPtr new_packet( new Packet( StreamID, TAG_ALL_HULLS, AllHullsFormatString,
-                                    DensityArray,            NumberOfHulls,
-                                    TotalTimeArray,          NumberOfHulls,
-                                    NumberOfPointsArray,     NumberOfHulls,
-                                    NumberOfDimensionsArray, NumberOfHulls,
-                                    InstancesArray,          TotalNumberOfPoints,
-                                    NeighbourhoodSizesArray, TotalNumberOfPoints,
-                                    DimensionsValuesArray,   TotalDimensionsValues ) );
+                                    PacketBuffer, (int) Buffer.size() ) );
 
   new_packet->set_DestroyData(true);
   OutputPackets.push_back( new_packet );
@@ -340,76 +285,16 @@ void HullManager::SerializeDone(int StreamID, vector<PacketPtr> &OutputPackets)
   OutputPackets.push_back( new_packet );
 }
 
-void HullManager::SerializeAll(
-  vector<HullModel*> &HullsList,
-  int                &NumberOfHulls,
-  long long         *&DensityArray,
-  long long         *&TotalTimeArray,
-  int               *&NumberOfPointsArray,
-  int               *&NumberOfDimensionsArray,
-  int                &TotalNumberOfPoints,
-  long long         *&InstancesArray,
-  long long         *&NeighbourhoodSizesArray,
-  int                &TotalDimensionsValues,
-  double            *&DimensionsValuesArray)
+/**
+ * Encodes the hulls in the wire format shared by all the nodes of the tree.
+ * @param HullsList A vector of hulls to encode.
+ * @param Buffer The encoded hulls.
+ */
+void HullManager::Encode(vector<HullModel*> &HullsList, vector<unsigned char> &Buffer)
 {
-  NumberOfHulls = HullsList.size();
-
-  DensityArray            = (long long *)malloc(NumberOfHulls * sizeof(long long));
-  TotalTimeArray          = (long long *)malloc(NumberOfHulls * sizeof(long long));
-  NumberOfPointsArray     =       (int *)malloc(NumberOfHulls * sizeof(int));
-  NumberOfDimensionsArray =       (int *)malloc(NumberOfHulls * sizeof(int));
-
-  for (unsigned int i=0; i<NumberOfHulls; i++)
+  if (!EncodeHulls(HullsList, Buffer))
   {
-    long long  Density=0;
-    long long  TotalTime=0;
-    int        NumberOfPoints=0;
-    int        NumberOfDimensions=0;
-    long long *Instances=NULL;
-    long long *NeighbourhoodSizes=NULL;
-    double    *DimensionsValues=NULL;
-    int        idx=0;
-
-    HullsList[i]->Serialize(Density,
-                            TotalTime,
-                            NumberOfPoints,
-                            NumberOfDimensions,
-                            Instances,
-                            NeighbourhoodSizes,
-                            DimensionsValues);
-
-    DensityArray[i]            = Density;
-    TotalTimeArray[i]          = TotalTime;
-    NumberOfPointsArray[i]     = NumberOfPoints;
-    NumberOfDimensionsArray[i] = NumberOfDimensions;
-
-    TotalNumberOfPoints   += NumberOfPoints;
-    TotalDimensionsValues += NumberOfPoints * NumberOfDimensions;
-
-    InstancesArray          = (long long *)realloc(InstancesArray,          TotalNumberOfPoints * sizeof(long long));
-    NeighbourhoodSizesArray = (long long *)realloc(NeighbourhoodSizesArray, TotalNumberOfPoints * sizeof(long long));
-    DimensionsValuesArray   =    (double *)realloc(DimensionsValuesArray,   TotalDimensionsValues * sizeof(double));
-
-    idx = TotalNumberOfPoints - NumberOfPoints;
-
-    memcpy(&InstancesArray[idx],
-           Instances,
-           NumberOfPoints * sizeof(long long));
-
-    memcpy(&NeighbourhoodSizesArray[idx],
-           NeighbourhoodSizes,
-           NumberOfPoints * sizeof(long long));
-
-    idx = TotalDimensionsValues - (NumberOfPoints * NumberOfDimensions);
-
-    memcpy(&DimensionsValuesArray[idx],
-           DimensionsValues,
-           NumberOfPoints * NumberOfDimensions * sizeof(double));
-
-    xfree(Instances);
-    xfree(NeighbourhoodSizes);
-    xfree(DimensionsValues);
+    std::cerr << "ERROR: HullManager::Encode: Hulls with different dimensions can not be sent together" << std::endl;
+    exit(EXIT_FAILURE);
   }
 }
-
@@ -63,18 +63,7 @@ class HullManager
     void SerializeAll(int StreamID, vector<PacketPtr> &OutputPackets, vector<HullModel*> &HullsList);
 
   private:
-    void SerializeAll(
-      vector<HullModel*> &HullsList, 
-      int                &NumberOfHulls,
-      long long         *&DensityArray,
-      long long         *&TotalTimeArray,
-      int               *&NumberOfPointsArray,
-      int               *&NumberOfDimensionsArray,
-      int                &TotalNumberOfPoints,
-      long long         *&InstancesArray,
-      long long         *&NeighbourhoodSizesArray,
-      int                &TotalDimensionsValues,
-      double            *&DimensionsValuesArray);
+    void Encode(vector<HullModel*> &HullsList, vector<unsigned char> &Buffer);
 
     /* Back-end API */
     void SerializeOne(STREAM *OutputStream, HullModel *Hull);
@@ -0,0 +1,328 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "HullsMerge.h"
+
+#include <algorithm>
+using std::sort;
+
+/**
+ * Bounding box of a hull, inflated by half epsilon on each side. Two hulls
+ * can only be merged if their inflated boxes overlap: otherwise they are
+ * apart more than epsilon in one of the axes.
+ */
+struct HullBox
+{
+  double MinX, MinY, MaxX, MaxY;
+  size_t Hull;
+};
+
+struct SortBoxesByMinX
+{
+  bool operator()(const HullBox &a, const HullBox &b) const
+  {
+    return a.MinX < b.MinX;
+  }
+};
+
+static bool GetInflatedBox(HullModel *Hull, double Epsilon, HullBox &Box)
+{
+  if (!Hull->GetBoundingBox(Box.MinX, Box.MinY, Box.MaxX, Box.MaxY))
+  {
+    return false;
+  }
+
+  Box.MinX -= Epsilon / 2;
+  Box.MinY -= Epsilon / 2;
+  Box.MaxX += Epsilon / 2;
+  Box.MaxY += Epsilon / 2;
+
+  return true;
+}
+
+static bool BoxesOverlap(const HullBox &a, const HullBox &b)
+{
+  return (a.MinX <= b.MaxX && b.MinX <= a.MaxX &&
+          a.MinY <= b.MaxY && b.MinY <= a.MaxY);
+}
+
+/**
+ * Union-find over the hulls indices. The representative of a group is
+ * always its lowest index, so the groups keep the order of the input.
+ */
+class HullsUnionFind
+{
+  private:
+    vector<size_t> Parent;
+
+  public:
+    HullsUnionFind(size_t Size): Parent(Size)
+    {
+      for (size_t i = 0; i < Size; i++)
+      {
+        Parent[i] = i;
+      }
+    }
+
+    size_t Find(size_t i)
+    {
+      while (Parent[i] != i)
+      {
+        Parent[i] = Parent[Parent[i]];
+        i         = Parent[i];
+      }
+      return i;
+    }
+
+    void Union(size_t Root1, size_t Root2)
+    {
+      if (Root1 < Root2)
+        Parent[Root2] = Root1;
+      else
+        Parent[Root1] = Root2;
+    }
+};
+
+/**
+ * Density required to the clusters found in the noise points of a
+ * reduction node. It is weighted with the number of nodes in the same
+ * level of the tree, but never lower than 3.
+ * @param MinPoints MinPoints of the whole analysis.
+ * @param NumSiblings Number of nodes sharing the parent, including this one.
+ * @return the weighted MinPoints.
+ */
+int ReductionMinPoints(int MinPoints, unsigned int NumSiblings)
+{
+  int WeightedMinPoints;
+
+  if (NumSiblings == 0)
+  {
+    NumSiblings = 1;
+  }
+
+  WeightedMinPoints = MinPoints / NumSiblings;
+  if (WeightedMinPoints < 3) WeightedMinPoints = 3;
+
+  return WeightedMinPoints;
+}
+
+
+/**
+ * Merges (incrementally) a hull received from a child with all the hulls
+ * merged previously. Every hull intersecting the child one is removed from
+ * the list, and the resulting hull is stored at the end.
+ * @param ChildHull The hull to merge.
+ * @param MergedHulls List of hulls merged so far.
+ * @param Epsilon Determines the minimum distance to consider whether two hulls intersect.
+ * @param MinPoints Minimum density of the merged hull.
+ * @param Intersects Incremented with the number of hulls that intersected.
+ * @param Tests Incremented with the number of intersections tested.
+ */
+void MergeHull(HullModel          *ChildHull,
+               vector<HullModel*> &MergedHulls,
+               double              Epsilon,
+               int                 MinPoints,
+               int                &Intersects,
+               int                &Tests)
+{
+  unsigned int i = 0;
+  HullModel   *Intersect = NULL, *MaxMerge = NULL;
+  HullBox      MaxMergeBox, CurrentBox;
+  bool         HasBox;
+
+  MaxMerge = ChildHull;
+  HasBox   = GetInflatedBox(MaxMerge, Epsilon, MaxMergeBox);
+
+  while (i < MergedHulls.size())
+  {
+    /* Hulls far apart can not intersect, skip the exact test */
+    if (HasBox &&
+        GetInflatedBox(MergedHulls[i], Epsilon, CurrentBox) &&
+        !BoxesOverlap(MaxMergeBox, CurrentBox))
+    {
+      i++;
+      continue;
+    }
+
+    Intersect = MaxMerge->Merge(MergedHulls[i], Epsilon, MinPoints);
+    Tests ++;
+    if (Intersect != NULL)
+    {
+      Intersects ++;
+//      delete MaxMerge;
+//      delete MergedHulls[i];
+      MergedHulls.erase(MergedHulls.begin()+i);
+      MaxMerge = Intersect;
+      HasBox   = GetInflatedBox(MaxMerge, Epsilon, MaxMergeBox);
+    }
+    else
+    {
+      i++;
+    }
+  }
+  /* Store the merged hull in the list */
+  MergedHulls.push_back( MaxMerge );
+}
+
+
+/**
+ * Merges a set of hulls with all the hulls merged previously. Candidate pairs
+ * are found sweeping the bounding boxes (inflated by epsilon) along the X
+ * axis, so the exact intersection test only runs on hulls that are close.
+ * The intersecting pairs are grouped with a union-find, and each group is
+ * joined in a single hull. As a joined hull can reach hulls none of its parts
+ * intersected, the new hulls are tested again until no more merges happen.
+ * @param NewHulls Hulls to merge.
+ * @param MergedHulls List of hulls merged so far, updated with the result.
+ * @param Epsilon Determines the minimum distance to consider whether two hulls intersect.
+ * @param MinPoints Minimum density of the merged hull.
+ * @param Intersects Incremented with the number of hulls that intersected.
+ * @param Tests Incremented with the number of intersections tested.
+ */
+void MergeHulls(vector<HullModel*> &NewHulls,
+                vector<HullModel*> &MergedHulls,
+                double              Epsilon,
+                int                 MinPoints,
+                int                &Intersects,
+                int                &Tests)
+{
+  vector<HullModel*> Hulls (MergedHulls);
+  /* Hulls not tested yet. Previous hulls were already tested among them */
+  vector<bool>       Pending (MergedHulls.size(), false);
+  /* Intermediate hulls created here, that can be freed once joined */
+  vector<bool>       Owned;
+  bool               Merged;
+
+  Hulls.insert(Hulls.end(), NewHulls.begin(), NewHulls.end());
+  Pending.resize(Hulls.size(), true);
+  Owned.resize(Hulls.size(), false);
+
+  do
+  {
+    vector<HullBox>    Boxes;
+    vector<size_t>     Active;
+    HullsUnionFind     Groups(Hulls.size());
+    vector<HullModel*> NextHulls;
+    vector<bool>       NextPending, NextOwned;
+    vector<size_t>     GroupSlot (Hulls.size(), Hulls.size());
+
+    Merged = false;
+
+    for (size_t i = 0; i < Hulls.size(); i++)
+    {
+      HullBox Box;
+
+      if (GetInflatedBox(Hulls[i], Epsilon, Box))
+      {
+        Box.Hull = i;
+        Boxes.push_back(Box);
+      }
+    }
+    sort(Boxes.begin(), Boxes.end(), SortBoxesByMinX());
+
+    /* Sweep the boxes, keeping those that still overlap in X as active */
+    for (size_t i = 0; i < Boxes.size(); i++)
+    {
+      size_t j = 0;
+
+      while (j < Active.size())
+      {
+        HullBox &Candidate = Boxes[Active[j]];
+
+        if (Candidate.MaxX < Boxes[i].MinX)
+        {
+          Active[j] = Active.back();
+          Active.pop_back();
+          continue;
+        }
+
+        if ((Pending[Candidate.Hull] || Pending[Boxes[i].Hull]) &&
+            BoxesOverlap(Candidate, Boxes[i]))
+        {
+          size_t Root1 = Groups.Find(Candidate.Hull);
+          size_t Root2 = Groups.Find(Boxes[i].Hull);
+
+          /* Already in the same group through other hulls */
+          if (Root1 != Root2)
+          {
+            Tests ++;
+            if (Hulls[Candidate.Hull]->IsMergeable(Hulls[Boxes[i].Hull], Epsilon, MinPoints))
+            {
+              Intersects ++;
+              Groups.Union(Root1, Root2);
+            }
+          }
+        }
+        j++;
+      }
+      Active.push_back(i);
+    }
+
+    /* Join the hulls of each group in the slot of its representative */
+    for (size_t i = 0; i < Hulls.size(); i++)
+    {
+      size_t Root = Groups.Find(i);
+
+      if (GroupSlot[Root] == Hulls.size())
+      {
+        GroupSlot[Root] = NextHulls.size();
+        NextHulls.push_back(Hulls[i]);
+        NextPending.push_back(false);
+        NextOwned.push_back(Owned[i]);
+      }
+      else
+      {
+        size_t     Slot   = GroupSlot[Root];
+        HullModel *Joined = NextHulls[Slot]->Join(Hulls[i]);
+
+        if (NextOwned[Slot])
+          delete NextHulls[Slot];
+        if (Owned[i])
+          delete Hulls[i];
+
+        NextHulls[Slot]   = Joined;
+        NextPending[Slot] = true;
+        NextOwned[Slot]   = true;
+        Merged            = true;
+      }
+    }
+
+    Hulls.swap(NextHulls);
+    Pending.swap(NextPending);
+    Owned.swap(NextOwned);
+
+  } while (Merged);
+
+  MergedHulls.swap(Hulls);
+}
@@ -0,0 +1,63 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef __HULLS_MERGE_H__
+#define __HULLS_MERGE_H__
+
+#include <vector>
+#include <HullModel.hpp>
+
+using std::vector;
+
+/* Hull merging used by the reduction nodes of the tree. These routines do
+ * not depend on the communication layer, so they are shared by the MRNet
+ * filter and the in-process (threaded) version of the algorithm */
+
+int  ReductionMinPoints(int MinPoints, unsigned int NumSiblings);
+
+void MergeHull(HullModel          *ChildHull,
+               vector<HullModel*> &MergedHulls,
+               double              Epsilon,
+               int                 MinPoints,
+               int                &Intersects,
+               int                &Tests);
+
+void MergeHulls(vector<HullModel*> &NewHulls,
+                vector<HullModel*> &MergedHulls,
+                double              Epsilon,
+                int                 MinPoints,
+                int                &Intersects,
+                int                &Tests);
+
+#endif /* __HULLS_MERGE_H__ */
@@ -37,7 +37,9 @@
 #include <stdlib.h>
 #include "NoiseManager.h"
 #include "TDBSCANTags.h"
+#include "WireFormat.h"
 #include "Utils.h"
+#include <string.h>
 
 using std::vector;
 using std::cerr;
@@ -57,17 +59,31 @@ using std::endl;
 NoiseManager::NoiseManager()
 {
    libClustering = NULL;
+   Summary       = NULL;
+   MinPoints     = 0;
 }
 
 
 /**
  * Filter constructor. Initializes a new instance of libDistributedClustering
- * to cluster noise points in the tree.
+ * to cluster noise points in the tree, or a noise summary when the noise is
+ * propagated as weighted representatives (see NoiseSummary.h).
  * @param Epsilon
  * @param MinPoints
+ * @param Summarize True to summarize the noise that crosses the filter.
  */
-NoiseManager::NoiseManager(double Epsilon, int MinPoints)
+NoiseManager::NoiseManager(double Epsilon, int MinPoints, bool Summarize)
 {
+   libClustering   = NULL;
+   Summary         = NULL;
+   this->MinPoints = MinPoints;
+
+   if (Summarize)
+   {
+      Summary = new NoiseSummary(Epsilon);
+      return;
+   }
+
    libClustering = new libDistributedClustering(false, "NOISE"); /* true = Verbose */
 
    if (!libClustering->InitClustering(Epsilon, MinPoints))
@@ -78,6 +94,18 @@ NoiseManager::NoiseManager(double Epsilon, int MinPoints)
 }
 
 
+/**
+ * Destructor. Frees the noise summary, if any.
+ */
+NoiseManager::~NoiseManager()
+{
+   if (Summary != NULL)
+   {
+      delete Summary;
+   }
+}
+
+
 /**
  * Filter pushes the remaining noise points into the output packets array.
  * @param StreamID The ID of the stream where the packet will be sent through.
@@ -85,19 +113,17 @@ NoiseManager::NoiseManager(double Epsilon, int MinPoints)
  */
 void NoiseManager::Serialize(int StreamID, std::vector< PacketPtr >& OutputPackets)
 {
-   int          NoiseCount           = 0;
-   int          DimensionsCount      = 0;
-   double      *SerialPoints         = NULL;
-   unsigned int SerialPointsCount    = 0;
-   long long   *SerialNoiseDurations = NULL;
+   vector<unsigned char> Buffer;
+   unsigned char        *PacketBuffer = NULL;
 
-   Serialize(NoiseCount, DimensionsCount, SerialPoints, SerialPointsCount, SerialNoiseDurations);
+   Serialize(Buffer);
 
-   PacketPtr new_packet1( new Packet( StreamID, TAG_NOISE, "%d %alf %ald", DimensionsCount, SerialPoints, SerialPointsCount, SerialNoiseDurations, NoiseCount) );
-   if (SerialPoints != NULL)
-   {
-      new_packet1->set_DestroyData(true);
-   }
+   /* The packet frees the data once sent */
+   PacketBuffer = (unsigned char *)malloc(Buffer.size());
+   memcpy(PacketBuffer, &Buffer[0], Buffer.size());
+
+   PacketPtr new_packet1( new Packet( StreamID, TAG_NOISE, "%auc", PacketBuffer, (int) Buffer.size()) );
+   new_packet1->set_DestroyData(true);
    PacketPtr new_packet2( new Packet( StreamID, TAG_ALL_NOISE_SENT, "") );
 
    OutputPackets.push_back(new_packet1);
@@ -115,6 +141,32 @@ void NoiseManager::Serialize(int StreamID, std::vector< PacketPtr >& OutputPacke
 
 bool NoiseManager::ClusterNoise(vector<const Point*>& Points, vector<long long>& Durations, vector<HullModel*>& NoiseModel, int &CountRemainingNoise)
 {
+   vector<long long> Weights;
+
+   return ClusterNoise(Points, Durations, Weights, NoiseModel, CountRemainingNoise);
+}
+
+
+/**
+ * Called from the MRNet filter to cluster a set of weighted noise points.
+ * @param Points Noise points to cluster.
+ * @param Durations Duration of each point.
+ * @param Weights Number of points each one stands for (only used when summarizing).
+ * @param NoiseModel The resulting models for the clustered points.
+ * @param CountRemainingNoise The number of remaining noise points after clustering.
+ * @return true on success; false otherwise.
+ */
+bool NoiseManager::ClusterNoise(vector<const Point*>& Points, vector<long long>& Durations, vector<long long>& Weights, vector<HullModel*>& NoiseModel, int &CountRemainingNoise)
+{
+   if (Summary != NULL)
+   {
+      Summary->Add(Points, Durations, Weights);
+      Summary->Cluster(MinPoints, NoiseModel);
+
+      CountRemainingNoise = (int) Summary->Weight();
+      return true;
+   }
+
    int rc = libClustering->ClusterAnalysis(Points, Durations, NoiseModel);
 
    CountRemainingNoise = 0;
@@ -129,7 +181,7 @@ bool NoiseManager::ClusterNoise(vector<const Point*>& Points, vector<long long>&
 
 
 /**
- * Unpacks an array of noise points from a MRNet packet and stores them
+ * Unpacks a set of noise points from a MRNet packet and stores them
  * into the specified vector.
  * @param in_packet MRNet packet to extract the points from.
  * @param NoisePoints Array where the points are stored.
@@ -137,33 +189,39 @@ bool NoiseManager::ClusterNoise(vector<const Point*>& Points, vector<long long>&
  */
 int NoiseManager::Unpack(PACKET_PTR in_packet, vector<const Point *> &NoisePoints, vector<long long> &NoiseDurations)
 {
-   int        dimsCount      = 0, dimsValuesCount = 0, countPoints = 0, noiseCount = 0;
-   double    *dimsValues     = NULL;
-   long long *noiseDurations = NULL;
+   vector<long long> NoiseWeights;
+
+   return Unpack(in_packet, NoisePoints, NoiseDurations, NoiseWeights);
+}
+
+
+/**
+ * Unpacks a set of noise points and the number of points each one stands
+ * for from a MRNet packet.
+ * @param in_packet MRNet packet to extract the points from.
+ * @param NoisePoints Array where the points are stored.
+ * @param NoiseDurations Array where the durations are stored.
+ * @param NoiseWeights Array where the weights are stored.
+ * @return the number of noise points unpacked.
+ */
+int NoiseManager::Unpack(PACKET_PTR in_packet, vector<const Point *> &NoisePoints, vector<long long> &NoiseDurations, vector<long long> &NoiseWeights)
+{
+   unsigned char *Buffer       = NULL;
+   int            BufferSize   = 0;
+   size_t         PointsBefore = NoisePoints.size();
 
    if (in_packet == NULL) return 0;
 
-   PACKET_unpack(in_packet, "%d %alf %ald", &dimsCount, &dimsValues, &dimsValuesCount, &noiseDurations, &noiseCount);
+   PACKET_unpack(in_packet, "%auc", &Buffer, &BufferSize);
 
-   /* Build clustering points from the dimensions values */
-   for (unsigned int i=0; i<dimsValuesCount; i+=dimsCount)
+   if (!DecodeNoise(Buffer, BufferSize, NoisePoints, NoiseDurations, NoiseWeights))
    {
-      countPoints ++;
-
-      vector<double> PointDimensions;
-      for (unsigned int j=0; j<dimsCount; j++)
-      {
-         PointDimensions.push_back( dimsValues[i+j] );
-      }
-      const Point *childPoint = new Point( PointDimensions );
-      /* Accumulate this noise point in a vector */
-      NoisePoints.push_back( childPoint );
-      NoiseDurations.push_back( noiseDurations[countPoints - 1] );
+      cerr << "ERROR: NoiseManager::Unpack: Wrong noise points set received" << endl;
+      exit (EXIT_FAILURE);
    }
 
-   xfree( dimsValues );
-   xfree( noiseDurations );
-   return countPoints;
+   xfree( Buffer );
+   return NoisePoints.size() - PointsBefore;
 }
 
 
@@ -175,10 +233,14 @@ int NoiseManager::Unpack(PACKET_PTR in_packet, vector<const Point *> &NoisePoint
 /**
  * Back-end constructor.
  * @param libClustering An instance of libDistributedClustering that performed a clustering analysis.
+ * @param Summarize True to send the noise points summarized as weighted representatives.
+ * @param Epsilon Epsilon of the analysis, sizes the cells of the summary.
  */
-NoiseManager::NoiseManager(libDistributedClustering *libClustering)
+NoiseManager::NoiseManager(libDistributedClustering *libClustering, bool Summarize, double Epsilon)
 {
    this->libClustering = libClustering;
+   this->Summary       = (Summarize ? new NoiseSummary(Epsilon) : NULL);
+   this->MinPoints     = 0;
    if (libClustering == NULL)
    {
       cerr << "ERROR: NoiseManager::NoiseManager: Clustering library was not initialized?" << endl;
@@ -193,16 +255,11 @@ NoiseManager::NoiseManager(libDistributedClustering *libClustering)
  */
 void NoiseManager::Serialize(Stream *OutputStream)
 {
-   int          NoiseCount           = 0;
-   int          DimensionsCount      = 0;
-   double      *SerialPoints         = NULL;
-   unsigned int SerialPointsCount    = 0;
-   long long   *SerialNoiseDurations = NULL;
+   vector<unsigned char> Buffer;
 
-   Serialize(NoiseCount, DimensionsCount, SerialPoints, SerialPointsCount, SerialNoiseDurations);
+   Serialize(Buffer);
 
-   STREAM_send(OutputStream, TAG_NOISE, "%d %alf %ald", DimensionsCount, SerialPoints, SerialPointsCount, SerialNoiseDurations, NoiseCount);
-   xfree(SerialPoints);
+   STREAM_send(OutputStream, TAG_NOISE, "%auc", &Buffer[0], (int) Buffer.size());
    STREAM_send(OutputStream, TAG_ALL_NOISE_SENT, "");
 }
 
@@ -213,63 +270,46 @@ void NoiseManager::Serialize(Stream *OutputStream)
 
 
 /**
- * Retrieves the remaining noise points out of the libClustering instance and stores the information into
- * an array that can be sent through the MRNet.
- * @param DimensionsCount Number of clustering dimensions.
- * @param SerialPoints Array of points dimensions, in sequence.
- * @param SerialPointsCount Size of the points dimensions array.
- * @return the above 3 parameters by reference.
+ * Retrieves the remaining noise points out of the libClustering instance (or the
+ * representatives of the summary) and encodes them (see WireFormat.h) in a buffer
+ * that can be sent through the MRNet.
+ * @param Buffer The encoded noise points.
  */
-void NoiseManager::Serialize(int &NoiseCount, int &DimensionsCount, double *&SerialPoints, unsigned int &SerialPointsCount, long long *&SerialNoiseDurations)
+void NoiseManager::Serialize(vector<unsigned char> &Buffer)
 {
    vector<const Point*> NoisePoints;
    vector<long long>    NoiseDurations;
-
-   DimensionsCount   = 0;
-   SerialPoints      = NULL;
-   SerialPointsCount = 0;
+   vector<long long>    NoiseWeights;
 
    /* Retrieve the remaining noise points */
-   if (!libClustering->GetNoisePoints(NoisePoints, NoiseDurations))
+   if ((libClustering != NULL) && (!libClustering->GetNoisePoints(NoisePoints, NoiseDurations)))
    {
       cerr << "ERROR: NoiseManager::Serialize: Error retrieving noise points: " << libClustering->GetErrorMessage() << endl;
       NoisePoints.clear();
       NoiseDurations.clear();
    }
 
-   /* DEBUG -- Fill with fake points
-   vector<double> dim1, dim2;
-   dim1.push_back(0.12);
-   dim1.push_back(3.45);
-   dim2.push_back(6.78);
-   dim2.push_back(9.10);
-   const Point* pt1 = new Point( dim1 );
-   const Point* pt2 = new Point( dim2 );
-   NoisePoints.push_back( pt1 );
-   NoisePoints.push_back( pt2 ); */
-
-   NoiseCount = NoisePoints.size();
-   if (NoiseCount > 0)
+   if (Summary != NULL)
    {
-      DimensionsCount      = NoisePoints[0]->size();
-      SerialPointsCount    = DimensionsCount * NoiseCount;
-      SerialPoints         = (double *)malloc(SerialPointsCount * sizeof(double));
-      SerialNoiseDurations = (long long *)malloc(NoiseCount * sizeof(long long));
+      /* Back-end points are summarized here, filters already hold the summary */
+      Summary->Add(NoisePoints, NoiseDurations);
 
-      if (SerialPoints == NULL)
-      {
-         cerr << "ERROR: NoiseManager::Serialize: Not enough memory to serialize " << NoiseCount << " noise points" << endl;
-         exit(EXIT_FAILURE);
-      }
+      NoisePoints.clear();
+      NoiseDurations.clear();
+      Summary->GetRepresentatives(NoisePoints, NoiseDurations, NoiseWeights);
+   }
+
+   if (!EncodeNoise(NoisePoints, NoiseDurations, NoiseWeights, Buffer))
+   {
+      cerr << "ERROR: NoiseManager::Serialize: Error encoding " << NoisePoints.size() << " noise points" << endl;
+      exit(EXIT_FAILURE);
+   }
 
-      /* Store the points dimensions in a linear array */
-      for (unsigned int i=0; i<NoiseCount; i++)
+   if (Summary != NULL)
+   {
+      for (size_t i = 0; i < NoisePoints.size(); i++)
       {
-         for (unsigned int j=0; j<DimensionsCount; j++)
-         {
-            SerialPoints[ (i*DimensionsCount)+j ] = (*(NoisePoints[i]))[j];
-         }
-         SerialNoiseDurations[i] = NoiseDurations[i];
+         delete NoisePoints[i];
       }
    }
 }
@@ -37,6 +37,7 @@
 
 #include "libDistributedClustering.hpp"
 #include "MRNet_wrappers.h"
+#include "NoiseSummary.h"
 
 #define PROCESS_NOISE
 
@@ -52,24 +53,36 @@ class NoiseManager
    public:
       /* Front-end/Filter interface */
       NoiseManager();
-      NoiseManager(double Epsilon, int MinPoints);
+      NoiseManager(double Epsilon, int MinPoints, bool Summarize = false);
+
+      ~NoiseManager();
 
       bool ClusterNoise(vector<const Point*>& Points, vector<long long>& Durations, vector<HullModel*>& NoiseModel, int &CountRemainingNoise);
 
+      bool ClusterNoise(vector<const Point*>& Points, vector<long long>& Durations, vector<long long>& Weights, vector<HullModel*>& NoiseModel, int &CountRemainingNoise);
+
       void Serialize(int StreamID, std::vector< PacketPtr >& OutputPackets);
 
       int  Unpack(PACKET_PTR in_packet, vector<const Point *> &NoisePoints, vector<long long> &NoiseDurations);
 
+      int  Unpack(PACKET_PTR in_packet, vector<const Point *> &NoisePoints, vector<long long> &NoiseDurations, vector<long long> &NoiseWeights);
+
 
       /* Back-end interface */
-      NoiseManager(libDistributedClustering *libClustering);
+      NoiseManager(libDistributedClustering *libClustering, bool Summarize = false, double Epsilon = 0);
 
       void Serialize(Stream *OutputStream);
 
    private:
       libDistributedClustering *libClustering;
+      NoiseSummary             *Summary;
+      int                       MinPoints;
+
+      /* The summary is owned by the manager, copies are not allowed */
+      NoiseManager(const NoiseManager &);
+      NoiseManager& operator=(const NoiseManager &);
 
-      void Serialize(int &NoiseCount, int &DimensionsCount, double *&SerialPoints, unsigned int &SerialPointsCount, long long *&SerialNoiseDurations);
+      void Serialize(vector<unsigned char> &Buffer);
 };
 
 #endif /* __NOISE_MANAGER_H__ */
@@ -0,0 +1,385 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "NoiseSummary.h"
+#include <ConvexHullModel.hpp>
+#include <RepresentativesModel.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using std::sort;
+
+
+/**
+ * Orders the representatives by their first coordinate, to sweep them when
+ * looking for neighbours.
+ */
+struct SortByFirstCoordinate
+{
+  vector<vector<double> > &Centroids;
+
+  SortByFirstCoordinate(vector<vector<double> > &Centroids): Centroids(Centroids) {}
+
+  bool operator()(size_t a, size_t b) const
+  {
+    return Centroids[a][0] < Centroids[b][0];
+  }
+};
+
+
+/**
+ * Constructor.
+ * @param Epsilon Epsilon of the analysis, used to size the grid cells and
+ *                to cluster the representatives.
+ */
+NoiseSummary::NoiseSummary(double Epsilon)
+{
+  this->Epsilon = Epsilon;
+  CellSide      = 0;
+  Dimensions    = 0;
+  TotalWeight   = 0;
+  Displacement  = 0;
+}
+
+
+/**
+ * Adds a set of noise points to the summary. The points are read again to
+ * measure the displacement, so they have to be kept until the next call to
+ * Cluster() or GetRepresentatives().
+ * @param Points The noise points.
+ * @param Durations Duration of each point.
+ */
+void NoiseSummary::Add(const vector<const Point*> &Points,
+                       const vector<long long>    &Durations)
+{
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    AddPoint(Points[i], Durations[i], 1);
+  }
+}
+
+
+/**
+ * Adds a set of weighted representatives (of another summary) to the summary.
+ * @param Points The representatives.
+ * @param Durations Aggregated duration of each representative.
+ * @param Weights Number of points each representative replaces.
+ */
+void NoiseSummary::Add(const vector<const Point*> &Points,
+                       const vector<long long>    &Durations,
+                       const vector<long long>    &Weights)
+{
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    AddPoint(Points[i], Durations[i], (i < Weights.size() ? Weights[i] : 1));
+  }
+}
+
+
+/**
+ * Clusters the representatives with DBSCAN. A representative is core when
+ * the weights of the representatives closer than Epsilon (itself included)
+ * reach MinPoints. The clustered cells are removed from the summary.
+ * @param MinPoints Minimum weighted density of a core representative.
+ * @param Hulls Output vector, the hulls of the new clusters are appended.
+ */
+void NoiseSummary::Cluster(int MinPoints, vector<HullModel*> &Hulls)
+{
+  vector<CellsMap::iterator> Representatives;
+  vector<vector<double> >    Centroids;
+  vector<size_t>             Order;
+  vector<vector<size_t> >    Neighbours;
+  vector<long long>          Densities;
+  vector<int>                Labels;
+  int                        Clusters = 0;
+
+  UpdateDisplacement();
+
+  for (CellsMap::iterator it = Summary.begin(); it != Summary.end(); ++it)
+  {
+    vector<double> Centroid (Dimensions);
+
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      Centroid[Dim] = it->second.Sum[Dim] / it->second.Weight;
+    }
+
+    Representatives.push_back(it);
+    Centroids.push_back(Centroid);
+    Order.push_back(Order.size());
+  }
+
+  if (Representatives.size() == 0)
+  {
+    return;
+  }
+
+  /* Neighbours closer than Epsilon, sweeping along the first coordinate */
+  sort(Order.begin(), Order.end(), SortByFirstCoordinate(Centroids));
+
+  Neighbours.resize(Representatives.size());
+  Densities.resize(Representatives.size(), 0);
+
+  for (size_t i = 0; i < Order.size(); i++)
+  {
+    size_t a = Order[i];
+
+    for (size_t j = i; j < Order.size(); j++)
+    {
+      size_t b        = Order[j];
+      double Distance = 0;
+
+      if (Centroids[b][0] - Centroids[a][0] > Epsilon)
+      {
+        break;
+      }
+
+      for (size_t Dim = 0; Dim < Dimensions; Dim++)
+      {
+        Distance += (Centroids[a][Dim] - Centroids[b][Dim]) * (Centroids[a][Dim] - Centroids[b][Dim]);
+      }
+
+      if (Distance <= Epsilon * Epsilon)
+      {
+        Neighbours[a].push_back(b);
+        Densities[a] += Representatives[b]->second.Weight;
+
+        if (a != b)
+        {
+          Neighbours[b].push_back(a);
+          Densities[b] += Representatives[a]->second.Weight;
+        }
+      }
+    }
+  }
+
+  /* Expand the clusters from the core representatives */
+  Labels.assign(Representatives.size(), -1);
+
+  for (size_t i = 0; i < Representatives.size(); i++)
+  {
+    vector<size_t> Seeds;
+
+    if (Labels[i] != -1 || Densities[i] < MinPoints)
+    {
+      continue;
+    }
+
+    Labels[i] = Clusters;
+    Seeds.push_back(i);
+
+    while (Seeds.size() > 0)
+    {
+      size_t Current = Seeds.back();
+      Seeds.pop_back();
+
+      for (size_t j = 0; j < Neighbours[Current].size(); j++)
+      {
+        size_t Neighbour = Neighbours[Current][j];
+
+        if (Labels[Neighbour] == -1)
+        {
+          Labels[Neighbour] = Clusters;
+
+          if (Densities[Neighbour] >= MinPoints)
+          {
+            Seeds.push_back(Neighbour);
+          }
+        }
+      }
+    }
+
+    Clusters++;
+  }
+
+  /* Build the hull of each cluster, weighted with the points it replaces */
+  vector<vector<const Point*> > ClusterPoints (Clusters);
+  vector<long long>             ClusterWeight (Clusters, 0);
+  vector<long long>             ClusterDuration (Clusters, 0);
+
+  for (size_t i = 0; i < Representatives.size(); i++)
+  {
+    if (Labels[i] == -1)
+    {
+      continue;
+    }
+
+    Point *Representative = new Point(Centroids[i]);
+    Representative->SetNeighbourhoodSize(Densities[i]);
+
+    ClusterPoints[Labels[i]].push_back(Representative);
+    ClusterWeight[Labels[i]]   += Representatives[i]->second.Weight;
+    ClusterDuration[Labels[i]] += Representatives[i]->second.Duration;
+
+    TotalWeight -= Representatives[i]->second.Weight;
+    Summary.erase(Representatives[i]);
+  }
+
+  for (int i = 0; i < Clusters; i++)
+  {
+    if (Dimensions > 2)
+    {
+      Hulls.push_back(new HullModel(new RepresentativesModel(ClusterPoints[i],
+                                                             ClusterWeight[i],
+                                                             ClusterDuration[i],
+                                                             Epsilon)));
+    }
+    else
+    {
+      Hulls.push_back(new HullModel(new ConvexHullModel(ClusterPoints[i],
+                                                        ClusterWeight[i],
+                                                        ClusterDuration[i])));
+    }
+
+    for (size_t j = 0; j < ClusterPoints[i].size(); j++)
+    {
+      delete ClusterPoints[i][j];
+    }
+  }
+}
+
+
+/**
+ * Returns the representatives of the cells not clustered.
+ * @param Points Output vector, the centroids of the cells are appended.
+ * @param Durations Output vector, the duration of each cell is appended.
+ * @param Weights Output vector, the number of points of each cell is appended.
+ */
+void NoiseSummary::GetRepresentatives(vector<const Point*> &Points,
+                                      vector<long long>    &Durations,
+                                      vector<long long>    &Weights)
+{
+  UpdateDisplacement();
+
+  for (CellsMap::iterator it = Summary.begin(); it != Summary.end(); ++it)
+  {
+    vector<double> Centroid (Dimensions);
+
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      Centroid[Dim] = it->second.Sum[Dim] / it->second.Weight;
+    }
+
+    Points.push_back(new Point(Centroid));
+    Durations.push_back(it->second.Duration);
+    Weights.push_back(it->second.Weight);
+  }
+}
+
+
+/**
+ * Maximum distance between a point (or representative) added to the summary
+ * and the centroid of its cell.
+ */
+double NoiseSummary::MaxDisplacement(void)
+{
+  UpdateDisplacement();
+  return Displacement;
+}
+
+/**
+ * Maximum distance between any point and the representative that replaces
+ * it, regardless of the data.
+ */
+double NoiseSummary::DisplacementBound(void)
+{
+  return NOISE_CELL_DIAGONAL * Epsilon;
+}
+
+
+void NoiseSummary::AddPoint(const Point *Item, long long Duration, long long Weight)
+{
+  vector<long long>  Key;
+  CellsMap::iterator CellIt;
+
+  if (Dimensions == 0)
+  {
+    Dimensions = Item->size();
+    CellSide   = (NOISE_CELL_DIAGONAL * Epsilon) / sqrt((double) Dimensions);
+  }
+
+  Key.resize(Dimensions);
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    Key[Dim] = (long long) floor((*Item)[Dim] / CellSide);
+  }
+
+  CellIt = Summary.find(Key);
+  if (CellIt == Summary.end())
+  {
+    Cell NewCell;
+
+    NewCell.Weight   = 0;
+    NewCell.Duration = 0;
+    NewCell.Sum.assign(Dimensions, 0);
+
+    CellIt = Summary.insert(std::make_pair(Key, NewCell)).first;
+  }
+
+  CellIt->second.Weight   += Weight;
+  CellIt->second.Duration += Duration;
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    CellIt->second.Sum[Dim] += (*Item)[Dim] * Weight;
+  }
+
+  TotalWeight += Weight;
+
+  AddedPoints.push_back(Item);
+  AddedCells.push_back(CellIt);
+}
+
+void NoiseSummary::UpdateDisplacement(void)
+{
+  for (size_t i = 0; i < AddedPoints.size(); i++)
+  {
+    Cell  &CurrentCell = AddedCells[i]->second;
+    double Distance    = 0;
+
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      double Delta = (*AddedPoints[i])[Dim] - CurrentCell.Sum[Dim] / CurrentCell.Weight;
+      Distance += Delta * Delta;
+    }
+
+    if (sqrt(Distance) > Displacement)
+    {
+      Displacement = sqrt(Distance);
+    }
+  }
+
+  AddedPoints.clear();
+  AddedCells.clear();
+}
@@ -0,0 +1,107 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef __NOISE_SUMMARY_H__
+#define __NOISE_SUMMARY_H__
+
+#include <vector>
+#include <map>
+#include <libDistributedClustering.hpp>
+
+using std::vector;
+using std::map;
+
+/* Diagonal of the summary cells, relative to Epsilon. It bounds the distance
+ * between a noise point and the representative that replaces it */
+#define NOISE_CELL_DIAGONAL 0.5
+
+/**
+ * Summary of a set of noise points as weighted representatives. The space is
+ * split in a regular grid aligned to the origin, and the points falling in
+ * the same cell are replaced by their centroid, weighted by the number of
+ * points and carrying their aggregated duration. As the grid is the same in
+ * all the nodes of the tree, the summaries of the children merge exactly.
+ * The weighted representatives are clustered with DBSCAN, counting the
+ * weights of the neighbours to check the density.
+ */
+class NoiseSummary
+{
+  public:
+    NoiseSummary(double Epsilon);
+
+    void Add(const vector<const Point*> &Points,
+             const vector<long long>    &Durations);
+
+    void Add(const vector<const Point*> &Points,
+             const vector<long long>    &Durations,
+             const vector<long long>    &Weights);
+
+    void Cluster(int MinPoints, vector<HullModel*> &Hulls);
+
+    void GetRepresentatives(vector<const Point*> &Points,
+                            vector<long long>    &Durations,
+                            vector<long long>    &Weights);
+
+    size_t    Cells(void)           { return Summary.size(); };
+    long long Weight(void)          { return TotalWeight; };
+    double    MaxDisplacement(void);
+    double    DisplacementBound(void);
+
+  private:
+    struct Cell
+    {
+      long long      Weight;
+      long long      Duration;
+      vector<double> Sum;
+    };
+
+    typedef map<vector<long long>, Cell> CellsMap;
+
+    double      Epsilon;
+    double      CellSide;
+    size_t      Dimensions;
+    CellsMap    Summary;
+    long long   TotalWeight;
+    double      Displacement;
+
+    /* Points added, to compute the displacement once the centroids are known */
+    vector<const Point*>        AddedPoints;
+    vector<CellsMap::iterator>  AddedCells;
+
+    void   AddPoint(const Point *Item, long long Duration, long long Weight);
+
+    void   UpdateDisplacement(void);
+};
+
+#endif /* __NOISE_SUMMARY_H__ */
@@ -49,6 +49,12 @@ void Statistics::IncreaseNumIntersects(bool valid)
   NumTotalIntersects ++;
 }
 
+void Statistics::IncreaseNumIntersects(int Valid, int Total)
+{
+  NumValidIntersects += Valid;
+  NumTotalIntersects += Total;
+}
+
 void Statistics::ExtractionTimerStart()
 {
   ExtractionTimer.begin();
@@ -28,6 +28,7 @@ class Statistics
     void IncreaseInputPoints  (int num_points);
     void IncreaseOutputPoints (int num_points);
     void IncreaseNumIntersects(bool valid);
+    void IncreaseNumIntersects(int Valid, int Total);
     void ExtractionTimerStart();
     void ExtractionTimerStop();
     void ClusteringTimerStart();
@@ -49,6 +49,7 @@ TDBSCANCore::TDBSCANCore()
   OutputFileName          = "OUTPUT.prv";
   Verbose                 = false;
   ReconstructTrace        = false;
+  SummarizeNoise          = false;
   stClustering            = NULL;
   stXchangeDims           = NULL;
   stSupport               = NULL;
@@ -61,14 +62,15 @@ TDBSCANCore::TDBSCANCore()
  */
 void TDBSCANCore::Send_Configuration (void)
 {
-  stClustering->send (TAG_CLUSTERING_CONFIG, "%lf %d %s %s %s %d %d",
+  stClustering->send (TAG_CLUSTERING_CONFIG, "%lf %d %s %s %s %d %d %d",
                       Epsilon,
                       MinPoints,
                       ClusteringDefinitionXML.c_str(),
                       InputTraceName.c_str(),
                       OutputFileName.c_str(),
                       ( (int) Verbose),
-                      ( (int) ReconstructTrace) );
+                      ( (int) ReconstructTrace),
+                      ( (int) SummarizeNoise) );
 }
 
 
@@ -78,12 +80,12 @@ void TDBSCANCore::Send_Configuration (void)
 void TDBSCANCore::Recv_Configuration (void)
 {
   char *XML, *Input, *Output;
-  int tag, Verb, Reconstruct;
+  int tag, Verb, Reconstruct, Summarize;
   PACKET_new (p);
 
   /* Receive clustering configuration from the front-end */
   STREAM_recv (stClustering, &tag, p, TAG_CLUSTERING_CONFIG);
-  PACKET_unpack (p, "%lf %d %s %s %s %d %d", &Epsilon, &TargetMinPoints, &XML, &Input, &Output, &Verb, &Reconstruct);
+  PACKET_unpack (p, "%lf %d %s %s %s %d %d %d", &Epsilon, &TargetMinPoints, &XML, &Input, &Output, &Verb, &Reconstruct, &Summarize);
   PACKET_delete (p);
 
   MinPoints               = 3;
@@ -92,6 +94,7 @@ void TDBSCANCore::Recv_Configuration (void)
   OutputFileName          = string (Output);
   Verbose                 = (Verb == 1);
   ReconstructTrace        = (Reconstruct == 1);
+  SummarizeNoise          = (Summarize == 1);
   xfree (XML);
   xfree (Input);
   xfree (Output);
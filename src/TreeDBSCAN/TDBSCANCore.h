@@ -62,6 +62,7 @@ class TDBSCANCore
       string OutputFileName;
       bool   Verbose;
       bool   ReconstructTrace;
+      bool   SummarizeNoise;
 
       void Send_Configuration(void);
       void Recv_Configuration(void);
@@ -44,6 +44,7 @@
 #include "Utils.h"
 #include "Statistics.h"
 #include "ClustersInfo.h"
+#include "HullsMerge.h"
 
 using namespace MRN;
 using namespace std;
@@ -60,6 +61,7 @@ bool NeedsReset   = true;
 
 vector<const Point *> NoisePoints;
 vector<long long>     NoiseDurations;
+vector<long long>     NoiseWeights;
 vector<HullModel *>   MergedHulls;
 
 Statistics *NetworkStats = NULL;
@@ -88,6 +90,7 @@ void Init(const TopologyLocalInfo & top_info)
 
    NoisePoints.clear();
    NoiseDurations.clear();
+   NoiseWeights.clear();
 
 /*
    for (unsigned int i=0; i<MergedHulls.size(); i++)
@@ -115,8 +118,9 @@ void filterTDBSCAN( std::vector< PacketPtr >& packets_in,
                        const TopologyLocalInfo& top_info)
 {
    int    tag = packets_in[0]->get_Tag();
-   double Epsilon   = 0.0;
-   int    MinPoints = 0;
+   double Epsilon        = 0.0;
+   int    MinPoints      = 0;
+   int    SummarizeNoise = 0;
 
    /* Bypass the filter in the back-ends, there's nothing to merge at this level! */
    if (BOTTOM_FILTER(top_info))
@@ -142,10 +146,9 @@ void filterTDBSCAN( std::vector< PacketPtr >& packets_in,
    }
 
    /* Get filter parameters */
-   params->unpack("%lf %d", &Epsilon, &MinPoints);
+   params->unpack("%lf %d %d", &Epsilon, &MinPoints, &SummarizeNoise);
    unsigned int NumSiblings = top_info.get_NumSiblings() + 1;
-   int WeightedMinPoints = MinPoints / NumSiblings;
-   if (WeightedMinPoints < 3) WeightedMinPoints = 3;
+   int WeightedMinPoints = ReductionMinPoints(MinPoints, NumSiblings);
 
    /* DEBUG 
    cerr << "[FILTER " << FILTER_ID(top_info) << "] NumSiblings=" << NumSiblings << " WeightedMinPoints=" << WeightedMinPoints << endl; */
@@ -157,8 +160,8 @@ void filterTDBSCAN( std::vector< PacketPtr >& packets_in,
       case TAG_NOISE:
       {
          /* Accumulate all children noise points in vector NoisePoints */
-         NoiseManager Noise = NoiseManager();
-         Noise.Unpack( packets_in[0], NoisePoints, NoiseDurations );
+         NoiseManager Noise;
+         Noise.Unpack( packets_in[0], NoisePoints, NoiseDurations, NoiseWeights );
          break;
       }
       case TAG_ALL_NOISE_SENT:
@@ -169,7 +172,7 @@ void filterTDBSCAN( std::vector< PacketPtr >& packets_in,
          {
             NetworkStats->IncreaseInputPoints( NoisePoints.size() );
 
-            NoiseManager Noise = NoiseManager(Epsilon, WeightedMinPoints);
+            NoiseManager Noise (Epsilon, WeightedMinPoints, (SummarizeNoise == 1));
             /* DEBUG -- Number of noise points 
             cerr << "[DEBUG FILTER " << FILTER_ID(top_info) << "] NoisePoints.size()=" << NoisePoints.size() << endl; */
 
@@ -177,7 +180,7 @@ void filterTDBSCAN( std::vector< PacketPtr >& packets_in,
             NetworkStats->ClusteringTimerStart();
             vector<HullModel*> NoiseModel;
             int CountRemainingNoise = 0;
-            Noise.ClusterNoise( NoisePoints, NoiseDurations, NoiseModel, CountRemainingNoise );
+            Noise.ClusterNoise( NoisePoints, NoiseDurations, NoiseWeights, NoiseModel, CountRemainingNoise );
             NetworkStats->ClusteringTimerStop();
             NetworkStats->IncreaseOutputPoints( CountRemainingNoise );
 
@@ -233,12 +236,9 @@ void filterTDBSCAN( std::vector< PacketPtr >& packets_in,
          HullManager HM = HullManager();
          HM.Unpack(packets_in[0], ChildHulls);
          /* Merge the hulls as they arrive */
-         for (unsigned int i = 0; i < ChildHulls.size(); i ++)
-         {
-            NetworkStats->MergeTimerStart();
-            NewMerge(ChildHulls[i], Epsilon, WeightedMinPoints);
-            NetworkStats->MergeTimerStop();
-         }
+         NetworkStats->MergeTimerStart();
+         NewMerge(ChildHulls, Epsilon, WeightedMinPoints);
+         NetworkStats->MergeTimerStop();
          NetworkStats->IncreaseInputHulls( ChildHulls.size() );
          break;
       }
@@ -363,32 +363,14 @@ void MergeAlltoAll(vector<HullModel*> &ClustersHulls,
 #endif
 
 
-void NewMerge(HullModel *ChildHull, double Epsilon, int MinPoints)
+void NewMerge(vector<HullModel*> &ChildHulls, double Epsilon, int MinPoints)
 {
-  /* Try to merge it (incrementally) with all hulls received previously */
-  unsigned int i = 0;
-  HullModel   *Intersect = NULL, *MaxMerge = NULL;
-
-  MaxMerge = ChildHull;
-
-  while (i < MergedHulls.size())
-  {
-    Intersect = MaxMerge->Merge(MergedHulls[i], Epsilon, MinPoints);
-    NetworkStats->IncreaseNumIntersects( (Intersect != NULL) );
-    if (Intersect != NULL)
-    {
-//      delete MaxMerge;
-//      delete MergedHulls[i];
-      MergedHulls.erase(MergedHulls.begin()+i);
-      MaxMerge = Intersect;
-    }
-    else
-    {
-      i++;
-    }
-  }
-  /* Store the merged hull in the list */
-  MergedHulls.push_back( MaxMerge );
+  int Intersects = 0, Tests = 0;
+
+  /* Merge them with all hulls received previously */
+  MergeHulls(ChildHulls, MergedHulls, Epsilon, MinPoints, Intersects, Tests);
+
+  NetworkStats->IncreaseNumIntersects(Intersects, Tests);
 }
 
 
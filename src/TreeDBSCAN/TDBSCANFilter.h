@@ -59,7 +59,7 @@ void MergeAlltoAll(vector<HullModel*> &ClustersHulls,
                    int                 MinPoints);
 */
 
-void NewMerge(HullModel *ChildHull, double Epsilon, int MinPoints);
+void NewMerge(vector<HullModel*> &ChildHulls, double Epsilon, int MinPoints);
 
 }
 
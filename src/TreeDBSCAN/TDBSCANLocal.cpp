@@ -0,0 +1,913 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include <algorithm>
+#include <sstream>
+using std::ostringstream;
+using std::endl;
+
+#include <SystemMessages.hpp>
+using cepba_tools::system_messages;
+
+#include <Timer.hpp>
+using cepba_tools::Timer;
+
+#include <FileNameManipulator.hpp>
+using cepba_tools::FileNameManipulator;
+
+#include <ParallelFor.hpp>
+
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::counter_id;
+
+#include "TDBSCANLocal.h"
+#include "HullsMerge.h"
+#include "NoiseSummary.h"
+
+#include <ConvexHullClassifier.hpp>
+#include <RepresentativesClassifier.hpp>
+
+#include <map>
+using std::map;
+
+/* MinPoints used by the workers, as in the MRNet back-ends */
+#define LOCAL_MIN_POINTS 3
+
+
+/**
+ * Tree node constructor.
+ */
+TDBSCANTreeNode::TDBSCANTreeNode(void)
+{
+  libClustering = NULL;
+  FirstChild    = 0;
+  LastChild     = 0;
+  MinPoints     = LOCAL_MIN_POINTS;
+  Intersects    = 0;
+  Tests         = 0;
+  Failed        = false;
+
+  SummarizedNoise   = false;
+  NoiseDisplacement = 0;
+}
+
+
+/**
+ * Replaces the noise points of a node by the representatives of the given
+ * summary, weighted with the number of points each one stands for.
+ * @param Node The node.
+ * @param Summary Summary of the noise of the node.
+ */
+static void SetSummarizedNoise(TDBSCANTreeNode &Node, NoiseSummary &Summary)
+{
+  Node.NoisePoints.clear();
+  Node.NoiseDurations.clear();
+  Node.NoiseWeights.clear();
+
+  Summary.GetRepresentatives(Node.NoisePoints, Node.NoiseDurations, Node.NoiseWeights);
+
+  Node.SummarizedNoise   = true;
+  Node.NoiseDisplacement = Summary.MaxDisplacement();
+}
+
+
+/**
+ * Number of noise points of a node, the summarized ones included.
+ * @param Node The node.
+ * @return the number of noise points.
+ */
+static long long CountNoise(TDBSCANTreeNode &Node)
+{
+  long long Count = 0;
+
+  if (!Node.SummarizedNoise)
+  {
+    return Node.NoisePoints.size();
+  }
+
+  for (size_t i = 0; i < Node.NoiseWeights.size(); i++)
+  {
+    Count += Node.NoiseWeights[i];
+  }
+  return Count;
+}
+
+
+/**
+ * Local cluster analysis of a leaf of the tree. It produces the local hulls
+ * and the local noise points.
+ * @param Leaf The leaf node, with its slice of the data.
+ * @param Epsilon Epsilon of the analysis.
+ * @param Summarize True to summarize the local noise points.
+ */
+static void ClusterLeaf(TDBSCANTreeNode &Leaf, double Epsilon, bool Summarize)
+{
+  if (Leaf.Points.size() == 0)
+  {
+    return;
+  }
+
+  if (!Leaf.libClustering->ClusterAnalysis(Leaf.Points, Leaf.Durations, Leaf.Hulls) ||
+      !Leaf.libClustering->GetNoisePoints(Leaf.NoisePoints, Leaf.NoiseDurations))
+  {
+    Leaf.Failed       = true;
+    Leaf.ErrorMessage = Leaf.libClustering->GetErrorMessage();
+    return;
+  }
+
+  if (Summarize)
+  {
+    NoiseSummary Summary (Epsilon);
+
+    Summary.Add(Leaf.NoisePoints, Leaf.NoiseDurations);
+    SetSummarizedNoise(Leaf, Summary);
+  }
+}
+
+
+/**
+ * Reduction of an inner node of the tree: the noise points received from
+ * all children are clustered, and the resulting hulls and the children hulls
+ * are merged, as the MRNet filter does.
+ * @param Node The inner node.
+ * @param Children Nodes of the previous level of the tree.
+ * @param Epsilon Epsilon of the analysis.
+ * @param Summarize True if the children noise is summarized.
+ */
+static void ReduceNode(TDBSCANTreeNode         &Node,
+                       vector<TDBSCANTreeNode> &Children,
+                       double                   Epsilon,
+                       bool                     Summarize)
+{
+  if (Summarize)
+  {
+    /* The children representatives are merged in a single summary, and the
+     * noise hulls come out of the weighted clustering of the cells */
+    NoiseSummary Summary (Epsilon);
+
+    for (size_t i = Node.FirstChild; i < Node.LastChild; i++)
+    {
+      Summary.Add(Children[i].NoisePoints,
+                  Children[i].NoiseDurations,
+                  Children[i].NoiseWeights);
+    }
+
+    Summary.Cluster(Node.MinPoints, Node.Hulls);
+    SetSummarizedNoise(Node, Summary);
+
+    for (size_t i = Node.FirstChild; i < Node.LastChild; i++)
+    {
+      Node.NoiseDisplacement = std::max(Node.NoiseDisplacement,
+                                        Children[i].NoiseDisplacement);
+    }
+  }
+  else
+  {
+    for (size_t i = Node.FirstChild; i < Node.LastChild; i++)
+    {
+      Node.Points.insert(Node.Points.end(),
+                         Children[i].NoisePoints.begin(),
+                         Children[i].NoisePoints.end());
+      Node.Durations.insert(Node.Durations.end(),
+                            Children[i].NoiseDurations.begin(),
+                            Children[i].NoiseDurations.end());
+    }
+
+    /* Cluster all children noise points. The new hulls are not merged among
+     * them, as they come from the same analysis */
+    if (Node.Points.size() > 0)
+    {
+      if (!Node.libClustering->ClusterAnalysis(Node.Points, Node.Durations, Node.Hulls) ||
+          !Node.libClustering->GetNoisePoints(Node.NoisePoints, Node.NoiseDurations))
+      {
+        Node.Failed       = true;
+        Node.ErrorMessage = Node.libClustering->GetErrorMessage();
+        return;
+      }
+    }
+  }
+
+  /* Merge the children hulls */
+  vector<HullModel*> ChildrenHulls;
+
+  for (size_t i = Node.FirstChild; i < Node.LastChild; i++)
+  {
+    ChildrenHulls.insert(ChildrenHulls.end(),
+                         Children[i].Hulls.begin(),
+                         Children[i].Hulls.end());
+  }
+
+  static counter_id HullTests         = instrumentation::counter("tdbscan.hull_tests");
+  static counter_id HullIntersections = instrumentation::counter("tdbscan.hull_intersections");
+
+  instrumentation::phase_begin("merge_hulls");
+  MergeHulls(ChildrenHulls,
+             Node.Hulls,
+             Epsilon,
+             Node.MinPoints,
+             Node.Intersects,
+             Node.Tests);
+  instrumentation::phase_end();
+
+  instrumentation::add(HullTests,         Node.Tests);
+  instrumentation::add(HullIntersections, Node.Intersects);
+}
+
+
+/**
+ * Functor to run the leaves local clustering through 'parallel_for'.
+ */
+class LeavesClusteringTask
+{
+  private:
+    vector<TDBSCANTreeNode> &Leaves;
+    double                   Epsilon;
+    bool                     Summarize;
+
+  public:
+    LeavesClusteringTask(vector<TDBSCANTreeNode> &Leaves,
+                         double                   Epsilon,
+                         bool                     Summarize)
+    : Leaves(Leaves), Epsilon(Epsilon), Summarize(Summarize) {}
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        ClusterLeaf(Leaves[i], Epsilon, Summarize);
+      }
+    }
+};
+
+
+/**
+ * Functor to run the reduction of a tree level through 'parallel_for'.
+ */
+class LevelReductionTask
+{
+  private:
+    vector<TDBSCANTreeNode> &Children;
+    vector<TDBSCANTreeNode> &Parents;
+    double                   Epsilon;
+    bool                     Summarize;
+
+  public:
+    LevelReductionTask(vector<TDBSCANTreeNode> &Children,
+                       vector<TDBSCANTreeNode> &Parents,
+                       double                   Epsilon,
+                       bool                     Summarize)
+    : Children(Children), Parents(Parents), Epsilon(Epsilon), Summarize(Summarize) {}
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        ReduceNode(Parents[i], Children, Epsilon, Summarize);
+      }
+    }
+};
+
+
+/**
+ * Constructor sets the clustering configuration parameters.
+ * @param Eps Epsilon of the analysis (-1 to read it from the XML).
+ * @param MinPts MinPoints of the analysis (-1 to read it from the XML).
+ * @param ClusteringDefinitionXML XML to define the data extraction.
+ * @param InputTraceName Trace to analyze.
+ * @param OutputFileName Output trace name, used as prefix of the rest of outputs.
+ * @param Verbose Show information messages.
+ * @param ReconstructTrace Write the output trace with the clusters information.
+ * @param Workers Number of leaves (and threads) of the tree.
+ * @param Fanout Number of children of the inner nodes of the tree.
+ * @param SummarizeNoise Propagate the noise as weighted grid cells.
+ * @param CompareNoise Also build the model forwarding the noise exactly, and
+ *                     report the differences of the summarized one.
+ */
+TDBSCANLocal::TDBSCANLocal(double       Eps,
+                           int          MinPts,
+                           string       ClusteringDefinitionXML,
+                           string       InputTraceName,
+                           string       OutputFileName,
+                           bool         Verbose,
+                           bool         ReconstructTrace,
+                           unsigned int Workers,
+                           unsigned int Fanout,
+                           bool         SummarizeNoise,
+                           bool         CompareNoise)
+{
+  this->ClusteringDefinitionXML = ClusteringDefinitionXML;
+  this->InputTraceName          = InputTraceName;
+  this->OutputFileName          = OutputFileName;
+  this->Verbose                 = Verbose;
+  this->ReconstructTrace        = ReconstructTrace;
+  this->Workers                 = (Workers == 0 ? cepba_tools::parallel_threads() : Workers);
+  this->Fanout                  = (Fanout < 2 ? 2 : Fanout);
+  this->SummarizeNoise          = SummarizeNoise;
+  this->CompareNoise            = SummarizeNoise && CompareNoise;
+
+  libClustering = new libDistributedClustering((Verbose ? VERBOSE : SILENT), "LOCAL");
+
+  /* Read the default parameters from the XML */
+  if (!libClustering->InitClustering(ClusteringDefinitionXML, true, 0, 1))
+  {
+    SetError(true);
+    SetErrorMessage(libClustering->GetErrorMessage());
+    return;
+  }
+
+  this->Epsilon   = (Eps    == -1 ? libClustering->GetEpsilon()   : Eps);
+  this->MinPoints = (MinPts == -1 ? libClustering->GetMinPoints() : MinPts);
+}
+
+
+/**
+ * Destructor.
+ */
+TDBSCANLocal::~TDBSCANLocal(void)
+{
+  if (libClustering != NULL)
+  {
+    delete libClustering;
+  }
+}
+
+
+/**
+ * Runs the whole analysis: extraction, local clustering on the leaves,
+ * reduction up to the global model, classification and outputs.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::Run(void)
+{
+  ostringstream Messages;
+  Timer         t;
+
+  if (GetError())
+  {
+    return false;
+  }
+
+  OutputPrefix = FileNameManipulator(OutputFileName,
+                                     FileNameManipulator::GetExtension(OutputFileName)).GetChoppedFileName();
+
+  Messages << "Local TDBSCAN configuration:"                                  << endl;
+  Messages << "+ Epsilon     = " << Epsilon                                   << endl;
+  Messages << "+ Min Points  = " << MinPoints                                 << endl;
+  Messages << "+ XML         = " << ClusteringDefinitionXML                   << endl;
+  Messages << "+ Input       = " << InputTraceName                            << endl;
+  Messages << "+ Output      = " << OutputFileName                            << endl;
+  Messages << "+ Workers     = " << Workers                                   << endl;
+  Messages << "+ Fan-out     = " << Fanout                                    << endl;
+  Messages << "+ Reconstruct = " << ( ReconstructTrace ? "yes" : "no" )       << endl;
+  Messages << "+ Noise       = " << ( SummarizeNoise ? "summarized" : "exact" );
+  Messages << ( CompareNoise ? " (compared with exact)" : "" )                << endl;
+  Messages << endl;
+  system_messages::information(Messages.str());
+
+  /* The leaves and the reduction nodes run one per thread */
+  cepba_tools::set_parallel_threads(Workers);
+
+  t.begin();
+  instrumentation::phase_begin("extraction");
+  if (!ExtractData())
+  {
+    return false;
+  }
+  instrumentation::phase_end();
+  system_messages::show_timer("Data extraction time", t.end());
+
+  if (CompareNoise)
+  {
+    vector<HullModel*> ExactModel;
+
+    system_messages::information("Building the model with exact noise forwarding, for comparison\n");
+
+    if (!BuildGlobalModel(false, ExactModel))
+    {
+      return false;
+    }
+
+    system_messages::information("Building the model with summarized noise\n");
+
+    if (!BuildGlobalModel(true, GlobalModel) ||
+        !ReportNoiseSummaryError(ExactModel))
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < ExactModel.size(); i++)
+    {
+      delete ExactModel[i];
+    }
+  }
+  else if (!BuildGlobalModel(SummarizeNoise, GlobalModel))
+  {
+    return false;
+  }
+
+  t.begin();
+  instrumentation::phase_begin("classification");
+  if (!ClassifyData())
+  {
+    return false;
+  }
+  instrumentation::phase_end();
+  system_messages::show_timer("Classification time", t.end());
+
+  instrumentation::phase_begin("outputs");
+  if (!GenerateOutputs())
+  {
+    return false;
+  }
+  instrumentation::phase_end();
+
+  return true;
+}
+
+
+/**
+ * Clusters the leaves and reduces the tree up to the global model.
+ * @param Summarize Propagate the noise as weighted grid cells.
+ * @param Model Output vector of the hulls of the global model.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::BuildGlobalModel(bool Summarize, vector<HullModel*> &Model)
+{
+  ostringstream           Messages;
+  vector<TDBSCANTreeNode> Children, Parents;
+  Timer                   t;
+  unsigned int            Level = 0;
+
+  t.begin();
+  instrumentation::phase_begin("local_clustering");
+  if (!LocalClustering(Children, Summarize))
+  {
+    DeleteNodes(Children);
+    return false;
+  }
+  instrumentation::phase_end();
+  system_messages::show_timer("Local clustering time", t.end());
+
+  /* Reduce the tree up to a single node. There is always a reduction, so
+   * the noise of the leaves is clustered even with a single worker */
+  t.begin();
+  instrumentation::phase_begin("reduction");
+  do
+  {
+    if (!ReduceLevel(Children, Parents, Summarize))
+    {
+      DeleteNodes(Children);
+      DeleteNodes(Parents);
+      return false;
+    }
+
+    Level++;
+
+    Messages.str("");
+    Messages << "Reduction level " << Level << ": " << Parents.size() << " node(s), ";
+    Messages << Parents[0].Hulls.size() << " hull(s) and ";
+    Messages << CountNoise(Parents[0]) << " noise point(s) on the first one";
+    if (Summarize)
+    {
+      Messages << " in " << Parents[0].NoisePoints.size() << " cell(s), ";
+      Messages << "max. displacement " << Parents[0].NoiseDisplacement;
+      Messages << " (bound " << NOISE_CELL_DIAGONAL * Epsilon << ")";
+    }
+    Messages << endl;
+    system_messages::information(Messages.str());
+
+    DeleteNodes(Children);
+    Children.swap(Parents);
+    Parents.clear();
+  }
+  while (Children.size() > 1);
+  instrumentation::phase_end();
+  system_messages::show_timer("Reduction time", t.end());
+
+  /* Keep the dense enough hulls, sorted by their aggregated time */
+  for (size_t i = 0; i < Children[0].Hulls.size(); i++)
+  {
+    if (Children[0].Hulls[i]->Density() >= MinPoints)
+    {
+      Model.push_back(Children[0].Hulls[i]);
+    }
+  }
+  std::sort(Model.begin(), Model.end(), SortHullsByTime());
+
+  Messages.str("");
+  Messages << "Global model: " << Model.size() << " hull(s), ";
+  Messages << "remaining noise points = " << CountNoise(Children[0]) << endl;
+  system_messages::information(Messages.str());
+
+  DeleteNodes(Children);
+
+  return true;
+}
+
+
+/**
+ * Extracts and normalizes the data of the whole trace.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::ExtractData(void)
+{
+  vector<double> MinValues, MaxValues;
+
+  if (!libClustering->ExtractData(InputTraceName))
+  {
+    SetError(true);
+    SetErrorMessage("error extracting data", libClustering->GetErrorMessage());
+    return false;
+  }
+
+  libClustering->GetParameterRanges(MinValues, MaxValues);
+  libClustering->NormalizeData(MinValues, MaxValues);
+
+  return true;
+}
+
+
+/**
+ * Splits the data in as many disjoint slices as workers and clusters them
+ * in parallel.
+ * @param Leaves Output vector of the leaves of the tree.
+ * @param Summarize Summarize the local noise points.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::LocalClustering(vector<TDBSCANTreeNode> &Leaves, bool Summarize)
+{
+  ostringstream        Messages;
+  vector<const Point*> Points;
+  vector<long long>    Durations;
+
+  if (!libClustering->GetClusteringPoints(Points, Durations))
+  {
+    SetError(true);
+    SetErrorMessage(libClustering->GetErrorMessage());
+    return false;
+  }
+
+  Messages << "Bursts to analyze: " << Points.size() << endl;
+  system_messages::information(Messages.str());
+
+  Leaves.resize(Workers);
+
+  for (size_t i = 0; i < Leaves.size(); i++)
+  {
+    size_t Begin = (Points.size() * i)     / Leaves.size();
+    size_t End   = (Points.size() * (i+1)) / Leaves.size();
+
+    Leaves[i].Points.assign(Points.begin() + Begin, Points.begin() + End);
+    Leaves[i].Durations.assign(Durations.begin() + Begin, Durations.begin() + End);
+
+    /* The library set up is not thread safe, so it is done here */
+    Leaves[i].libClustering = new libDistributedClustering(SILENT, "LOCAL");
+    if (!Leaves[i].libClustering->InitClustering(Epsilon, LOCAL_MIN_POINTS))
+    {
+      SetError(true);
+      SetErrorMessage("error initializing worker",
+                      Leaves[i].libClustering->GetErrorMessage());
+      return false;
+    }
+  }
+
+  LeavesClusteringTask Task(Leaves, Epsilon, Summarize);
+  cepba_tools::parallel_for(Task, 0, Leaves.size());
+
+  system_messages::verbose = Verbose;
+
+  return CheckNodes(Leaves);
+}
+
+
+/**
+ * Builds and reduces the next level of the tree.
+ * @param Children Nodes of the current level.
+ * @param Parents Output vector of nodes of the next level.
+ * @param Summarize True if the noise is summarized.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::ReduceLevel(vector<TDBSCANTreeNode> &Children,
+                               vector<TDBSCANTreeNode> &Parents,
+                               bool                     Summarize)
+{
+  Parents.resize((Children.size() + Fanout - 1) / Fanout);
+
+  for (size_t i = 0; i < Parents.size(); i++)
+  {
+    size_t FirstSibling = (i / Fanout) * Fanout;
+    size_t NumSiblings  = std::min((size_t) Fanout, Parents.size() - FirstSibling);
+
+    Parents[i].FirstChild = i * Fanout;
+    Parents[i].LastChild  = std::min(Parents[i].FirstChild + Fanout, Children.size());
+    Parents[i].MinPoints  = ReductionMinPoints(MinPoints, NumSiblings);
+
+    Parents[i].libClustering = new libDistributedClustering(SILENT, "LOCAL");
+    if (!Parents[i].libClustering->InitClustering(Epsilon, Parents[i].MinPoints))
+    {
+      SetError(true);
+      SetErrorMessage("error initializing reduction node",
+                      Parents[i].libClustering->GetErrorMessage());
+      return false;
+    }
+  }
+
+  LevelReductionTask Task(Children, Parents, Epsilon, Summarize);
+  cepba_tools::parallel_for(Task, 0, Parents.size());
+
+  system_messages::verbose = Verbose;
+
+  return CheckNodes(Parents);
+}
+
+
+/**
+ * Classifies all the data using the global model.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::ClassifyData(void)
+{
+  libClustering->SetMinPoints(MinPoints);
+
+  if (!libClustering->ClassifyData(GlobalModel))
+  {
+    SetError(true);
+    SetErrorMessage("error classifying data", libClustering->GetErrorMessage());
+    return false;
+  }
+
+  return true;
+}
+
+
+/**
+ * Classifies the given points with a global model, as the library does with
+ * the whole data.
+ * @param Model Hulls of the global model.
+ * @param Points Points to classify.
+ * @param Assignment Output partition of the points.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::ClassifyPoints(vector<HullModel*>   &Model,
+                                  vector<const Point*> &Points,
+                                  Partition            &Assignment)
+{
+  vector<ConvexHullModel>      Hulls;
+  vector<RepresentativesModel> Representatives;
+
+  for (size_t i = 0; i < Model.size(); i++)
+  {
+    if (Model[i]->Representatives() != NULL)
+    {
+      Representatives.push_back(*(Model[i]->Representatives()));
+    }
+    else
+    {
+      Hulls.push_back(*(Model[i]->Model()));
+    }
+  }
+
+  if (Representatives.size() > 0)
+  {
+    RepresentativesClassifier Classifier(Representatives, Epsilon, MinPoints);
+    return Classifier.Classify(Points, Assignment);
+  }
+  else
+  {
+    ConvexHullClassifier Classifier(Hulls, Epsilon, MinPoints);
+    return Classifier.Classify(Points, Assignment);
+  }
+}
+
+
+/**
+ * Classifies the data with the model built from exact noise forwarding and
+ * with the summarized one, and reports how many points change their cluster
+ * and the noise of both. Each summarized cluster is matched to the exact
+ * cluster that shares more points with it.
+ * @param ExactModel Global model built forwarding the noise exactly.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::ReportNoiseSummaryError(vector<HullModel*> &ExactModel)
+{
+  ostringstream        Messages;
+  vector<const Point*> Points;
+  vector<long long>    Durations;
+  Partition            ExactPartition, SummaryPartition;
+  bool                 Verbosity = system_messages::verbose;
+  size_t               ExactNoise = 0, SummaryNoise = 0, Different = 0;
+
+  map<cluster_id_t, map<cluster_id_t, size_t> >           Overlap;
+  map<cluster_id_t, map<cluster_id_t, size_t> >::iterator OverlapIt;
+  map<cluster_id_t, cluster_id_t>                         Match;
+
+  if (!libClustering->GetClusteringPoints(Points, Durations))
+  {
+    SetError(true);
+    SetErrorMessage(libClustering->GetErrorMessage());
+    return false;
+  }
+
+  system_messages::verbose = false;
+  if (!ClassifyPoints(ExactModel,  Points, ExactPartition) ||
+      !ClassifyPoints(GlobalModel, Points, SummaryPartition))
+  {
+    system_messages::verbose = Verbosity;
+    SetError(true);
+    SetErrorMessage("error classifying the points to compare the noise summary");
+    return false;
+  }
+  system_messages::verbose = Verbosity;
+
+  vector<cluster_id_t>& Exact   = ExactPartition.GetAssignmentVector();
+  vector<cluster_id_t>& Summary = SummaryPartition.GetAssignmentVector();
+
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    ExactNoise   += (Exact[i]   == NOISE_CLUSTERID ? 1 : 0);
+    SummaryNoise += (Summary[i] == NOISE_CLUSTERID ? 1 : 0);
+
+    if (Summary[i] != NOISE_CLUSTERID && Exact[i] != NOISE_CLUSTERID)
+    {
+      Overlap[Summary[i]][Exact[i]]++;
+    }
+  }
+
+  /* Noise only matches noise */
+  Match[NOISE_CLUSTERID] = NOISE_CLUSTERID;
+
+  for (OverlapIt = Overlap.begin(); OverlapIt != Overlap.end(); ++OverlapIt)
+  {
+    map<cluster_id_t, size_t>::iterator CandidateIt;
+    size_t                              Shared = 0;
+
+    for (CandidateIt  = OverlapIt->second.begin();
+         CandidateIt != OverlapIt->second.end();
+         ++CandidateIt)
+    {
+      if (CandidateIt->second > Shared)
+      {
+        Match[OverlapIt->first] = CandidateIt->first;
+        Shared                  = CandidateIt->second;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    if (Match.count(Summary[i]) == 0 || Match[Summary[i]] != Exact[i])
+    {
+      Different++;
+    }
+  }
+
+  Messages.precision(2);
+  Messages << std::fixed;
+  Messages << "Noise summary against exact forwarding: " << Different;
+  Messages << " of " << Points.size() << " point(s) in a different cluster (";
+  Messages << (Points.size() > 0 ? 100.0 * Different / Points.size() : 0.0) << "%), ";
+  Messages << "noise points " << ExactNoise << " exact / " << SummaryNoise << " summarized, ";
+  Messages << "clusters " << ExactModel.size() << " exact / " << GlobalModel.size() << " summarized";
+  Messages << endl;
+  system_messages::information(Messages.str());
+
+  return true;
+}
+
+
+/**
+ * Writes the global model, the clustered data and plots, the clusters
+ * information and, if required, the reconstructed trace.
+ * @return true on success; false otherwise.
+ */
+bool TDBSCANLocal::GenerateOutputs(void)
+{
+  ostringstream ModelTitle;
+  Timer         t;
+
+  ModelTitle << "Global Model MinPoints = " << MinPoints << " Eps = " << Epsilon;
+
+  if (!libClustering->PrintModels(GlobalModel,
+                                  OutputPrefix + ".GLOBAL_MODEL.csv",
+                                  OutputPrefix + ".GLOBAL_MODEL",
+                                  ModelTitle.str()))
+  {
+    SetError(true);
+    SetErrorMessage("error printing global model", libClustering->GetErrorMessage());
+    return false;
+  }
+
+  if (!libClustering->PrintPlotScripts(OutputPrefix + ".FINAL.DATA.csv",
+                                       OutputPrefix + ".FINAL",
+                                       false)) // false = Global classification
+  {
+    SetError(true);
+    SetErrorMessage("error printing data plots", libClustering->GetErrorMessage());
+    return false;
+  }
+
+  if (!libClustering->FlushClustersInformation(OutputPrefix + ".FINAL.clusters_info.csv"))
+  {
+    SetError(true);
+    SetErrorMessage("error writing clusters information", libClustering->GetErrorMessage());
+    return false;
+  }
+
+  if (ReconstructTrace)
+  {
+    system_messages::information("Reconstructing trace\n");
+
+    t.begin();
+    if (!libClustering->ReconstructInputTrace(OutputFileName))
+    {
+      SetError(true);
+      SetErrorMessage("error writing output trace", libClustering->GetErrorMessage());
+      return false;
+    }
+    system_messages::show_timer("Trace reconstruction time", t.end());
+  }
+
+  return true;
+}
+
+
+/**
+ * Checks if any node of a level failed, taking its error message.
+ * @param Nodes Nodes of the level.
+ * @return true if all nodes succeeded; false otherwise.
+ */
+bool TDBSCANLocal::CheckNodes(vector<TDBSCANTreeNode> &Nodes)
+{
+  for (size_t i = 0; i < Nodes.size(); i++)
+  {
+    if (Nodes[i].Failed)
+    {
+      SetError(true);
+      SetErrorMessage(Nodes[i].ErrorMessage);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/**
+ * Releases the clustering libraries of the nodes of a level, and the
+ * summarized noise. The points belong to the extracted data and the hulls
+ * are kept by the next level.
+ * @param Nodes Nodes of the level.
+ */
+void TDBSCANLocal::DeleteNodes(vector<TDBSCANTreeNode> &Nodes)
+{
+  for (size_t i = 0; i < Nodes.size(); i++)
+  {
+    if (Nodes[i].SummarizedNoise)
+    {
+      for (size_t j = 0; j < Nodes[i].NoisePoints.size(); j++)
+      {
+        delete Nodes[i].NoisePoints[j];
+      }
+      Nodes[i].NoisePoints.clear();
+      Nodes[i].SummarizedNoise = false;
+    }
+
+    if (Nodes[i].libClustering != NULL)
+    {
+      delete Nodes[i].libClustering;
+      Nodes[i].libClustering = NULL;
+    }
+  }
+}
@@ -0,0 +1,153 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef __TDBSCAN_LOCAL_H__
+#define __TDBSCAN_LOCAL_H__
+
+#include <vector>
+#include <string>
+#include <Error.hpp>
+#include <libDistributedClustering.hpp>
+#include <Partition.hpp>
+
+using std::vector;
+using std::string;
+using cepba_tools::Error;
+
+/**
+ * Node of the in-process reduction tree. The leaves cluster a slice of the
+ * data and the inner nodes merge the hulls and cluster the noise of their
+ * children, just as the MRNet filter does.
+ */
+struct TDBSCANTreeNode
+{
+  libDistributedClustering *libClustering;
+
+  /* Input points: data slice (leaves) or children noise (inner nodes) */
+  vector<const Point*>      Points;
+  vector<long long>         Durations;
+
+  /* Output of the node */
+  vector<HullModel*>        Hulls;
+  vector<const Point*>      NoisePoints;
+  vector<long long>         NoiseDurations;
+
+  /* Summarized noise: the noise points are weighted representatives owned
+   * by the node (see NoiseSummary.h) */
+  bool                      SummarizedNoise;
+  vector<long long>         NoiseWeights;
+  double                    NoiseDisplacement;
+
+  /* Children of an inner node, in the previous level of the tree */
+  size_t                    FirstChild;
+  size_t                    LastChild;
+  int                       MinPoints;
+
+  int                       Intersects;
+  int                       Tests;
+
+  bool                      Failed;
+  string                    ErrorMessage;
+
+  TDBSCANTreeNode(void);
+};
+
+/**
+ * This class implements the TDBSCAN algorithm in a single process. The
+ * bursts are extracted once, the worker threads cluster disjoint slices of
+ * them and a reduction tree of threads, with the given fan-out, merges the
+ * local hulls and noise up to the global model. No network is needed.
+ */
+class TDBSCANLocal: public Error
+{
+  public:
+    TDBSCANLocal(double       Eps,
+                 int          MinPts,
+                 string       ClusteringDefinitionXML,
+                 string       InputTraceName,
+                 string       OutputFileName,
+                 bool         Verbose,
+                 bool         ReconstructTrace,
+                 unsigned int Workers,
+                 unsigned int Fanout,
+                 bool         SummarizeNoise = false,
+                 bool         CompareNoise   = false);
+
+    ~TDBSCANLocal(void);
+
+    bool Run(void);
+
+  private:
+    double       Epsilon;
+    int          MinPoints;
+    string       ClusteringDefinitionXML;
+    string       InputTraceName;
+    string       OutputFileName;
+    string       OutputPrefix;
+    bool         Verbose;
+    bool         ReconstructTrace;
+    unsigned int Workers;
+    unsigned int Fanout;
+    bool         SummarizeNoise;
+    bool         CompareNoise;
+
+    libDistributedClustering *libClustering;
+    vector<HullModel*>        GlobalModel;
+
+    bool ExtractData(void);
+
+    bool BuildGlobalModel(bool Summarize, vector<HullModel*> &Model);
+
+    bool LocalClustering(vector<TDBSCANTreeNode> &Leaves, bool Summarize);
+
+    bool ReduceLevel(vector<TDBSCANTreeNode> &Children,
+                     vector<TDBSCANTreeNode> &Parents,
+                     bool                     Summarize);
+
+    bool ClassifyPoints(vector<HullModel*>   &Model,
+                        vector<const Point*> &Points,
+                        Partition            &Assignment);
+
+    bool ReportNoiseSummaryError(vector<HullModel*> &ExactModel);
+
+    bool ClassifyData(void);
+
+    bool GenerateOutputs(void);
+
+    bool CheckNodes(vector<TDBSCANTreeNode> &Nodes);
+
+    void DeleteNodes(vector<TDBSCANTreeNode> &Nodes);
+};
+
+#endif /* __TDBSCAN_LOCAL_H__ */
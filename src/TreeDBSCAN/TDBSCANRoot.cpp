@@ -44,11 +44,15 @@ using cepba_tools::system_messages;
 #include <FileNameManipulator.hpp>
 using cepba_tools::FileNameManipulator;
 
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+
 #include <libDistributedClustering.hpp>
 
 #include "TDBSCANRoot.h"
 #include "NoiseManager.h"
 #include "HullManager.h"
+#include "DataFilesMerge.h"
 #include "TDBSCANTags.h"
 #include "Utils.h"
 #include "Support.h"
@@ -64,7 +68,8 @@ TDBSCANRoot::TDBSCANRoot (
   string InputTraceName,
   string OutputFileName,
   bool   Verbose,
-  bool   ReconstructTrace)
+  bool   ReconstructTrace,
+  bool   SummarizeNoise)
 {
 
   this->ClusteringDefinitionXML = ClusteringDefinitionXML;
@@ -72,6 +77,7 @@ TDBSCANRoot::TDBSCANRoot (
   this->OutputFileName          = OutputFileName;
   this->Verbose                 = Verbose;
   this->ReconstructTrace        = ReconstructTrace;
+  this->SummarizeNoise          = SummarizeNoise;
   system_messages::verbose      = Verbose;
 
   libClustering = new libDistributedClustering(Verbose, "FE");
@@ -117,7 +123,7 @@ TDBSCANRoot::TDBSCANRoot (
 void TDBSCANRoot::Setup()
 {
   stClustering = Register_Stream ("TDBSCAN", SFILTER_DONTWAIT);
-  stClustering->set_FilterParameters (FILTER_UPSTREAM_TRANS, "%lf %d", Epsilon, MinPoints);
+  stClustering->set_FilterParameters (FILTER_UPSTREAM_TRANS, "%lf %d %d", Epsilon, MinPoints, (int) SummarizeNoise);
   stXchangeDims = Register_Stream ("XchangeDimensions", SFILTER_WAITFORALL);
   stSupport = Register_Stream("Support", SFILTER_WAITFORALL);
 }
@@ -173,21 +179,26 @@ int TDBSCANRoot::Run()
   double *MinGlobalDimensions=NULL, *MaxGlobalDimensions=NULL;
   int     NumberOfDimensions;
 
+  instrumentation::phase_begin("global_dimensions");
   MRN_STREAM_RECV (stXchangeDims, &tag, p, TAG_XCHANGE_DIMENSIONS);
   PACKET_unpack(p, "%alf %alf", &MinGlobalDimensions, &NumberOfDimensions, &MaxGlobalDimensions, &NumberOfDimensions);
 
   stXchangeDims->send (p);
+  instrumentation::phase_end();
 
   Messages.str ("");
   Messages << "[FE] In barrier while back-ends are clustering...." << endl;
   system_messages::information (Messages.str() );
 
+  instrumentation::phase_begin("local_clustering");
   Barrier();
+  instrumentation::phase_end();
 
   Messages.str ("");
   Messages << "[FE] Computing global hulls..." << endl;
   system_messages::information (Messages.str() );
 
+  instrumentation::phase_begin("global_hulls");
   do
   {
     MRN_STREAM_RECV (stClustering, &tag, p, TAG_ANY);
@@ -245,12 +256,24 @@ int TDBSCANRoot::Run()
     {
       vector<const Point *> NoisePoints;
       vector<long long>     NoiseDurations;
+      vector<long long>     NoiseWeights;
+      long long             CountNoise = 0;
+
+      NoiseManager Noise;
+      Noise.Unpack (p, NoisePoints, NoiseDurations, NoiseWeights);
 
-      NoiseManager Noise = NoiseManager();
-      Noise.Unpack (p, NoisePoints, NoiseDurations);
+      for (size_t i = 0; i < NoiseWeights.size(); i++)
+      {
+        CountNoise += NoiseWeights[i];
+      }
 
       Messages.str ("");
-      Messages << "[FE] Remaining noise points = " << NoisePoints.size() << endl;
+      Messages << "[FE] Remaining noise points = " << CountNoise;
+      if (SummarizeNoise)
+      {
+        Messages << " (summarized in " << NoisePoints.size() << " cells)";
+      }
+      Messages << endl;
       system_messages::information (Messages.str() );
     }
 #endif
@@ -258,6 +281,7 @@ int TDBSCANRoot::Run()
   while (tag != TAG_ALL_HULLS_SENT);
 
   stClustering->send (TAG_ALL_HULLS_SENT, "");
+  instrumentation::phase_end();
 
   Messages.str ("");
   Messages << "[FE] Broadcasted " << countGlobalHulls << " global hulls!" << endl;
@@ -269,17 +293,6 @@ int TDBSCANRoot::Run()
   system_messages::information (Messages.str() );
 
   string FinalDataFileName = OutputPrefix + ".FINAL.DATA.csv";
-#if 0
-  MergedDataFileNames << "head -n 1 " << OutputPrefix << ".GLOBAL_CLUSTERING_0.csv ";
-  MergedDataFileNames << "> " + FinalDataFileName + "; ";
-  MergedDataFileNames << "tail -qn +2 ";
-
-  for (unsigned int i = 0; i < NumBackEnds(); i++)
-  {
-    MergedDataFileNames << OutputPrefix << ".GLOBAL_CLUSTERING_" << i << ".csv ";
-  }
-  MergedDataFileNames << ">> " + FinalDataFileName + "; ";  
-#endif
 
   if (!libClustering->PrintGlobalPlotScripts(
     FinalDataFileName,
@@ -292,12 +305,14 @@ int TDBSCANRoot::Run()
 
 
   /* Receive the support */
+  instrumentation::phase_begin("global_support");
   MRN_STREAM_RECV (stSupport, &tag, p, TAG_SUPPORT);
   Support GlobalSupport(NumberOfDimensions, MinGlobalDimensions, MaxGlobalDimensions);
   GlobalSupport.Unpack(p);
   GlobalSupport.Serialize(stSupport);
   //GlobalSupport.dump();
   GlobalSupport.plot2(OutputPrefix + ".FINAL.support.csv");
+  instrumentation::phase_end();
 
   /* Receive the averaged clusters info stats */
   ClustersInfo ClustersStats;
@@ -317,12 +332,25 @@ int TDBSCANRoot::Run()
   PrintGraphStats (NetworkStats);
 
   /* Write the final DATA file */
-  cout << "Concatenating data files..." << endl;
-  ostringstream ConcatCMD;
-  ConcatCMD << getenv("TDBSCAN_HOME") << "/bin/concat-csv " << NumBackEnds() << " " << OutputPrefix << ".GLOBAL_CLUSTERING_" << " " << FinalDataFileName; 
-  cout << ConcatCMD.str() << endl;
-  cout.flush();
-  system( ConcatCMD.str().c_str() );
+  Messages.str ("");
+  Messages << "[FE] Merging back-ends data files" << endl;
+  system_messages::information (Messages.str() );
+
+  vector<string> DataFileNames;
+  string         MergeError;
+  for (unsigned int i = 0; i < NumBackEnds(); i++)
+  {
+    ostringstream DataFileName;
+    DataFileName << OutputPrefix << ".GLOBAL_CLUSTERING_" << i << ".csv";
+    DataFileNames.push_back (DataFileName.str() );
+  }
+
+  instrumentation::phase_begin("merge_data_files");
+  if (!MergeDataFiles (DataFileNames, FinalDataFileName, MergeError) )
+  {
+    cout << "Error merging data files: " << MergeError << endl;
+  }
+  instrumentation::phase_end();
 
   xfree(MinGlobalDimensions);
   xfree(MaxGlobalDimensions);
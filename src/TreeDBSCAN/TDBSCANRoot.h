@@ -63,7 +63,8 @@ class TDBSCANRoot : public TDBSCANCore, public FrontProtocol
                  string InputTraceName,
                  string OutputFileName,
                  bool   Verbose,
-                 bool   ReconstructTrace);
+                 bool   ReconstructTrace,
+                 bool   SummarizeNoise = false);
 
     TDBSCANRoot (string ClusteringDefinitionXML,
                  bool   Verbose);
@@ -178,7 +178,7 @@ int TDBSCANWorker::Run()
   /* DEBUG -- count remaining noise points */
   if (Verbose) cerr << "[BE " << WhoAmI() << "] Number of noise points = " << NoisePoints.size() << endl; 
 
-  NoiseManager Noise = NoiseManager (libClustering);
+  NoiseManager Noise (libClustering, SummarizeNoise, Epsilon);
   Noise.Serialize (stClustering);
 #endif
 
@@ -47,6 +47,9 @@ using std::endl;
 
 #include <fstream>
 
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+
 /* Configuration variables */
 double Epsilon   = -1;
 int    MinPoints = -1;
@@ -55,8 +58,23 @@ string InputTraceName;           /* Input trace name */
 string OutputFileName;           /* Data extracted from input trace */
 bool   Verbose          = true;
 bool   ReconstructTrace = false;
+bool   SummarizeNoise   = false;
+string StatsJSONFileName;        /* Phases and counters of the front-end */
+bool   WriteStatsJSON   = false;
 string TDBSCAN_HOME;
 
+/**
+ * Writes the phases and counters of the front-end if requested.
+ */
+static void WriteStatistics(void)
+{
+  if (WriteStatsJSON &&
+      !instrumentation::write_json(StatsJSONFileName, "TDBSCAN_FE"))
+  {
+    cerr << "Error writing statistics file " << StatsJSONFileName << endl;
+  }
+}
+
 #if defined(BACKEND_ATTACH)
 
 int main (int argc, char *argv[])
@@ -66,6 +84,8 @@ int main (int argc, char *argv[])
   /* Parse input argumens */
   ReadArgs (argc, argv);
 
+  instrumentation::enabled = WriteStatsJSON;
+
   /* Create an MRNet front-end */
   FrontEnd *FE = new FrontEnd();
 
@@ -76,7 +96,7 @@ int main (int argc, char *argv[])
   }
 
   /* Load the clustering protocol */
-  FrontProtocol *protClustering = new TDBSCANRoot (Epsilon, MinPoints, ClusteringDefinitionXML, InputTraceName, OutputFileName, Verbose, ReconstructTrace);
+  FrontProtocol *protClustering = new TDBSCANRoot (Epsilon, MinPoints, ClusteringDefinitionXML, InputTraceName, OutputFileName, Verbose, ReconstructTrace, SummarizeNoise);
   FE->LoadProtocol ( protClustering );
 
   /* Tell the back-ends to run the clustering protocol */
@@ -85,6 +105,8 @@ int main (int argc, char *argv[])
   /* Shutdown the network */
   FE->Shutdown();
 
+  WriteStatistics();
+
   return 0;
 }
 
@@ -104,6 +126,8 @@ int main (int argc, char *argv[])
   /* Parse input argumens */
   ReadArgs (argc, argv);
 
+  instrumentation::enabled = WriteStatsJSON;
+
   /* Create an MRNet front-end */
   FrontEnd *FE = new FrontEnd();
   const char **BE_argv = (const char **) (& (argv[1]) );
@@ -121,7 +145,7 @@ int main (int argc, char *argv[])
   cout << "Loading protocols..." << endl;
   cout.flush();
   /* Load the clustering protocol */
-  FrontProtocol *protClustering = new TDBSCANRoot (Epsilon, MinPoints, ClusteringDefinitionXML, InputTraceName, OutputFileName, Verbose, ReconstructTrace);
+  FrontProtocol *protClustering = new TDBSCANRoot (Epsilon, MinPoints, ClusteringDefinitionXML, InputTraceName, OutputFileName, Verbose, ReconstructTrace, SummarizeNoise);
   FE->LoadProtocol ( protClustering );
 
   /* Tell the back-ends to run the clustering protocol */
@@ -130,6 +154,8 @@ int main (int argc, char *argv[])
   /* Shutdown the network */
   FE->Shutdown();
 
+  WriteStatistics();
+
   return 0;
 }
 
@@ -193,6 +219,9 @@ void ReadArgs (int argc, char *argv[])
         case 'r':
           ReconstructTrace = true;
           break;
+        case 'n':
+          SummarizeNoise = true;
+          break;
         case 'e':
           j++;
           Epsilon = atof (argv[j]);
@@ -214,6 +243,19 @@ void ReadArgs (int argc, char *argv[])
             exit (EXIT_FAILURE);
           }
 
+          break;
+        case '-':
+          if (strcmp (argv[j], "--stats-json") == 0 && j+1 < argc)
+          {
+            j++;
+            StatsJSONFileName = argv[j];
+            WriteStatsJSON    = true;
+            break;
+          }
+
+          cerr << "**** INVALID PARAMETER '" << argv[j] << "' **** " << endl << endl;
+          PrintUsage (argv[0]);
+          exit (EXIT_FAILURE);
           break;
         default:
           cerr << "**** INVALID PARAMETER '" << argv[j][1] << "' **** " << endl << endl;
@@ -298,7 +340,7 @@ void ReadArgs (int argc, char *argv[])
 void PrintUsage (char* ApplicationName)
 {
   cout << "Usage: " << ApplicationName;
-  cout << " [-sr] [-e <epsilon>] [-m <min_points>]";
+  cout << " [-srn] [-e <epsilon>] [-m <min_points>] [--stats-json <file>]";
   cout << " -d <clustering_def.xml> -i <input_trace> -o <output_trace>";
   cout << endl;
 }
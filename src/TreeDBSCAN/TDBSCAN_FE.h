@@ -38,7 +38,7 @@
 #define HELP                                                                        \
    "\n"                                                                             \
    "Usage:\n"                                                                       \
-   "  %s [-s] -d <clustering_def.xml> -i <input_trace> -o <output_trace>\n"         \
+   "  %s [-sn] -d <clustering_def.xml> -i <input_trace> -o <output_trace>\n"         \
    "\n"                                                                             \
    "  -v|--version               Information about the tool\n"                      \
    "\n"                                                                             \
@@ -49,6 +49,9 @@
    "  -r                         Reconstruct the input trace adding the cluster\n"  \
    "                             information obtained\n"                            \
    "\n"                                                                             \
+   "  -n                         Summarize the noise points sent up the tree as\n"  \
+   "                             weighted cells of Epsilon/2 diagonal\n"            \
+   "\n"                                                                             \
    "  -d <clustering_def_xml>    XML containing the clustering process\n"           \
    "                             definition\n"                                      \
    "\n"                                                                             \
@@ -61,6 +64,9 @@
    "  -e <epsilon>               Specify the Epsilon for the density clustering\n"  \
    "\n"                                                                             \
    "  -m <min_points>            Specify the minimum points to form a cluster\n"    \
+   "\n"                                                                             \
+   "  --stats-json <file>        Write the time spent on each front-end phase\n"    \
+   "                             and its work counters to a JSON file\n"            \
    "\n"
 
 
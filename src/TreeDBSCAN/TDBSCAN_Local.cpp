@@ -0,0 +1,320 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include <types.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "TDBSCAN_Local.h"
+#include "TDBSCANLocal.h"
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+#include <cstring>
+
+#include <fstream>
+
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+#include <SelfProfilePRVGenerator.hpp>
+
+/* Configuration variables */
+double       Epsilon   = -1;
+int          MinPoints = -1;
+string       ClusteringDefinitionXML;  /* Clustering definition XML file name */
+string       InputTraceName;           /* Input trace name */
+string       OutputFileName;           /* Output trace name */
+bool         Verbose          = true;
+bool         ReconstructTrace = false;
+bool         SummarizeNoise   = false;
+bool         CompareNoise     = false;
+unsigned int Workers          = 0;     /* 0 = all available processors */
+unsigned int Fanout           = DEFAULT_FANOUT;
+string       StatsJSONFileName;        /* Phases and counters output */
+bool         WriteStatsJSON   = false;
+string       SelfTraceFileName;        /* Paraver trace of the analysis */
+bool         WriteSelfTrace   = false;
+
+/**
+ * The single-node application runs the whole TDBSCAN analysis in this
+ * process, using threads instead of an MRNet network.
+ * @param argc Number of arguments.
+ * @param argv Array of arguments.
+ * @return 0 on success; -1 otherwise.
+ */
+int main (int argc, char *argv[])
+{
+  /* Parse input argumens */
+  ReadArgs (argc, argv);
+
+  instrumentation::enabled = WriteStatsJSON;
+
+  if (WriteSelfTrace)
+  {
+    instrumentation::start_trace();
+  }
+
+  TDBSCANLocal Analysis (Epsilon,
+                         MinPoints,
+                         ClusteringDefinitionXML,
+                         InputTraceName,
+                         OutputFileName,
+                         Verbose,
+                         ReconstructTrace,
+                         Workers,
+                         Fanout,
+                         SummarizeNoise,
+                         CompareNoise);
+
+  if (!Analysis.Run())
+  {
+    cerr << "Error running the analysis: " << Analysis.GetLastError() << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (WriteStatsJSON &&
+      !instrumentation::write_json(StatsJSONFileName, "TDBSCAN_Local"))
+  {
+    cerr << "Error writing statistics file " << StatsJSONFileName << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (WriteSelfTrace)
+  {
+    SelfProfilePRVGenerator SelfTrace (SelfTraceFileName, "TDBSCAN_Local");
+
+    if (!SelfTrace.Run())
+    {
+      cerr << "Error writing self-profiling trace " << SelfTraceFileName << ": ";
+      cerr << SelfTrace.GetLastError() << endl;
+      exit (EXIT_FAILURE);
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Parse the input parameters.
+ * @param argc Number of arguments.
+ * @param argv Array of arguments.
+ */
+void ReadArgs (int argc, char *argv[])
+{
+  bool  ClusteringDefinitionRead = false;
+  bool  InputTraceNameRead       = false;
+  bool  OutputFileNameRead       = false;
+
+  INT32 j = 1;
+
+  if (argc == 1 ||
+      argc == 2 &&
+      ( (strcmp (argv[1], "-h") == 0) || (strcmp (argv[1], "--help") == 0) ) )
+  {
+    fprintf (stdout, HELP, argv[0], DEFAULT_FANOUT);
+    exit (EXIT_SUCCESS);
+  }
+
+  if (argc == 2 &&
+      ( (strcmp (argv[1], "-v") == 0 || (strcmp (argv[1], "--version") == 0) ) ) )
+  {
+    fprintf (stdout, ABOUT, argv[0], VERSION, __DATE__);
+    exit (EXIT_SUCCESS);
+  }
+
+  if (argv[1][0] == '-')
+  {
+    for (j = 1; (j < argc) && (argv[j][0] == '-'); j++)
+    {
+      switch (argv[j][1])
+      {
+        case 'd':
+          j++;
+          ClusteringDefinitionXML  = argv[j];
+          ClusteringDefinitionRead = true;
+          break;
+        case 'i':
+          j++;
+          InputTraceName     = argv[j];
+          InputTraceNameRead = true;
+          break;
+        case 'o':
+          j++;
+          OutputFileName     = argv[j];
+          OutputFileNameRead = true;
+          break;
+        case 's':
+          Verbose = false;
+          break;
+        case 'r':
+          ReconstructTrace = true;
+          break;
+        case 'n':
+          SummarizeNoise = true;
+          break;
+        case 'c':
+          CompareNoise = true;
+          break;
+        case 'e':
+          j++;
+          Epsilon = atof (argv[j]);
+
+          if (Epsilon <= 0)
+          {
+            cerr << "**** INVALID PARAMETER '-e " << argv[j] << "' **** " << endl << endl;
+            exit (EXIT_FAILURE);
+          }
+
+          break;
+        case 'm':
+          j++;
+          MinPoints = atoi (argv[j]);
+
+          if (MinPoints <= 0)
+          {
+            cerr << "**** INVALID PARAMETER '-m " << argv[j] << "' **** " << endl << endl;
+            exit (EXIT_FAILURE);
+          }
+
+          break;
+        case 'w':
+          j++;
+
+          if (atoi (argv[j]) <= 0)
+          {
+            cerr << "**** INVALID PARAMETER '-w " << argv[j] << "' **** " << endl << endl;
+            exit (EXIT_FAILURE);
+          }
+          Workers = atoi (argv[j]);
+
+          break;
+        case 'f':
+          j++;
+
+          if (atoi (argv[j]) < 2)
+          {
+            cerr << "**** INVALID PARAMETER '-f " << argv[j] << "' **** " << endl << endl;
+            exit (EXIT_FAILURE);
+          }
+          Fanout = atoi (argv[j]);
+
+          break;
+        case '-':
+          if (strcmp (argv[j], "--stats-json") == 0 && j+1 < argc)
+          {
+            j++;
+            StatsJSONFileName = argv[j];
+            WriteStatsJSON    = true;
+            break;
+          }
+
+          if (strcmp (argv[j], "--self-trace") == 0 && j+1 < argc)
+          {
+            j++;
+            SelfTraceFileName = argv[j];
+            WriteSelfTrace    = true;
+            break;
+          }
+
+          cerr << "**** INVALID PARAMETER '" << argv[j] << "' **** " << endl << endl;
+          PrintUsage (argv[0]);
+          exit (EXIT_FAILURE);
+          break;
+        default:
+          cerr << "**** INVALID PARAMETER '" << argv[j][1] << "' **** " << endl << endl;
+          PrintUsage (argv[0]);
+          exit (EXIT_FAILURE);
+          break;
+      }
+    }
+  }
+
+  if (!ClusteringDefinitionRead)
+  {
+    cerr << "Definition XML file missing ( \'-d\' parameter)" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (!InputTraceNameRead)
+  {
+    cerr << "Input trace missing ( \'-i\' parameter)" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (!OutputFileNameRead)
+  {
+    cerr << "Output data file file missing ( \'-o\' parameter)" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  if (CompareNoise && !SummarizeNoise)
+  {
+    cerr << "Noise summary comparison ( \'-c\' parameter) requires \'-n\'" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  /* Check the files exist and are readable */
+  std::ifstream fd_XML (ClusteringDefinitionXML.c_str() );
+
+  if (!fd_XML.good() )
+  {
+    cerr << "Definition XML file '" << ClusteringDefinitionXML << "' does not exist!" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  std::ifstream fd_Input (InputTraceName.c_str() );
+
+  if (!fd_Input.good() )
+  {
+    cerr << "Input trace '" << InputTraceName << "' does not exist!" << endl;
+    exit (EXIT_FAILURE);
+  }
+
+  return;
+}
+
+
+/**
+ * Print a help message.
+ */
+void PrintUsage (char* ApplicationName)
+{
+  cout << "Usage: " << ApplicationName;
+  cout << " [-srnc] [-e <epsilon>] [-m <min_points>] [-w <workers>] [-f <fan-out>]";
+  cout << " [--stats-json <file>] [--self-trace <file.prv>]";
+  cout << " -d <clustering_def.xml> -i <input_trace> -o <output_trace>";
+  cout << endl;
+}
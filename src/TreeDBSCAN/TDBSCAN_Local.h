@@ -0,0 +1,96 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef __TDBSCAN_LOCAL_MAIN_H__
+#define __TDBSCAN_LOCAL_MAIN_H__
+
+#define HELP                                                                        \
+   "\n"                                                                             \
+   "Usage:\n"                                                                       \
+   "  %s [-srnc] [-w <workers>] [-f <fan-out>] [--stats-json <file>]\n"             \
+   "     [--self-trace <file.prv>]\n"                                               \
+   "     -d <clustering_def.xml> -i <input_trace> -o <output_trace>\n"              \
+   "\n"                                                                             \
+   "  -v|--version               Information about the tool\n"                      \
+   "\n"                                                                             \
+   "  -h                         This help\n"                                       \
+   "\n"                                                                             \
+   "  -s                         Do not show information messages (silent mode)\n"  \
+   "\n"                                                                             \
+   "  -r                         Reconstruct the input trace adding the cluster\n"  \
+   "                             information obtained\n"                            \
+   "\n"                                                                             \
+   "  -n                         Summarize the noise points sent up the tree as\n"  \
+   "                             weighted cells of Epsilon/2 diagonal\n"            \
+   "\n"                                                                             \
+   "  -c                         With '-n', also build a model forwarding the\n"    \
+   "                             noise exactly, and report how many points\n"       \
+   "                             change their cluster and the noise of both\n"      \
+   "\n"                                                                             \
+   "  -d <clustering_def_xml>    XML containing the clustering process\n"           \
+   "                             definition\n"                                      \
+   "\n"                                                                             \
+   "  -i <input_file>            Input CSV / Dimemas trace / Paraver trace\n"       \
+   "\n"                                                                             \
+   "  -o <output_file>           Output CSV file / Dimemas trace / Paraver trace\n" \
+   "\n"                                                                             \
+   "  -e <epsilon>               Specify the Epsilon for the density clustering\n"  \
+   "\n"                                                                             \
+   "  -m <min_points>            Specify the minimum points to form a cluster\n"    \
+   "\n"                                                                             \
+   "  -w <workers>               Number of worker threads that cluster the data\n"  \
+   "                             (all available processors by default)\n"           \
+   "\n"                                                                             \
+   "  -f <fan-out>               Children of each node of the reduction tree\n"     \
+   "                             (%d by default)\n"                                 \
+   "\n"                                                                             \
+   "  --stats-json <file>        Write the time spent on each phase and the work\n" \
+   "                             counters of the analysis to a JSON file\n"         \
+   "\n"                                                                             \
+   "  --self-trace <file.prv>    Write a Paraver trace of the analysis itself,\n"   \
+   "                             with the phases run by each thread\n"              \
+   "\n"
+
+
+#define ABOUT                                            \
+   "%s v%s (%s)\n"                                       \
+   "(c) CEPBA-Tools - Barcelona Supercomputing Center\n" \
+   "Automatic clustering analysis of Paraver/Dimemas traces and CSV files\n"
+
+#define DEFAULT_FANOUT 8
+
+void ReadArgs  (int argc, char *argv[]);
+void PrintUsage(char* ApplicationName);
+
+#endif /* __TDBSCAN_LOCAL_MAIN_H__ */
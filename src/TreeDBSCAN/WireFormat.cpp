@@ -0,0 +1,535 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "WireFormat.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+enum
+{
+  WIRE_HULLS_SET = 1,
+  WIRE_NOISE_SET = 2
+};
+
+#define WIRE_MAX_LEVEL ((1ULL << WIRE_QUANTIZATION_BITS) - 1)
+
+static const unsigned char WireMagic[4] = { 'T', 'D', 'B', 'W' };
+
+
+/**
+ * Appends an unsigned integer using 7 bits per byte, least significant
+ * group first. The high bit of each byte marks that more bytes follow.
+ */
+static void PutVarint(vector<unsigned char> &Buffer, unsigned long long Value)
+{
+  while (Value >= 0x80)
+  {
+    Buffer.push_back((unsigned char) (Value | 0x80));
+    Value >>= 7;
+  }
+  Buffer.push_back((unsigned char) Value);
+}
+
+static bool GetVarint(const unsigned char *&Cursor, const unsigned char *End, unsigned long long &Value)
+{
+  unsigned int Shift = 0;
+
+  Value = 0;
+  while (Cursor < End && Shift < 64)
+  {
+    unsigned char Byte = *Cursor++;
+
+    Value |= ((unsigned long long) (Byte & 0x7f)) << Shift;
+    if ((Byte & 0x80) == 0)
+    {
+      return true;
+    }
+    Shift += 7;
+  }
+  return false;
+}
+
+/* Signed values are zig-zag encoded, so small magnitudes use few bytes */
+static void PutSigned(vector<unsigned char> &Buffer, long long Value)
+{
+  PutVarint(Buffer, ((unsigned long long) Value << 1) ^ (unsigned long long) (Value >> 63));
+}
+
+static bool GetSigned(const unsigned char *&Cursor, const unsigned char *End, long long &Value)
+{
+  unsigned long long Raw;
+
+  if (!GetVarint(Cursor, End, Raw))
+  {
+    return false;
+  }
+
+  Value = (long long) (Raw >> 1) ^ -((long long) (Raw & 1));
+  return true;
+}
+
+/* Doubles are stored with their IEEE 754 bits, little-endian */
+static void PutDouble(vector<unsigned char> &Buffer, double Value)
+{
+  unsigned long long Bits;
+
+  memcpy(&Bits, &Value, sizeof(Bits));
+  for (int i = 0; i < 8; i++)
+  {
+    Buffer.push_back((unsigned char) (Bits >> (8*i)));
+  }
+}
+
+static bool GetDouble(const unsigned char *&Cursor, const unsigned char *End, double &Value)
+{
+  unsigned long long Bits = 0;
+
+  if (End - Cursor < 8)
+  {
+    return false;
+  }
+
+  for (int i = 0; i < 8; i++)
+  {
+    Bits |= ((unsigned long long) Cursor[i]) << (8*i);
+  }
+  Cursor += 8;
+
+  memcpy(&Value, &Bits, sizeof(Value));
+  return true;
+}
+
+
+/**
+ * Computes, per dimension, the minimum value and the quantization step of
+ * a set of points stored in a linear array.
+ * @param Values Coordinates of the points, one point after the other.
+ * @param Dimensions Number of dimensions of each point.
+ * @param Min Minimum value of each dimension.
+ * @param Step Quantization step of each dimension (0 if the range is empty).
+ */
+static void ComputeRanges(vector<double> &Values,
+                          size_t          Dimensions,
+                          vector<double> &Min,
+                          vector<double> &Step)
+{
+  vector<double> Max;
+
+  Min.assign(Dimensions, 0);
+  Max.assign(Dimensions, 0);
+  Step.assign(Dimensions, 0);
+
+  for (size_t i = 0; i < Values.size(); i++)
+  {
+    size_t Dim = i % Dimensions;
+
+    if (i < Dimensions || Values[i] < Min[Dim]) Min[Dim] = Values[i];
+    if (i < Dimensions || Values[i] > Max[Dim]) Max[Dim] = Values[i];
+  }
+
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    Step[Dim] = (Max[Dim] - Min[Dim]) / (double) WIRE_MAX_LEVEL;
+  }
+}
+
+static unsigned long long Quantize(double Value, double Min, double Step)
+{
+  double Level;
+
+  if (Step <= 0)
+  {
+    return 0;
+  }
+
+  Level = floor((Value - Min) / Step + 0.5);
+
+  if (Level < 0)                       return 0;
+  if (Level > (double) WIRE_MAX_LEVEL) return WIRE_MAX_LEVEL;
+
+  return (unsigned long long) Level;
+}
+
+static void PutHeader(vector<unsigned char> &Buffer,
+                      int                    Kind,
+                      size_t                 Items,
+                      size_t                 Dimensions,
+                      vector<double>        &Min,
+                      vector<double>        &Step)
+{
+  Buffer.insert(Buffer.end(), WireMagic, WireMagic + sizeof(WireMagic));
+  Buffer.push_back((unsigned char) WIRE_FORMAT_VERSION);
+  Buffer.push_back((unsigned char) Kind);
+
+  PutVarint(Buffer, Items);
+  PutVarint(Buffer, Dimensions);
+
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    PutDouble(Buffer, Min[Dim]);
+    PutDouble(Buffer, Step[Dim]);
+  }
+}
+
+static bool GetHeader(const unsigned char *&Cursor,
+                      const unsigned char  *End,
+                      int                   Kind,
+                      size_t               &Items,
+                      size_t               &Dimensions,
+                      vector<double>       &Min,
+                      vector<double>       &Step)
+{
+  unsigned long long Value;
+
+  if (End - Cursor < (long) sizeof(WireMagic) + 2 ||
+      memcmp(Cursor, WireMagic, sizeof(WireMagic)) != 0)
+  {
+    return false;
+  }
+  Cursor += sizeof(WireMagic);
+
+  /* Only the current version is understood */
+  if (*Cursor++ != WIRE_FORMAT_VERSION || *Cursor++ != Kind)
+  {
+    return false;
+  }
+
+  if (!GetVarint(Cursor, End, Value)) return false;
+  Items = (size_t) Value;
+
+  if (!GetVarint(Cursor, End, Value)) return false;
+  Dimensions = (size_t) Value;
+
+  /* Each item takes at least one byte per dimension */
+  if (Items > (size_t) (End - Cursor) ||
+      Dimensions > (size_t) (End - Cursor) / 16 ||
+      (Items > 0 && Dimensions == 0))
+  {
+    return false;
+  }
+
+  Min.resize(Dimensions);
+  Step.resize(Dimensions);
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    if (!GetDouble(Cursor, End, Min[Dim]) || !GetDouble(Cursor, End, Step[Dim]))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/**
+ * Encodes a set of hulls in a single buffer.
+ * @param Hulls The hulls to encode. All of them must have the same dimensions.
+ * @param Buffer Output buffer, the encoded set is appended.
+ * @return true on success; false if the hulls dimensions differ.
+ */
+bool EncodeHulls(vector<HullModel*>    &Hulls,
+                 vector<unsigned char> &Buffer)
+{
+  vector<long long>  Densities, TotalTimes, Instances, NeighbourhoodSizes;
+  vector<int>        PointsPerHull;
+  vector<double>     Values, Min, Step;
+  vector<long long>  Previous;
+  long long          PreviousInstance = 0;
+  size_t             Dimensions       = 0;
+  size_t             Point            = 0;
+
+  for (size_t i = 0; i < Hulls.size(); i++)
+  {
+    long long  Density=0, TotalTime=0;
+    int        NumberOfPoints=0, NumberOfDimensions=0;
+    long long *HullInstances=NULL, *HullNeighbourhoodSizes=NULL;
+    double    *DimensionsValues=NULL;
+
+    Hulls[i]->Serialize(Density,
+                        TotalTime,
+                        NumberOfPoints,
+                        NumberOfDimensions,
+                        HullInstances,
+                        HullNeighbourhoodSizes,
+                        DimensionsValues);
+
+    if (i == 0)
+    {
+      Dimensions = NumberOfDimensions;
+    }
+
+    if ((size_t) NumberOfDimensions != Dimensions)
+    {
+      free(HullInstances);
+      free(HullNeighbourhoodSizes);
+      free(DimensionsValues);
+      return false;
+    }
+
+    Densities.push_back(Density);
+    TotalTimes.push_back(TotalTime);
+    PointsPerHull.push_back(NumberOfPoints);
+
+    Instances.insert(Instances.end(), HullInstances, HullInstances + NumberOfPoints);
+    NeighbourhoodSizes.insert(NeighbourhoodSizes.end(), HullNeighbourhoodSizes, HullNeighbourhoodSizes + NumberOfPoints);
+    Values.insert(Values.end(), DimensionsValues, DimensionsValues + (NumberOfPoints * NumberOfDimensions));
+
+    free(HullInstances);
+    free(HullNeighbourhoodSizes);
+    free(DimensionsValues);
+  }
+
+  ComputeRanges(Values, Dimensions, Min, Step);
+  PutHeader(Buffer, WIRE_HULLS_SET, Hulls.size(), Dimensions, Min, Step);
+
+  Previous.assign(Dimensions, 0);
+  for (size_t i = 0; i < Hulls.size(); i++)
+  {
+    PutSigned(Buffer, Densities[i]);
+    PutSigned(Buffer, TotalTimes[i]);
+    PutVarint(Buffer, PointsPerHull[i]);
+
+    for (int j = 0; j < PointsPerHull[i]; j++, Point++)
+    {
+      PutSigned(Buffer, Instances[Point] - PreviousInstance);
+      PutSigned(Buffer, NeighbourhoodSizes[Point]);
+      PreviousInstance = Instances[Point];
+
+      for (size_t Dim = 0; Dim < Dimensions; Dim++)
+      {
+        long long Level = (long long) Quantize(Values[Point*Dimensions + Dim], Min[Dim], Step[Dim]);
+
+        PutSigned(Buffer, Level - Previous[Dim]);
+        Previous[Dim] = Level;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+/**
+ * Decodes a set of hulls encoded with EncodeHulls.
+ * @param Buffer The encoded set.
+ * @param Size Size of the buffer in bytes.
+ * @param Hulls Output vector, the decoded hulls are appended.
+ * @return true on success; false if the buffer is not a valid set of hulls.
+ */
+bool DecodeHulls(const unsigned char *Buffer,
+                 size_t               Size,
+                 vector<HullModel*>  &Hulls)
+{
+  const unsigned char *Cursor = Buffer, *End = Buffer + Size;
+  size_t               Items, Dimensions;
+  vector<double>       Min, Step;
+  vector<long long>    Previous;
+  long long            PreviousInstance = 0;
+
+  if (Buffer == NULL || !GetHeader(Cursor, End, WIRE_HULLS_SET, Items, Dimensions, Min, Step))
+  {
+    return false;
+  }
+
+  Previous.assign(Dimensions, 0);
+  for (size_t i = 0; i < Items; i++)
+  {
+    long long          Density, TotalTime;
+    unsigned long long NumberOfPoints;
+    vector<long long>  Instances, NeighbourhoodSizes;
+    vector<double>     Values;
+
+    if (!GetSigned(Cursor, End, Density) ||
+        !GetSigned(Cursor, End, TotalTime) ||
+        !GetVarint(Cursor, End, NumberOfPoints) ||
+        NumberOfPoints > (unsigned long long) (End - Cursor))
+    {
+      return false;
+    }
+
+    Instances.resize(NumberOfPoints);
+    NeighbourhoodSizes.resize(NumberOfPoints);
+    Values.resize(NumberOfPoints * Dimensions);
+
+    for (size_t j = 0; j < NumberOfPoints; j++)
+    {
+      long long Delta;
+
+      if (!GetSigned(Cursor, End, Delta) ||
+          !GetSigned(Cursor, End, NeighbourhoodSizes[j]))
+      {
+        return false;
+      }
+      Instances[j]     = PreviousInstance + Delta;
+      PreviousInstance = Instances[j];
+
+      for (size_t Dim = 0; Dim < Dimensions; Dim++)
+      {
+        if (!GetSigned(Cursor, End, Delta))
+        {
+          return false;
+        }
+        Previous[Dim]               += Delta;
+        Values[j*Dimensions + Dim]   = Min[Dim] + Previous[Dim] * Step[Dim];
+      }
+    }
+
+    Hulls.push_back(new HullModel(Density,
+                                  TotalTime,
+                                  (int) NumberOfPoints,
+                                  (int) Dimensions,
+                                  (NumberOfPoints > 0 ? &Instances[0] : NULL),
+                                  (NumberOfPoints > 0 ? &NeighbourhoodSizes[0] : NULL),
+                                  (NumberOfPoints > 0 ? &Values[0] : NULL)));
+  }
+
+  return true;
+}
+
+
+/**
+ * Encodes a set of noise points and their durations in a single buffer.
+ * @param Points The noise points.
+ * @param Durations Duration of each point.
+ * @param Weights Number of points each one stands for (empty means 1 for all).
+ * @param Buffer Output buffer, the encoded set is appended.
+ * @return true on success; false if the points dimensions differ.
+ */
+bool EncodeNoise(vector<const Point*>  &Points,
+                 vector<long long>     &Durations,
+                 vector<long long>     &Weights,
+                 vector<unsigned char> &Buffer)
+{
+  size_t            Dimensions = (Points.size() > 0 ? Points[0]->size() : 0);
+  vector<double>    Values, Min, Step;
+  vector<long long> Previous;
+
+  if (Durations.size() != Points.size() ||
+      (Weights.size() > 0 && Weights.size() != Points.size()))
+  {
+    return false;
+  }
+
+  Values.reserve(Points.size() * Dimensions);
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    if (Points[i]->size() != Dimensions)
+    {
+      return false;
+    }
+
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      Values.push_back((*Points[i])[Dim]);
+    }
+  }
+
+  ComputeRanges(Values, Dimensions, Min, Step);
+  PutHeader(Buffer, WIRE_NOISE_SET, Points.size(), Dimensions, Min, Step);
+
+  Previous.assign(Dimensions, 0);
+  for (size_t i = 0; i < Points.size(); i++)
+  {
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      long long Level = (long long) Quantize(Values[i*Dimensions + Dim], Min[Dim], Step[Dim]);
+
+      PutSigned(Buffer, Level - Previous[Dim]);
+      Previous[Dim] = Level;
+    }
+    PutSigned(Buffer, Durations[i]);
+    PutVarint(Buffer, (Weights.size() > 0 ? Weights[i] : 1));
+  }
+
+  return true;
+}
+
+
+/**
+ * Decodes a set of noise points encoded with EncodeNoise.
+ * @param Buffer The encoded set.
+ * @param Size Size of the buffer in bytes.
+ * @param Points Output vector, the decoded points are appended.
+ * @param Durations Output vector, the duration of each decoded point is appended.
+ * @param Weights Output vector, the weight of each decoded point is appended.
+ * @return true on success; false if the buffer is not a valid set of points.
+ */
+bool DecodeNoise(const unsigned char  *Buffer,
+                 size_t                Size,
+                 vector<const Point*> &Points,
+                 vector<long long>    &Durations,
+                 vector<long long>    &Weights)
+{
+  const unsigned char *Cursor = Buffer, *End = Buffer + Size;
+  size_t               Items, Dimensions;
+  vector<double>       Min, Step;
+  vector<long long>    Previous;
+
+  if (Buffer == NULL || !GetHeader(Cursor, End, WIRE_NOISE_SET, Items, Dimensions, Min, Step))
+  {
+    return false;
+  }
+
+  Previous.assign(Dimensions, 0);
+  for (size_t i = 0; i < Items; i++)
+  {
+    vector<double>     PointDimensions (Dimensions);
+    long long          Value;
+    unsigned long long Weight;
+
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      if (!GetSigned(Cursor, End, Value))
+      {
+        return false;
+      }
+      Previous[Dim]       += Value;
+      PointDimensions[Dim] = Min[Dim] + Previous[Dim] * Step[Dim];
+    }
+
+    if (!GetSigned(Cursor, End, Value) || !GetVarint(Cursor, End, Weight))
+    {
+      return false;
+    }
+
+    Points.push_back(new Point(PointDimensions));
+    Durations.push_back(Value);
+    Weights.push_back((long long) Weight);
+  }
+
+  return true;
+}
@@ -0,0 +1,76 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef __WIRE_FORMAT_H__
+#define __WIRE_FORMAT_H__
+
+#include <vector>
+#include <libDistributedClustering.hpp>
+
+using std::vector;
+
+/* Binary encoding of the hull sets and noise sets exchanged between the
+ * nodes of the tree. It does not depend on the communication layer, so any
+ * transport can carry the buffers as plain byte arrays.
+ *
+ * Every buffer starts with a header: the magic "TDBW", the format version,
+ * the kind of set, the number of items and dimensions and, per dimension,
+ * the minimum value and the quantization step. Coordinates are quantized to
+ * WIRE_QUANTIZATION_BITS over the range of the set, and they are stored
+ * (as the instances) as deltas with respect to the previous point, using
+ * variable-length integers. Noise points carry their duration and the
+ * number of points they stand for (1 unless the noise is summarized). */
+
+#define WIRE_FORMAT_VERSION    2
+#define WIRE_QUANTIZATION_BITS 32
+
+bool EncodeHulls(vector<HullModel*>    &Hulls,
+                 vector<unsigned char> &Buffer);
+
+bool DecodeHulls(const unsigned char *Buffer,
+                 size_t               Size,
+                 vector<HullModel*>  &Hulls);
+
+bool EncodeNoise(vector<const Point*>  &Points,
+                 vector<long long>     &Durations,
+                 vector<long long>     &Weights,
+                 vector<unsigned char> &Buffer);
+
+bool DecodeNoise(const unsigned char  *Buffer,
+                 size_t                Size,
+                 vector<const Point*> &Points,
+                 vector<long long>    &Durations,
+                 vector<long long>    &Weights);
+
+#endif /* __WIRE_FORMAT_H__ */
@@ -29,6 +29,7 @@
 #include <cstdlib>						// C standard lib defs
 #include <ANN/ANNx.h>					// all ANN includes
 #include <ANN/ANNperf.h>				// ANN performance 
+#include <DistanceKernels.hpp>			// unrolled squared distances
 
 using namespace std;					// make std:: accessible
 
@@ -48,19 +49,10 @@ ANNdist annDist(						// interpoint squared distance
 	ANNpoint			p,
 	ANNpoint			q)
 {
-	register int d;
-	register ANNcoord diff;
-	register ANNcoord dist;
-
-	dist = 0;
-	for (d = 0; d < dim; d++) {
-		diff = p[d] - q[d];
-		dist = ANN_SUM(dist, ANN_POW(diff));
-	}
 	ANN_FLOP(3*dim)					// performance counts
 	ANN_PTS(1)
 	ANN_COORD(dim)
-	return dist;
+	return SquaredEuclideanDistance(p, q, dim);
 }
 
 //----------------------------------------------------------------------
@@ -188,7 +180,7 @@ void annError(const char* msg, ANNerr level)
 //----------------------------------------------------------------------
 
 int	ANNmaxPtsVisited = 0;	// maximum number of pts visited
-int	ANNptsVisited;			// number of pts visited in search
+ANN_THREAD_LOCAL int	ANNptsVisited;			// number of pts visited in search
 
 //----------------------------------------------------------------------
 //	Global function declarations
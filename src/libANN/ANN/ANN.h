@@ -85,6 +85,18 @@
   #define DLL_API
 #endif
 
+//----------------------------------------------------------------------
+//  ANN_THREAD_LOCAL
+//  The searches keep their state in global variables to shorten the
+//  argument lists. These variables are thread local, so the same or
+//  different trees can be searched from several threads at once.
+//----------------------------------------------------------------------
+#if defined(__GNUC__)
+  #define ANN_THREAD_LOCAL __thread
+#else
+  #define ANN_THREAD_LOCAL
+#endif
+
 //----------------------------------------------------------------------
 //  basic includes
 //----------------------------------------------------------------------
@@ -153,9 +165,19 @@ enum ANNbool {ANNfalse = 0, ANNtrue = 1}; // ANN boolean type (non ANSI C++)
 //
 //		It is the user's responsibility to make sure that overflow does
 //		not occur in distance calculation.
+//
+//		ClusteringSuite builds configured with '--enable-single-precision'
+//		keep the coordinates of the points and the tree in float, halving
+//		the memory of the spatial indexes. The squared distances between
+//		points are then accumulated in float too (see 'DistanceKernels.hpp'),
+//		and only widened to ANNdist when compared or returned.
 //----------------------------------------------------------------------
 
+#ifdef CLUSTERING_SINGLE_PRECISION
+typedef float	ANNcoord;				// coordinate data type
+#else
 typedef double	ANNcoord;				// coordinate data type
+#endif
 typedef double	ANNdist;				// distance data type
 
 //----------------------------------------------------------------------
@@ -328,6 +350,9 @@ const ANNbool	ANN_ALLOW_SELF_MATCH	= ANNtrue;
 //
 //		By default the Euclidean norm is assumed.  To change the norm,
 //		uncomment the appropriate set of macros below.
+//		The distances of the leaf nodes and 'annDist' are computed by
+//		the Euclidean kernels of 'DistanceKernels.hpp', that must be
+//		replaced as well.
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
@@ -818,6 +843,9 @@ public:
 //	Other functions
 //	annMaxPtsVisit		Sets a limit on the maximum number of points
 //						to visit in the search.
+//	annkFRPtsVisited	Points visited (distances evaluated) by the
+//						last fixed-radius search of the calling thread.
+//	annkFRNodesVisited	Tree nodes visited by the same search.
 //  annClose			Can be called when all use of ANN is finished.
 //						It clears up a minor memory leak.
 //----------------------------------------------------------------------
@@ -825,6 +853,10 @@ public:
 DLL_API void annMaxPtsVisit(	// max. pts to visit in search
 	int				maxPts);	// the limit
 
+DLL_API int annkFRPtsVisited();	// pts visited in last FR search
+
+DLL_API int annkFRNodesVisited();	// nodes visited in last FR search
+
 DLL_API void annClose();		// called to end use of ANN
 
 #endif
@@ -58,4 +58,5 @@ void ANNbd_shrink::ann_FR_search(ANNdist box_dist)
 	}
 	ANN_FLOP(3*n_bnds)							// increment floating ops
 	ANN_SHR(1)									// one more shrinking node
+	ANNkdFRNodesVisited++;						// one more node visited
 }
@@ -23,6 +23,7 @@
 //----------------------------------------------------------------------
 
 #include "kd_fix_rad_search.h"			// kd fixed-radius search decls
+#include <DistanceKernels.hpp>			// unrolled squared distances
 
 //----------------------------------------------------------------------
 //	Approximate fixed-radius k nearest neighbor search
@@ -42,14 +43,15 @@
 //		These are given below.
 //----------------------------------------------------------------------
 
-int				ANNkdFRDim;				// dimension of space
-ANNpoint		ANNkdFRQ;				// query point
-ANNdist			ANNkdFRSqRad;			// squared radius search bound
-double			ANNkdFRMaxErr;			// max tolerable squared error
-ANNpointArray	ANNkdFRPts;				// the points
-ANNmin_k*		ANNkdFRPointMK;			// set of k closest points
-int				ANNkdFRPtsVisited;		// total points visited
-int				ANNkdFRPtsInRange;		// number of points in the range
+ANN_THREAD_LOCAL int				ANNkdFRDim;				// dimension of space
+ANN_THREAD_LOCAL ANNpoint		ANNkdFRQ;				// query point
+ANN_THREAD_LOCAL ANNdist			ANNkdFRSqRad;			// squared radius search bound
+ANN_THREAD_LOCAL double			ANNkdFRMaxErr;			// max tolerable squared error
+ANN_THREAD_LOCAL ANNpointArray	ANNkdFRPts;				// the points
+ANN_THREAD_LOCAL ANNmin_k*		ANNkdFRPointMK;			// set of k closest points
+ANN_THREAD_LOCAL int				ANNkdFRPtsVisited;		// total points visited
+ANN_THREAD_LOCAL int				ANNkdFRNodesVisited;	// total nodes visited
+ANN_THREAD_LOCAL int				ANNkdFRPtsInRange;		// number of points in the range
 
 //----------------------------------------------------------------------
 //	annkFRSearch - fixed radius search for k nearest neighbors
@@ -68,6 +70,7 @@ int ANNkd_tree::annkFRSearch(
 	ANNkdFRSqRad = sqRad;
 	ANNkdFRPts = pts;
 	ANNkdFRPtsVisited = 0;				// initialize count of points visited
+	ANNkdFRNodesVisited = 0;			// ...and nodes visited
 	ANNkdFRPtsInRange = 0;				// ...and points in the range
 
 	ANNkdFRMaxErr = ANN_POW(1.0 + eps);
@@ -137,6 +140,7 @@ void ANNkd_split::ann_FR_search(ANNdist box_dist)
 	}
 	ANN_FLOP(13)						// increment floating ops
 	ANN_SPL(1)							// one more splitting node visited
+	ANNkdFRNodesVisited++;				// increment number of nodes visited
 }
 
 //----------------------------------------------------------------------
@@ -148,29 +152,14 @@ void ANNkd_split::ann_FR_search(ANNdist box_dist)
 void ANNkd_leaf::ann_FR_search(ANNdist box_dist)
 {
 	register ANNdist dist;				// distance to data point
-	register ANNcoord* pp;				// data coordinate pointer
-	register ANNcoord* qq;				// query coordinate pointer
-	register ANNcoord t;
-	register int d;
 
 	for (int i = 0; i < n_pts; i++) {	// check points in bucket
+										// squared distance to the point
+		dist = SquaredEuclideanDistance(ANNkdFRQ, ANNkdFRPts[bkt[i]], ANNkdFRDim);
+		ANN_COORD(ANNkdFRDim)				// coordinates hit
+		ANN_FLOP(5*ANNkdFRDim)			// increment floating ops
 
-		pp = ANNkdFRPts[bkt[i]];		// first coord of next data point
-		qq = ANNkdFRQ;					// first coord of query point
-		dist = 0;
-
-		for(d = 0; d < ANNkdFRDim; d++) {
-			ANN_COORD(1)				// one more coordinate hit
-			ANN_FLOP(5)					// increment floating ops
-
-			t = *(qq++) - *(pp++);		// compute length and adv coordinate
-										// exceeds dist to k-th smallest?
-			if( (dist = ANN_SUM(dist, ANN_POW(t))) > ANNkdFRSqRad) {
-				break;
-			}
-		}
-
-		if (d >= ANNkdFRDim &&					// among the k best?
+		if (dist <= ANNkdFRSqRad &&			// within the radius?
 		   (ANN_ALLOW_SELF_MATCH || dist!=0)) { // and no self-match problem
 												// add it to the list
 			ANNkdFRPointMK->insert(dist, bkt[i]);
@@ -180,4 +169,20 @@ void ANNkd_leaf::ann_FR_search(ANNdist box_dist)
 	ANN_LEAF(1)							// one more leaf node visited
 	ANN_PTS(n_pts)						// increment points visited
 	ANNkdFRPtsVisited += n_pts;			// increment number of points visited
+	ANNkdFRNodesVisited++;				// increment number of nodes visited
+}
+
+//----------------------------------------------------------------------
+//	annkFRPtsVisited, annkFRNodesVisited - work done by the last
+//		fixed-radius search of the calling thread
+//----------------------------------------------------------------------
+
+int annkFRPtsVisited()
+{
+	return ANNkdFRPtsVisited;
+}
+
+int annkFRNodesVisited()
+{
+	return ANNkdFRNodesVisited;
 }
@@ -39,6 +39,7 @@
 //		procedures.
 //----------------------------------------------------------------------
 
-extern ANNpoint			ANNkdFRQ;			// query point (static copy)
+extern ANN_THREAD_LOCAL ANNpoint			ANNkdFRQ;			// query point (static copy)
+extern ANN_THREAD_LOCAL int				ANNkdFRNodesVisited;	// total nodes visited
 
 #endif
@@ -23,6 +23,7 @@
 //----------------------------------------------------------------------
 
 #include "kd_pr_search.h"				// kd priority search declarations
+#include <DistanceKernels.hpp>			// unrolled squared distances
 
 //----------------------------------------------------------------------
 //	Approximate nearest neighbor searching by priority search.
@@ -72,13 +73,13 @@
 //		These are given below.
 //----------------------------------------------------------------------
 
-double			ANNprEps;				// the error bound
-int				ANNprDim;				// dimension of space
-ANNpoint		ANNprQ;					// query point
-double			ANNprMaxErr;			// max tolerable squared error
-ANNpointArray	ANNprPts;				// the points
-ANNpr_queue		*ANNprBoxPQ;			// priority queue for boxes
-ANNmin_k		*ANNprPointMK;			// set of k closest points
+ANN_THREAD_LOCAL double			ANNprEps;				// the error bound
+ANN_THREAD_LOCAL int				ANNprDim;				// dimension of space
+ANN_THREAD_LOCAL ANNpoint		ANNprQ;					// query point
+ANN_THREAD_LOCAL double			ANNprMaxErr;			// max tolerable squared error
+ANN_THREAD_LOCAL ANNpointArray	ANNprPts;				// the points
+ANN_THREAD_LOCAL ANNpr_queue		*ANNprBoxPQ;			// priority queue for boxes
+ANN_THREAD_LOCAL ANNmin_k		*ANNprPointMK;			// set of k closest points
 
 //----------------------------------------------------------------------
 //	annkPriSearch - priority search for k nearest neighbors
@@ -181,32 +182,17 @@ void ANNkd_split::ann_pri_search(ANNdist box_dist)
 void ANNkd_leaf::ann_pri_search(ANNdist box_dist)
 {
 	register ANNdist dist;				// distance to data point
-	register ANNcoord* pp;				// data coordinate pointer
-	register ANNcoord* qq;				// query coordinate pointer
 	register ANNdist min_dist;			// distance to k-th closest point
-	register ANNcoord t;
-	register int d;
 
 	min_dist = ANNprPointMK->max_key(); // k-th smallest distance so far
 
 	for (int i = 0; i < n_pts; i++) {	// check points in bucket
+										// squared distance to the point
+		dist = SquaredEuclideanDistance(ANNprQ, ANNprPts[bkt[i]], ANNprDim);
+		ANN_COORD(ANNprDim)				// coordinates hit
+		ANN_FLOP(4*ANNprDim)			// increment floating ops
 
-		pp = ANNprPts[bkt[i]];			// first coord of next data point
-		qq = ANNprQ;					// first coord of query point
-		dist = 0;
-
-		for(d = 0; d < ANNprDim; d++) {
-			ANN_COORD(1)				// one more coordinate hit
-			ANN_FLOP(4)					// increment floating ops
-
-			t = *(qq++) - *(pp++);		// compute length and adv coordinate
-										// exceeds dist to k-th smallest?
-			if( (dist = ANN_SUM(dist, ANN_POW(t))) > min_dist) {
-				break;
-			}
-		}
-
-		if (d >= ANNprDim &&					// among the k best?
+		if (dist <= min_dist &&					// among the k best?
 		   (ANN_ALLOW_SELF_MATCH || dist!=0)) { // and no self-match problem
 												// add it to the list
 			ANNprPointMK->insert(dist, bkt[i]);
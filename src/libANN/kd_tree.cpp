@@ -266,8 +266,16 @@ void ANNkd_tree::SkeletonTree(			// construct skeleton tree
 	}
 
 	bnd_box_lo = bnd_box_hi = NULL;		// bounding box is nonexistent
-	if (KD_TRIVIAL == NULL)				// no trivial leaf node yet?
+	if (KD_TRIVIAL == NULL) {			// no trivial leaf node yet?
+#if defined(__GNUC__)
+		// trees may be built from several threads, keep just one leaf
+		ANNkd_leaf *trivial = new ANNkd_leaf(0, IDX_TRIVIAL);
+		if (!__sync_bool_compare_and_swap(&KD_TRIVIAL, (ANNkd_leaf*) NULL, trivial))
+			delete trivial;
+#else
 		KD_TRIVIAL = new ANNkd_leaf(0, IDX_TRIVIAL);	// allocate it
+#endif
+	}
 }
 
 ANNkd_tree::ANNkd_tree(					// basic constructor
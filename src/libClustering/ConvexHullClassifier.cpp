@@ -40,9 +40,23 @@ using cepba_tools::system_messages;
 using std::ostringstream;
 
 #include <cassert>
+#include <cmath>
 
 #include "ConvexHullClassifier.hpp"
 
+/* Grid cell of a coordinate, clamped to the grid limits */
+static inline size_t GetCell(double Value, double Min, double Width, size_t Cells)
+{
+  size_t Cell;
+
+  if (Width <= 0 || Value <= Min)
+    return 0;
+
+  Cell = (size_t) ((Value - Min) / Width);
+
+  return (Cell < Cells ? Cell : Cells-1);
+}
+
 bool ConvexHullClassifier::Classify(vector<const Point*>& Data,
                                     Partition&            DataPartition)
 {
@@ -52,38 +66,136 @@ bool ConvexHullClassifier::Classify(vector<const Point*>& Data,
 
 bool ConvexHullClassifier::Classify(const Point* QueryPoint, cluster_id_t& ID)
 {
-  ostringstream Message;
-  ID = NOISE_CLUSTERID;
-
-  double MinSqDistance = MAX_DOUBLE;
-
   if (QueryPoint == NULL)
   {
+    ID = NOISE_CLUSTERID;
     SetErrorMessage("no point to classify!");
     SetError(true);
     return false;
   }
 
-  /* To improve the search, first we just look using the inclusion */
+  ID = ClassifyPoint(QueryPoint);
+
+  return true;
+}
+
+/* Computes the inflated bounding boxes of the hulls and distributes them over
+ * a grid of about one cell per hull */
+void ConvexHullClassifier::BuildIndex(void)
+{
+  double GridMaxX = -MAX_DOUBLE, GridMaxY = -MAX_DOUBLE;
+  bool   AnyValid = false;
+
+  GridMinX    = GridMinY   = MAX_DOUBLE;
+  CellWidth   = CellHeight = 0;
+  GridColumns = GridRows   = 0;
+
+  Bounds.resize(HullModels.size());
+
+  for (size_t i = 0; i < HullModels.size(); i++)
+  {
+    ConvexHullBounds &Box = Bounds[i];
+
+    Box.Valid = HullModels[i].GetBoundingBox(Box.MinX, Box.MinY, Box.MaxX, Box.MaxY);
+
+    if (!Box.Valid)
+      continue;
+
+    Box.MinX -= Eps;
+    Box.MinY -= Eps;
+    Box.MaxX += Eps;
+    Box.MaxY += Eps;
+
+    if (Box.MinX < GridMinX) GridMinX = Box.MinX;
+    if (Box.MinY < GridMinY) GridMinY = Box.MinY;
+    if (Box.MaxX > GridMaxX) GridMaxX = Box.MaxX;
+    if (Box.MaxY > GridMaxY) GridMaxY = Box.MaxY;
+
+    AnyValid = true;
+  }
+
+  if (!AnyValid)
+  {
+    GridCells.clear();
+    return;
+  }
+
+  GridColumns = GridRows = (size_t) ceil(sqrt((double) HullModels.size()));
+  CellWidth   = (GridMaxX - GridMinX) / GridColumns;
+  CellHeight  = (GridMaxY - GridMinY) / GridRows;
+
+  GridCells.assign(GridColumns*GridRows, vector<size_t> ());
+
   for (size_t i = 0; i < HullModels.size(); i++)
   {
-    if (HullModels[i].IsInside(QueryPoint))
+    size_t FirstColumn, LastColumn, FirstRow, LastRow;
+
+    if (!Bounds[i].Valid)
+      continue;
+
+    FirstColumn = GetCell(Bounds[i].MinX, GridMinX, CellWidth,  GridColumns);
+    LastColumn  = GetCell(Bounds[i].MaxX, GridMinX, CellWidth,  GridColumns);
+    FirstRow    = GetCell(Bounds[i].MinY, GridMinY, CellHeight, GridRows);
+    LastRow     = GetCell(Bounds[i].MaxY, GridMinY, CellHeight, GridRows);
+
+    for (size_t Row = FirstRow; Row <= LastRow; Row++)
     {
-      ID    = (cluster_id_t) i+1;
-      return true;
+      for (size_t Column = FirstColumn; Column <= LastColumn; Column++)
+      {
+        GridCells[Row*GridColumns + Column].push_back(i);
+      }
+    }
+  }
+}
+
+/* Same criteria as the exhaustive search: the first hull (in order) that
+ * includes the point, otherwise the closest hull within Eps with enough
+ * density. Only the hulls registered in the cell of the point are checked,
+ * in the same order, so the result does not change */
+cluster_id_t ConvexHullClassifier::ClassifyPoint(const Point* QueryPoint)
+{
+  cluster_id_t ID            = NOISE_CLUSTERID;
+  double       MinSqDistance = MAX_DOUBLE;
+  double       X, Y;
+  size_t       Column, Row;
+
+  if (QueryPoint == NULL || GridCells.size() == 0)
+  {
+    return NOISE_CLUSTERID;
+  }
+
+  X = (*QueryPoint)[0];
+  Y = (*QueryPoint)[1];
+
+  Column = GetCell(X, GridMinX, CellWidth,  GridColumns);
+  Row    = GetCell(Y, GridMinY, CellHeight, GridRows);
+
+  vector<size_t>& Candidates = GridCells[Row*GridColumns + Column];
+
+  /* To improve the search, first we just look using the inclusion */
+  for (size_t j = 0; j < Candidates.size(); j++)
+  {
+    size_t i = Candidates[j];
+
+    if (Bounds[i].Contains(X, Y) && HullModels[i].IsInside(QueryPoint))
+    {
+      return (cluster_id_t) i+1;
     }
   }
 
   /* If point hasn't been classified, we try the proximity */
-  for (size_t i = 0; i < HullModels.size(); i++)
+  for (size_t j = 0; j < Candidates.size(); j++)
   {
+    size_t i = Candidates[j];
     double CurrentSqDistance;
     int    CurrentDensity;
 
+    if (!Bounds[i].Contains(X, Y))
+      continue;
+
     HullModels[i].GetDistanceAndDensity(QueryPoint, CurrentSqDistance, CurrentDensity);
 
-    if ((CurrentSqDistance <= pow(Eps
-                                  , 2.0)) &&
+    if ((CurrentSqDistance <= pow(Eps, 2.0)) &&
         (CurrentSqDistance < MinSqDistance) &&
         (CurrentDensity+(QueryPoint->GetNeighbourhoodSize())+1) >= MinPoints)
     {
@@ -92,10 +204,5 @@ bool ConvexHullClassifier::Classify(const Point* QueryPoint, cluster_id_t& ID)
     }
   }
 
-  /* DEBUG
-  Message << " ID = " << ID << endl;
-  system_messages::information(Message.str().c_str());
-  */
-
-  return true;
+  return ID;
 }
@@ -48,30 +48,65 @@ using cepba_tools::system_messages;
 #include <sstream>
 using std::ostringstream;
 
+#include <ParallelFor.hpp>
+
+/* Points collected from the input iterators before classifying them in
+ * parallel. Iterators over the bursts database create the points on the fly,
+ * so they are not read all at once */
+#define CLASSIFICATION_BLOCK     65536
+#define CLASSIFICATION_MIN_CHUNK 1024
+
+/* Bounding box of a hull inflated by Eps: a point outside the box can be
+ * neither inside the hull nor near it */
+struct ConvexHullBounds
+{
+  double MinX, MinY, MaxX, MaxY;
+  bool   Valid;
+
+  bool Contains(double X, double Y) const
+  {
+    return (Valid && X >= MinX && X <= MaxX && Y >= MinY && Y <= MaxY);
+  }
+};
+
 /* Forward declarations */
+class ConvexHullClassifyTask;
 
 class ConvexHullClassifier: public Classifier
 {
+  friend class ConvexHullClassifyTask;
+
   protected:
 
     double                   Eps;
     int                      MinPoints;
     vector<ConvexHullModel>& HullModels;
 
+    vector<ConvexHullBounds> Bounds;
+
+    /* Uniform grid over the boxes. Each cell keeps the (sorted) indices of
+     * the hulls whose box overlaps it */
+    double                   GridMinX, GridMinY;
+    double                   CellWidth, CellHeight;
+    size_t                   GridColumns, GridRows;
+    vector<vector<size_t> >  GridCells;
+
   public:
 
     ConvexHullClassifier(vector<ConvexHullModel>& _HullModels,
                          double                   _Eps,
                          int                      _MinPoints):
-    HullModels(_HullModels),
     Eps(_Eps),
-    MinPoints(_MinPoints)
+    MinPoints(_MinPoints),
+    HullModels(_HullModels)
     {
       ostringstream Message;
       Message << "Classifier - Total Models = " << _HullModels.size();
       Message << " Epsilon = " << _Eps;
       Message << " MinPoints = " << _MinPoints << std::endl;
       system_messages::information(Message.str());
+
+      BuildIndex();
     };
 
     bool Classify(vector<const Point*>& Data,
@@ -84,6 +119,36 @@ class ConvexHullClassifier: public Classifier
 
   private:
 
+    void         BuildIndex(void);
+
+    cluster_id_t ClassifyPoint(const Point* QueryPoint);
+
+};
+
+/* Functor to classify a block of points through 'parallel_for' */
+class ConvexHullClassifyTask
+{
+  private:
+    ConvexHullClassifier& Classifier;
+    vector<const Point*>& Points;
+    vector<cluster_id_t>& IDs;
+
+  public:
+    ConvexHullClassifyTask(ConvexHullClassifier& Classifier,
+                           vector<const Point*>& Points,
+                           vector<cluster_id_t>& IDs):
+    Classifier(Classifier),
+    Points(Points),
+    IDs(IDs)
+    {};
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        IDs[i] = Classifier.ClassifyPoint(Points[i]);
+      }
+    }
 };
 
 template <typename T>
@@ -94,54 +159,51 @@ bool ConvexHullClassifier::Classify(T          begin,
 {
   T PointsIt;
 
-  cluster_id_t          CurrentClusterId;
   vector<cluster_id_t>& AssignmentVector = DataPartition.GetAssignmentVector();
   set<cluster_id_t>     DifferentIDs;
+  vector<bool>          UsedIDs (HullModels.size()+1, false);
 
-  ostringstream Message;
+  vector<const Point*>  Block;
+  vector<cluster_id_t>  BlockIDs;
 
-  for (PointsIt = begin; PointsIt != end; ++PointsIt)
+  AssignmentVector.reserve(AssignmentVector.size()+size);
+
+  PointsIt = begin;
+  while (PointsIt != end)
   {
-    /* DEBUG
-    Message.str("");
-    Message << "Point[" << i << "]";
-    system_messages::information(Message.str()); */
+    Block.clear();
+    while (PointsIt != end && Block.size() < CLASSIFICATION_BLOCK)
+    {
+      Block.push_back((const Point*) (*PointsIt));
+      ++PointsIt;
+    }
 
-    Classify((Point*) (*PointsIt), CurrentClusterId);
-    AssignmentVector.push_back(CurrentClusterId);
+    BlockIDs.resize(Block.size());
 
-    DifferentIDs.insert(CurrentClusterId);
+    ConvexHullClassifyTask Task(*this, Block, BlockIDs);
+    cepba_tools::parallel_for(Task, 0, Block.size(), CLASSIFICATION_MIN_CHUNK);
 
-    /* DEBUG
-    Message.str("");
-    Message << " ID = " << CurrentClusterId << endl;
-    system_messages::information(Message.str()); */
+    for (size_t i = 0; i < BlockIDs.size(); i++)
+    {
+      AssignmentVector.push_back(BlockIDs[i]);
+      UsedIDs[BlockIDs[i]] = true;
+    }
   }
 
-  DataPartition.SetIDs(DifferentIDs);
-
-  // DataPartition.NumberOfClusters(HullModels.size()+1);
-  // DataPartition.HasNoise(true);
-
-  /* DEBUG
-  Message.str("");
-  Message << "IDs in use { ";
-  set<cluster_id_t>::iterator IDsIt;
-  for (IDsIt  = DifferentIDs.begin();
-       IDsIt != DifferentIDs.end();
-       ++IDsIt)
+  for (size_t i = 0; i < UsedIDs.size(); i++)
   {
-    Message << *IDsIt << " ";
+    if (UsedIDs[i])
+    {
+      DifferentIDs.insert((cluster_id_t) i);
+    }
   }
-  Message << "}" << endl;
 
+  DataPartition.SetIDs(DifferentIDs);
 
-  // Message << "Classification Partition Size = " << DataPartition.NumberOfClusters() << " ";
-  // Message << "Has noise? " << DataPartition.HasNoise() << endl;
-  system_messages::information(Message.str().c_str());
-  */
+  // DataPartition.NumberOfClusters(HullModels.size()+1);
+  // DataPartition.HasNoise(true);
 
   return true;
 }
 
-#endif /* _NEARESTNEIGHBOURCLASSIFIER_HPP_ */
+#endif /* _CONVEX_HULL_CLASSIFIER_HPP_ */
@@ -42,8 +42,79 @@ using cepba_tools::system_messages;
 #include <sstream>
 using std::ostringstream;
 
+#include <algorithm>
+using std::sort;
+
+#include <cmath>
+
+#include <boost/thread/mutex.hpp>
+
 int ConvexHullModel::MIN_HULL_POINTS = 3;
 
+/* Relative error bound of the double precision orientation determinant
+ * (Shewchuk's 'ccwerrboundA') */
+#define ORIENTATION_ERROR_BOUND 3.3306690738754716e-16
+
+static boost::mutex ExactOrientationMutex;
+
+/* Orientation of the points (a, b, c): 1 on a left turn, -1 on a right turn
+ * and 0 when collinear. It is computed in double precision, and only when
+ * the determinant is too close to zero to trust its sign the exact kernel is
+ * used. All coordinates come from doubles, so the result is always exact.
+ * Hulls are queried from the classification threads, and the exact kernel
+ * number types are not guaranteed to be thread safe, so the (rare) exact
+ * evaluations are serialized */
+static int Orientation(double ax, double ay,
+                       double bx, double by,
+                       double cx, double cy)
+{
+  double Left  = (bx - ax) * (cy - ay);
+  double Right = (by - ay) * (cx - ax);
+  double Det   = Left - Right;
+  double Bound = ORIENTATION_ERROR_BOUND * (fabs(Left) + fabs(Right));
+
+  if (Det > Bound)
+  {
+    return 1;
+  }
+  else if (-Det > Bound)
+  {
+    return -1;
+  }
+  else if (Bound == 0)
+  {
+    /* Both products are exact zeros */
+    return 0;
+  }
+  else
+  {
+    boost::mutex::scoped_lock ExactLock (ExactOrientationMutex);
+    K::Orientation_2          ExactOrientation;
+
+    switch(ExactOrientation(MyPoint_2(ax, ay), MyPoint_2(bx, by), MyPoint_2(cx, cy)))
+    {
+      case CGAL::LEFT_TURN:
+        return 1;
+      case CGAL::RIGHT_TURN:
+        return -1;
+      default:
+        return 0;
+    }
+  }
+}
+
+/* Lexicographical (X, Y) order of the input points of a hull */
+struct SortPointsByXY
+{
+  bool operator()(const Point* a, const Point* b) const
+  {
+    if ((*a)[0] != (*b)[0])
+      return (*a)[0] < (*b)[0];
+
+    return (*a)[1] < (*b)[1];
+  }
+};
+
 ConvexHullModel::ConvexHullModel(void)
 {
   Dimensions     = 0;
@@ -54,33 +125,102 @@ ConvexHullModel::ConvexHullModel(void)
 
 ConvexHullModel::ConvexHullModel( vector<const Point*> cluster_points, long long TotalTime )
 {
-  vector<MyPoint_2> InternalPoints;
+  Dimensions = 2;
 
+  this->Density = cluster_points.size();
+  this->TotalTime = TotalTime;
+
+  BuildHull(cluster_points);
+}
+
+/* Hull of points that stand for several bursts each, so the density is not
+ * the number of points */
+ConvexHullModel::ConvexHullModel( vector<const Point*> cluster_points, long long Density, long long TotalTime )
+{
   Dimensions = 2;
 
-  for (size_t i = 0; i < cluster_points.size(); i++)
+  this->Density = Density;
+  this->TotalTime = TotalTime;
+
+  BuildHull(cluster_points);
+}
+
+void ConvexHullModel::BuildHull(const vector<const Point*> &cluster_points)
+{
+  vector<const Point*> Sorted;
+  vector<const Point*> Hull;
+  size_t               k = 0;
+
+  /* Andrew's monotone chain over the sorted points, without duplicates */
+  Sorted = cluster_points;
+  sort(Sorted.begin(), Sorted.end(), SortPointsByXY());
+
+  for (size_t i = 0; i < Sorted.size(); i++)
   {
-    MyPoint_2 NewPoint((*cluster_points[i])[0], (*cluster_points[i])[1]);
-    NewPoint.Instance()          = (long long) (*cluster_points[i]).GetInstance();
-    NewPoint.NeighbourhoodSize() = (long long) (*cluster_points[i]).GetNeighbourhoodSize();
-    InternalPoints.push_back(NewPoint);
+    if (k == 0 ||
+        (*Sorted[i])[0] != (*Sorted[k-1])[0] ||
+        (*Sorted[i])[1] != (*Sorted[k-1])[1])
+    {
+      Sorted[k++] = Sorted[i];
+    }
   }
-
-  this->Density = cluster_points.size();
-  this->TotalTime = TotalTime;
+  Sorted.resize(k);
 
   /* To compute a hull we need at least three points */
-  if (Density >= ConvexHullModel::MIN_HULL_POINTS)
+  if (Density >= ConvexHullModel::MIN_HULL_POINTS && Sorted.size() >= 3)
+  {
+    Hull.resize(2*Sorted.size());
+    k = 0;
+
+    /* Lower hull */
+    for (size_t i = 0; i < Sorted.size(); i++)
+    {
+      while (k >= 2 &&
+             Orientation((*Hull[k-2])[0], (*Hull[k-2])[1],
+                         (*Hull[k-1])[0], (*Hull[k-1])[1],
+                         (*Sorted[i])[0], (*Sorted[i])[1]) <= 0)
+      {
+        k--;
+      }
+      Hull[k++] = Sorted[i];
+    }
+
+    /* Upper hull */
+    for (size_t i = Sorted.size()-1, t = k+1; i > 0; i--)
+    {
+      while (k >= t &&
+             Orientation((*Hull[k-2])[0], (*Hull[k-2])[1],
+                         (*Hull[k-1])[0], (*Hull[k-1])[1],
+                         (*Sorted[i-1])[0], (*Sorted[i-1])[1]) <= 0)
+      {
+        k--;
+      }
+      Hull[k++] = Sorted[i-1];
+    }
+
+    /* The first point closes the chain */
+    Hull.resize(k-1);
+  }
+  else if (Density >= ConvexHullModel::MIN_HULL_POINTS)
   {
-    CGAL::convex_hull_2(InternalPoints.begin(),
-                        InternalPoints.end(),
-                        std::back_inserter(HullPoints) );
+    /* One or two distinct points */
+    Hull = Sorted;
   }
   else
   {
     /* All points are "hull" points */
-    HullPoints = InternalPoints;
+    Hull = cluster_points;
+  }
+
+  for (size_t i = 0; i < Hull.size(); i++)
+  {
+    MyPoint_2 NewPoint((*Hull[i])[0], (*Hull[i])[1]);
+    NewPoint.Instance()          = (long long) (*Hull[i]).GetInstance();
+    NewPoint.NeighbourhoodSize() = (long long) (*Hull[i]).GetNeighbourhoodSize();
+    HullPoints.push_back(NewPoint);
   }
+
+  UpdateHullCoordinates();
 }
 
 ConvexHullModel::ConvexHullModel(vector<MyPoint_2> HullPoints, long long Density, long long TotalTime)
@@ -97,6 +237,8 @@ ConvexHullModel::ConvexHullModel(vector<MyPoint_2> HullPoints, long long Density
   {
     this->HullPoints = HullPoints;
   }
+
+  UpdateHullCoordinates();
 }
 
 /*
@@ -139,6 +281,20 @@ ConvexHullModel::ConvexHullModel(long long  Density,
            DimValues);
 }
 
+/* Keeps the double precision copy of the vertices. They come from double
+ * values (input points or serialized hulls), so the conversion is exact */
+void ConvexHullModel::UpdateHullCoordinates(void)
+{
+  HullX.resize(HullPoints.size());
+  HullY.resize(HullPoints.size());
+
+  for (size_t i = 0; i < HullPoints.size(); i++)
+  {
+    HullX[i] = CGAL::to_double(HullPoints[i].x());
+    HullY[i] = CGAL::to_double(HullPoints[i].y());
+  }
+}
+
 int ConvexHullModel::size()
 {
   return this->HullPoints.size();
@@ -234,13 +390,51 @@ bool ConvexHullModel::Flush(ostream& str, cluster_id_t id)
 
 bool ConvexHullModel::IsInside(const Point* QueryPoint)
 {
-  MyPoint_2 InternalPoint((*QueryPoint)[0], (*QueryPoint)[1]);
+  double X = (*QueryPoint)[0];
+  double Y = (*QueryPoint)[1];
+  size_t n = HullX.size();
+  size_t Low, High;
+
+  /* Degenerated hulls: a single point or a segment. The shared kernel
+   * points are not used, so concurrent queries are safe */
+  if (n == 0)
+  {
+    return false;
+  }
+  else if (n == 1)
+  {
+    return (X == HullX[0] && Y == HullY[0]);
+  }
+  else if (n == 2)
+  {
+    return (Orientation(HullX[0], HullY[0], HullX[1], HullY[1], X, Y) == 0 &&
+            X >= std::min(HullX[0], HullX[1]) && X <= std::max(HullX[0], HullX[1]) &&
+            Y >= std::min(HullY[0], HullY[1]) && Y <= std::max(HullY[0], HullY[1]));
+  }
 
-  InternalPoint.Instance()          = QueryPoint->GetInstance();
-  InternalPoint.NeighbourhoodSize() = QueryPoint->GetNeighbourhoodSize();
+  /* Binary search of the triangle fan around the first vertex that contains
+   * the point. Points on the boundary are inside */
+  if (Orientation(HullX[0], HullY[0], HullX[1], HullY[1], X, Y) < 0 ||
+      Orientation(HullX[0], HullY[0], HullX[n-1], HullY[n-1], X, Y) > 0)
+  {
+    return false;
+  }
+
+  Low  = 1;
+  High = n-1;
+  while (High - Low > 1)
+  {
+    size_t Middle = (Low + High) / 2;
 
-  return IsInside(InternalPoint);
+    if (Orientation(HullX[0], HullY[0], HullX[Middle], HullY[Middle], X, Y) >= 0)
+      Low = Middle;
+    else
+      High = Middle;
+  }
+
+  return (Orientation(HullX[Low], HullY[Low], HullX[Low+1], HullY[Low+1], X, Y) >= 0);
 }
+
 bool ConvexHullModel::IsInside(const MyPoint_2& QueryPoint)
 {
   ostringstream Message;
@@ -262,27 +456,17 @@ bool ConvexHullModel::IsInside(const MyPoint_2& QueryPoint)
 
 bool ConvexHullModel::IsNear(const Point* QueryPoint, double Epsilon, int MinPoints)
 {
-  vector<MyPoint_2>::iterator HullPointsIt;
-  MyPoint_2 InternalQueryPoint((*QueryPoint)[0], (*QueryPoint)[1]);
-
-  InternalQueryPoint.Instance()          = QueryPoint->GetInstance();
-  InternalQueryPoint.NeighbourhoodSize() = QueryPoint->GetNeighbourhoodSize();
+  double    X               = (*QueryPoint)[0];
+  double    Y               = (*QueryPoint)[1];
+  double    SqEpsilon       = Epsilon * Epsilon;
+  long long QueryNeighbours = QueryPoint->GetNeighbourhoodSize();
 
-  // PolytopePoint_2 CGALPoint_Dist ((*QueryPoint)[0], (*QueryPoint)[1]);
-  // vector<PolytopePoint_2> R, S;
-
-  /*
-  Message << " (Using distance query!) ";
-  system_messages::information(Message.str()); */
-
-  for (HullPointsIt = HullPoints.begin(); HullPointsIt != HullPoints.end(); ++HullPointsIt)
+  for (size_t i = 0; i < HullX.size(); i++)
   {
-    MyPoint_2 CurrentHullPoint = *HullPointsIt;
+    double sqrDistance = (HullX[i] - X) * (HullX[i] - X) + (HullY[i] - Y) * (HullY[i] - Y);
 
-    double sqrDistance = CGAL::to_double(squared_distance(CurrentHullPoint, InternalQueryPoint));
-
-    if ((sqrDistance <= pow(Epsilon, 2.0)) &&
-        ((CurrentHullPoint.NeighbourhoodSize()+(InternalQueryPoint.NeighbourhoodSize()/2)+1) >= MinPoints))
+    if ((sqrDistance <= SqEpsilon) &&
+        ((HullPoints[i].NeighbourhoodSize()+(QueryNeighbours/2)+1) >= MinPoints))
     {
       return true;
     }
@@ -295,23 +479,20 @@ void ConvexHullModel::GetDistanceAndDensity(const Point* QueryPoint,
                                             double      &SqDistance,
                                             int         &Density)
 {
-  vector<MyPoint_2>::iterator HullPointsIt;
-
-  MyPoint_2 InternalQueryPoint((*QueryPoint)[0], (*QueryPoint)[1]);
+  double X = (*QueryPoint)[0];
+  double Y = (*QueryPoint)[1];
 
   SqDistance = MAX_DOUBLE;
   Density    = 0;
 
-  for (HullPointsIt = HullPoints.begin(); HullPointsIt != HullPoints.end(); ++HullPointsIt)
+  for (size_t i = 0; i < HullX.size(); i++)
   {
-    MyPoint_2 CurrentHullPoint = *HullPointsIt;
-
-    double CurrentDistance = CGAL::to_double(squared_distance(CurrentHullPoint, InternalQueryPoint));
+    double CurrentDistance = (HullX[i] - X) * (HullX[i] - X) + (HullY[i] - Y) * (HullY[i] - Y);
 
     if (CurrentDistance < SqDistance)
     {
       SqDistance = CurrentDistance;
-      Density    = CurrentHullPoint.NeighbourhoodSize();
+      Density    = HullPoints[i].NeighbourhoodSize();
     }
   }
 
@@ -319,13 +500,26 @@ void ConvexHullModel::GetDistanceAndDensity(const Point* QueryPoint,
 }
 
 ConvexHullModel * ConvexHullModel::Merge( ConvexHullModel * CHull2, double Epsilon, int MinPoints )
+{
+  if (IsMergeable(CHull2, Epsilon, MinPoints))
+  {
+    /* DEBUG
+    std::cout << "The two hulls are merged." << std::endl; */
+    return Join(CHull2);
+  }
+  else
+  {
+    /* DEBUG
+    std::cout << "The two hulls are NOT merged." << std::endl; */
+    return NULL;
+  }
+}
+
+bool ConvexHullModel::IsMergeable( ConvexHullModel * CHull2, double Epsilon, int MinPoints )
 {
   Polygon_2         P, Q;
   bool              doMerge = false;
-  vector<MyPoint_2> Hull2Points, JointPoints;
-  ConvexHullModel  *JointHull;
-  long long         JointDensity   = this->GetDensity() + CHull2->GetDensity();
-  long long         JointTotalTime = this->GetTotalTime() + CHull2->GetTotalTime();               
+  vector<MyPoint_2> Hull2Points;
 
   Hull2Points = CHull2->getHullPoints();
 
@@ -399,57 +593,69 @@ ConvexHullModel * ConvexHullModel::Merge( ConvexHullModel * CHull2, double Epsil
     }
   }
 
-  if (doMerge)
-  {
-    for (size_t i = 0; i < HullPoints.size(); i++)
-    {
-      JointPoints.push_back(HullPoints[i]);
-    }
+  return doMerge;
+}
 
-    for (size_t i = 0; i < Hull2Points.size(); i++)
-    {
-      JointPoints.push_back(Hull2Points[i]);
-    }
+/* Hull of the points of both hulls, without checking if they intersect. Used
+ * to build groups of hulls already known to be mergeable */
+ConvexHullModel * ConvexHullModel::Join( ConvexHullModel * CHull2 )
+{
+  vector<MyPoint_2> JointPoints;
+  vector<MyPoint_2> &Hull2Points    = CHull2->getHullPoints();
+  long long          JointDensity   = this->GetDensity() + CHull2->GetDensity();
+  long long          JointTotalTime = this->GetTotalTime() + CHull2->GetTotalTime();
 
-    JointHull = new ConvexHullModel( JointPoints, JointDensity, JointTotalTime );
-    /* DEBUG
-    std::cout << "The two hulls are merged." << std::endl;
-    JointHull->Print(); */
-    return JointHull;
+  JointPoints.reserve(HullPoints.size() + Hull2Points.size());
+  JointPoints.insert(JointPoints.end(), HullPoints.begin(),  HullPoints.end());
+  JointPoints.insert(JointPoints.end(), Hull2Points.begin(), Hull2Points.end());
+
+  return new ConvexHullModel( JointPoints, JointDensity, JointTotalTime );
+}
+
+/* Axis-aligned box of the hull vertices. The enclosing intervals of the exact
+ * coordinates are used, so the box always contains the hull */
+bool ConvexHullModel::GetBoundingBox(double &MinX, double &MinY,
+                                     double &MaxX, double &MaxY)
+{
+  if (HullPoints.size() == 0)
+  {
+    return false;
   }
-  else
+
+  MinX = MinY = MAX_DOUBLE;
+  MaxX = MaxY = -MAX_DOUBLE;
+
+  for (size_t i = 0; i < HullPoints.size(); i++)
   {
-    /* DEBUG
-    std::cout << "The two hulls are NOT merged." << std::endl; */
-    return NULL;
+    std::pair<double, double> X = CGAL::to_interval(HullPoints[i].x());
+    std::pair<double, double> Y = CGAL::to_interval(HullPoints[i].y());
+
+    if (X.first  < MinX) MinX = X.first;
+    if (X.second > MaxX) MaxX = X.second;
+    if (Y.first  < MinY) MinY = Y.first;
+    if (Y.second > MaxY) MaxY = Y.second;
   }
+
+  return true;
 }
 
 bool ConvexHullModel::IsNear (ConvexHullModel *Hull2, double Epsilon, int MinPoints)
 {
-  K::Compute_squared_distance_2 squared_distance;
-
-  vector<MyPoint_2> HullPoints2;
-  vector<MyPoint_2>::iterator it1, it2;
+  double             SqEpsilon   = Epsilon * Epsilon;
+  vector<MyPoint_2> &HullPoints2 = Hull2->getHullPoints();
+  vector<double>    &HullX2      = Hull2->HullX;
+  vector<double>    &HullY2      = Hull2->HullY;
 
-  MyPoint_2 Cand1, Cand2;
-
-  HullPoints2 = Hull2->getHullPoints();
-  for (it1 = HullPoints.begin(); it1 != HullPoints.end(); ++it1)
+  for (size_t i = 0; i < HullX.size(); i++)
   {
-    Cand1 = *it1;
-    for (it2 = HullPoints2.begin(); it2 != HullPoints2.end(); ++it2)
+    for (size_t j = 0; j < HullX2.size(); j++)
     {
-      double sqrDistance;
-
-      Cand2 = *it2;
+      double sqrDistance = (HullX[i] - HullX2[j]) * (HullX[i] - HullX2[j]) +
+                           (HullY[i] - HullY2[j]) * (HullY[i] - HullY2[j]);
 
-      sqrDistance = CGAL::to_double(squared_distance(Cand1, Cand2));
-
-      if ( sqrDistance <= pow(Epsilon, 2.0) &&
-          (((Cand1.NeighbourhoodSize() + Cand2.NeighbourhoodSize())/2)+1) >= MinPoints)
+      if ( sqrDistance <= SqEpsilon &&
+          (((HullPoints[i].NeighbourhoodSize() + HullPoints2[j].NeighbourhoodSize())/2)+1) >= MinPoints)
       {
-        // std::cout << "Cand1.NeighbourhoodSize = " << Cand1.NeighbourhoodSize() << " Cand2.NeighbourhoodSize = " << Cand2.NeighbourhoodSize() << std::endl;
         return true;
       }
     }
@@ -483,6 +689,8 @@ void ConvexHullModel::Assemble(long long  Density,
     HullPoints.push_back(NewPoint);
   }
 
+  UpdateHullCoordinates();
+
   /*
   for (int i = 0; i < NumPoints*NumDimensions; i +=2)
   {
@@ -74,6 +74,11 @@ class ConvexHullModel
     long long         TotalTime;
     vector<MyPoint_2> HullPoints;
 
+    /* Double precision copy of the hull vertices (counter-clockwise), used
+     * by the fast paths of the queries */
+    vector<double>    HullX;
+    vector<double>    HullY;
+
   public:
 
     static int MIN_HULL_POINTS;
@@ -82,6 +87,8 @@ class ConvexHullModel
 
     ConvexHullModel ( vector< const Point* >, long long TotalTime );
 
+    ConvexHullModel ( vector< const Point* >, long long Density, long long TotalTime );
+
     ConvexHullModel(vector<MyPoint_2> HullPoints, long long Density, long long TotalTime);
     /* ConvexHullModel ( Polygon_2 P, Polygon_2 Q ); */
     ConvexHullModel(long long  Density,
@@ -105,6 +112,10 @@ class ConvexHullModel
                    double    *&DimValues );
     void Flush( );
     ConvexHullModel * Merge( ConvexHullModel * CHull2, double Epsilon = 0, int MinPoints = 1);
+    bool              IsMergeable( ConvexHullModel * CHull2, double Epsilon = 0, int MinPoints = 1);
+    ConvexHullModel * Join( ConvexHullModel * CHull2 );
+
+    bool GetBoundingBox(double &MinX, double &MinY, double &MaxX, double &MaxY);
 
     vector<MyPoint_2>& getHullPoints();
 
@@ -122,6 +133,10 @@ class ConvexHullModel
 
   private:
 
+    void   BuildHull(const vector<const Point*> &cluster_points);
+
+    void   UpdateHullCoordinates(void);
+
     void   Assemble(long long  Density,
                     long long  TotalTime,
                     int        NumPoints,
@@ -35,6 +35,13 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::counter_id;
+
 #include "DBSCAN.hpp"
 
 #include "Point.hpp"
@@ -62,6 +69,7 @@ using std::make_pair;
 const string DBSCAN::NAME              = "DBSCAN";
 const string DBSCAN::EPSILON_STRING    = "epsilon";
 const string DBSCAN::MIN_POINTS_STRING = "min_points";
+const string DBSCAN::DEDUPLICATION_GRID_STRING = "deduplication_grid";
 
 /*****************************************************************************
  * class DBSCAN implementation                                               *
@@ -125,6 +133,26 @@ DBSCAN::DBSCAN(map<string, string> ClusteringParameters)
     }
   }
 
+  /* Deduplication grid (optional) */
+  DeduplicationGrid = -1.0;
+
+  ParametersIterator = ClusteringParameters.find(DBSCAN::DEDUPLICATION_GRID_STRING);
+  if (ParametersIterator != ClusteringParameters.end())
+  {
+    char* err;
+    DeduplicationGrid = strtod(ParametersIterator->second.c_str(), &err);
+
+    if (*err || DeduplicationGrid < 0)
+    {
+      string ErrorMessage;
+      ErrorMessage = "incorrect value for DBSCAN parameter '"+ DBSCAN::DEDUPLICATION_GRID_STRING + "'";
+
+      SetErrorMessage(ErrorMessage);
+      SetError(true);
+      return;
+    }
+  }
+
   return;
 }
 
@@ -162,30 +190,64 @@ bool DBSCAN::Run(const vector<const Point*>& Data,
     }
   }
 
+  /* Duplicated points are clustered once, weighting their representative */
+  PointsDeduplication         Deduplication (DeduplicationGrid);
+  const vector<const Point*>* ClusteringData = &Data;
+  vector<cluster_id_t>        ReducedAssignmentVector;
+  vector<cluster_id_t>*       AssignmentVector = &ClusterAssignmentVector;
+
+  Weights.clear();
+
+  if (DeduplicationGrid >= 0)
+  {
+    static counter_id Representatives = instrumentation::counter("dbscan.representatives");
+
+    instrumentation::phase_begin("deduplicate");
+
+    Deduplication.Run(Data);
+    Deduplication.ReduceAssignment(ClusterAssignmentVector, ReducedAssignmentVector);
+
+    ClusteringData   = &Deduplication.GetRepresentatives();
+    AssignmentVector = &ReducedAssignmentVector;
+    Weights          = Deduplication.GetWeights();
+
+    instrumentation::add(Representatives, ClusteringData->size());
+    instrumentation::phase_end();
+
+    ostringstream Messages;
+    Messages << "Clustering " << ClusteringData->size() << " representatives of ";
+    Messages << Data.size() << " points" << endl;
+    system_messages::information(Messages.str());
+  }
+
   /* Build KD-Tree */
-  BuildKDTree(Data);
+  instrumentation::phase_begin("build_index");
+  BuildKDTree(*ClusteringData);
+  instrumentation::phase_end();
 
-  system_messages::show_progress("Clustering points", 0, (int) Data.size());
+  instrumentation::phase_begin("expand_clusters");
+
+  ProgressReporter Progress ("Clustering points", ClusteringData->size());
   Index = 0; // Double counter: total points vs. clustering points!
 
   srandom((unsigned int) time(NULL));
   // Offset = random();
   Offset = 0;
 
-  for (point_idx i = 0; i < Data.size(); i++)
+  for (point_idx i = 0; i < ClusteringData->size(); i++)
   {
-    system_messages::show_progress("Clustering points", i, (int) Data.size());
-
-    point_idx index = (i + Offset) % Data.size();
+    point_idx index = (i + Offset) % ClusteringData->size();
 
-    if (ClusterAssignmentVector[index] == UNCLASSIFIED)
+    if ((*AssignmentVector)[index] == UNCLASSIFIED)
     {
-      if (ExpandCluster(Data, index, ClusterAssignmentVector, ClusterId))
+      if (ExpandCluster(*ClusteringData, index, *AssignmentVector, ClusterId))
       {
         DifferentIDs.insert(ClusterId);
         ClusterId++;
       }
     }
+
+    Progress.increment();
   }
 
   if (NoisePoints != 0)
@@ -194,11 +256,25 @@ bool DBSCAN::Run(const vector<const Point*>& Data,
   }
 
   /* We need a local copy of the assignment vector to later generate a possible
-   * classifier */
-  IDs     = ClusterAssignmentVector;
+   * classifier. It refers to the points on the spatial index, so it is the
+   * representatives one when deduplicating */
+  IDs     = (*AssignmentVector);
   IDsUsed = DifferentIDs;
 
-  system_messages::show_progress_end("Clustering points", (int) Data.size());
+  Progress.end();
+
+  if (DeduplicationGrid >= 0)
+  {
+    Deduplication.ExpandAssignment(ReducedAssignmentVector, ClusterAssignmentVector);
+
+    for (size_t i = 0; i < Data.size(); i++)
+    {
+      const Point* Representative = (*ClusteringData)[Deduplication.GetRepresentative(i)];
+      const_cast<Point*>(Data[i])->SetNeighbourhoodSize(Representative->GetNeighbourhoodSize());
+    }
+  }
+
+  instrumentation::phase_end();
 
   return true;
 }
@@ -309,6 +385,8 @@ bool DBSCAN::ComputeNeighbourhood(const vector<const Point*>& Data,
   /* Build KD tree */
   BuildKDTree(Data);
 
+  ProgressReporter Progress ("Computing K-Neighbour distance", Data.size());
+
   for (size_t i = 0; i < Data.size(); i++)
   {
 
@@ -319,9 +397,11 @@ bool DBSCAN::ComputeNeighbourhood(const vector<const Point*>& Data,
 
     ComputeNeighboursDistance(Data[i], K, K, ResultingDistances);
 
-    system_messages::show_progress("Computing K-Neighbour distance", i, Data.size());
+    Progress.increment();
   }
 
+  Progress.end();
+
   Distances = ResultingDistances[0];
   sort(Distances.rbegin(), Distances.rend());
 
@@ -340,17 +420,18 @@ bool DBSCAN::Classify(const vector<const Point*> &Data,
   DifferentIDs = IDsUsed;
   ClusterAssignmentVector.clear();
 
-  system_messages::show_progress("Classifying points", 0, (int) Data.size());
+  ProgressReporter Progress ("Classifying points", Data.size());
 
   for (size_t i = 0; i < Data.size(); i++)
   {
-    system_messages::show_progress("Classifying points", i, (int) Data.size());
     cluster_id_t CurrentID;
 
     Classify(Data[i], CurrentID);
     ClusterAssignmentVector.push_back(CurrentID);
+
+    Progress.increment();
   }
-  system_messages::show_progress_end("Classifying points", (int) Data.size());
+  Progress.end();
 
   return true;
 }
@@ -393,17 +474,22 @@ bool DBSCAN::BuildKDTree(const vector<const Point*>& Data)
 /*  cout << "Current clustering has " << Dimensions << " dimensions" << endl; */
 #endif
 
-  system_messages::show_progress("Building data spatial index", 0, Data.size());
+  ProgressReporter Progress ("Building data spatial index", Data.size());
 
   ANNDataPoints = annAllocPts(Data.size(), Dimensions);
 
+  /* Fill the contiguous block allocated by 'annAllocPts', in the ANN
+   * coordinate type (float on single precision builds) */
   for (size_t i = 0; i < Data.size(); i++)
   {
-    system_messages::show_progress("Building data spatial index", i, Data.size());
-    ANNDataPoints[i] = ToANNPoint(Data[i]);
+    for (size_t j = 0; j < Dimensions; j++)
+    {
+      ANNDataPoints[i][j] = (ANNcoord) (*Data[i])[j];
+    }
+    Progress.increment();
   }
 
-  system_messages::show_progress_end("Building data spatial index", Data.size());
+  Progress.end();
 
   SpatialIndex = new ANNkd_tree(ANNDataPoints,
                                 Data.size(),
@@ -445,10 +531,10 @@ bool DBSCAN::ExpandCluster(const vector<const Point*>& Data,
   cout << "SeedList.size() = " << SeedList.size() << endl;
   */
 
-  const_cast<Point*>(Data[CurrentPoint])->SetNeighbourhoodSize(SeedList.size());
+  const_cast<Point*>(Data[CurrentPoint])->SetNeighbourhoodSize(NeighbourhoodWeight(SeedList));
 
   /* Point is NO core object */
-  if (SeedList.size() < MinPoints)
+  if (Data[CurrentPoint]->GetNeighbourhoodSize() < MinPoints)
   {
     ClusterAssignmentVector[CurrentPoint] = NOISE_CLUSTERID;
     NoisePoints++;
@@ -477,13 +563,13 @@ bool DBSCAN::ExpandCluster(const vector<const Point*>& Data,
 
     EpsilonRangeQuery(Data[CurrentNeighbour], NeighbourSeedList);
 
-    const_cast<Point*>(Data[CurrentNeighbour])->SetNeighbourhoodSize(NeighbourSeedList.size());
+    const_cast<Point*>(Data[CurrentNeighbour])->SetNeighbourhoodSize(NeighbourhoodWeight(NeighbourSeedList));
 
     /* DEBUG
     cout << "NeighbourSeedList.size() = " << SeedList.size() << endl; */
 
     /* CurrentNeighbour is a core object */
-    if (NeighbourSeedList.size() >= MinPoints)
+    if (Data[CurrentNeighbour]->GetNeighbourhoodSize() >= MinPoints)
     {
       for (NeighbourSeedListIterator  = NeighbourSeedList.begin();
            NeighbourSeedListIterator != NeighbourSeedList.end();
@@ -526,14 +612,22 @@ bool DBSCAN::ExpandCluster(const vector<const Point*>& Data,
 void DBSCAN::EpsilonRangeQuery(const Point* const QueryPoint,
                                list<size_t>&      SeedList)
 {
+  static counter_id RangeQueries        = instrumentation::counter("dbscan.range_queries");
+  static counter_id NodesVisited        = instrumentation::counter("dbscan.kdtree_nodes_visited");
+  static counter_id DistanceEvaluations = instrumentation::counter("dbscan.distance_evaluations");
+
   ANNpoint    ANNQueryPoint;
   ANNidxArray Results;
   size_t      ResultSize;
+  int         PointsVisited, NodesCount;
 
   ANNQueryPoint = ToANNPoint(QueryPoint);
 
   ResultSize = SpatialIndex->annkFRSearch(ANNQueryPoint, pow(Eps, 2.0), 0);
 
+  PointsVisited = annkFRPtsVisited();
+  NodesCount    = annkFRNodesVisited();
+
   Results = new ANNidx[ResultSize];
 
   ResultSize = SpatialIndex->annkFRSearch(ANNQueryPoint,
@@ -541,6 +635,11 @@ void DBSCAN::EpsilonRangeQuery(const Point* const QueryPoint,
                                           ResultSize,
                                           Results);
 
+  /* Both searches (count and retrieval) do the same work */
+  instrumentation::add(RangeQueries);
+  instrumentation::add(NodesVisited,        NodesCount    + annkFRNodesVisited());
+  instrumentation::add(DistanceEvaluations, PointsVisited + annkFRPtsVisited());
+
   for (INT32 i = 0; i < ResultSize; i++)
   {
     SeedList.push_back(Results[i]);
@@ -549,13 +648,35 @@ void DBSCAN::EpsilonRangeQuery(const Point* const QueryPoint,
   delete [] Results;
 }
 
+/* Number of original points in a neighbourhood: each representative counts
+ * as many points as it collapsed */
+size_t DBSCAN::NeighbourhoodWeight(const list<point_idx>& SeedList)
+{
+  list<point_idx>::const_iterator SeedListIterator;
+  size_t                          Weight = 0;
+
+  if (Weights.size() == 0)
+  {
+    return SeedList.size();
+  }
+
+  for (SeedListIterator  = SeedList.begin();
+       SeedListIterator != SeedList.end();
+       SeedListIterator++)
+  {
+    Weight += Weights[(*SeedListIterator)];
+  }
+
+  return Weight;
+}
+
 ANNpoint DBSCAN::ToANNPoint(const Point* InputPoint)
 {
   ANNpoint Result = annAllocPt(InputPoint->size());
 
   for (size_t i = 0; i < InputPoint->size(); i++)
   {
-    Result[i] = (*InputPoint)[i];
+    Result[i] = (ANNcoord) (*InputPoint)[i];
   }
 
   return Result;
@@ -629,9 +750,7 @@ DBSCAN::ComputeKNeighbourhoods(const vector<const Point*>& Data,
 
   /* Compute the distances for all points */
 
-  system_messages::show_progress("Computing K-Neighbour distance",
-                                 0,
-                                 Data.size());
+  ProgressReporter Progress ("Computing K-Neighbour distance", Data.size());
 
 
   for (size_t i = 0; i < Data.size(); i++)
@@ -644,11 +763,10 @@ DBSCAN::ComputeKNeighbourhoods(const vector<const Point*>& Data,
 
     ComputeNeighboursDistance(Data[i], k_begin, k_end, ResultingDistances);
 
-    system_messages::show_progress("Computing K-Neighbour distance", i, Data.size());
+    Progress.increment();
   }
 
-  system_messages::show_progress_end("Computing K-Neighbour distance",
-                                     Data.size());
+  Progress.end();
 
   /* Sort distances */
   for (size_t i = 0; i <= (k_end - k_begin); i++)
@@ -36,6 +36,7 @@
 #define _DBSCAN_HPP_
 
 #include "ClusteringAlgorithm.hpp"
+#include "PointsDeduplication.hpp"
 #include "clustering_types.h"
 //#include "KDTreeClassifier.hpp"
 
@@ -66,6 +67,11 @@ class DBSCAN: public ClusteringAlgorithm
     double              Eps;
     INT32               MinPoints;
 
+    /* Side of the grid used to collapse the duplicated points, negative when
+     * the points are clustered as they are */
+    double              DeduplicationGrid;
+    vector<size_t>      Weights;
+
     /*
     vector<INT32>       ClusterIdTranslation;
     ClusterInformation* NoiseClusterInfo;
@@ -84,6 +90,7 @@ class DBSCAN: public ClusteringAlgorithm
 
     static const string EPSILON_STRING;
     static const string MIN_POINTS_STRING;
+    static const string DEDUPLICATION_GRID_STRING;
 
     DBSCAN(map<string, string> ClusteringParameters);
 
@@ -136,6 +143,8 @@ class DBSCAN: public ClusteringAlgorithm
     void EpsilonRangeQuery(const Point*     QueryPoint,
                            list<point_idx>& SeedList);
 
+    size_t NeighbourhoodWeight(const list<point_idx>& SeedList);
+
     ANNpoint ToANNPoint(const Point* const InputPoint);
 
     /* Parameters approximation methods */
@@ -0,0 +1,868 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::counter_id;
+using cepba_tools::phase_scope;
+
+#include "IncrementalDBSCAN.hpp"
+#include "Point.hpp"
+#include <DistanceKernels.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <sstream>
+using std::ostringstream;
+
+using std::make_pair;
+
+const size_t IncrementalDBSCAN::NO_POINT = std::numeric_limits<size_t>::max();
+
+/* A subtree is rebuilt when one of its children holds more than this
+ * fraction of its nodes */
+const double IncrementalDBSCAN::BALANCE = 0.7;
+
+IncrementalDBSCAN::IncrementalDBSCAN(double Eps, INT32 MinPoints)
+{
+  this->Eps        = Eps;
+  this->SquaredEps = Eps*Eps;
+  this->MinPoints  = MinPoints;
+  this->Dimensions = 0;
+
+  Cores.HoldsCores    = true;
+  Cores.Root          = NO_POINT;
+  NonCores.HoldsCores = false;
+  NonCores.Root       = NO_POINT;
+}
+
+/**
+ * Inserts a batch of points and updates the clusters they modify
+ *
+ * \param Batch New points, all of them with the same number of dimensions
+ *
+ * \return True if the points were inserted, false otherwise
+ */
+bool IncrementalDBSCAN::AddPoints(const vector<const Point*>& Batch)
+{
+  static counter_id InsertedPoints = instrumentation::counter("incremental_dbscan.points");
+  phase_scope       Phase("incremental_dbscan");
+
+  size_t   FirstPoint = Core.size();
+  TreeNode OutOfTree;
+
+  if (Batch.size() == 0)
+  {
+    return true;
+  }
+
+  if (Eps <= 0)
+  {
+    SetErrorMessage("epsilon must be greater than 0");
+    SetError(true);
+    return false;
+  }
+
+  if (MinPoints <= 0)
+  {
+    SetErrorMessage("minimum points must be greater than 0");
+    SetError(true);
+    return false;
+  }
+
+  if (Dimensions == 0)
+  {
+    Dimensions = Batch[0]->size();
+    Corner.resize(Dimensions);
+  }
+
+  for (size_t i = 0; i < Batch.size(); i++)
+  {
+    if (Batch[i]->size() != Dimensions)
+    {
+      ostringstream ErrorMessage;
+
+      ErrorMessage << "point " << i << " of the batch has " << Batch[i]->size();
+      ErrorMessage << " dimensions, " << Dimensions << " expected";
+
+      SetErrorMessage(ErrorMessage.str());
+      SetError(true);
+      return false;
+    }
+  }
+
+  Coordinates.reserve(Coordinates.size() + Batch.size()*Dimensions);
+
+  for (size_t i = 0; i < Batch.size(); i++)
+  {
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      Coordinates.push_back((*Batch[i])[Dim]);
+    }
+
+    NeighboursCount.push_back(0);
+    Core.push_back(false);
+    BorderOf.push_back(NO_POINT);
+    ClusterParent.push_back(FirstPoint + i);
+    ClusterRank.push_back(0);
+  }
+
+  OutOfTree.Left           = NO_POINT;
+  OutOfTree.Right          = NO_POINT;
+  OutOfTree.Up             = NO_POINT;
+  OutOfTree.SplitDimension = 0;
+  OutOfTree.Size           = 0;
+  OutOfTree.Live           = 0;
+  OutOfTree.Unclaimed      = 0;
+  OutOfTree.ClusterCore    = NO_POINT;
+
+  Cores.Nodes.resize(Core.size(), OutOfTree);
+  Cores.Bounds.resize(2*Core.size()*Dimensions);
+  NonCores.Nodes.resize(Core.size(), OutOfTree);
+  NonCores.Bounds.resize(2*Core.size()*Dimensions);
+
+  for (size_t i = FirstPoint; i < Core.size(); i++)
+  {
+    InsertPoint(i);
+  }
+
+  instrumentation::add(InsertedPoints, Batch.size());
+
+  return true;
+}
+
+/**
+ * Generates the partition of all the points inserted so far. Clusters are
+ * numbered in order of appearance of their first point
+ *
+ * \param CurrentPartition Partition where the assignment is stored
+ */
+void IncrementalDBSCAN::GetPartition(Partition& CurrentPartition)
+{
+  vector<cluster_id_t>& Assignment = CurrentPartition.GetAssignmentVector();
+  set<cluster_id_t>&    IDs        = CurrentPartition.GetIDs();
+  map<size_t, cluster_id_t>           ClusterOfRoot;
+  map<size_t, cluster_id_t>::iterator RootIt;
+  cluster_id_t                        NextID = MIN_CLUSTERID;
+
+  Assignment.assign(Core.size(), NOISE_CLUSTERID);
+  IDs.clear();
+  IDs.insert(NOISE_CLUSTERID);
+
+  for (size_t i = 0; i < Core.size(); i++)
+  {
+    size_t ClusterCore = (Core[i] ? i : BorderOf[i]);
+
+    if (ClusterCore == NO_POINT)
+    {
+      continue;
+    }
+
+    size_t ClusterRoot = FindCluster(ClusterCore);
+
+    RootIt = ClusterOfRoot.find(ClusterRoot);
+    if (RootIt == ClusterOfRoot.end())
+    {
+      RootIt = ClusterOfRoot.insert(make_pair(ClusterRoot, NextID)).first;
+      IDs.insert(NextID);
+      NextID++;
+    }
+
+    Assignment[i] = RootIt->second;
+  }
+}
+
+size_t IncrementalDBSCAN::GetCoresCount(void) const
+{
+  return (Cores.Root == NO_POINT ? 0 : Cores.Nodes[Cores.Root].Live);
+}
+
+/* Counts the neighbourhood of the new point, promotes the points that reach
+ * MinPoints and links the new cores to the clusters around them */
+void IncrementalDBSCAN::InsertPoint(size_t NewPoint)
+{
+  static counter_id NewCoresCounter = instrumentation::counter("incremental_dbscan.new_cores");
+
+  size_t         CoreNeighbour = NO_POINT;
+  vector<size_t> NonCoreNeighbours;
+  vector<size_t> NewCores;
+
+  /* Non-core neighbours must always be updated */
+  FindNonCores(NewPoint, NonCores.Root, NonCoreNeighbours);
+
+  size_t Count = 1 + NonCoreNeighbours.size(); /* The point itself */
+
+  for (size_t i = 0; i < NonCoreNeighbours.size(); i++)
+  {
+    NeighboursCount[NonCoreNeighbours[i]]++;
+    if (NeighboursCount[NonCoreNeighbours[i]] == (size_t) MinPoints)
+    {
+      NewCores.push_back(NonCoreNeighbours[i]);
+    }
+  }
+
+  /* Core neighbours are only counted until the point becomes a core, or all
+   * seen when it does not, so the point knows whether it is a border */
+  CountCores(NewPoint, Cores.Root, Count, CoreNeighbour);
+
+  if (Count >= (size_t) MinPoints)
+  {
+    NewCores.push_back(NewPoint);
+  }
+  else
+  {
+    NeighboursCount[NewPoint] = Count;
+    BorderOf[NewPoint]        = CoreNeighbour;
+    InsertNode(NonCores, NewPoint);
+  }
+
+  /* Promote all the cores before linking them. The cores linked later see
+   * the ones already on the tree, so all of them see each other */
+  vector<size_t> PromotedCores;
+  for (size_t i = 0; i < NewCores.size(); i++)
+  {
+    PromoteToCore(NewCores[i], PromotedCores);
+  }
+
+  for (size_t i = 0; i < PromotedCores.size(); i++)
+  {
+    ConnectCore(PromotedCores[i]);
+
+    if (PromotedCores[i] != NewPoint)
+    {
+      ClaimBorders(PromotedCores[i], NonCores.Root);
+      continue;
+    }
+
+    /* The non-core neighbours of the new point are already known */
+    for (size_t j = 0; j < NonCoreNeighbours.size(); j++)
+    {
+      if (IsUnclaimed(NonCoreNeighbours[j]))
+      {
+        ClaimBorder(NonCoreNeighbours[j], NewPoint);
+      }
+    }
+  }
+
+  instrumentation::add(NewCoresCounter, PromotedCores.size());
+}
+
+/* Collects the non-core neighbours of a point. Less than MinPoints
+ * non-cores fit in a ball of Eps/2, so they are a few */
+void IncrementalDBSCAN::FindNonCores(size_t          PointIndex,
+                                     size_t          Subtree,
+                                     vector<size_t>& Neighbours)
+{
+  if (Subtree == NO_POINT ||
+      NonCores.Nodes[Subtree].Live == 0 ||
+      NearestDistance(NonCores, Subtree, PointIndex) > SquaredEps)
+  {
+    return;
+  }
+
+  if (InTree(NonCores, Subtree) && AreNeighbours(PointIndex, Subtree))
+  {
+    Neighbours.push_back(Subtree);
+  }
+
+  FindNonCores(PointIndex, NonCores.Nodes[Subtree].Left,  Neighbours);
+  FindNonCores(PointIndex, NonCores.Nodes[Subtree].Right, Neighbours);
+}
+
+/* Counts the cores around the new point until it reaches MinPoints, first
+ * on the side of each split where the point lies. A subtree that lies
+ * within Eps is counted at once */
+void IncrementalDBSCAN::CountCores(size_t  NewPoint,
+                                   size_t  Subtree,
+                                   size_t& Count,
+                                   size_t& CoreNeighbour)
+{
+  if (Subtree == NO_POINT ||
+      Count >= (size_t) MinPoints ||
+      NearestDistance(Cores, Subtree, NewPoint) > SquaredEps)
+  {
+    return;
+  }
+
+  const TreeNode& Current = Cores.Nodes[Subtree];
+
+  if (FarthestDistance(Cores, Subtree, NewPoint) <= SquaredEps)
+  {
+    Count        += Current.Live;
+    CoreNeighbour = Subtree;
+    return;
+  }
+
+  if (AreNeighbours(NewPoint, Subtree))
+  {
+    Count++;
+    CoreNeighbour = Subtree;
+  }
+
+  size_t Split = Current.SplitDimension;
+
+  if (Coordinates[NewPoint*Dimensions+Split] < Coordinates[Subtree*Dimensions+Split])
+  {
+    CountCores(NewPoint, Current.Left,  Count, CoreNeighbour);
+    CountCores(NewPoint, Current.Right, Count, CoreNeighbour);
+  }
+  else
+  {
+    CountCores(NewPoint, Current.Right, Count, CoreNeighbour);
+    CountCores(NewPoint, Current.Left,  Count, CoreNeighbour);
+  }
+}
+
+/* Marks a point as core and takes it out of the non-cores tree, if it was
+ * there */
+void IncrementalDBSCAN::PromoteToCore(size_t PointIndex, vector<size_t>& NewCores)
+{
+  if (Core[PointIndex])
+  {
+    return;
+  }
+
+  Core[PointIndex]            = true;
+  NeighboursCount[PointIndex] = MinPoints;
+  NewCores.push_back(PointIndex);
+
+  if (NonCores.Nodes[PointIndex].Size > 0)
+  {
+    RemoveNode(NonCores, PointIndex);
+  }
+}
+
+/* Merges the cluster of a new core with the ones of the cores it reaches,
+ * and then hangs it on the cores tree, already in its cluster */
+void IncrementalDBSCAN::ConnectCore(size_t CorePoint)
+{
+  ConnectClusters(CorePoint, Cores.Root);
+  InsertNode(Cores, CorePoint);
+}
+
+/* Subtrees whose cores are already in the cluster of the new core are not
+ * inspected, the ones of a single cluster within Eps are merged at once,
+ * and the inspected ones learn whether they became a single cluster */
+void IncrementalDBSCAN::ConnectClusters(size_t CorePoint, size_t Subtree)
+{
+  if (Subtree == NO_POINT ||
+      NearestDistance(Cores, Subtree, CorePoint) > SquaredEps)
+  {
+    return;
+  }
+
+  const TreeNode& Current = Cores.Nodes[Subtree];
+
+  if (Current.ClusterCore != NO_POINT)
+  {
+    if (FindCluster(Current.ClusterCore) == FindCluster(CorePoint))
+    {
+      return;
+    }
+
+    if (FarthestDistance(Cores, Subtree, CorePoint) <= SquaredEps)
+    {
+      UnionClusters(CorePoint, Current.ClusterCore);
+      return;
+    }
+  }
+
+  if (FindCluster(Subtree) != FindCluster(CorePoint) &&
+      AreNeighbours(CorePoint, Subtree))
+  {
+    UnionClusters(CorePoint, Subtree);
+  }
+
+  ConnectClusters(CorePoint, Current.Left);
+  ConnectClusters(CorePoint, Current.Right);
+
+  UpdateClusterCore(Subtree);
+}
+
+/* Assigns the non-core neighbours with no cluster to the one of the core,
+ * only looking into the subtrees that still have some of them */
+void IncrementalDBSCAN::ClaimBorders(size_t CorePoint, size_t Subtree)
+{
+  if (Subtree == NO_POINT ||
+      NonCores.Nodes[Subtree].Unclaimed == 0 ||
+      NearestDistance(NonCores, Subtree, CorePoint) > SquaredEps)
+  {
+    return;
+  }
+
+  TreeNode& Current = NonCores.Nodes[Subtree];
+
+  if (IsUnclaimed(Subtree) && AreNeighbours(CorePoint, Subtree))
+  {
+    BorderOf[Subtree] = CorePoint;
+  }
+
+  ClaimBorders(CorePoint, Current.Left);
+  ClaimBorders(CorePoint, Current.Right);
+
+  Current.Unclaimed = (IsUnclaimed(Subtree) ? 1 : 0);
+  if (Current.Left != NO_POINT)
+  {
+    Current.Unclaimed += NonCores.Nodes[Current.Left].Unclaimed;
+  }
+  if (Current.Right != NO_POINT)
+  {
+    Current.Unclaimed += NonCores.Nodes[Current.Right].Unclaimed;
+  }
+}
+
+/* Assigns a non-core of the tree to the cluster of a core */
+void IncrementalDBSCAN::ClaimBorder(size_t PointIndex, size_t CorePoint)
+{
+  BorderOf[PointIndex] = CorePoint;
+
+  for (size_t Node = PointIndex; Node != NO_POINT; Node = NonCores.Nodes[Node].Up)
+  {
+    NonCores.Nodes[Node].Unclaimed--;
+  }
+}
+
+bool IncrementalDBSCAN::AreNeighbours(size_t Point1, size_t Point2) const
+{
+  return SquaredEuclideanDistance(&Coordinates[Point1*Dimensions], 1,
+                                  &Coordinates[Point2*Dimensions], 1,
+                                  Dimensions) <= SquaredEps;
+}
+
+/* Distance from a point to the nearest point of the box of a subtree. It is
+ * measured with the same kernel as the points, so it never exceeds the
+ * distance to any of them */
+double IncrementalDBSCAN::NearestDistance(const PointsTree& Tree,
+                                          size_t            Subtree,
+                                          size_t            PointIndex)
+{
+  const double* Point   = &Coordinates[PointIndex*Dimensions];
+  const double* Minimum = &Tree.Bounds[2*Subtree*Dimensions];
+  const double* Maximum = Minimum + Dimensions;
+
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    Corner[Dim] = std::min(std::max(Point[Dim], Minimum[Dim]), Maximum[Dim]);
+  }
+
+  return SquaredEuclideanDistance(Point, 1, &Corner[0], 1, Dimensions);
+}
+
+/* Distance from a point to the farthest corner of the box of a subtree,
+ * never below the distance to any of its points */
+double IncrementalDBSCAN::FarthestDistance(const PointsTree& Tree,
+                                           size_t            Subtree,
+                                           size_t            PointIndex)
+{
+  const double* Point   = &Coordinates[PointIndex*Dimensions];
+  const double* Minimum = &Tree.Bounds[2*Subtree*Dimensions];
+  const double* Maximum = Minimum + Dimensions;
+
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    Corner[Dim] = (Point[Dim] - Minimum[Dim] > Maximum[Dim] - Point[Dim] ?
+                   Minimum[Dim] : Maximum[Dim]);
+  }
+
+  return SquaredEuclideanDistance(Point, 1, &Corner[0], 1, Dimensions);
+}
+
+/* Whether the point of a node still belongs to its tree */
+bool IncrementalDBSCAN::InTree(const PointsTree& Tree, size_t PointIndex) const
+{
+  return Core[PointIndex] == Tree.HoldsCores;
+}
+
+/* Whether a point is a non-core with no cluster */
+bool IncrementalDBSCAN::IsUnclaimed(size_t PointIndex) const
+{
+  return !Core[PointIndex] && BorderOf[PointIndex] == NO_POINT;
+}
+
+/* Hangs a point as a leaf of the tree, and rebuilds the highest unbalanced
+ * subtree on its path when the leaf is too deep */
+void IncrementalDBSCAN::InsertNode(PointsTree& Tree, size_t PointIndex)
+{
+  static counter_id RebuiltNodes = instrumentation::counter("incremental_dbscan.rebuilt_nodes");
+
+  const double* Point   = &Coordinates[PointIndex*Dimensions];
+  TreeNode&     NewNode = Tree.Nodes[PointIndex];
+  size_t        Depth   = 0;
+  size_t        Cluster = (Tree.HoldsCores ? FindCluster(PointIndex) : NO_POINT);
+
+  std::copy(Point, Point + Dimensions, &Tree.Bounds[2*PointIndex*Dimensions]);
+  std::copy(Point, Point + Dimensions, &Tree.Bounds[(2*PointIndex+1)*Dimensions]);
+
+  NewNode.Left        = NO_POINT;
+  NewNode.Right       = NO_POINT;
+  NewNode.Up          = NO_POINT;
+  NewNode.Size        = 1;
+  NewNode.Live        = 1;
+  NewNode.Unclaimed   = (IsUnclaimed(PointIndex) ? 1 : 0);
+  NewNode.ClusterCore = (Tree.HoldsCores ? PointIndex : NO_POINT);
+
+  if (Tree.Root == NO_POINT)
+  {
+    NewNode.SplitDimension = 0;
+    Tree.Root              = PointIndex;
+    return;
+  }
+
+  size_t Current = Tree.Root;
+  while (true)
+  {
+    TreeNode& Node    = Tree.Nodes[Current];
+    double*   Minimum = &Tree.Bounds[2*Current*Dimensions];
+    double*   Maximum = Minimum + Dimensions;
+
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      Minimum[Dim] = std::min(Minimum[Dim], Point[Dim]);
+      Maximum[Dim] = std::max(Maximum[Dim], Point[Dim]);
+    }
+    Node.Size++;
+    Node.Live++;
+    Node.Unclaimed += NewNode.Unclaimed;
+
+    if (Node.ClusterCore != NO_POINT && FindCluster(Node.ClusterCore) != Cluster)
+    {
+      Node.ClusterCore = NO_POINT;
+    }
+    Depth++;
+
+    size_t  Split = Node.SplitDimension;
+    size_t& Child = (Point[Split] < Coordinates[Current*Dimensions+Split] ?
+                     Node.Left : Node.Right);
+
+    if (Child == NO_POINT)
+    {
+      Child                  = PointIndex;
+      NewNode.Up             = Current;
+      NewNode.SplitDimension = (Split + 1) % Dimensions;
+      break;
+    }
+
+    Current = Child;
+  }
+
+  if ((double) Depth <= log((double) Tree.Nodes[Tree.Root].Size) / log(1.0 / BALANCE) + 1)
+  {
+    return;
+  }
+
+  /* Scapegoat: the first ancestor with a child too large for it */
+  for (Current = NewNode.Up; Current != NO_POINT; Current = Tree.Nodes[Current].Up)
+  {
+    size_t Left      = Tree.Nodes[Current].Left;
+    size_t Right     = Tree.Nodes[Current].Right;
+    size_t LeftSize  = (Left  == NO_POINT ? 0 : Tree.Nodes[Left].Size);
+    size_t RightSize = (Right == NO_POINT ? 0 : Tree.Nodes[Right].Size);
+
+    if ((double) std::max(LeftSize, RightSize) > BALANCE * Tree.Nodes[Current].Size)
+    {
+      instrumentation::add(RebuiltNodes, Tree.Nodes[Current].Size);
+      Rebuild(Tree, Current);
+      break;
+    }
+  }
+}
+
+/* Leaves a point that no longer belongs to the tree as a dead node, which
+ * still splits the space but is out of the boxes and the counts. The
+ * highest subtree on its path where dead nodes outnumber the live ones is
+ * rebuilt without them */
+void IncrementalDBSCAN::RemoveNode(PointsTree& Tree, size_t PointIndex)
+{
+  size_t Purged = NO_POINT;
+
+  for (size_t Node = PointIndex; Node != NO_POINT; Node = Tree.Nodes[Node].Up)
+  {
+    UpdateNode(Tree, Node);
+
+    if (Tree.Nodes[Node].Size > 2*Tree.Nodes[Node].Live)
+    {
+      Purged = Node;
+    }
+  }
+
+  if (Purged != NO_POINT)
+  {
+    Rebuild(Tree, Purged);
+  }
+}
+
+/* Rebuilds a subtree with its live points, splitting them by the median
+ * coordinate of the dimension where they spread the most */
+void IncrementalDBSCAN::Rebuild(PointsTree& Tree, size_t Subtree)
+{
+  size_t         Up = Tree.Nodes[Subtree].Up;
+  vector<size_t> SubtreePoints;
+  vector<size_t> Pending (1, Subtree);
+
+  SubtreePoints.reserve(Tree.Nodes[Subtree].Live);
+
+  while (Pending.size() > 0)
+  {
+    size_t    Current = Pending.back();
+    TreeNode& Node    = Tree.Nodes[Current];
+    Pending.pop_back();
+
+    if (Node.Left != NO_POINT)
+    {
+      Pending.push_back(Node.Left);
+    }
+
+    if (Node.Right != NO_POINT)
+    {
+      Pending.push_back(Node.Right);
+    }
+
+    if (InTree(Tree, Current))
+    {
+      SubtreePoints.push_back(Current);
+    }
+    else
+    {
+      Node.Size = 0;
+    }
+  }
+
+  size_t NewSubtree = BuildSubtree(Tree, SubtreePoints, 0, SubtreePoints.size(), Up);
+
+  if (Up == NO_POINT)
+  {
+    Tree.Root = NewSubtree;
+  }
+  else if (Tree.Nodes[Up].Left == Subtree)
+  {
+    Tree.Nodes[Up].Left = NewSubtree;
+  }
+  else
+  {
+    Tree.Nodes[Up].Right = NewSubtree;
+  }
+
+  /* Dead nodes leave the sizes above */
+  for (size_t Node = Up; Node != NO_POINT; Node = Tree.Nodes[Node].Up)
+  {
+    UpdateNode(Tree, Node);
+  }
+}
+
+size_t IncrementalDBSCAN::BuildSubtree(PointsTree&     Tree,
+                                       vector<size_t>& Points,
+                                       size_t          Begin,
+                                       size_t          End,
+                                       size_t          Up)
+{
+  if (Begin == End)
+  {
+    return NO_POINT;
+  }
+
+  size_t Split       = 0;
+  double SplitSpread = -1;
+
+  for (size_t Dim = 0; Dim < Dimensions; Dim++)
+  {
+    double Minimum = Coordinates[Points[Begin]*Dimensions+Dim];
+    double Maximum = Minimum;
+
+    for (size_t i = Begin + 1; i < End; i++)
+    {
+      Minimum = std::min(Minimum, Coordinates[Points[i]*Dimensions+Dim]);
+      Maximum = std::max(Maximum, Coordinates[Points[i]*Dimensions+Dim]);
+    }
+
+    if (Maximum - Minimum > SplitSpread)
+    {
+      Split       = Dim;
+      SplitSpread = Maximum - Minimum;
+    }
+  }
+
+  size_t Middle = Begin + (End - Begin) / 2;
+
+  std::nth_element(Points.begin() + Begin,
+                   Points.begin() + Middle,
+                   Points.begin() + End,
+                   CoordinateOrder(Coordinates, Dimensions, Split));
+
+  size_t    NewSubtree = Points[Middle];
+  TreeNode& Node       = Tree.Nodes[NewSubtree];
+
+  Node.Up             = Up;
+  Node.SplitDimension = Split;
+  Node.Left           = BuildSubtree(Tree, Points, Begin, Middle, NewSubtree);
+  Node.Right          = BuildSubtree(Tree, Points, Middle + 1, End, NewSubtree);
+
+  UpdateNode(Tree, NewSubtree);
+
+  return NewSubtree;
+}
+
+/* Recomputes the box and the counts of a subtree from its point, if it
+ * still belongs to the tree, and its children */
+void IncrementalDBSCAN::UpdateNode(PointsTree& Tree, size_t NodeIndex)
+{
+  TreeNode& Current     = Tree.Nodes[NodeIndex];
+  double*   Minimum     = &Tree.Bounds[2*NodeIndex*Dimensions];
+  double*   Maximum     = Minimum + Dimensions;
+  size_t    Children[2] = { Current.Left, Current.Right };
+
+  Current.Size = 1;
+
+  if (InTree(Tree, NodeIndex))
+  {
+    const double* Point = &Coordinates[NodeIndex*Dimensions];
+
+    std::copy(Point, Point + Dimensions, Minimum);
+    std::copy(Point, Point + Dimensions, Maximum);
+    Current.Live = 1;
+  }
+  else
+  {
+    std::fill(Minimum, Maximum, std::numeric_limits<double>::infinity());
+    std::fill(Maximum, Maximum + Dimensions, -std::numeric_limits<double>::infinity());
+    Current.Live = 0;
+  }
+
+  Current.Unclaimed = (IsUnclaimed(NodeIndex) ? 1 : 0);
+
+  for (size_t i = 0; i < 2; i++)
+  {
+    if (Children[i] == NO_POINT)
+    {
+      continue;
+    }
+
+    Current.Size      += Tree.Nodes[Children[i]].Size;
+    Current.Unclaimed += Tree.Nodes[Children[i]].Unclaimed;
+
+    if (Tree.Nodes[Children[i]].Live == 0)
+    {
+      continue;
+    }
+
+    const double* ChildMinimum = &Tree.Bounds[2*Children[i]*Dimensions];
+    const double* ChildMaximum = ChildMinimum + Dimensions;
+
+    for (size_t Dim = 0; Dim < Dimensions; Dim++)
+    {
+      Minimum[Dim] = std::min(Minimum[Dim], ChildMinimum[Dim]);
+      Maximum[Dim] = std::max(Maximum[Dim], ChildMaximum[Dim]);
+    }
+
+    Current.Live += Tree.Nodes[Children[i]].Live;
+  }
+
+  if (Tree.HoldsCores)
+  {
+    UpdateClusterCore(NodeIndex);
+  }
+}
+
+/* A subtree of the cores tree knows the cluster of its cores when its core
+ * and both children agree on it. Unions only merge clusters, so a known one
+ * stays valid */
+void IncrementalDBSCAN::UpdateClusterCore(size_t NodeIndex)
+{
+  TreeNode& Current     = Cores.Nodes[NodeIndex];
+  size_t    Children[2] = { Current.Left, Current.Right };
+
+  for (size_t i = 0; i < 2; i++)
+  {
+    if (Children[i] == NO_POINT)
+    {
+      continue;
+    }
+
+    size_t ChildCore = Cores.Nodes[Children[i]].ClusterCore;
+
+    if (ChildCore == NO_POINT || FindCluster(ChildCore) != FindCluster(NodeIndex))
+    {
+      Current.ClusterCore = NO_POINT;
+      return;
+    }
+  }
+
+  Current.ClusterCore = NodeIndex;
+}
+
+size_t IncrementalDBSCAN::FindCluster(size_t CorePoint)
+{
+  size_t ClusterRoot = CorePoint;
+
+  while (ClusterParent[ClusterRoot] != ClusterRoot)
+  {
+    ClusterRoot = ClusterParent[ClusterRoot];
+  }
+
+  /* Path compression */
+  while (ClusterParent[CorePoint] != ClusterRoot)
+  {
+    size_t Next = ClusterParent[CorePoint];
+    ClusterParent[CorePoint] = ClusterRoot;
+    CorePoint = Next;
+  }
+
+  return ClusterRoot;
+}
+
+void IncrementalDBSCAN::UnionClusters(size_t Core1, size_t Core2)
+{
+  size_t Root1 = FindCluster(Core1);
+  size_t Root2 = FindCluster(Core2);
+
+  if (Root1 == Root2)
+  {
+    return;
+  }
+
+  if (ClusterRank[Root1] < ClusterRank[Root2])
+  {
+    ClusterParent[Root1] = Root2;
+  }
+  else if (ClusterRank[Root1] > ClusterRank[Root2])
+  {
+    ClusterParent[Root2] = Root1;
+  }
+  else
+  {
+    ClusterParent[Root2] = Root1;
+    ClusterRank[Root1]++;
+  }
+}
@@ -0,0 +1,225 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _INCREMENTALDBSCAN_HPP_
+#define _INCREMENTALDBSCAN_HPP_
+
+#include <Error.hpp>
+using cepba_tools::Error;
+
+#include "clustering_types.h"
+#include "Partition.hpp"
+
+class Point;
+
+#include <vector>
+using std::vector;
+
+#include <map>
+using std::map;
+
+/* DBSCAN that keeps its result while new points keep arriving, e.g. the
+ * bursts of an online analysis. Points are inserted in batches and never
+ * removed, so a core point stays core and clusters only grow or merge.
+ * Clusters are a union-find over the cores.
+ *
+ * Cores and non-cores are kept on two kd-trees over all the dimensions,
+ * rebalanced like scapegoat trees, whose nodes store the box and the number
+ * of points of their subtree. An insertion only visits the subtrees whose
+ * box is within Eps of the new point:
+ *  - on the non-cores tree, to update every non-core neighbour. Less than
+ *    MinPoints non-cores fit in a ball of Eps/2, as they would be cores
+ *    otherwise, so the density of this tree is bounded and so are the
+ *    nodes visited besides the depth, although that bound grows fast with
+ *    the dimensions
+ *  - on the cores tree, to count neighbours until MinPoints, first on the
+ *    side of each split where the point lies, and the subtrees inside the
+ *    Eps ball at once
+ *  - on the cores tree again for each new core, to merge the clusters it
+ *    reaches. Each node keeps a core all the subtree cores share the cluster
+ *    with, if any, so subtrees already in the cluster of the new core are
+ *    skipped and the ones inside the Eps ball are merged at once
+ *
+ * The work of an insertion then depends on the depth of the trees, which is
+ * logarithmic, and on the points around the new one, not on how many points
+ * were seen before. The exception are the cores just beyond Eps of a point
+ * that does not become core, or of a new core facing another cluster, which
+ * are tested one by one. Beyond 2 dimensions no exact method is known to
+ * avoid them, as it would solve a problem believed to be hard (Gan and Tao,
+ * 2017) */
+class IncrementalDBSCAN: public Error
+{
+  private:
+
+    static const size_t NO_POINT;
+    static const double BALANCE;
+
+    struct TreeNode
+    {
+      size_t Left, Right, Up;
+      size_t SplitDimension;
+      size_t Size;        /* Nodes of the subtree, 0 out of the tree */
+      size_t Live;        /* Points of the subtree that belong to the tree */
+      size_t Unclaimed;   /* Live non-cores of the subtree with no cluster */
+      size_t ClusterCore; /* Core in the cluster of all the subtree cores,
+                             NO_POINT if unknown */
+    };
+
+    /* Nodes are indexed by point. A non-core promoted to core stays on the
+     * non-cores tree as a dead node until its subtree is rebuilt */
+    struct PointsTree
+    {
+      bool             HoldsCores;
+      vector<TreeNode> Nodes;
+      vector<double>   Bounds; /* Minimum and maximum corners of each node */
+      size_t           Root;
+    };
+
+    /* Orders points by one of their coordinates */
+    struct CoordinateOrder
+    {
+      const vector<double>& Coordinates;
+      size_t                Dimensions;
+      size_t                Dimension;
+
+      CoordinateOrder(const vector<double>& Coordinates,
+                      size_t                Dimensions,
+                      size_t                Dimension)
+      :Coordinates(Coordinates),
+       Dimensions(Dimensions),
+       Dimension(Dimension)
+      {}
+
+      bool operator()(size_t Point1, size_t Point2) const
+      {
+        return Coordinates[Point1*Dimensions+Dimension] <
+               Coordinates[Point2*Dimensions+Dimension];
+      }
+    };
+
+    double              Eps, SquaredEps;
+    INT32               MinPoints;
+    size_t              Dimensions;
+
+    /* Coordinates of the points, one row per point */
+    vector<double>      Coordinates;
+
+    vector<size_t>      NeighboursCount; /* Saturates at MinPoints */
+    vector<bool>        Core;
+    vector<size_t>      BorderOf;        /* Core neighbour, if any */
+
+    /* Union-find of the cores */
+    vector<size_t>      ClusterParent;
+    vector<size_t>      ClusterRank;
+
+    PointsTree          Cores;
+    PointsTree          NonCores;
+
+    vector<double>      Corner; /* Scratch point of the box distances */
+
+  public:
+
+    IncrementalDBSCAN(double Eps, INT32 MinPoints);
+
+    bool   AddPoints(const vector<const Point*>& Batch);
+
+    void   GetPartition(Partition& CurrentPartition);
+
+    size_t size(void) const { return Core.size(); };
+
+    size_t GetCoresCount(void) const;
+
+  private:
+
+    void   InsertPoint(size_t NewPoint);
+
+    void   FindNonCores(size_t          PointIndex,
+                        size_t          Subtree,
+                        vector<size_t>& Neighbours);
+
+    void   CountCores(size_t  NewPoint,
+                      size_t  Subtree,
+                      size_t& Count,
+                      size_t& CoreNeighbour);
+
+    void   PromoteToCore(size_t PointIndex, vector<size_t>& NewCores);
+
+    void   ConnectCore(size_t CorePoint);
+
+    void   ConnectClusters(size_t CorePoint, size_t Subtree);
+
+    void   ClaimBorders(size_t CorePoint, size_t Subtree);
+
+    void   ClaimBorder(size_t PointIndex, size_t CorePoint);
+
+    bool   AreNeighbours(size_t Point1, size_t Point2) const;
+
+    double NearestDistance(const PointsTree& Tree,
+                           size_t            Subtree,
+                           size_t            PointIndex);
+
+    double FarthestDistance(const PointsTree& Tree,
+                            size_t            Subtree,
+                            size_t            PointIndex);
+
+    bool   InTree(const PointsTree& Tree, size_t PointIndex) const;
+
+    bool   IsUnclaimed(size_t PointIndex) const;
+
+    void   InsertNode(PointsTree& Tree, size_t PointIndex);
+
+    void   RemoveNode(PointsTree& Tree, size_t PointIndex);
+
+    void   Rebuild(PointsTree& Tree, size_t Subtree);
+
+    size_t BuildSubtree(PointsTree&     Tree,
+                        vector<size_t>& Points,
+                        size_t          Begin,
+                        size_t          End,
+                        size_t          Up);
+
+    void   UpdateNode(PointsTree& Tree, size_t NodeIndex);
+
+    void   UpdateClusterCore(size_t NodeIndex);
+
+    size_t FindCluster(size_t CorePoint);
+
+    void   UnionClusters(size_t Core1, size_t Core2);
+
+    /* Owns the trees and the union-find: non-copyable */
+    IncrementalDBSCAN(const IncrementalDBSCAN&);
+    IncrementalDBSCAN& operator=(const IncrementalDBSCAN&);
+};
+
+#endif // _INCREMENTALDBSCAN_HPP_
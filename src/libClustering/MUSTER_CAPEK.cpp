@@ -81,7 +81,7 @@ int CAPEK_Point::packed_size(MPI_Comm comm) const
   int dimensions_size;
   int normalized_size;
 
-  dimensions_size = mpi_packed_size(Dimensions.size(), MPI_DOUBLE, comm);
+  dimensions_size = mpi_packed_size(DimensionsCount, MPI_DOUBLE, comm);
   normalized_size = mpi_packed_size(1, MPI_CHAR, comm);
 
   return (dimensions_size + normalized_size);
@@ -90,12 +90,12 @@ int CAPEK_Point::packed_size(MPI_Comm comm) const
 /// Packs a point into an MPI packed buffer
 void CAPEK_Point::pack(void *buf, int bufsize, int *position, MPI_Comm comm) const
 {
-  double dimensions_buffer[Dimensions.size()];
+  double dimensions_buffer[DimensionsCount];
   char   normalized_buffer = 0;
   
-  for (size_t i = 0; i < Dimensions.size(); i++)
+  for (size_t i = 0; i < DimensionsCount; i++)
   {
-    dimensions_buffer[i] = Dimensions[i];
+    dimensions_buffer[i] = (*this)[i];
   }
 
   if (Normalized)
@@ -103,7 +103,7 @@ void CAPEK_Point::pack(void *buf, int bufsize, int *position, MPI_Comm comm) con
     normalized_buffer = 1;
   }
   
-  MPI_Pack(const_cast<double*>(dimensions_buffer), Dimensions.size(), MPI_DOUBLE, buf, bufsize, position, comm);
+  MPI_Pack(const_cast<double*>(dimensions_buffer), DimensionsCount, MPI_DOUBLE, buf, bufsize, position, comm);
   MPI_Pack(const_cast<char*>(&normalized_buffer), 1, MPI_CHAR, buf, bufsize, position, comm);
 }
 
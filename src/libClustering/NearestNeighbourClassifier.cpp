@@ -36,6 +36,9 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
 #include <cassert>
 
 #include "NearestNeighbourClassifier.hpp"
@@ -50,17 +53,22 @@ NearestNeighbourClassifier::NearestNeighbourClassifier(
   ANNpointArray       ANNDataPoints;
   size_t Dimensions = Data[0]->size();
 
-  system_messages::show_progress("Building data spatial index", 0, Data.size());
+  ProgressReporter Progress ("Building data spatial index", Data.size());
   
   ANNDataPoints = annAllocPts(Data.size(), Dimensions);
 
+  /* Fill the contiguous block allocated by 'annAllocPts', in the ANN
+   * coordinate type (float on single precision builds) */
   for (size_t i = 0; i < Data.size(); i++)
   {
-    system_messages::show_progress("Building data spatial index", i, Data.size());
-    ANNDataPoints[i] = ToANNPoint(Data[i]);
+    for (size_t j = 0; j < Dimensions; j++)
+    {
+      ANNDataPoints[i][j] = (ANNcoord) (*Data[i])[j];
+    }
+    Progress.increment();
   }
 
-  system_messages::show_progress_end("Building data spatial index", Data.size());
+  Progress.end();
 
   SpatialIndex = new ANNkd_tree(ANNDataPoints,
                                 Data.size(),
@@ -138,7 +146,7 @@ NearestNeighbourClassifier::ToANNPoint(Point* InputPoint)
 
   for (size_t i = 0; i < InputPoint->size(); i++)
   {
-    Result[i] = (*InputPoint)[i];
+    Result[i] = (ANNcoord) (*InputPoint)[i];
   }
 
   return Result;
@@ -35,6 +35,9 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
 #include "OPTICS.hpp"
 
 #include "Point.hpp"
@@ -165,9 +168,9 @@ bool OPTICS::Run(const vector<const Point*>& Data,
   /* Build KD-Tree */
   BuildKDTree(Data);
 
-  system_messages::show_progress("Clustering points", 0, (int) Data.size());
+  ProgressReporter Progress ("Clustering points", Data.size());
 
-  system_messages::show_progress_end("Clustering points", (int) Data.size());
+  Progress.end();
 
   /* NOISE cluster has to be considered as a cluster, to mantain coherence across the namings */
 
@@ -200,17 +203,22 @@ bool OPTICS::BuildKDTree(const vector<const Point*>& Data)
 /*  cout << "Current clustering has " << Dimensions << " dimensions" << endl; */
 #endif
   
-  system_messages::show_progress("Building data spatial index", 0, Data.size());
+  ProgressReporter Progress ("Building data spatial index", Data.size());
   
   ANNDataPoints = annAllocPts(Data.size(), Dimensions);
 
+  /* Fill the contiguous block allocated by 'annAllocPts', in the ANN
+   * coordinate type (float on single precision builds) */
   for (size_t i = 0; i < Data.size(); i++)
   {
-    system_messages::show_progress("Building data spatial index", i, Data.size());
-    ANNDataPoints[i] = ToANNPoint(Data[i]);
+    for (size_t j = 0; j < Dimensions; j++)
+    {
+      ANNDataPoints[i][j] = (ANNcoord) (*Data[i])[j];
+    }
+    Progress.increment();
   }
 
-  system_messages::show_progress_end("Building data spatial index", Data.size());
+  Progress.end();
 
   SpatialIndex = new ANNkd_tree(ANNDataPoints,
                                 Data.size(),
@@ -226,7 +234,7 @@ ANNpoint OPTICS::ToANNPoint(const Point* InputPoint)
 
   for (size_t i = 0; i < InputPoint->size(); i++)
   {
-    Result[i] = (*InputPoint)[i];
+    Result[i] = (ANNcoord) (*InputPoint)[i];
   }
 
   return Result;
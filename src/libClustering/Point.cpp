@@ -33,6 +33,7 @@
 \* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
 
 #include "Point.hpp"
+#include <DistanceKernels.hpp>
 
 #include <cmath>
 #include <cassert>
@@ -48,10 +49,29 @@ instance_t Point::InstanceNumber = 0;
 size_t Point::PointDimensions = 0;
 #endif
 
+Point::Point()
+{
+  Instance          = 0;
+  Dimensions        = NULL;
+  DimensionsCount   = 0;
+  Stride            = 1;
+  NeighbourhoodSize = 0;
+  Normalized        = false;
+  OwnDimensions     = false;
+}
+
 Point::Point(size_t Dimensions)
 {
-  this->Instance   = (Point::InstanceNumber++);
-  this->Dimensions = vector<double> (Dimensions, 0.0);
+  this->Instance          = (Point::InstanceNumber++);
+  this->NeighbourhoodSize = 0;
+  this->Normalized        = false;
+
+  AllocateDimensions(Dimensions);
+
+  for (size_t i = 0; i < Dimensions; i++)
+  {
+    this->Dimensions[i] = 0.0;
+  }
 
 #if defined (HAVE_MUSTER) && defined (HAVE_MPI)
   if (Point::PointDimensions == 0)
@@ -61,10 +81,17 @@ Point::Point(size_t Dimensions)
 #endif
 }
 
-Point::Point(vector<double>& _Dimensions)
+Point::Point(const vector<double>& _Dimensions)
 {
-  Dimensions = _Dimensions;
-  Normalized = false;
+  Normalized        = false;
+  NeighbourhoodSize = 0;
+
+  AllocateDimensions(_Dimensions.size());
+
+  for (size_t i = 0; i < _Dimensions.size(); i++)
+  {
+    Dimensions[i] = _Dimensions[i];
+  }
 
   this->Instance   = (Point::InstanceNumber++);
 
@@ -80,11 +107,18 @@ Point::Point(vector<double>& _Dimensions)
   */
 }
 
-Point::Point(instance_t _Instance, vector<double>& _Dimensions)
+Point::Point(instance_t _Instance, const vector<double>& _Dimensions)
 {
-  Instance   = _Instance;
-  Dimensions = _Dimensions;
-  Normalized = true;
+  Instance          = _Instance;
+  Normalized        = true;
+  NeighbourhoodSize = 0;
+
+  AllocateDimensions(_Dimensions.size());
+
+  for (size_t i = 0; i < _Dimensions.size(); i++)
+  {
+    Dimensions[i] = _Dimensions[i];
+  }
 
 #if defined (HAVE_MUSTER) && defined (HAVE_MPI)
   if (Point::PointDimensions == 0)
@@ -94,9 +128,37 @@ Point::Point(instance_t _Instance, vector<double>& _Dimensions)
 #endif
 }
 
-vector<double>& Point::GetDimensions(void)
+/* Copies always own their coordinates, even if the original point is a row
+ * of an external block */
+Point::Point(const Point& other)
 {
-  return Dimensions;
+  Instance          = other.Instance;
+  Normalized        = other.Normalized;
+  NeighbourhoodSize = other.NeighbourhoodSize;
+
+  AllocateDimensions(other.size());
+
+  for (size_t i = 0; i < other.size(); i++)
+  {
+    Dimensions[i] = other[i];
+  }
+}
+
+Point::~Point()
+{
+  ReleaseDimensions();
+}
+
+vector<double> Point::GetDimensions(void) const
+{
+  vector<double> Result (DimensionsCount);
+
+  for (size_t i = 0; i < DimensionsCount; i++)
+  {
+    Result[i] = Dimensions[i*Stride];
+  }
+
+  return Result;
 }
 
 void
@@ -117,11 +179,11 @@ Point::RangeNormalization(const vector<double>& MaxValues,
 
 
 
-  for (size_t i = 0; i < Dimensions.size(); i++)
+  for (size_t i = 0; i < DimensionsCount; i++)
   {
-    BaseValue = Dimensions[i];
+    BaseValue = (*this)[i];
 
-    Dimensions[i] = Factors[i]*((BaseValue - MinValues[i]) / (MaxValues[i] - MinValues[i]));
+    (*this)[i] = Factors[i]*((BaseValue - MinValues[i]) / (MaxValues[i] - MinValues[i]));
   }
 
   Normalized = true;
@@ -138,49 +200,79 @@ Point::RangeNormalization(const vector<double>& MaxValues,
 
 double Point::EuclideanDistance(const Point& OtherPoint) const
 {
-  double Result = std::numeric_limits<double>::max();
-
-  if (Dimensions.size() != OtherPoint.size())
+  if (DimensionsCount != OtherPoint.size())
   {
-    return Result;
+    return std::numeric_limits<double>::max();
   }
-  else
-  {
-    Result = 0.0;
-
-    for (size_t i = 0; i < Dimensions.size(); i++)
-    {
 
-      Result += pow(Dimensions[i] - OtherPoint.Dimensions[i], 2.0);
-    }
-
-    return sqrt(Result);
-  }
+  return sqrt(SquaredEuclideanDistance(OtherPoint));
 }
 
-size_t Point::size(void) const
+double Point::SquaredEuclideanDistance(const Point& OtherPoint) const
 {
-  return Dimensions.size();
-}
+  if (DimensionsCount != OtherPoint.size())
+  {
+    return std::numeric_limits<double>::max();
+  }
 
-void Point::clear(void)
-{
-  Dimensions.clear();
-  Normalized = false;
+  return ::SquaredEuclideanDistance(Dimensions,
+                                    Stride,
+                                    OtherPoint.Dimensions,
+                                    OtherPoint.Stride,
+                                    DimensionsCount);
 }
 
-double& Point::operator[](int i)
+/**
+ * Squared distances to a set of points, in a single batch when all of them
+ * share the dimensions and the stride (e.g. rows of the same storage block)
+ * \param OtherPoints Points to compare with
+ * \param Distances Resulting distances, in the same order as 'OtherPoints'
+ */
+void Point::SquaredEuclideanDistances(const vector<const Point*>& OtherPoints,
+                                      vector<double>&             Distances) const
 {
-  assert(i >= 0 && i < Dimensions.size());
+  vector<const double*> Targets (OtherPoints.size());
+  bool                  Uniform = true;
+
+  Distances.resize(OtherPoints.size());
+
+  for (size_t i = 0; i < OtherPoints.size(); i++)
+  {
+    if (OtherPoints[i]->DimensionsCount != DimensionsCount ||
+        OtherPoints[i]->Stride          != OtherPoints[0]->Stride)
+    {
+      Uniform = false;
+      break;
+    }
+
+    Targets[i] = OtherPoints[i]->Dimensions;
+  }
 
-  return Dimensions[i];
+  if (!Uniform)
+  {
+    for (size_t i = 0; i < OtherPoints.size(); i++)
+    {
+      Distances[i] = SquaredEuclideanDistance(*OtherPoints[i]);
+    }
+    return;
+  }
+
+  if (OtherPoints.size() > 0)
+  {
+    ::SquaredEuclideanDistances(Dimensions,
+                                Stride,
+                                &Targets[0],
+                                OtherPoints[0]->Stride,
+                                OtherPoints.size(),
+                                DimensionsCount,
+                                &Distances[0]);
+  }
 }
 
-double Point::operator[](int i) const
+void Point::clear(void)
 {
-  assert(i >= 0 && i < Dimensions.size());
-
-  return Dimensions[i];
+  ReleaseDimensions();
+  Normalized = false;
 }
 
 Point Point::operator +  (const Point& other)
@@ -220,9 +312,9 @@ bool Point::operator != (const Point& other) const
   if (this->size() != other.size())
     return true;
 
-  for (size_t i = 0; i < Dimensions.size(); i++)
+  for (size_t i = 0; i < DimensionsCount; i++)
   {
-    if (this[i] != other[i])
+    if ((*this)[i] != other[i])
     {
       return true;
     }
@@ -235,11 +327,15 @@ Point& Point::operator =  (const Point& other)
 {
   if ((*this) != other)
   {
-    Dimensions.clear();
+    if (DimensionsCount != other.size())
+    { /* Different sizes can only be stored in an owned buffer */
+      ReleaseDimensions();
+      AllocateDimensions(other.size());
+    }
 
     for (size_t i = 0; i < other.size(); i++)
     {
-      Dimensions.push_back(other[i]);
+      (*this)[i] = other[i];
     }
   }
 
@@ -248,9 +344,58 @@ Point& Point::operator =  (const Point& other)
 
 void Point::PrintPoint(void)
 {
-  for (size_t i = 0; i < Dimensions.size(); i++)
+  for (size_t i = 0; i < DimensionsCount; i++)
   {
-    cout << " [" << i << "] = " << Dimensions[i];
+    cout << " [" << i << "] = " << (*this)[i];
   }
   cout << endl;
 }
+
+/**
+ * Makes the point coordinates a row of an external block
+ * \param Storage Address of the first coordinate
+ * \param Count Number of coordinates
+ * \param Stride Distance, in doubles, between two consecutive coordinates
+ * \param TakeOwnership If true, the block is released along with the point
+ *        (it must have been allocated using 'new []')
+ */
+void Point::AttachDimensions(double* Storage,
+                             size_t  Count,
+                             UINT32  Stride,
+                             bool    TakeOwnership)
+{
+  ReleaseDimensions();
+
+  this->Dimensions      = Storage;
+  this->DimensionsCount = (UINT32) Count;
+  this->Stride          = Stride;
+  this->OwnDimensions   = TakeOwnership;
+
+#if defined (HAVE_MUSTER) && defined (HAVE_MPI)
+  if (Point::PointDimensions == 0)
+  {
+    Point::PointDimensions = Count;
+  }
+#endif
+}
+
+void Point::AllocateDimensions(size_t Count)
+{
+  Dimensions      = (Count > 0 ? new double[Count] : NULL);
+  DimensionsCount = (UINT32) Count;
+  Stride          = 1;
+  OwnDimensions   = true;
+}
+
+void Point::ReleaseDimensions(void)
+{
+  if (OwnDimensions && Dimensions != NULL)
+  {
+    delete [] Dimensions;
+  }
+
+  Dimensions      = NULL;
+  DimensionsCount = 0;
+  Stride          = 1;
+  OwnDimensions   = false;
+}
@@ -38,6 +38,8 @@
 #include <vector>
 using std::vector;
 
+#include <cassert>
+
 #include "clustering_types.h"
 
 class Point
@@ -46,10 +48,18 @@ class Point
 
 
   protected:
-    instance_t     Instance;
-    vector<double> Dimensions;
-    bool           Normalized;
-    size_t         NeighbourhoodSize;
+    instance_t Instance;
+
+    /* Coordinates are accessed through a strided pointer, so a point can
+     * either own a contiguous buffer or be a row of an external column-major
+     * block (see 'BurstsStorage' on libSharedComponents) */
+    double*    Dimensions;
+    UINT32     DimensionsCount;
+    UINT32     Stride;
+
+    UINT32     NeighbourhoodSize;
+    bool       Normalized;
+    bool       OwnDimensions;
 
   public:
     static instance_t InstanceNumber;
@@ -58,19 +68,27 @@ class Point
     static size_t PointDimensions;
 #endif
 
-    Point() {};
+    Point();
 
     Point(size_t Dimensions);
 
-    Point(vector<double>& _Dimensions);
+    Point(const vector<double>& _Dimensions);
+
+    Point(instance_t _Instance, const vector<double>& _Dimensions);
 
-    Point(instance_t _Instance, vector<double>& _Dimensions);
+    Point(const Point& other);
+
+    ~Point();
 
     instance_t GetInstance(void) const { return this->Instance; }
 
-    vector<double>& GetDimensions(void);
+    vector<double> GetDimensions(void) const;
+
+    const double* GetDimensionsData(void) const { return Dimensions; };
+    double*       GetDimensionsData(void)       { return Dimensions; };
+    UINT32        GetStride(void) const         { return Stride; };
 
-    void       SetNeighbourhoodSize(size_t NeighbourhoodSize) { this->NeighbourhoodSize = NeighbourhoodSize; }
+    void       SetNeighbourhoodSize(size_t NeighbourhoodSize) { this->NeighbourhoodSize = (UINT32) NeighbourhoodSize; }
     size_t     GetNeighbourhoodSize(void) const               { return this->NeighbourhoodSize; }
 
     void   RangeNormalization(const vector<double>& MaxValues,
@@ -81,6 +99,11 @@ class Point
 
     double EuclideanDistance(const Point& OtherPoint) const;
 
+    double SquaredEuclideanDistance(const Point& OtherPoint) const;
+
+    void   SquaredEuclideanDistances(const vector<const Point*>& OtherPoints,
+                                     vector<double>&             Distances) const;
+
     double NormalizedEuclideanDistance(Point& OtherPoint) const;
 
     bool   IsNormalized(void) const { return Normalized; };
@@ -88,10 +111,10 @@ class Point
 
     void   clear(void);
 
-    size_t size(void) const;
+    size_t size(void) const { return DimensionsCount; };
 
-    double& operator [] (int i);
-    double  operator [] (int i) const;
+    double& operator [] (int i)       { assert(i >= 0 && i < (int) DimensionsCount); return Dimensions[i*Stride]; };
+    double  operator [] (int i) const { assert(i >= 0 && i < (int) DimensionsCount); return Dimensions[i*Stride]; };
     Point   operator +  (const Point& other);
     Point   operator /  (const size_t scalar);
     bool    operator != (const Point& other) const;
@@ -101,8 +124,19 @@ class Point
 
     void PrintPoint(void);
 
+  protected:
+
+    void   AttachDimensions(double* Storage,
+                            size_t  Count,
+                            UINT32  Stride,
+                            bool    TakeOwnership = false);
+
   private:
 
+    void   AllocateDimensions(size_t Count);
+
+    void   ReleaseDimensions(void);
+
 };
 
 /*
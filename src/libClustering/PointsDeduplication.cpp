@@ -0,0 +1,164 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "PointsDeduplication.hpp"
+#include "Point.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include <map>
+using std::map;
+using std::make_pair;
+
+PointsDeduplication::PointsDeduplication(double GridSide)
+{
+  this->GridSide = GridSide;
+}
+
+/**
+ * Groups the points per grid cell, keeping the order of first appearance so
+ * the algorithms visit the representatives as they would visit the points
+ *
+ * \param Data Points to be collapsed
+ */
+void PointsDeduplication::Run(const vector<const Point*>& Data)
+{
+  map<vector<long long>, size_t>           Cells;
+  map<vector<long long>, size_t>::iterator CellIt;
+  vector<long long>                        Key;
+
+  Representatives.clear();
+  Weights.clear();
+  RepresentativeOf.assign(Data.size(), 0);
+
+  for (size_t i = 0; i < Data.size(); i++)
+  {
+    if (!GetKey(Data[i], Key))
+    {
+      /* A cell of its own */
+      RepresentativeOf[i] = Representatives.size();
+      Representatives.push_back(Data[i]);
+      Weights.push_back(1);
+      continue;
+    }
+
+    CellIt = Cells.find(Key);
+    if (CellIt == Cells.end())
+    {
+      CellIt = Cells.insert(make_pair(Key, Representatives.size())).first;
+      Representatives.push_back(Data[i]);
+      Weights.push_back(0);
+    }
+
+    RepresentativeOf[i] = CellIt->second;
+    Weights[CellIt->second]++;
+  }
+}
+
+/**
+ * Builds the assignment of the representatives from the one of the original
+ * points, taking the value of the first point of each cell
+ */
+void PointsDeduplication::ReduceAssignment(const vector<cluster_id_t>& Assignment,
+                                           vector<cluster_id_t>&       ReducedAssignment) const
+{
+  vector<bool> Seen (Representatives.size(), false);
+
+  ReducedAssignment.assign(Representatives.size(), UNCLASSIFIED);
+
+  for (size_t i = 0; i < Assignment.size(); i++)
+  {
+    if (!Seen[RepresentativeOf[i]])
+    {
+      ReducedAssignment[RepresentativeOf[i]] = Assignment[i];
+      Seen[RepresentativeOf[i]]              = true;
+    }
+  }
+}
+
+/**
+ * Copies the assignment of each representative to all the points it stands for
+ */
+void PointsDeduplication::ExpandAssignment(const vector<cluster_id_t>& ReducedAssignment,
+                                           vector<cluster_id_t>&       Assignment) const
+{
+  Assignment.resize(RepresentativeOf.size());
+
+  for (size_t i = 0; i < RepresentativeOf.size(); i++)
+  {
+    Assignment[i] = ReducedAssignment[RepresentativeOf[i]];
+  }
+}
+
+/* Exact duplicates are keyed by the bit pattern of their coordinates, with
+ * -0.0 turned into 0.0 so both match. Returns false when the point has no
+ * cell: a NaN coordinate, which equals nothing, or a cell index out of the
+ * range of the key */
+bool PointsDeduplication::GetKey(const Point*       DataPoint,
+                                 vector<long long>& Key) const
+{
+  const double KeyLimit = ldexp(1.0, 63);
+
+  Key.resize(DataPoint->size());
+
+  for (size_t Dim = 0; Dim < DataPoint->size(); Dim++)
+  {
+    double Value = (*DataPoint)[Dim];
+
+    if (Value != Value)
+    {
+      return false;
+    }
+
+    if (GridSide > 0)
+    {
+      double Cell = floor(Value / GridSide);
+
+      if (!(Cell >= -KeyLimit && Cell < KeyLimit))
+      {
+        return false;
+      }
+
+      Key[Dim] = (long long) Cell;
+    }
+    else
+    {
+      Value += 0.0;
+      memcpy(&Key[Dim], &Value, sizeof(long long));
+    }
+  }
+
+  return true;
+}
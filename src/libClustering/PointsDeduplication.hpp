@@ -0,0 +1,81 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _POINTSDEDUPLICATION_HPP_
+#define _POINTSDEDUPLICATION_HPP_
+
+#include "clustering_types.h"
+
+class Point;
+
+#include <vector>
+using std::vector;
+
+/* Collapses the points that fall on the same cell of a grid into a single
+ * weighted representative (the first point of the cell). A grid side of 0
+ * only collapses points with exactly the same coordinates. Algorithms run on
+ * the representatives and expand their assignment to every original point */
+class PointsDeduplication
+{
+  private:
+
+    double               GridSide;
+
+    vector<const Point*> Representatives;
+    vector<size_t>       Weights;
+    vector<size_t>       RepresentativeOf; /* One per original point */
+
+  public:
+
+    PointsDeduplication(double GridSide = 0.0);
+
+    void Run(const vector<const Point*>& Data);
+
+    const vector<const Point*>& GetRepresentatives(void) const { return Representatives; };
+    const vector<size_t>&       GetWeights(void) const         { return Weights; };
+
+    size_t GetRepresentative(size_t PointIndex) const { return RepresentativeOf[PointIndex]; };
+
+    void ReduceAssignment(const vector<cluster_id_t>& Assignment,
+                          vector<cluster_id_t>&       ReducedAssignment) const;
+
+    void ExpandAssignment(const vector<cluster_id_t>& ReducedAssignment,
+                          vector<cluster_id_t>&       Assignment) const;
+
+  private:
+
+    bool GetKey(const Point* DataPoint, vector<long long>& Key) const;
+};
+
+#endif /* _POINTSDEDUPLICATION_HPP_ */
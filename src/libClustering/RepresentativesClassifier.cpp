@@ -0,0 +1,161 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "clustering_types.h"
+
+#include <cmath>
+
+#include "RepresentativesClassifier.hpp"
+
+RepresentativesClassifier::~RepresentativesClassifier(void)
+{
+  if (Index != NULL)
+  {
+    delete Index;
+  }
+}
+
+bool RepresentativesClassifier::Classify(vector<const Point*>& Data,
+                                         Partition&            DataPartition)
+{
+  return Classify(Data.begin(), Data.end(), (size_t) Data.size(), DataPartition);
+}
+
+
+bool RepresentativesClassifier::Classify(const Point* QueryPoint, cluster_id_t& ID)
+{
+  if (QueryPoint == NULL)
+  {
+    ID = NOISE_CLUSTERID;
+    SetErrorMessage("no point to classify!");
+    SetError(true);
+    return false;
+  }
+
+  ID = ClassifyPoint(QueryPoint);
+
+  return true;
+}
+
+/* Puts the representatives of all models together and indexes them */
+void RepresentativesClassifier::BuildIndex(void)
+{
+  Dimensions = 0;
+
+  for (size_t i = 0; i < Models.size(); i++)
+  {
+    const vector<double>&    ModelValues = Models[i].GetValues();
+    const vector<long long>& ModelSizes  = Models[i].GetNeighbourhoodSizes();
+
+    if (Models[i].size() == 0)
+      continue;
+
+    if (Dimensions == 0)
+    {
+      Dimensions = Models[i].GetDimensions();
+    }
+    else if (Dimensions != Models[i].GetDimensions())
+    {
+      continue;
+    }
+
+    Values.insert(Values.end(), ModelValues.begin(), ModelValues.end());
+    NeighbourhoodSizes.insert(NeighbourhoodSizes.end(), ModelSizes.begin(), ModelSizes.end());
+    Owners.insert(Owners.end(), ModelSizes.size(), i);
+  }
+
+  if (Dimensions > 0 && Eps > 0)
+  {
+    Index = new RepresentativesIndex(Values, Dimensions, Eps);
+  }
+}
+
+/* Same criteria as the hulls: the first model (in order) that includes the
+ * point, this is, has a representative closer than the cover radius,
+ * otherwise the model of the closest representative within Eps with enough
+ * density */
+cluster_id_t RepresentativesClassifier::ClassifyPoint(const Point* QueryPoint)
+{
+  double         SqEpsilon     = Eps * Eps;
+  double         SqRadius      = SqEpsilon * REPRESENTATIVES_COVER_RADIUS * REPRESENTATIVES_COVER_RADIUS;
+  double         MinSqDistance = MAX_DOUBLE;
+  size_t         Inside        = Models.size();
+  cluster_id_t   ID            = NOISE_CLUSTERID;
+  vector<double> Query;
+  vector<size_t> Candidates;
+
+  if (QueryPoint == NULL || Index == NULL || QueryPoint->size() != (size_t) Dimensions)
+  {
+    return NOISE_CLUSTERID;
+  }
+
+  Query.resize(Dimensions);
+  for (int Dim = 0; Dim < Dimensions; Dim++)
+  {
+    Query[Dim] = (*QueryPoint)[Dim];
+  }
+
+  Index->Candidates(&Query[0], Candidates);
+
+  for (size_t j = 0; j < Candidates.size(); j++)
+  {
+    const double* Current     = &Values[Candidates[j]*Dimensions];
+    double        sqrDistance = 0;
+
+    for (int Dim = 0; Dim < Dimensions && sqrDistance <= SqEpsilon; Dim++)
+    {
+      sqrDistance += (Current[Dim] - Query[Dim]) * (Current[Dim] - Query[Dim]);
+    }
+
+    if (sqrDistance <= SqRadius && Owners[Candidates[j]] < Inside)
+    {
+      Inside = Owners[Candidates[j]];
+    }
+
+    if ((sqrDistance <= SqEpsilon) &&
+        (sqrDistance < MinSqDistance) &&
+        (NeighbourhoodSizes[Candidates[j]]+(long long) QueryPoint->GetNeighbourhoodSize()+1) >= MinPoints)
+    {
+      MinSqDistance = sqrDistance;
+      ID            = (cluster_id_t) Owners[Candidates[j]]+1;
+    }
+  }
+
+  if (Inside < Models.size())
+  {
+    return (cluster_id_t) Inside+1;
+  }
+
+  return ID;
+}
@@ -0,0 +1,198 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _REPRESENTATIVES_CLASSIFIER_HPP_
+#define _REPRESENTATIVES_CLASSIFIER_HPP_
+
+#include <Error.hpp>
+using cepba_tools::Error;
+#include <SystemMessages.hpp>
+using cepba_tools::system_messages;
+
+#include "Classifier.hpp"
+#include "RepresentativesModel.hpp"
+
+#include <set>
+using std::set;
+
+#include <sstream>
+using std::ostringstream;
+
+#include <ParallelFor.hpp>
+
+/* Points collected from the input iterators before classifying them in
+ * parallel (as in the convex hull classifier) */
+#define REPRESENTATIVES_CLASSIFICATION_BLOCK     65536
+#define REPRESENTATIVES_CLASSIFICATION_MIN_CHUNK 1024
+
+/* Forward declarations */
+class RepresentativesClassifyTask;
+
+class RepresentativesClassifier: public Classifier
+{
+  friend class RepresentativesClassifyTask;
+
+  protected:
+
+    double                        Eps;
+    int                           MinPoints;
+    vector<RepresentativesModel>& Models;
+
+    /* Representatives of all models, with the model they belong to */
+    int                           Dimensions;
+    vector<double>                Values;
+    vector<long long>             NeighbourhoodSizes;
+    vector<size_t>                Owners;
+    RepresentativesIndex*         Index;
+
+  public:
+
+    RepresentativesClassifier(vector<RepresentativesModel>& _Models,
+                              double                        _Eps,
+                              int                           _MinPoints):
+    Eps(_Eps),
+    MinPoints(_MinPoints),
+    Models(_Models)
+    {
+      ostringstream Message;
+      Message << "Classifier - Total Models = " << _Models.size();
+      Message << " Epsilon = " << _Eps;
+      Message << " MinPoints = " << _MinPoints << std::endl;
+      system_messages::information(Message.str());
+
+      Index = NULL;
+      BuildIndex();
+    };
+
+    ~RepresentativesClassifier(void);
+
+    bool Classify(vector<const Point*>& Data,
+                  Partition&            DataPartition);
+
+    template <typename T>
+    bool Classify(T begin, T end, size_t size, Partition& DataPartition);
+
+    bool Classify(const Point* QueryPoint, cluster_id_t& ID);
+
+  private:
+
+    /* Owns the index of the representatives: non-copyable */
+    RepresentativesClassifier(const RepresentativesClassifier&);
+    RepresentativesClassifier& operator=(const RepresentativesClassifier&);
+
+    void         BuildIndex(void);
+
+    cluster_id_t ClassifyPoint(const Point* QueryPoint);
+
+};
+
+/* Functor to classify a block of points through 'parallel_for' */
+class RepresentativesClassifyTask
+{
+  private:
+    RepresentativesClassifier& Classifier;
+    vector<const Point*>&      Points;
+    vector<cluster_id_t>&      IDs;
+
+  public:
+    RepresentativesClassifyTask(RepresentativesClassifier& Classifier,
+                                vector<const Point*>&      Points,
+                                vector<cluster_id_t>&      IDs):
+    Classifier(Classifier),
+    Points(Points),
+    IDs(IDs)
+    {};
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        IDs[i] = Classifier.ClassifyPoint(Points[i]);
+      }
+    }
+};
+
+template <typename T>
+bool RepresentativesClassifier::Classify(T          begin,
+                                         T          end,
+                                         size_t     size,
+                                         Partition& DataPartition)
+{
+  T PointsIt;
+
+  vector<cluster_id_t>& AssignmentVector = DataPartition.GetAssignmentVector();
+  set<cluster_id_t>     DifferentIDs;
+  vector<bool>          UsedIDs (Models.size()+1, false);
+
+  vector<const Point*>  Block;
+  vector<cluster_id_t>  BlockIDs;
+
+  AssignmentVector.reserve(AssignmentVector.size()+size);
+
+  PointsIt = begin;
+  while (PointsIt != end)
+  {
+    Block.clear();
+    while (PointsIt != end && Block.size() < REPRESENTATIVES_CLASSIFICATION_BLOCK)
+    {
+      Block.push_back((const Point*) (*PointsIt));
+      ++PointsIt;
+    }
+
+    BlockIDs.resize(Block.size());
+
+    RepresentativesClassifyTask Task(*this, Block, BlockIDs);
+    cepba_tools::parallel_for(Task, 0, Block.size(), REPRESENTATIVES_CLASSIFICATION_MIN_CHUNK);
+
+    for (size_t i = 0; i < BlockIDs.size(); i++)
+    {
+      AssignmentVector.push_back(BlockIDs[i]);
+      UsedIDs[BlockIDs[i]] = true;
+    }
+  }
+
+  for (size_t i = 0; i < UsedIDs.size(); i++)
+  {
+    if (UsedIDs[i])
+    {
+      DifferentIDs.insert((cluster_id_t) i);
+    }
+  }
+
+  DataPartition.SetIDs(DifferentIDs);
+
+  return true;
+}
+
+#endif /* _REPRESENTATIVES_CLASSIFIER_HPP_ */
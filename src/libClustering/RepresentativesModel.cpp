@@ -0,0 +1,480 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "RepresentativesModel.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+/****************************************************************************
+ * RepresentativesIndex
+ ***************************************************************************/
+
+RepresentativesIndex::RepresentativesIndex(int Dimensions, double Eps)
+{
+  this->Dimensions      = Dimensions;
+  this->IndexDimensions = (Dimensions < REPRESENTATIVES_INDEX_DIMENSIONS ? Dimensions : REPRESENTATIVES_INDEX_DIMENSIONS);
+  this->Eps             = Eps;
+}
+
+RepresentativesIndex::RepresentativesIndex(const vector<double>& Values,
+                                           int                   Dimensions,
+                                           double                Eps)
+{
+  size_t NumPoints = (Dimensions > 0 ? Values.size() / Dimensions : 0);
+
+  this->Dimensions      = Dimensions;
+  this->IndexDimensions = (Dimensions < REPRESENTATIVES_INDEX_DIMENSIONS ? Dimensions : REPRESENTATIVES_INDEX_DIMENSIONS);
+  this->Eps             = Eps;
+
+  for (size_t i = 0; i < NumPoints; i++)
+  {
+    Add(&Values[i*Dimensions], i);
+  }
+}
+
+void RepresentativesIndex::Add(const double* Values, size_t Index)
+{
+  vector<long long> Key;
+
+  GetKey(Values, Key);
+  Cells[Key].push_back(Index);
+}
+
+/* Indices of the points in the cell of the query and its neighbours: all
+ * points closer than Eps to the query are among them */
+void RepresentativesIndex::Candidates(const double* Query, vector<size_t>& Indices) const
+{
+  vector<long long> Key, Neighbour;
+  vector<int>       Offset (IndexDimensions, -1);
+  bool              Done = (IndexDimensions == 0 || Cells.size() == 0);
+
+  GetKey(Query, Key);
+  Neighbour.resize(IndexDimensions);
+
+  while (!Done)
+  {
+    CellsMap::const_iterator Cell;
+
+    for (int Dim = 0; Dim < IndexDimensions; Dim++)
+    {
+      Neighbour[Dim] = Key[Dim] + Offset[Dim];
+    }
+
+    Cell = Cells.find(Neighbour);
+    if (Cell != Cells.end())
+    {
+      Indices.insert(Indices.end(), Cell->second.begin(), Cell->second.end());
+    }
+
+    /* Next offset in {-1, 0, 1}^IndexDimensions */
+    Done = true;
+    for (int Dim = 0; Dim < IndexDimensions; Dim++)
+    {
+      if (Offset[Dim] < 1)
+      {
+        Offset[Dim]++;
+        Done = false;
+        break;
+      }
+      Offset[Dim] = -1;
+    }
+  }
+}
+
+void RepresentativesIndex::GetKey(const double* Values, vector<long long>& Key) const
+{
+  Key.resize(IndexDimensions);
+
+  for (int Dim = 0; Dim < IndexDimensions; Dim++)
+  {
+    Key[Dim] = (long long) floor(Values[Dim] / Eps);
+  }
+}
+
+/****************************************************************************
+ * RepresentativesModel
+ ***************************************************************************/
+
+RepresentativesModel::RepresentativesModel(void)
+{
+  Dimensions = 0;
+  Density    = 0;
+  TotalTime  = 0;
+}
+
+RepresentativesModel::RepresentativesModel(vector<const Point*> cluster_points,
+                                           long long            TotalTime,
+                                           double               Eps)
+{
+  this->Density   = cluster_points.size();
+  this->TotalTime = TotalTime;
+
+  Build(cluster_points, Eps);
+}
+
+/* Model of points that stand for several bursts each, so the density is not
+ * the number of points */
+RepresentativesModel::RepresentativesModel(vector<const Point*> cluster_points,
+                                           long long            Density,
+                                           long long            TotalTime,
+                                           double               Eps)
+{
+  this->Density   = Density;
+  this->TotalTime = TotalTime;
+
+  Build(cluster_points, Eps);
+}
+
+RepresentativesModel::RepresentativesModel(long long  Density,
+                                           long long  TotalTime,
+                                           int        NumPoints,
+                                           int        NumDimensions,
+                                           long long *Instances,
+                                           long long *NeighbourhoodSizes,
+                                           double    *DimValues)
+{
+  this->Density    = Density;
+  this->TotalTime  = TotalTime;
+  this->Dimensions = NumDimensions;
+
+  if (NumPoints > 0)
+  {
+    this->Instances.assign(Instances, Instances + NumPoints);
+    this->NeighbourhoodSizes.assign(NeighbourhoodSizes, NeighbourhoodSizes + NumPoints);
+    this->Values.assign(DimValues, DimValues + (NumPoints * NumDimensions));
+  }
+}
+
+int RepresentativesModel::size(void)
+{
+  return Instances.size();
+}
+
+int RepresentativesModel::GetDimensions(void)
+{
+  return Dimensions;
+}
+
+long long RepresentativesModel::GetDensity(void)
+{
+  return Density;
+}
+
+long long RepresentativesModel::GetTotalTime(void)
+{
+  return TotalTime;
+}
+
+const vector<double>& RepresentativesModel::GetValues(void)
+{
+  return Values;
+}
+
+const vector<long long>& RepresentativesModel::GetNeighbourhoodSizes(void)
+{
+  return NeighbourhoodSizes;
+}
+
+void RepresentativesModel::Serialize(long long  &Density,
+                                     long long  &TotalTime,
+                                     int        &NumPoints,
+                                     int        &NumDimensions,
+                                     long long *&Instances,
+                                     long long *&NeighbourhoodSizes,
+                                     double    *&DimValues )
+{
+  Density            = this->Density;
+  TotalTime          = this->TotalTime;
+  NumPoints          = this->Instances.size();
+  NumDimensions      = Dimensions;
+  Instances          = (long long*) malloc (sizeof(long long)*(NumPoints));
+  NeighbourhoodSizes = (long long*) malloc (sizeof(long long)*(NumPoints));
+  DimValues          = (double*)    malloc (sizeof(double)*(NumPoints*NumDimensions));
+
+  for (int i = 0; i < NumPoints; i++)
+  {
+    Instances[i]          = this->Instances[i];
+    NeighbourhoodSizes[i] = this->NeighbourhoodSizes[i];
+  }
+
+  for (size_t i = 0; i < Values.size(); i++)
+  {
+    DimValues[i] = Values[i];
+  }
+}
+
+void RepresentativesModel::Flush( )
+{
+  std::cout << Instances.size() << " representatives in " << Dimensions << " dimensions" << std::endl;
+
+  for (size_t i = 0; i < Instances.size(); i++)
+  {
+    std::cout << "(";
+    for (int Dim = 0; Dim < Dimensions; Dim++)
+    {
+      std::cout << (Dim > 0 ? "," : "") << Values[i*Dimensions + Dim];
+    }
+    std::cout << ")" << std::endl;
+  }
+}
+
+/* The models file is plotted in two dimensions, as the hulls */
+bool RepresentativesModel::Flush(ostream& str, cluster_id_t id)
+{
+  if (Instances.size() == 0 || Dimensions < 2)
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < Instances.size(); i++)
+  {
+    str.precision(9);
+    str << Values[i*Dimensions] << ", " << Values[i*Dimensions+1] << ", " << id << endl;
+  }
+
+  return true;
+}
+
+RepresentativesModel* RepresentativesModel::Merge(RepresentativesModel* Other, double Eps, int MinPoints)
+{
+  if (IsMergeable(Other, Eps, MinPoints))
+  {
+    return Join(Other);
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+/* Two models are merged when their covers touch (representatives closer
+ * than the cover radius) or, as the hulls, when two representatives
+ * are closer than Eps and dense enough */
+bool RepresentativesModel::IsMergeable(RepresentativesModel* Other, double Eps, int MinPoints)
+{
+  const vector<double>&    OtherValues = Other->GetValues();
+  const vector<long long>& OtherSizes  = Other->GetNeighbourhoodSizes();
+  double                   SqEpsilon   = Eps * Eps;
+  double                   SqRadius    = SqEpsilon * REPRESENTATIVES_COVER_RADIUS * REPRESENTATIVES_COVER_RADIUS;
+  vector<size_t>           Candidates;
+
+  if (Eps <= 0 || Dimensions != Other->GetDimensions() || size() == 0 || Other->size() == 0)
+  {
+    return false;
+  }
+
+  RepresentativesIndex OtherIndex(OtherValues, Dimensions, Eps);
+
+  for (size_t i = 0; i < Instances.size(); i++)
+  {
+    const double* Current = &Values[i*Dimensions];
+
+    Candidates.clear();
+    OtherIndex.Candidates(Current, Candidates);
+
+    for (size_t j = 0; j < Candidates.size(); j++)
+    {
+      const double* Candidate   = &OtherValues[Candidates[j]*Dimensions];
+      double        sqrDistance = 0;
+
+      for (int Dim = 0; Dim < Dimensions && sqrDistance <= SqEpsilon; Dim++)
+      {
+        sqrDistance += (Current[Dim] - Candidate[Dim]) * (Current[Dim] - Candidate[Dim]);
+      }
+
+      if (sqrDistance <= SqRadius)
+      {
+        return true;
+      }
+
+      if (sqrDistance <= SqEpsilon &&
+          (((NeighbourhoodSizes[i] + OtherSizes[Candidates[j]])/2)+1) >= MinPoints)
+      {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/* Representatives of both models, without checking if they are close. Used
+ * to build groups of models already known to be mergeable */
+RepresentativesModel* RepresentativesModel::Join(RepresentativesModel* Other)
+{
+  RepresentativesModel* Joint = new RepresentativesModel();
+
+  Joint->Dimensions = Dimensions;
+  Joint->Density    = Density   + Other->Density;
+  Joint->TotalTime  = TotalTime + Other->TotalTime;
+
+  Joint->Values = Values;
+  Joint->Values.insert(Joint->Values.end(), Other->Values.begin(), Other->Values.end());
+
+  Joint->Instances = Instances;
+  Joint->Instances.insert(Joint->Instances.end(), Other->Instances.begin(), Other->Instances.end());
+
+  Joint->NeighbourhoodSizes = NeighbourhoodSizes;
+  Joint->NeighbourhoodSizes.insert(Joint->NeighbourhoodSizes.end(),
+                                   Other->NeighbourhoodSizes.begin(),
+                                   Other->NeighbourhoodSizes.end());
+
+  return Joint;
+}
+
+/* Box of the representatives in the first two dimensions, the projection
+ * used to prefilter the merges */
+bool RepresentativesModel::GetBoundingBox(double &MinX, double &MinY,
+                                          double &MaxX, double &MaxY)
+{
+  if (Instances.size() == 0 || Dimensions == 0)
+  {
+    return false;
+  }
+
+  MinX = MinY = MAX_DOUBLE;
+  MaxX = MaxY = -MAX_DOUBLE;
+
+  for (size_t i = 0; i < Instances.size(); i++)
+  {
+    double X = Values[i*Dimensions];
+    double Y = (Dimensions > 1 ? Values[i*Dimensions+1] : 0);
+
+    if (X < MinX) MinX = X;
+    if (X > MaxX) MaxX = X;
+    if (Y < MinY) MinY = Y;
+    if (Y > MaxY) MaxY = Y;
+  }
+
+  return true;
+}
+
+/* Visiting order of the cluster points: densest first, and then by their
+ * coordinates, so the model does not depend on the order of the points */
+struct RepresentativesOrder
+{
+  const vector<const Point*>& Points;
+
+  RepresentativesOrder(const vector<const Point*>& Points): Points(Points) {}
+
+  bool operator()(size_t a, size_t b) const
+  {
+    if (Points[a]->GetNeighbourhoodSize() != Points[b]->GetNeighbourhoodSize())
+    {
+      return Points[a]->GetNeighbourhoodSize() > Points[b]->GetNeighbourhoodSize();
+    }
+
+    for (size_t Dim = 0; Dim < Points[a]->size(); Dim++)
+    {
+      if ((*Points[a])[Dim] != (*Points[b])[Dim])
+      {
+        return (*Points[a])[Dim] < (*Points[b])[Dim];
+      }
+    }
+
+    return false;
+  }
+};
+
+/* Greedy cover of the cluster points: a point becomes a representative
+ * unless one closer than the cover radius was already chosen. Unlike a grid,
+ * whose cells get emptier as the dimensions grow, the size of the cover
+ * depends on the extent of the cluster */
+void RepresentativesModel::Build(const vector<const Point*>& cluster_points, double Eps)
+{
+  vector<size_t> Order (cluster_points.size());
+  vector<size_t> Candidates;
+  vector<double> Current;
+  double         SqRadius = Eps * Eps * REPRESENTATIVES_COVER_RADIUS * REPRESENTATIVES_COVER_RADIUS;
+
+  Dimensions = (cluster_points.size() > 0 ? cluster_points[0]->size() : 0);
+
+  if (Dimensions == 0)
+  {
+    return;
+  }
+
+  for (size_t i = 0; i < Order.size(); i++)
+  {
+    Order[i] = i;
+  }
+  std::sort(Order.begin(), Order.end(), RepresentativesOrder(cluster_points));
+
+  RepresentativesIndex Index (Dimensions, Eps);
+  Current.resize(Dimensions);
+
+  for (size_t i = 0; i < Order.size(); i++)
+  {
+    const Point* Candidate = cluster_points[Order[i]];
+    bool         Covered   = false;
+
+    for (int Dim = 0; Dim < Dimensions; Dim++)
+    {
+      Current[Dim] = (*Candidate)[Dim];
+    }
+
+    /* Without Eps every point is a representative */
+    if (Eps > 0)
+    {
+      Candidates.clear();
+      Index.Candidates(&Current[0], Candidates);
+
+      for (size_t j = 0; j < Candidates.size() && !Covered; j++)
+      {
+        const double* Representative = &Values[Candidates[j]*Dimensions];
+        double        sqrDistance    = 0;
+
+        for (int Dim = 0; Dim < Dimensions && sqrDistance <= SqRadius; Dim++)
+        {
+          sqrDistance += (Current[Dim] - Representative[Dim]) * (Current[Dim] - Representative[Dim]);
+        }
+
+        Covered = (sqrDistance <= SqRadius);
+      }
+
+      if (Covered)
+      {
+        continue;
+      }
+
+      Index.Add(&Current[0], Instances.size());
+    }
+
+    Values.insert(Values.end(), Current.begin(), Current.end());
+    Instances.push_back((long long) Candidate->GetInstance());
+    NeighbourhoodSizes.push_back((long long) Candidate->GetNeighbourhoodSize());
+  }
+}
@@ -0,0 +1,153 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _REPRESENTATIVES_MODEL_HPP_
+#define _REPRESENTATIVES_MODEL_HPP_
+
+#include <vector>
+using std::vector;
+#include <map>
+using std::map;
+#include <iostream>
+using std::ostream;
+using std::endl;
+
+#include <Point.hpp>
+
+/* Radius of the cover of the cluster points, relative to Eps. Any point of
+ * the cluster is closer than this to some representative */
+#define REPRESENTATIVES_COVER_RADIUS 0.5
+
+/* Dimensions used to index the representatives. Two representatives closer
+ * than Eps are also closer than Eps in any projection, so a grid of Eps side
+ * over the first dimensions finds them looking at the neighbour cells */
+#define REPRESENTATIVES_INDEX_DIMENSIONS 3
+
+/* Grid of Eps side over the first dimensions of a set of points */
+class RepresentativesIndex
+{
+  public:
+
+    RepresentativesIndex(int Dimensions, double Eps);
+
+    RepresentativesIndex(const vector<double>& Values,
+                         int                   Dimensions,
+                         double                Eps);
+
+    void Add(const double* Values, size_t Index);
+
+    void Candidates(const double* Query, vector<size_t>& Indices) const;
+
+  private:
+
+    typedef map<vector<long long>, vector<size_t> > CellsMap;
+
+    int      Dimensions;
+    int      IndexDimensions;
+    double   Eps;
+    CellsMap Cells;
+
+    void GetKey(const double* Values, vector<long long>& Key) const;
+};
+
+/* Model of a cluster of any dimensionality: the cluster points thinned to a
+ * cover of Eps/2 radius, picking the densest points first. It supports the
+ * same operations as the convex hulls, so the distributed analysis is not
+ * limited to two metrics */
+class RepresentativesModel
+{
+  protected:
+
+    int               Dimensions;
+    long long         Density;
+    long long         TotalTime;
+
+    vector<double>    Values; /* NumPoints x Dimensions */
+    vector<long long> Instances;
+    vector<long long> NeighbourhoodSizes;
+
+  public:
+
+    RepresentativesModel(void);
+
+    RepresentativesModel(vector<const Point*> cluster_points,
+                         long long            TotalTime,
+                         double               Eps);
+
+    RepresentativesModel(vector<const Point*> cluster_points,
+                         long long            Density,
+                         long long            TotalTime,
+                         double               Eps);
+
+    RepresentativesModel(long long  Density,
+                         long long  TotalTime,
+                         int        NumPoints,
+                         int        NumDimensions,
+                         long long *Instances,
+                         long long *NeighbourhoodSizes,
+                         double    *DimValues);
+
+    int       size(void);
+    int       GetDimensions(void);
+    long long GetDensity(void);
+    long long GetTotalTime(void);
+
+    const vector<double>&    GetValues(void);
+    const vector<long long>& GetNeighbourhoodSizes(void);
+
+    void Serialize(long long  &Density,
+                   long long  &TotalTime,
+                   int        &NumPoints,
+                   int        &NumDimensions,
+                   long long *&Instances,
+                   long long *&NeighbourhoodSizes,
+                   double    *&DimValues );
+
+    void Flush( );
+
+    bool Flush(ostream&     str,
+               cluster_id_t id);
+
+    RepresentativesModel* Merge(RepresentativesModel* Other, double Eps = 0, int MinPoints = 1);
+    bool                  IsMergeable(RepresentativesModel* Other, double Eps = 0, int MinPoints = 1);
+    RepresentativesModel* Join(RepresentativesModel* Other);
+
+    bool GetBoundingBox(double &MinX, double &MinY, double &MaxX, double &MaxY);
+
+  private:
+
+    void Build(const vector<const Point*>& cluster_points, double Eps);
+};
+
+#endif // _REPRESENTATIVES_MODEL_HPP_
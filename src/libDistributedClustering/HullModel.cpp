@@ -34,15 +34,24 @@
 
 #include "HullModel.hpp"
 #include <ConvexHullModel.hpp>
+#include <RepresentativesModel.hpp>
 
 HullModel::HullModel(void)
 {
-  _Model = NULL;
+  _Model           = NULL;
+  _Representatives = NULL;
 }
 
 HullModel::HullModel(ConvexHullModel* Model)
 {
-  _Model = Model;
+  _Model           = Model;
+  _Representatives = NULL;
+}
+
+HullModel::HullModel(RepresentativesModel* Representatives)
+{
+  _Model           = NULL;
+  _Representatives = Representatives;
 }
 
 HullModel::HullModel(long long  Density,
@@ -53,13 +62,29 @@ HullModel::HullModel(long long  Density,
                      long long *NeighbourhoodSizes,
                      double    *DimValues)
 {
-  _Model = new ConvexHullModel(Density,
-                               TotalTime,
-                               NumPoints,
-                               NumDimensions,
-                               Instances,
-                               NeighbourhoodSizes,
-                               DimValues);
+  _Model           = NULL;
+  _Representatives = NULL;
+
+  if (NumDimensions > 2)
+  {
+    _Representatives = new RepresentativesModel(Density,
+                                                TotalTime,
+                                                NumPoints,
+                                                NumDimensions,
+                                                Instances,
+                                                NeighbourhoodSizes,
+                                                DimValues);
+  }
+  else
+  {
+    _Model = new ConvexHullModel(Density,
+                                 TotalTime,
+                                 NumPoints,
+                                 NumDimensions,
+                                 Instances,
+                                 NeighbourhoodSizes,
+                                 DimValues);
+  }
 }
 
 HullModel::~HullModel(void)
@@ -68,6 +93,11 @@ HullModel::~HullModel(void)
   {
     delete _Model;
   }
+
+  if (_Representatives != NULL)
+  {
+    delete _Representatives;
+  }
 }
 
 void HullModel::Serialize(long long  &Density,
@@ -88,28 +118,59 @@ void HullModel::Serialize(long long  &Density,
                       NeighbourhoodSizes,
                       DimValues);
   }
+  else if (_Representatives != NULL)
+  {
+    _Representatives->Serialize(Density,
+                                TotalTime,
+                                NumPoints,
+                                NumDimensions,
+                                Instances,
+                                NeighbourhoodSizes,
+                                DimValues);
+  }
 }
 
 HullModel* HullModel::Merge (HullModel* Other, double Epsilon, int MinPoints)
 {
-  ConvexHullModel *ThisModel, *OtherModel, *MergedModel;
-
-  if (_Model == NULL)
+  if (!IsMergeable(Other, Epsilon, MinPoints))
     return NULL;
 
-  ThisModel = _Model;
+  return Join(Other);
+}
 
-  OtherModel = Other->Model();
+/* Models of different kinds (different dimensions) never merge */
+bool HullModel::IsMergeable (HullModel* Other, double Epsilon, int MinPoints)
+{
+  if (_Model != NULL && Other->Model() != NULL)
+    return _Model->IsMergeable(Other->Model(), Epsilon, MinPoints);
 
-  if (Other->Model() == NULL)
-    return NULL;
+  if (_Representatives != NULL && Other->Representatives() != NULL)
+    return _Representatives->IsMergeable(Other->Representatives(), Epsilon, MinPoints);
 
-  MergedModel = ThisModel->Merge(OtherModel, Epsilon, MinPoints);
+  return false;
+}
 
-  if (MergedModel == NULL)
-    return NULL;
+HullModel* HullModel::Join (HullModel* Other)
+{
+  if (_Model != NULL && Other->Model() != NULL)
+    return new HullModel(_Model->Join(Other->Model()));
+
+  if (_Representatives != NULL && Other->Representatives() != NULL)
+    return new HullModel(_Representatives->Join(Other->Representatives()));
+
+  return NULL;
+}
+
+bool HullModel::GetBoundingBox(double &MinX, double &MinY,
+                               double &MaxX, double &MaxY)
+{
+  if (_Model != NULL)
+    return _Model->GetBoundingBox(MinX, MinY, MaxX, MaxY);
+
+  if (_Representatives != NULL)
+    return _Representatives->GetBoundingBox(MinX, MinY, MaxX, MaxY);
 
-  return new HullModel(MergedModel);
+  return false;
 }
 
 ConvexHullModel* const HullModel::Model(void)
@@ -117,28 +178,39 @@ ConvexHullModel* const HullModel::Model(void)
   return _Model;
 }
 
+RepresentativesModel* const HullModel::Representatives(void)
+{
+  return _Representatives;
+}
+
 int  HullModel::Size(void)
 {
-  if (_Model == NULL)
-    return -1;
-  else
+  if (_Model != NULL)
     return _Model->size();
+  else if (_Representatives != NULL)
+    return _Representatives->size();
+  else
+    return -1;
 }
 
 long long HullModel::Density(void)
 {
-  if (_Model == NULL)
-    return -1;
-  else
+  if (_Model != NULL)
     return _Model->GetDensity();
+  else if (_Representatives != NULL)
+    return _Representatives->GetDensity();
+  else
+    return -1;
 }
 
 long long HullModel::TotalTime(void)
 {
-  if (_Model == NULL)
-    return -1;
-  else
+  if (_Model != NULL)
     return _Model->GetTotalTime();
+  else if (_Representatives != NULL)
+    return _Representatives->GetTotalTime();
+  else
+    return -1;
 }
 
 void HullModel::Flush(void)
@@ -148,18 +220,26 @@ void HullModel::Flush(void)
   {
     _Model->Flush();
   }
+  else if (_Representatives != NULL)
+  {
+    _Representatives->Flush();
+  }
 }
 
 bool HullModel::Flush(ostream&             str,
                       cluster_id_t         id)
 {
-  if (_Model == NULL)
+  if (_Model != NULL)
   {
-    return false;
+    return _Model->Flush(str, id);
+  }
+  else if (_Representatives != NULL)
+  {
+    return _Representatives->Flush(str, id);
   }
   else
   {
-    return _Model->Flush(str, id);
+    return false;
   }
 }
 
@@ -40,12 +40,17 @@
 using std::ostream;
 
 class ConvexHullModel;
+class RepresentativesModel;
 
+/* Cluster model used in the distributed analysis. Two dimensional clusters
+ * are modelled with a convex hull, and clusters of more dimensions with a set
+ * of representatives (see RepresentativesModel.hpp) */
 class HullModel
 {
   private:
 
-    ConvexHullModel* _Model;
+    ConvexHullModel*      _Model;
+    RepresentativesModel* _Representatives;
 
   public:
 
@@ -53,6 +58,8 @@ class HullModel
 
     HullModel(ConvexHullModel* Model);
 
+    HullModel(RepresentativesModel* Representatives);
+
     HullModel(long long  Density,
               long long  TotalTime,
               int        NumPoints,
@@ -73,8 +80,17 @@ class HullModel
 
     HullModel* Merge (HullModel* Other, double Epsilon, int MinPoints);
 
+    bool       IsMergeable (HullModel* Other, double Epsilon, int MinPoints);
+
+    HullModel* Join (HullModel* Other);
+
+    bool       GetBoundingBox(double &MinX, double &MinY,
+                              double &MaxX, double &MaxY);
+
     ConvexHullModel* const Model(void);
 
+    RepresentativesModel* const Representatives(void);
+
     long long Density(void);
     long long TotalTime();
 
@@ -395,6 +395,27 @@ bool libDistributedClustering::GetNoisePoints(vector<const Point*>& NoisePoints,
   return true;
 }
 
+/**
+ * Returns the points used in the cluster analysis, and their durations
+ *
+ * \param Points    I/O vector where the clustering points will be stored
+ * \param Durations I/O vector where the points durations will be stored
+ *
+ * \return True if the points were correctly returned, false otherwise
+ */
+bool libDistributedClustering::GetClusteringPoints(vector<const Point*>& Points,
+                                                   vector<long long>&    Durations)
+{
+  if (!Implementation->GetClusteringPoints(Points, Durations))
+  {
+    Error        = true;
+    ErrorMessage = Implementation->GetLastError();
+    return false;
+  }
+
+  return true;
+}
+
 /**
  * Adds a new burst to the 'TraceData' container, extracted from external
  * sources
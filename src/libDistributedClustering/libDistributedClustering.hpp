@@ -124,6 +124,10 @@ class libDistributedClustering
 
     bool GetNoisePoints(vector<const Point*>& NoisePoints, vector<long long>& NoiseDurations);
 
+    /* Points (and their durations) of the data loaded, to split them among
+     * the workers of an in-process analysis */
+    bool GetClusteringPoints(vector<const Point*>& Points, vector<long long>& Durations);
+
     /* Methods to be used in the ON-LINE implementation of the algorithm. In
      * this case, the data comes from buffers present in the data extraction
      * library. For this reason, we have to expose the data manipulation
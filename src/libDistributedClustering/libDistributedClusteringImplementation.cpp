@@ -48,6 +48,8 @@
 
 #include "ConvexHullModel.hpp"
 #include "ConvexHullClassifier.hpp"
+#include "RepresentativesModel.hpp"
+#include "RepresentativesClassifier.hpp"
 #include "DBSCAN.hpp"
 
 #include <SystemMessages.hpp>
@@ -77,6 +79,10 @@ libDistributedClusteringImplementation::libDistributedClusteringImplementation(i
   system_messages::distributed = true;
   TraceData::distributed       = true;
 
+  Data              = NULL;
+  ClusteringCore    = NULL;
+  UsingExternalData = false;
+
   switch(verbose)
   {
     case SILENT:
@@ -526,12 +532,17 @@ bool libDistributedClusteringImplementation::ClassifyData(vector<HullModel*>& Cl
 
   for (size_t i = 0; i < ClusterModels.size(); i++)
   {
-    ConvexHullModel* CurrentConvexHull = ClusterModels[i]->Model();
-    GlobalModelHulls.push_back(*CurrentConvexHull);
+    if (ClusterModels[i]->Representatives() != NULL)
+    {
+      GlobalModelRepresentatives.push_back(*(ClusterModels[i]->Representatives()));
+    }
+    else
+    {
+      ConvexHullModel* CurrentConvexHull = ClusterModels[i]->Model();
+      GlobalModelHulls.push_back(*CurrentConvexHull);
+    }
   }
 
-  ConvexHullClassifier ClassifierCore(GlobalModelHulls, Epsilon, MinPoints);
-
   /* DEBUG
   ostringstream Messages;
   Messages << "Hulls used to classify points = " << ClusterModels.size() << endl;
@@ -540,7 +551,7 @@ bool libDistributedClusteringImplementation::ClassifyData(vector<HullModel*>& Cl
 
   if (UsingExternalData)
   {
-    ClassifierCore.Classify(ExternalData.begin(),
+    ClassifyWithGlobalModel(ExternalData.begin(),
                             ExternalData.end(),
                             ExternalData.size(),
                             ClassificationPartition);
@@ -553,13 +564,13 @@ bool libDistributedClusteringImplementation::ClassifyData(vector<HullModel*>& Cl
     // Messages << "Points to classify: " << Data->GetCompleteBurstsSize() << endl;
     // system_messages::information(Messages.str());
 
-    ClassifierCore.Classify(Data->GetCompleteBursts_begin(),
+    ClassifyWithGlobalModel(Data->GetCompleteBursts_begin(),
                             Data->GetCompleteBursts_end(),
                             Data->GetCompleteBurstsSize(),
                             ClassificationPartition);
 #else
 
-    ClassifierCore.Classify(Data->GetClusteringBursts().begin(),
+    ClassifyWithGlobalModel(Data->GetClusteringBursts().begin(),
                             Data->GetClusteringBursts().end(),
                             Data->GetClusteringBursts().size(),
                             ClassificationPartition);
@@ -680,8 +691,6 @@ bool libDistributedClusteringImplementation::GenerateStatistics (bool UseClassif
  */
 bool libDistributedClusteringImplementation::ReconstructInputTrace(string OutputTraceName)
 {
-  ConvexHullClassifier ClassifierCore(GlobalModelHulls, Epsilon, MinPoints);
-
   /* Only the "root worker" may run the trace reconstruction! */
   if (!Root)
   {
@@ -689,7 +698,7 @@ bool libDistributedClusteringImplementation::ReconstructInputTrace(string Output
   }
 
   /* First, classify the 'CompleteBursts' collection */
-  ClassifierCore.Classify(Data->GetCompleteBursts().begin(),
+  ClassifyWithGlobalModel(Data->GetCompleteBursts().begin(),
                           Data->GetCompleteBursts().end(),
                           Data->GetCompleteBursts().size(),
                           TraceReconstructionPartition);
@@ -977,6 +986,31 @@ bool libDistributedClusteringImplementation::GetNoisePoints(vector<const Point*>
   return true;
 }
 
+/**
+ * Returns the points used in the cluster analysis, and their durations
+ *
+ * \param Points    I/O vector where the clustering points will be stored
+ * \param Durations I/O vector where the points durations will be stored
+ *
+ * \return True if the points were correctly returned, false otherwise
+ */
+bool libDistributedClusteringImplementation::GetClusteringPoints(vector<const Point*>& Points,
+                                                                 vector<long long>&    Durations)
+{
+  if (!UsingExternalData && Data == NULL)
+  {
+    SetErrorMessage("data not initialized");
+    return false;
+  }
+
+  Points.clear();
+  Durations.clear();
+
+  GetDataPoints(Points, Durations);
+
+  return true;
+}
+
 /* Methods to be used in the ON-LINE implementation of the algorithm. In
      * this case, the data comes from buffers present in the data extraction
      * library. For this reason, we have to expose the data manipulation
@@ -1412,13 +1446,12 @@ bool libDistributedClusteringImplementation::PrintModels(vector<HullModel*> &Clu
 
   for (size_t i = 0; i < ClustersModels.size(); i++)
   {
-    ConvexHullModel* Hull = ClustersModels[i]->Model();
     /* DEBUG
     Messages << "**** Printing Hull " << i << " to file " << ModelsFileName << endl;
     system_messages::information(Messages.str().c_str());
     Messages.str("");
     */
-    Hull->Flush(OutputStream, MIN_CLUSTERID+i+PARAVER_OFFSET); // +1 because there is no noise!
+    ClustersModels[i]->Flush(OutputStream, MIN_CLUSTERID+i+PARAVER_OFFSET); // +1 because there is no noise!
     DifferentIDs.insert(i+1);
   }
   OutputStream.close();
@@ -1584,9 +1617,21 @@ bool libDistributedClusteringImplementation::GenerateClusterModels(vector<HullMo
     DurationPerCluster[AssignmentVector[i]] += PointsDurations[i];
   }
 
+  /* Convex hulls only model the first two dimensions */
+  bool MultiDimensional = (ClusteringPoints.size() > 0 && ClusteringPoints[0]->size() > 2);
+
   for (size_t i = NOISE_CLUSTERID+1; i < PointsPerCluster.size(); i++)
   {
-    HullModel *NewHull = new HullModel(new ConvexHullModel(PointsPerCluster[i], DurationPerCluster[i]));
+    HullModel *NewHull;
+
+    if (MultiDimensional)
+    {
+      NewHull = new HullModel(new RepresentativesModel(PointsPerCluster[i], DurationPerCluster[i], Epsilon));
+    }
+    else
+    {
+      NewHull = new HullModel(new ConvexHullModel(PointsPerCluster[i], DurationPerCluster[i]));
+    }
 
     Models.push_back(NewHull);
 
@@ -1610,6 +1655,35 @@ bool libDistributedClusteringImplementation::GenerateClusterModels(vector<HullMo
   return true;
 }
 
+/**
+ * Classifies a set of points with the global model received. Convex hulls
+ * and representatives models use their own classifier
+ *
+ * \param begin         Iterator to the first point to classify
+ * \param end           Iterator past the last point to classify
+ * \param size          Number of points to classify
+ * \param DataPartition I/O partition where the assignment is stored
+ *
+ * \return True if the points were classified correctly, false otherwise
+ */
+template <typename T>
+bool libDistributedClusteringImplementation::ClassifyWithGlobalModel(T          begin,
+                                                                     T          end,
+                                                                     size_t     size,
+                                                                     Partition& DataPartition)
+{
+  if (GlobalModelRepresentatives.size() > 0)
+  {
+    RepresentativesClassifier ClassifierCore(GlobalModelRepresentatives, Epsilon, MinPoints);
+    return ClassifierCore.Classify(begin, end, size, DataPartition);
+  }
+  else
+  {
+    ConvexHullClassifier ClassifierCore(GlobalModelHulls, Epsilon, MinPoints);
+    return ClassifierCore.Classify(begin, end, size, DataPartition);
+  }
+}
+
 /**
  * Returns a vector reference where the data is store
  *
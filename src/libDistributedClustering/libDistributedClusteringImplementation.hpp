@@ -54,6 +54,7 @@ class libDistributedClusteringImplementation: public Error
     libClustering          *ClusteringCore;
 
     vector<ConvexHullModel> GlobalModelHulls;
+    vector<RepresentativesModel> GlobalModelRepresentatives; /* More than 2 dimensions */
     Partition               LastPartition;
     Partition               ClassificationPartition;
     Partition               TraceReconstructionPartition;
@@ -140,6 +141,8 @@ class libDistributedClusteringImplementation: public Error
 
     bool GetNoisePoints(vector<const Point*>& NoisePoints, vector<long long>& NoiseDurations);
 
+    bool GetClusteringPoints(vector<const Point*>& Points, vector<long long>& Durations);
+
     /* Methods to be used in the ON-LINE implementation of the algorithm. In
      * this case, the data comes from buffers present in the data extraction
      * library. For this reason, we have to expose the data manipulation
@@ -213,6 +216,9 @@ private:
 
   bool GenerateClusterModels(vector<HullModel*> &Models);
 
+  template <typename T>
+  bool ClassifyWithGlobalModel(T begin, T end, size_t size, Partition& DataPartition);
+
   void GetDataPoints(vector<const Point *>&Points, vector<long long>&Durations);
 
   bool FlushData(string DataFileName, bool LocalPartition);
@@ -0,0 +1,468 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "ParaverTraceIndex.hpp"
+#include "ParaverRecord.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+
+#include <limits>
+using std::numeric_limits;
+#include <utility>
+using std::make_pair;
+
+#define PARAVER_INDEX_VERSION     1
+#define PARAVER_INDEX_LINE_BUFFER 4096
+
+const size_t ParaverTraceIndex::NO_BLOCK = numeric_limits<size_t>::max();
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+ParaverTraceIndex::ParaverTraceIndex(void)
+{
+  TraceSize             = 0;
+  TraceModificationTime = 0;
+  FirstRecordOffset     = 0;
+}
+
+/**
+ * Reads the records section of the trace once, splitting it in blocks and
+ * noting the time range and the objects present on each block. Long lines
+ * are read in chunks, only their first chunk is parsed
+ *
+ * \param TraceFile         The trace, opened for reading
+ * \param FirstRecordOffset Parser offset of the first record
+ *
+ * \return True if the trace was indexed correctly, false otherwise
+ */
+bool ParaverTraceIndex::Build(FILE* TraceFile, off_t FirstRecordOffset)
+{
+  char   Buffer[PARAVER_INDEX_LINE_BUFFER];
+  off_t  Position;
+  UINT64 Lines     = 0;
+  bool   LineStart = true;
+  int    FirstChar;
+
+  Blocks.clear();
+  Objects.clear();
+
+  if (!GetTraceStatistics(TraceFile, TraceSize, TraceModificationTime))
+  {
+    return false;
+  }
+
+  this->FirstRecordOffset = FirstRecordOffset;
+
+  if (fseeko(TraceFile, FirstRecordOffset, SEEK_SET) == -1)
+  {
+    SetError(true);
+    SetErrorMessage("unable to seek on first record to build the index",
+                    strerror(errno));
+    return false;
+  }
+
+  Position = FirstRecordOffset;
+
+  /* The parser offsets point to the new line that precedes each line */
+  if ((FirstChar = fgetc(TraceFile)) == '\n')
+  {
+    Position++;
+  }
+  else if (FirstChar != EOF)
+  {
+    ungetc(FirstChar, TraceFile);
+  }
+
+  while (fgets(Buffer, sizeof(Buffer), TraceFile) != NULL)
+  {
+    size_t Length = strlen(Buffer);
+
+    if (LineStart)
+    {
+      off_t  LineOffset = (Lines == 0 ? FirstRecordOffset : Position-1);
+      INT32  RecordType, CPU, AppId, TaskId, ThreadId;
+      UINT64 Time;
+
+      if (Blocks.size() == 0 ||
+          LineOffset - Blocks.back().Offset >= PARAVER_INDEX_BLOCK_SIZE)
+      {
+        Block NewBlock;
+
+        NewBlock.Offset  = LineOffset;
+        NewBlock.Lines   = Lines;
+        NewBlock.MinTime = numeric_limits<UINT64>::max();
+        NewBlock.MaxTime = 0;
+
+        Blocks.push_back(NewBlock);
+      }
+
+      if (sscanf(Buffer,
+                 "%d:%d:%d:%d:%d:%lu",
+                 &RecordType, &CPU, &AppId, &TaskId, &ThreadId, &Time) == 6)
+      {
+        Block& CurrentBlock = Blocks.back();
+        UINT64 EndTime      = Time, LogicalReceive, PhysicalReceive;
+
+        AddObject(TaskId-1, ThreadId-1, Blocks.size()-1);
+
+        /* States and communications last beyond their initial time, and the
+         * latter are also relevant to the receiver */
+        if (RecordType == PARAVER_STATE)
+        {
+          sscanf(Buffer, "%*d:%*d:%*d:%*d:%*d:%*u:%lu", &EndTime);
+        }
+        else if (RecordType == PARAVER_COMMUNICATION &&
+                 sscanf(Buffer,
+                        "%*d:%*d:%*d:%*d:%*d:%*u:%*u:%d:%d:%d:%d:%lu:%lu",
+                        &CPU, &AppId, &TaskId, &ThreadId,
+                        &LogicalReceive, &PhysicalReceive) == 6)
+        {
+          EndTime = (LogicalReceive > PhysicalReceive ? LogicalReceive : PhysicalReceive);
+          AddObject(TaskId-1, ThreadId-1, Blocks.size()-1);
+        }
+
+        if (Time    < CurrentBlock.MinTime) CurrentBlock.MinTime = Time;
+        if (EndTime > CurrentBlock.MaxTime) CurrentBlock.MaxTime = EndTime;
+      }
+    }
+
+    Position += Length;
+    LineStart = (Length > 0 && Buffer[Length-1] == '\n');
+
+    if (LineStart)
+    {
+      Lines++;
+    }
+  }
+
+  if (ferror(TraceFile))
+  {
+    SetError(true);
+    SetErrorMessage("error reading trace to build the index", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Loads an index previously saved. It fails if the index does not belong to
+ * the current contents of the trace (size, modification time or first record
+ * differ), so the caller can rebuild it
+ *
+ * \param IndexFileName     Name of the index file
+ * \param TraceFile         The trace the index should describe
+ * \param FirstRecordOffset Parser offset of the first record
+ *
+ * \return True if a valid index was loaded, false otherwise
+ */
+bool ParaverTraceIndex::Load(string IndexFileName,
+                             FILE*  TraceFile,
+                             off_t  FirstRecordOffset)
+{
+  FILE*              IndexFile;
+  int                Version, BlockSize;
+  unsigned long long Size, ModificationTime, FirstOffset;
+  size_t             BlocksCount, ObjectsCount;
+  off_t              CurrentSize;
+  time_t             CurrentModificationTime;
+  bool               Valid;
+
+  Blocks.clear();
+  Objects.clear();
+
+  if (!GetTraceStatistics(TraceFile, CurrentSize, CurrentModificationTime))
+  {
+    return false;
+  }
+
+  if ((IndexFile = fopen(IndexFileName.c_str(), "r")) == NULL)
+  {
+    SetError(true);
+    SetErrorMessage("unable to open trace index", strerror(errno));
+    return false;
+  }
+
+  Valid = (fscanf(IndexFile,
+                  "ParaverTraceIndex %d %d %llu %llu %llu %lu %lu",
+                  &Version, &BlockSize,
+                  &Size, &ModificationTime, &FirstOffset,
+                  &BlocksCount, &ObjectsCount) == 7);
+
+  Valid = Valid &&
+          Version          == PARAVER_INDEX_VERSION &&
+          BlockSize        == PARAVER_INDEX_BLOCK_SIZE &&
+          Size             == (unsigned long long) CurrentSize &&
+          ModificationTime == (unsigned long long) CurrentModificationTime &&
+          FirstOffset      == (unsigned long long) FirstRecordOffset;
+
+  for (size_t i = 0; Valid && i < BlocksCount; i++)
+  {
+    Block              NewBlock;
+    unsigned long long Offset;
+
+    Valid = (fscanf(IndexFile,
+                    "%llu %lu %lu %lu",
+                    &Offset, &NewBlock.Lines,
+                    &NewBlock.MinTime, &NewBlock.MaxTime) == 4);
+
+    NewBlock.Offset = (off_t) Offset;
+    Blocks.push_back(NewBlock);
+  }
+
+  for (size_t i = 0; Valid && i < ObjectsCount; i++)
+  {
+    INT32  TaskId, ThreadId;
+    size_t RunsCount;
+
+    Valid = (fscanf(IndexFile, "%d %d %lu", &TaskId, &ThreadId, &RunsCount) == 3);
+
+    BlockRuns& Runs = Objects[ObjectId(TaskId, ThreadId)];
+
+    for (size_t j = 0; Valid && j < RunsCount; j++)
+    {
+      size_t First, Last;
+
+      Valid = (fscanf(IndexFile, "%lu %lu", &First, &Last) == 2 &&
+               First <= Last && Last < Blocks.size());
+
+      Runs.push_back(make_pair(First, Last));
+    }
+  }
+
+  fclose(IndexFile);
+
+  if (!Valid)
+  {
+    Blocks.clear();
+    Objects.clear();
+
+    SetError(true);
+    SetErrorMessage("trace index out of date or corrupted");
+    return false;
+  }
+
+  TraceSize               = CurrentSize;
+  TraceModificationTime   = CurrentModificationTime;
+  this->FirstRecordOffset = FirstRecordOffset;
+
+  return true;
+}
+
+/**
+ * Writes the index in a plain text file
+ *
+ * \param IndexFileName Name of the index file
+ *
+ * \return True if the index was written correctly, false otherwise
+ */
+bool ParaverTraceIndex::Save(string IndexFileName)
+{
+  FILE*                              IndexFile;
+  map<ObjectId, BlockRuns>::iterator ObjectsIt;
+
+  if ((IndexFile = fopen(IndexFileName.c_str(), "w")) == NULL)
+  {
+    SetError(true);
+    SetErrorMessage("unable to create trace index", strerror(errno));
+    return false;
+  }
+
+  fprintf(IndexFile,
+          "ParaverTraceIndex %d %d %llu %llu %llu %lu %lu\n",
+          PARAVER_INDEX_VERSION,
+          PARAVER_INDEX_BLOCK_SIZE,
+          (unsigned long long) TraceSize,
+          (unsigned long long) TraceModificationTime,
+          (unsigned long long) FirstRecordOffset,
+          Blocks.size(),
+          Objects.size());
+
+  for (size_t i = 0; i < Blocks.size(); i++)
+  {
+    fprintf(IndexFile,
+            "%llu %lu %lu %lu\n",
+            (unsigned long long) Blocks[i].Offset,
+            Blocks[i].Lines,
+            Blocks[i].MinTime,
+            Blocks[i].MaxTime);
+  }
+
+  for (ObjectsIt = Objects.begin(); ObjectsIt != Objects.end(); ++ObjectsIt)
+  {
+    BlockRuns& Runs = ObjectsIt->second;
+
+    fprintf(IndexFile,
+            "%d %d %lu",
+            ObjectsIt->first.first,
+            ObjectsIt->first.second,
+            Runs.size());
+
+    for (size_t i = 0; i < Runs.size(); i++)
+    {
+      fprintf(IndexFile, " %lu %lu", Runs[i].first, Runs[i].second);
+    }
+    fprintf(IndexFile, "\n");
+  }
+
+  if (fclose(IndexFile) != 0)
+  {
+    SetError(true);
+    SetErrorMessage("error writing trace index", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Looks for the first block, starting on 'From', with records in the time
+ * window and of any of the tasks given
+ *
+ * \param From        First block to consider
+ * \param Tasks       Tasks of interest (0-based). NULL for any task
+ * \param WindowBegin Initial time of the window
+ * \param WindowEnd   Final time of the window
+ *
+ * \return The block number, or NO_BLOCK if no further block is relevant
+ */
+size_t ParaverTraceIndex::NextBlock(size_t            From,
+                                    const set<INT32>* Tasks,
+                                    UINT64            WindowBegin,
+                                    UINT64            WindowEnd) const
+{
+  size_t Current = From;
+
+  while (Current < Blocks.size())
+  {
+    set<INT32>::const_iterator               TasksIt;
+    map<ObjectId, BlockRuns>::const_iterator ObjectsIt;
+    size_t                                   Candidate = NO_BLOCK;
+
+    if (Blocks[Current].MaxTime < WindowBegin ||
+        Blocks[Current].MinTime > WindowEnd)
+    {
+      Current++;
+      continue;
+    }
+
+    if (Tasks == NULL)
+    {
+      return Current;
+    }
+
+    /* Earliest block from 'Current' where any thread of the tasks appears */
+    for (TasksIt = Tasks->begin(); TasksIt != Tasks->end(); ++TasksIt)
+    {
+      for (ObjectsIt  = Objects.lower_bound(ObjectId((*TasksIt), 0));
+           ObjectsIt != Objects.end() && ObjectsIt->first.first == (*TasksIt);
+           ++ObjectsIt)
+      {
+        const BlockRuns& Runs = ObjectsIt->second;
+        size_t           Low = 0, High = Runs.size();
+
+        while (Low < High)
+        {
+          size_t Middle = (Low + High) / 2;
+
+          if (Runs[Middle].second < Current)
+            Low = Middle + 1;
+          else
+            High = Middle;
+        }
+
+        if (Low < Runs.size())
+        {
+          size_t RunBlock = (Runs[Low].first > Current ? Runs[Low].first : Current);
+
+          if (RunBlock < Candidate)
+          {
+            Candidate = RunBlock;
+          }
+        }
+      }
+    }
+
+    if (Candidate == NO_BLOCK || Candidate == Current)
+    {
+      return Candidate;
+    }
+
+    Current = Candidate;
+  }
+
+  return NO_BLOCK;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+bool ParaverTraceIndex::GetTraceStatistics(FILE*   TraceFile,
+                                           off_t&  Size,
+                                           time_t& ModificationTime)
+{
+  struct stat FileStat;
+
+  if (fstat(fileno(TraceFile), &FileStat) < 0)
+  {
+    SetError(true);
+    SetErrorMessage("error reading Paraver trace statistics", strerror(errno));
+    return false;
+  }
+
+  Size             = FileStat.st_size;
+  ModificationTime = FileStat.st_mtime;
+
+  return true;
+}
+
+/* Extends the last run of the object when the block follows it */
+void ParaverTraceIndex::AddObject(INT32 TaskId, INT32 ThreadId, size_t BlockNumber)
+{
+  BlockRuns& Runs = Objects[ObjectId(TaskId, ThreadId)];
+
+  if (Runs.size() > 0 && Runs.back().second + 1 >= BlockNumber)
+  {
+    Runs.back().second = BlockNumber;
+  }
+  else
+  {
+    Runs.push_back(make_pair(BlockNumber, BlockNumber));
+  }
+}
@@ -0,0 +1,122 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _PARAVERTRACEINDEX_H
+#define _PARAVERTRACEINDEX_H
+
+#include <types.h>
+
+#include "Error.hpp"
+using cepba_tools::Error;
+
+#include <string>
+using std::string;
+#include <vector>
+using std::vector;
+#include <map>
+using std::map;
+#include <set>
+using std::set;
+#include <utility>
+using std::pair;
+
+#include <cstdio>
+// Required for 'off_t' definition
+#include <sys/types.h>
+
+/* Approximate size of the trace blocks indexed */
+#define PARAVER_INDEX_BLOCK_SIZE 65536
+
+/* Extension appended to the trace name to store the index */
+#define PARAVER_INDEX_EXTENSION ".idx"
+
+/* Sidecar index of the records section of a Paraver trace. The records are
+ * split in blocks starting on a line boundary. Each block keeps its offset,
+ * its line and the time range of its records, and each (task, thread) keeps
+ * the runs of consecutive blocks where it has records. The parser uses it to
+ * seek straight to the blocks of a set of tasks or a time window */
+class ParaverTraceIndex: public Error
+{
+  public:
+
+    /* Offsets follow the parser convention: the position of the new line
+     * character that precedes the first line of the block */
+    struct Block
+    {
+      off_t  Offset;
+      UINT64 Lines;    /* Lines from the first record to the block */
+      UINT64 MinTime;  /* Earliest initial time of its records */
+      UINT64 MaxTime;  /* Latest final time of its records */
+    };
+
+    typedef pair<INT32, INT32>                    ObjectId;  /* Task, thread (0-based) */
+    typedef vector<pair<size_t, size_t> >         BlockRuns; /* First and last block */
+
+    static const size_t NO_BLOCK;
+
+  private:
+
+    off_t  TraceSize;
+    time_t TraceModificationTime;
+    off_t  FirstRecordOffset;
+
+    vector<Block>           Blocks;
+    map<ObjectId, BlockRuns> Objects;
+
+  public:
+
+    ParaverTraceIndex(void);
+
+    bool Build(FILE* TraceFile, off_t FirstRecordOffset);
+
+    bool Load(string IndexFileName, FILE* TraceFile, off_t FirstRecordOffset);
+
+    bool Save(string IndexFileName);
+
+    size_t       size(void) const { return Blocks.size(); };
+    const Block& GetBlock(size_t BlockNumber) const { return Blocks[BlockNumber]; };
+
+    size_t NextBlock(size_t            From,
+                     const set<INT32>* Tasks,
+                     UINT64            WindowBegin,
+                     UINT64            WindowEnd) const;
+
+  private:
+
+    bool GetTraceStatistics(FILE* TraceFile, off_t& Size, time_t& ModificationTime);
+
+    void AddObject(INT32 TaskId, INT32 ThreadId, size_t BlockNumber);
+};
+
+#endif /* _PARAVERTRACEINDEX_H */
@@ -44,6 +44,8 @@ using std::cout;
 using std::endl;
 #include <sstream>
 using std::istringstream;
+#include <limits>
+using std::numeric_limits;
 
 /******************************************************************************
  * Public functions
@@ -54,6 +56,10 @@ ParaverTraceParser::ParaverTraceParser(string ParaverTraceName,
 {
   CurrentLine        = 1;
   ParsingInitialized = false;
+  FilterEventTypes   = false;
+  Index              = NULL;
+  WindowBegin        = 0;
+  WindowEnd          = numeric_limits<UINT64>::max();
 
   if (ParaverTraceFile != NULL)
   {
@@ -72,6 +78,14 @@ ParaverTraceParser::ParaverTraceParser(string ParaverTraceName,
   this->ParaverTraceName = ParaverTraceName;
 }
 
+ParaverTraceParser::~ParaverTraceParser(void)
+{
+  if (Index != NULL)
+  {
+    delete Index;
+  }
+}
+
 bool ParaverTraceParser::InitTraceParsing(void)
 {
   struct stat FileStat;
@@ -246,6 +260,111 @@ INT32 ParaverTraceParser::GetTimeUnits(void)
   return Header->GetTimeUnits();
 }
 
+/**
+ * Restricts the type/value pairs materialized on the event records to the
+ * given types. The rest are scanned in place and each run of them is
+ * replaced by a single SKIPPED_EVENTS_TYPE pair. An empty set disables the
+ * filter
+ *
+ * \param WantedEventTypes Event types to be materialized
+ */
+void ParaverTraceParser::SetEventTypesFilter(const set<INT32>& WantedEventTypes)
+{
+  this->WantedEventTypes = WantedEventTypes;
+  FilterEventTypes       = (WantedEventTypes.size() > 0);
+}
+
+/**
+ * Loads the sidecar index of the trace (trace name plus '.idx'), so further
+ * task or time window selections seek straight to the relevant blocks. When
+ * the index does not exist or does not match the trace, it is built in one
+ * pass and saved for later runs. Must be called after 'InitTraceParsing'
+ *
+ * \param Build True to build the index when it is missing or out of date
+ *
+ * \return True if the index is available, false otherwise
+ */
+bool ParaverTraceParser::LoadIndex(bool Build)
+{
+  string IndexFileName = ParaverTraceName+PARAVER_INDEX_EXTENSION;
+  off_t  CurrentPosition;
+
+  if (!ParsingInitialized)
+  {
+    SetError(true);
+    LastError = "Parsing not initialized";
+    return false;
+  }
+
+  if (Index != NULL)
+  {
+    delete Index;
+  }
+  Index      = new ParaverTraceIndex();
+  IndexBlock = ParaverTraceIndex::NO_BLOCK;
+
+  if (Index->Load(IndexFileName, ParaverTraceFile, FirstRecordOffset))
+  {
+    return true;
+  }
+
+  if (Build)
+  {
+    CurrentPosition = ftello(ParaverTraceFile);
+
+    if (Index->Build(ParaverTraceFile, FirstRecordOffset) &&
+        fseeko(ParaverTraceFile, CurrentPosition, SEEK_SET) == 0)
+    {
+      /* An index that can not be saved is still useful for this run */
+      if (!Index->Save(IndexFileName))
+      {
+        SetWarning(true);
+        SetWarningMessage(Index->GetLastError());
+      }
+      return true;
+    }
+  }
+
+  SetError(true);
+  SetErrorMessage("unable to load trace index", Index->GetLastError());
+
+  delete Index;
+  Index = NULL;
+
+  return false;
+}
+
+/**
+ * Restricts the blocks read to those containing records of the given tasks.
+ * Records of other tasks present in those blocks are still returned
+ *
+ * \param SelectedTasks Tasks of interest (0-based)
+ */
+void ParaverTraceParser::SetTasksSelection(const set<INT32>& SelectedTasks)
+{
+  this->SelectedTasks = SelectedTasks;
+}
+
+/**
+ * Restricts the blocks read to those overlapping the given time window.
+ * Records outside the window present in those blocks are still returned
+ *
+ * \param WindowBegin Initial time of the window
+ * \param WindowEnd   Final time of the window
+ */
+void ParaverTraceParser::SetTimeWindow(UINT64 WindowBegin, UINT64 WindowEnd)
+{
+  this->WindowBegin = WindowBegin;
+  this->WindowEnd   = WindowEnd;
+}
+
+void ParaverTraceParser::ClearSelection(void)
+{
+  SelectedTasks.clear();
+  WindowBegin = 0;
+  WindowEnd   = numeric_limits<UINT64>::max();
+}
+
 ParaverRecord_t ParaverTraceParser::GetNextRecord(void)
 {
   return NextTraceRecord(ANY_REC);
@@ -266,7 +385,7 @@ ParaverRecord_t ParaverTraceParser::GetNextRecord(UINT32 RecordTypeMask, set<INT
     if (Record != NULL)
       delete Record;
 
-    if ((Record = NextTraceRecord(RecordTypeMask)) == NULL)
+    if ((Record = NextTraceRecord(RecordTypeMask, &TaskIds)) == NULL)
       return NULL;
 
     TaskIdsIterator = TaskIds.find(Record->GetTaskId());
@@ -283,13 +402,17 @@ ParaverRecord_t ParaverTraceParser::GetNextRecord(UINT32 RecordTypeMask, set<INT
 ParaverRecord_t ParaverTraceParser::GetNextTaskRecord(INT32  TaskId)
 {
   ParaverRecord_t Record;
+  set<INT32>      TaskIds;
 
-  Record = NextTraceRecord(EVENT_REC | STATE_REC);
+  TaskIds.insert(TaskId);
+
+  if ((Record = NextTraceRecord(EVENT_REC | STATE_REC, &TaskIds)) == NULL)
+    return NULL;
 
   while (Record->GetTaskId() != TaskId)
   {
     delete Record;
-    if ( (Record = NextTraceRecord(EVENT_REC | STATE_REC)) == NULL)
+    if ( (Record = NextTraceRecord(EVENT_REC | STATE_REC, &TaskIds)) == NULL)
       return NULL;
   }
 
@@ -306,7 +429,7 @@ ParaverRecord_t ParaverTraceParser::GetNextTaskRecord(set<INT32> TaskIds)
     if (Record != NULL)
       delete Record;
 
-    if ((Record = NextTraceRecord(EVENT_REC | STATE_REC)) == NULL)
+    if ((Record = NextTraceRecord(EVENT_REC | STATE_REC, &TaskIds)) == NULL)
       return NULL;
 
     TaskIdsIterator = TaskIds.find(Record->GetTaskId());
@@ -383,6 +506,7 @@ bool ParaverTraceParser::Reload(void)
   }
 
   CurrentLine = FirstRecordLine;
+  IndexBlock  = ParaverTraceIndex::NO_BLOCK;
   return true;
 }
 
@@ -519,7 +643,77 @@ bool ParaverTraceParser::GetTraceLine(char* Line, int LineSize)
   return true;
 }
 
-ParaverRecord_t ParaverTraceParser::NextTraceRecord(UINT32 RecordTypeMask)
+/**
+ * When entering a new block of the index, moves the file to the next block
+ * relevant to the tasks and time window selected. When no further block is
+ * relevant, the file is moved to its end
+ *
+ * \param TaskIds Tasks requested by the caller. NULL to use the selection
+ *
+ * \return True if the seek was performed correctly, false otherwise
+ */
+bool ParaverTraceParser::SeekIndexBlock(const set<INT32>* TaskIds)
+{
+  size_t BlockNumber, NextBlock;
+
+  if (IndexBlock != ParaverTraceIndex::NO_BLOCK &&
+      ftello(ParaverTraceFile) < IndexNextBlockOffset)
+  {
+    return true;
+  }
+
+  if (TaskIds == NULL && SelectedTasks.size() > 0)
+  {
+    TaskIds = &SelectedTasks;
+  }
+
+  if (IndexBlock == ParaverTraceIndex::NO_BLOCK)
+  { /* First read after initialization or reload */
+    BlockNumber = 0;
+  }
+  else
+  {
+    BlockNumber = IndexBlock+1;
+  }
+
+  NextBlock = Index->NextBlock(BlockNumber, TaskIds, WindowBegin, WindowEnd);
+
+  if (NextBlock == ParaverTraceIndex::NO_BLOCK)
+  {
+    IndexBlock           = Index->size();
+    IndexNextBlockOffset = TraceSize+1;
+
+    return (fseeko(ParaverTraceFile, 0, SEEK_END) == 0);
+  }
+
+  if (NextBlock != BlockNumber)
+  {
+    if (fseeko(ParaverTraceFile,
+               Index->GetBlock(NextBlock).Offset,
+               SEEK_SET) == -1)
+    {
+      return false;
+    }
+
+    CurrentLine = FirstRecordLine + Index->GetBlock(NextBlock).Lines;
+  }
+
+  IndexBlock = NextBlock;
+
+  if (NextBlock+1 < Index->size())
+  {
+    IndexNextBlockOffset = Index->GetBlock(NextBlock+1).Offset;
+  }
+  else
+  {
+    IndexNextBlockOffset = TraceSize+1;
+  }
+
+  return true;
+}
+
+ParaverRecord_t ParaverTraceParser::NextTraceRecord(UINT32            RecordTypeMask,
+                                                    const set<INT32>* TaskIds)
 {
   ParaverRecord_t Result;
   INT32           LongLineResult;
@@ -537,6 +731,13 @@ ParaverRecord_t ParaverTraceParser::NextTraceRecord(UINT32 RecordTypeMask)
 
   while (!found)
   {
+    if (Index != NULL && !SeekIndexBlock(TaskIds))
+    {
+      SetError(true);
+      SetErrorMessage("unable to seek on trace index block", strerror(errno));
+      return NULL;
+    }
+
     if (feof(ParaverTraceFile))
     {
       return NULL;
@@ -672,70 +873,88 @@ Event_t ParaverTraceParser::ParseEvent(char* ASCIIEvent)
   INT32   CPU, AppId, TaskId, ThreadId;
   INT32   Type;
   INT64   Value;
-  char*   TypeValueStr = (char*) calloc(strlen(ASCIIEvent)+1, sizeof(char));
-  char*   CurrToken;
-  INT32   PairsReaded = 0;
-
+  char*   Cursor;
+  char*   End;
+  int     HeaderLength  = 0;
+  INT32   PairsReaded   = 0;
+  bool    SkippingPairs = false;
+
+  /* The type/value pairs are scanned in place, so the ones not wanted are
+   * never copied nor allocated */
   if (sscanf(ASCIIEvent,
-             "%d:%d:%d:%d:%lu:%[^n]",
+             "%d:%d:%d:%d:%lu:%n",
              &CPU, &AppId, &TaskId, &ThreadId,
-             &Timestamp, TypeValueStr) == 6)
+             &Timestamp, &HeaderLength) != 5 || HeaderLength == 0)
   {
-    NewEvent = new Event(CurrentLine, Timestamp, CPU, AppId, TaskId, ThreadId);
-
-    CurrToken = strtok(TypeValueStr, ":");
-    while(CurrToken != NULL)
-    {
-      Type = atoi(CurrToken);
-
-      CurrToken = strtok(NULL, ":");
-      if (CurrToken == NULL)
-      {
-        char CurrentError[256];
-        SetError(true);
-        sprintf(CurrentError,
-                "Unpaired type/value on event record on line %lu",
-                (long unsigned int) CurrentLine);
-        LastError = CurrentError;
-        delete NewEvent;
-        free( (void*) TypeValueStr);
-        return NULL;
-      }
+    char CurrentError[128];
 
-      Value = atoll(CurrToken);
-      PairsReaded++;
+    SetError(true);
+    sprintf(CurrentError,
+            "Wrong event record on line %lu",
+            (long unsigned int) CurrentLine);
+    LastError = CurrentError;
+    return NULL;
+  }
 
-      NewEvent->AddTypeValue(Type, Value);
+  NewEvent = new Event(CurrentLine, Timestamp, CPU, AppId, TaskId, ThreadId);
+  Cursor   = &ASCIIEvent[HeaderLength];
 
-      CurrToken = strtok(NULL, ":");
-    }
+  while (*Cursor != '\0' && *Cursor != '\n')
+  {
+    Type = strtol(Cursor, &End, 10);
 
-    if (PairsReaded == 0)
+    if (*End != ':')
     {
       char CurrentError[256];
       SetError(true);
       sprintf(CurrentError,
-              "Event record without type/value pairs on line %lu",
+              "Unpaired type/value on event record on line %lu",
               (long unsigned int) CurrentLine);
       LastError = CurrentError;
       delete NewEvent;
-      free( (void*) TypeValueStr);
       return NULL;
     }
+
+    Cursor = End+1;
+    PairsReaded++;
+
+    if (FilterEventTypes && WantedEventTypes.count(Type) == 0)
+    {
+      End = strpbrk(Cursor, ":\n");
+
+      if (!SkippingPairs)
+      {
+        NewEvent->AddTypeValue(SKIPPED_EVENTS_TYPE, 0);
+        SkippingPairs = true;
+      }
+    }
+    else
+    {
+      Value = strtoll(Cursor, &End, 10);
+      NewEvent->AddTypeValue(Type, Value);
+      SkippingPairs = false;
+    }
+
+    if (End == NULL || *End != ':')
+    {
+      break;
+    }
+
+    Cursor = End+1;
   }
-  else
-  {
-    char CurrentError[128];
 
+  if (PairsReaded == 0)
+  {
+    char CurrentError[256];
     SetError(true);
     sprintf(CurrentError,
-            "Wrong event record on line %lu",
+            "Event record without type/value pairs on line %lu",
             (long unsigned int) CurrentLine);
     LastError = CurrentError;
-    NewEvent = NULL;
+    delete NewEvent;
+    return NULL;
   }
 
-  free( (void*) TypeValueStr);
   return NewEvent;
 }
 
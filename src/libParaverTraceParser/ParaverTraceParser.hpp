@@ -40,6 +40,7 @@
 #include "ParaverRecord.hpp"
 #include "ParaverHeader.hpp"
 #include "ParaverMetadataManager.hpp"
+#include "ParaverTraceIndex.hpp"
 #include "Error.hpp"
 using cepba_tools::Error;
 
@@ -49,6 +50,9 @@ using std::string;
 #include <vector>
 using std::vector;
 
+#include <set>
+using std::set;
+
 #include <cstdio>
 // Required for 'off_t' definition
 #include <sys/types.h>
@@ -60,6 +64,11 @@ using std::vector;
 #define GLOBOP_REC 16
 #define ANY_REC    STATE_REC | EVENT_REC | COMM_REC | GLOBOP_REC
 
+/* Type of the pair that stands for each run of consecutive type/value pairs
+ * skipped by the event types filter. The event records keep track of those
+ * events without materializing them */
+#define SKIPPED_EVENTS_TYPE 0
+
 class ParaverTraceParser: public Error
 {
   private:
@@ -87,8 +96,20 @@ class ParaverTraceParser: public Error
 
     UINT64 CurrentLine;
 
+    bool       FilterEventTypes;
+    set<INT32> WantedEventTypes;
+
+    /* Block seeking using the trace index */
+    ParaverTraceIndex* Index;
+    set<INT32>         SelectedTasks;
+    UINT64             WindowBegin, WindowEnd;
+    size_t             IndexBlock;
+    off_t              IndexNextBlockOffset;
+
   public:
-    ParaverTraceParser(){ ParsingInitialized = false; };
+    ParaverTraceParser(){ ParsingInitialized = false; FilterEventTypes = false; Index = NULL; };
+
+    ~ParaverTraceParser(void);
 
     ParaverTraceParser(string ParaverTraceName,
                        FILE*  ParaverTraceFile = NULL);
@@ -105,6 +126,14 @@ class ParaverTraceParser: public Error
 
     vector<UINT64>& GetCutTimeOffsets(void) { return CutTimeOffsets; };
 
+    void SetEventTypesFilter(const set<INT32>& WantedEventTypes);
+
+    bool LoadIndex(bool Build = true);
+
+    void SetTasksSelection(const set<INT32>& SelectedTasks);
+    void SetTimeWindow(UINT64 WindowBegin, UINT64 WindowEnd);
+    void ClearSelection(void);
+
     ParaverRecord_t GetNextRecord(void);
 
     ParaverRecord_t GetNextRecord(UINT32         RecordTypeMask);
@@ -126,7 +155,14 @@ class ParaverTraceParser: public Error
 
   private:
 
-    ParaverRecord_t NextTraceRecord(UINT32 RecordType);
+    /* Owns the trace index: non-copyable */
+    ParaverTraceParser(const ParaverTraceParser&);
+    ParaverTraceParser& operator=(const ParaverTraceParser&);
+
+    ParaverRecord_t NextTraceRecord(UINT32            RecordType,
+                                    const set<INT32>* TaskIds = NULL);
+
+    bool   SeekIndexBlock(const set<INT32>* TaskIds);
 
     bool   GetAppCommunicators(ApplicationDescription_t AppDescription);
 
@@ -299,9 +299,9 @@ bool BurstsDB::NewBurst(CPUBurst* Burst)
   ostringstream       ExtraParamsValues;
   size_t              CurrentField = 0;
 
-  vector<double>&      RawClusteringValues       = Burst->GetRawDimensions();
-  vector<double>&      ProcessedClusteringValues = Burst->GetDimensions();
-  map<size_t, double>& ExtrapolationValues       = Burst->GetExtrapolationDimensions();
+  vector<double>       RawClusteringValues       = Burst->GetRawDimensions();
+  vector<double>       ProcessedClusteringValues = Burst->GetDimensions();
+  map<size_t, double>  ExtrapolationValues       = Burst->GetExtrapolationDimensions();
 
   map<size_t, double> ExtraParamsMap = Burst->GetExtrapolationDimensions();
   map<size_t, double>::iterator ExtraParameter;
@@ -435,8 +435,8 @@ bool BurstsDB::NewBurst(CPUBurst* Burst)
 
   if (Burst->GetBurstType() != MissingDataBurst)
   {
-    vector<double>& RawClusteringValues = Burst->GetRawDimensions();
-    vector<double>& ProcessedClusteringValues = Burst->GetDimensions();
+    vector<double> RawClusteringValues = Burst->GetRawDimensions();
+    vector<double> ProcessedClusteringValues = Burst->GetDimensions();
 
     for (size_t i = 0; i < RawClusteringValues.size(); i++)
     {
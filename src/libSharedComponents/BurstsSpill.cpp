@@ -0,0 +1,480 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "BurstsSpill.hpp"
+
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <sstream>
+using std::ostringstream;
+
+/* Offsets of the fixed fields of a record */
+#define SPILL_INSTANCE_OFFSET   0
+#define SPILL_TASK_OFFSET       8
+#define SPILL_THREAD_OFFSET     12
+#define SPILL_LINE_OFFSET       16
+#define SPILL_BEGIN_OFFSET      24
+#define SPILL_END_OFFSET        32
+#define SPILL_DURATION_OFFSET   40
+#define SPILL_TYPE_OFFSET       48
+#define SPILL_PROCESSED_OFFSET  52
+#define SPILL_RAW_OFFSET        56
+#define SPILL_DATA_OFFSET       64
+
+#define SPILL_HEADER_BYTES      24
+
+static const char SpillMagic[8] = { 'C', 'S', 'S', 'P', 'I', 'L', 'L', '\0' };
+
+BurstsSpill::BurstsSpill(string FileName,
+                         size_t ClusteringDimensions,
+                         size_t ExtrapolationDimensions)
+{
+  this->FileName                = FileName;
+  this->ClusteringDimensions    = ClusteringDimensions;
+  this->ExtrapolationDimensions = ExtrapolationDimensions;
+  this->RecordBytes             = SPILL_DATA_OFFSET + sizeof(double)*
+    BurstsStorage::RowWordsCount(ClusteringDimensions, ExtrapolationDimensions);
+
+  this->Record.resize(RecordBytes);
+
+  AllBurstsCount      = 0;
+  CompleteBurstsCount = 0;
+  NormalizeBursts     = false;
+
+  ChunkStorage  = NULL;
+  ChunkArena    = NULL;
+  ChunkFirst    = 0;
+  ChunkComplete = false;
+  NextRecord    = 0;
+
+  Writing = false;
+
+  if ( (File = fopen(FileName.c_str(), "w+b")) == NULL)
+  {
+    SetError(true);
+    SetErrorMessage("unable to open bursts spill file", strerror(errno));
+    return;
+  }
+
+  /* The file is only reachable through the open stream, so it disappears
+   * when the stream is closed, even if the process ends abruptly */
+  unlink(FileName.c_str());
+
+  /* Records are written one by one, a large buffer saves system calls */
+  setvbuf(File, NULL, _IOFBF, 1 << 20);
+
+  if (!WriteHeader())
+  {
+    return;
+  }
+
+  Writing = true;
+}
+
+BurstsSpill::~BurstsSpill(void)
+{
+  ReleaseChunk();
+
+  if (File != NULL)
+  {
+    fclose(File);
+  }
+}
+
+/**
+ * Appends a burst to the stream
+ * \result True if the burst was correctly written, false otherwise
+ */
+bool BurstsSpill::NewBurst(instance_t           Instance,
+                           task_id_t            TaskId,
+                           thread_id_t          ThreadId,
+                           line_t               Line,
+                           timestamp_t          BeginTime,
+                           timestamp_t          EndTime,
+                           duration_t           BurstDuration,
+                           vector<double>&      ClusteringRawData,
+                           vector<double>&      ClusteringProcessedData,
+                           map<size_t, double>& ExtrapolationData,
+                           burst_type_t         BurstType)
+{
+  UINT64  Value64;
+  UINT32  Value32;
+  double* Data;
+  char*   Mask;
+
+  if (!Writing)
+  {
+    SetError(true);
+    SetErrorMessage("bursts spill file not open for writing");
+    return false;
+  }
+
+  if (ClusteringProcessedData.size() > ClusteringDimensions ||
+      ClusteringRawData.size()       > ClusteringDimensions ||
+      (ExtrapolationData.size() > 0 &&
+       ExtrapolationData.rbegin()->first >= ExtrapolationDimensions))
+  {
+    SetError(true);
+    SetErrorMessage("burst dimensions do not fit the spill file records");
+    return false;
+  }
+
+  memset(&Record[0], 0, RecordBytes);
+
+  Value64 = Instance;
+  memcpy(&Record[SPILL_INSTANCE_OFFSET], &Value64, sizeof(UINT64));
+  Value32 = TaskId;
+  memcpy(&Record[SPILL_TASK_OFFSET],     &Value32, sizeof(UINT32));
+  Value32 = ThreadId;
+  memcpy(&Record[SPILL_THREAD_OFFSET],   &Value32, sizeof(UINT32));
+  Value64 = Line;
+  memcpy(&Record[SPILL_LINE_OFFSET],     &Value64, sizeof(UINT64));
+  Value64 = BeginTime;
+  memcpy(&Record[SPILL_BEGIN_OFFSET],    &Value64, sizeof(UINT64));
+  Value64 = EndTime;
+  memcpy(&Record[SPILL_END_OFFSET],      &Value64, sizeof(UINT64));
+  Value64 = BurstDuration;
+  memcpy(&Record[SPILL_DURATION_OFFSET], &Value64, sizeof(UINT64));
+  Value32 = BurstType;
+  memcpy(&Record[SPILL_TYPE_OFFSET],     &Value32, sizeof(UINT32));
+  Value32 = ClusteringProcessedData.size();
+  memcpy(&Record[SPILL_PROCESSED_OFFSET], &Value32, sizeof(UINT32));
+  Value32 = ClusteringRawData.size();
+  memcpy(&Record[SPILL_RAW_OFFSET],       &Value32, sizeof(UINT32));
+
+  Data = (double*) &Record[SPILL_DATA_OFFSET];
+
+  if (ClusteringProcessedData.size() > 0)
+  {
+    memcpy(Data,
+           &ClusteringProcessedData[0],
+           sizeof(double)*ClusteringProcessedData.size());
+  }
+
+  if (ClusteringRawData.size() > 0)
+  {
+    memcpy(Data + ClusteringDimensions,
+           &ClusteringRawData[0],
+           sizeof(double)*ClusteringRawData.size());
+  }
+
+  Mask = (char*) (Data + 2*ClusteringDimensions + ExtrapolationDimensions);
+
+  for (map<size_t, double>::iterator it  = ExtrapolationData.begin();
+                                     it != ExtrapolationData.end();
+                                   ++it)
+  {
+    Data[2*ClusteringDimensions + it->first] = it->second;
+    Mask[it->first/8] |= (char) (1 << (it->first%8));
+  }
+
+  if (fwrite(&Record[0], RecordBytes, 1, File) != 1)
+  {
+    SetError(true);
+    SetErrorMessage("unable to write burst to spill file", strerror(errno));
+    return false;
+  }
+
+  AllBurstsCount++;
+
+  if (BurstType == CompleteBurst)
+  {
+    CompleteBurstsCount++;
+  }
+
+  return true;
+}
+
+/**
+ * Closes the writing phase. After this call, the bursts can be read
+ * \result True if the pending records were correctly flushed
+ */
+bool BurstsSpill::EndWrites(void)
+{
+  if (!Writing)
+  {
+    return true;
+  }
+
+  Writing = false;
+
+  if (fflush(File) != 0)
+  {
+    SetError(true);
+    SetErrorMessage("unable to flush bursts spill file", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Sets the range normalization applied to the complete bursts when they are
+ * read, the same used in the bursts kept in memory
+ */
+void BurstsSpill::SetNormalization(const vector<double>& MaxValues,
+                                   const vector<double>& MinValues,
+                                   const vector<double>& Factors)
+{
+  this->MaxValues = MaxValues;
+  this->MinValues = MinValues;
+  this->Factors   = Factors;
+
+  NormalizeBursts = true;
+}
+
+/**
+ * Loads a chunk of bursts. The bursts returned are owned by the spill and
+ * remain valid until the next read
+ * \param CompleteOnly True to skip the bursts that are not complete
+ * \param First        Position of the first burst to read (counting only the
+ *                     complete bursts if 'CompleteOnly' is set)
+ * \param Bursts       Output vector of bursts read
+ * \param MaxBursts    Maximum number of bursts to read
+ * \result True if the bursts were correctly read, false otherwise
+ */
+bool BurstsSpill::ReadBursts(bool               CompleteOnly,
+                             size_t             First,
+                             vector<CPUBurst*>& Bursts,
+                             size_t             MaxBursts)
+{
+  size_t Available = (CompleteOnly ? CompleteBurstsCount : AllBurstsCount);
+
+  Bursts.clear();
+
+  if (First >= Available)
+  {
+    return true;
+  }
+
+  if (!LoadChunk(CompleteOnly, First))
+  {
+    return false;
+  }
+
+  for (size_t i = 0; i < Chunk.size() && i < MaxBursts; i++)
+  {
+    Bursts.push_back(Chunk[i]);
+  }
+
+  return true;
+}
+
+/*****************************************************************************
+ * Private Methods
+ ****************************************************************************/
+
+bool BurstsSpill::WriteHeader(void)
+{
+  UINT32 Fields[4];
+
+  Fields[0] = FORMAT_VERSION;
+  Fields[1] = (UINT32) ClusteringDimensions;
+  Fields[2] = (UINT32) ExtrapolationDimensions;
+  Fields[3] = (UINT32) RecordBytes;
+
+  if (fwrite(SpillMagic, sizeof(SpillMagic), 1, File) != 1 ||
+      fwrite(Fields,     sizeof(Fields),     1, File) != 1)
+  {
+    SetError(true);
+    SetErrorMessage("unable to write spill file header", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Reads the chunk of bursts starting at the given position. Sequential
+ * traversals continue from the last record read, so they never rescan
+ */
+bool BurstsSpill::LoadChunk(bool CompleteOnly, size_t First)
+{
+  size_t RecordIndex;
+  size_t Position;
+
+  if (!EndWrites())
+  {
+    return false;
+  }
+
+  if (ChunkComplete == CompleteOnly && ChunkArena != NULL &&
+      First == ChunkFirst + Chunk.size())
+  { /* Next chunk of a sequential traversal */
+    RecordIndex   = NextRecord;
+    Position = First;
+  }
+  else if (!CompleteOnly)
+  {
+    RecordIndex   = First;
+    Position = First;
+  }
+  else
+  { /* Complete bursts positions require a scan from the beginning */
+    RecordIndex   = 0;
+    Position = 0;
+  }
+
+  ReleaseChunk();
+
+  ChunkStorage  = new BurstsStorage(ClusteringDimensions, ExtrapolationDimensions);
+  ChunkArena    = new ObjectsArena<CPUBurst>(false);
+  ChunkFirst    = First;
+  ChunkComplete = CompleteOnly;
+
+  if (fseeko(File, (off_t) SPILL_HEADER_BYTES + (off_t) RecordIndex*RecordBytes, SEEK_SET) != 0)
+  {
+    SetError(true);
+    SetErrorMessage("unable to seek on bursts spill file", strerror(errno));
+    return false;
+  }
+
+  while (RecordIndex < AllBurstsCount && Chunk.size() < CHUNK_BURSTS)
+  {
+    UINT64 Instance, Line, BeginTime, EndTime, Duration;
+    UINT32 TaskId, ThreadId, Type;
+    UINT32 ProcessedCount, RawCount;
+    char*  Mask;
+    double* Data;
+
+    if (fread(&Record[0], RecordBytes, 1, File) != 1)
+    {
+      SetError(true);
+      SetErrorMessage("unable to read burst from spill file", strerror(errno));
+      return false;
+    }
+    RecordIndex++;
+
+    memcpy(&Type, &Record[SPILL_TYPE_OFFSET], sizeof(UINT32));
+
+    if (CompleteOnly && Type != CompleteBurst)
+    {
+      continue;
+    }
+
+    if (Position < First)
+    {
+      Position++;
+      continue;
+    }
+
+    memcpy(&Instance,       &Record[SPILL_INSTANCE_OFFSET],  sizeof(UINT64));
+    memcpy(&TaskId,         &Record[SPILL_TASK_OFFSET],      sizeof(UINT32));
+    memcpy(&ThreadId,       &Record[SPILL_THREAD_OFFSET],    sizeof(UINT32));
+    memcpy(&Line,           &Record[SPILL_LINE_OFFSET],      sizeof(UINT64));
+    memcpy(&BeginTime,      &Record[SPILL_BEGIN_OFFSET],     sizeof(UINT64));
+    memcpy(&EndTime,        &Record[SPILL_END_OFFSET],       sizeof(UINT64));
+    memcpy(&Duration,       &Record[SPILL_DURATION_OFFSET],  sizeof(UINT64));
+    memcpy(&ProcessedCount, &Record[SPILL_PROCESSED_OFFSET], sizeof(UINT32));
+    memcpy(&RawCount,       &Record[SPILL_RAW_OFFSET],       sizeof(UINT32));
+
+    Data = (double*) &Record[SPILL_DATA_OFFSET];
+    Mask = (char*) (Data + 2*ClusteringDimensions + ExtrapolationDimensions);
+
+    vector<double>      ProcessedData (Data, Data + ProcessedCount);
+    vector<double>      RawData (Data + ClusteringDimensions,
+                                 Data + ClusteringDimensions + RawCount);
+    map<size_t, double> ExtrapolationData;
+
+    for (size_t i = 0; i < ExtrapolationDimensions; i++)
+    {
+      if (Mask[i/8] & (1 << (i%8)))
+      {
+        ExtrapolationData[i] = Data[2*ClusteringDimensions + i];
+      }
+    }
+
+    CPUBurst* Burst = new (ChunkArena->Allocate())
+      CPUBurst ((instance_t) Instance,
+                (task_id_t) TaskId,
+                (thread_id_t) ThreadId,
+                (line_t) Line,
+                (timestamp_t) BeginTime,
+                (timestamp_t) EndTime,
+                (duration_t) Duration,
+                RawData,
+                ProcessedData,
+                ExtrapolationData,
+                (burst_type_t) Type,
+                ChunkStorage);
+
+    if (NormalizeBursts && Type == CompleteBurst)
+    {
+      Burst->RangeNormalization(MaxValues, MinValues, Factors);
+    }
+
+    Chunk.push_back(Burst);
+    Position++;
+  }
+
+  NextRecord = RecordIndex;
+
+  return true;
+}
+
+CPUBurst* BurstsSpill::GetBurst(bool CompleteOnly, size_t Position)
+{
+  if (ChunkArena == NULL            ||
+      ChunkComplete != CompleteOnly ||
+      Position < ChunkFirst         ||
+      Position >= ChunkFirst + Chunk.size())
+  {
+    if (!LoadChunk(CompleteOnly, Position) || Chunk.size() == 0)
+    {
+      return NULL;
+    }
+  }
+
+  return Chunk[Position - ChunkFirst];
+}
+
+void BurstsSpill::ReleaseChunk(void)
+{
+  Chunk.clear();
+
+  if (ChunkArena != NULL)
+  {
+    delete ChunkArena;
+    ChunkArena = NULL;
+  }
+
+  if (ChunkStorage != NULL)
+  {
+    delete ChunkStorage;
+    ChunkStorage = NULL;
+  }
+}
@@ -0,0 +1,210 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _BURSTSSPILL_HPP_
+#define _BURSTSSPILL_HPP_
+
+#include "trace_clustering_types.h"
+
+#include <Error.hpp>
+using cepba_tools::Error;
+
+#include "CPUBurst.hpp"
+#include "BurstsStorage.hpp"
+#include "ObjectsArena.hpp"
+
+#include <cstdio>
+#include <iterator>
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include <map>
+using std::map;
+
+/**
+ * Sequential on-disk stream of CPU bursts. Every burst is written as a fixed
+ * size binary record, in the order they are extracted from the trace, so
+ * the bursts that do not stay in memory (i.e. the ones not selected by the
+ * streaming sampling) can be traversed later, in chunks, to classify them
+ * and to generate the outputs.
+ *
+ * File layout (native byte order):
+ *
+ *   Header: "CSSPILL" magic, format version, clustering dimensions,
+ *           extrapolation dimensions, record size
+ *   Record: instance, task, thread, line, begin time, end time, duration,
+ *           burst type, processed and raw dimensions counts,
+ *           processed dimensions, raw dimensions, extrapolation values,
+ *           extrapolation presence bitmask
+ *
+ * The bursts read are only valid until the next chunk is loaded, so the
+ * iterators must be used in a single pass, as the ones of 'BurstsDB'. The
+ * file is unlinked once opened, so it never outlives the process.
+ */
+class BurstsSpill: public Error
+{
+  public:
+    static const UINT32 FORMAT_VERSION = 1;
+    static const size_t CHUNK_BURSTS   = 65536;
+
+  private:
+    string         FileName;
+    FILE*          File;
+    bool           Writing;
+
+    size_t         ClusteringDimensions;
+    size_t         ExtrapolationDimensions;
+    size_t         RecordBytes;
+    vector<char>   Record;
+
+    size_t         AllBurstsCount;
+    size_t         CompleteBurstsCount;
+
+    /* Normalization applied to the bursts read back */
+    bool           NormalizeBursts;
+    vector<double> MaxValues;
+    vector<double> MinValues;
+    vector<double> Factors;
+
+    /* Chunk of bursts currently loaded */
+    BurstsStorage*          ChunkStorage;
+    ObjectsArena<CPUBurst>* ChunkArena;
+    vector<CPUBurst*>       Chunk;
+    size_t                  ChunkFirst;    /* Position of the first burst */
+    bool                    ChunkComplete; /* Only complete bursts loaded */
+    size_t                  NextRecord;
+
+  public:
+    BurstsSpill(string FileName,
+                size_t ClusteringDimensions,
+                size_t ExtrapolationDimensions);
+
+    ~BurstsSpill(void);
+
+    bool NewBurst(instance_t           Instance,
+                  task_id_t            TaskId,
+                  thread_id_t          ThreadId,
+                  line_t               Line,
+                  timestamp_t          BeginTime,
+                  timestamp_t          EndTime,
+                  duration_t           BurstDuration,
+                  vector<double>&      ClusteringRawData,
+                  vector<double>&      ClusteringProcessedData,
+                  map<size_t, double>& ExtrapolationData,
+                  burst_type_t         BurstType);
+
+    bool EndWrites(void);
+
+    void SetNormalization(const vector<double>& MaxValues,
+                          const vector<double>& MinValues,
+                          const vector<double>& Factors);
+
+    bool ReadBursts(bool               CompleteOnly,
+                    size_t             First,
+                    vector<CPUBurst*>& Bursts,
+                    size_t             MaxBursts = CHUNK_BURSTS);
+
+    size_t AllBurstsSize(void) const      { return AllBurstsCount; };
+    size_t CompleteBurstsSize(void) const { return CompleteBurstsCount; };
+
+    string GetFileName(void) const        { return FileName; };
+
+  private:
+
+    bool LoadChunk(bool CompleteOnly, size_t First);
+
+    CPUBurst* GetBurst(bool CompleteOnly, size_t Position);
+
+    bool WriteHeader(void);
+
+    void ReleaseChunk(void);
+
+    /* Copies are not allowed, the file is closed on destruction */
+    BurstsSpill(const BurstsSpill&);
+    BurstsSpill& operator= (const BurstsSpill&);
+
+  public:
+
+    class iterator
+    {
+      private:
+        BurstsSpill* _spill;
+        bool         _complete;
+        size_t       _cur;
+
+      public:
+
+        typedef iterator   self_type;
+        typedef CPUBurst*  value_type;
+        typedef CPUBurst*& reference;
+        typedef CPUBurst** pointer;
+        typedef std::input_iterator_tag iterator_category;
+        typedef int difference_type;
+
+        iterator(void): _spill(NULL), _complete(false), _cur(0) {};
+        iterator(size_t       cur,
+                 bool         complete,
+                 BurstsSpill* spill): _spill(spill), _complete(complete), _cur(cur) {};
+        iterator(const self_type& rhs): _spill(rhs._spill), _complete(rhs._complete), _cur(rhs._cur) {};
+
+        self_type  operator++() { ++_cur; return (*this); };
+        self_type  operator++(int junk) { self_type tmp(*this); operator++(); return tmp; };
+        value_type operator*()
+        {
+          if (_spill == NULL)
+          {
+            return NULL;
+          }
+          else
+          {
+            return (_spill->GetBurst(_complete, _cur));
+          }
+        };
+
+        bool operator==(const self_type& rhs) { return _spill == rhs._spill && _cur == rhs._cur; };
+        bool operator!=(const self_type& rhs) { return _spill != rhs._spill || _cur != rhs._cur; };
+    };
+
+    iterator all_bursts_begin()      { iterator iter(0, false, this); return iter; };
+    iterator all_bursts_end()        { iterator iter(AllBurstsCount, false, this); return iter; };
+
+    iterator complete_bursts_begin() { iterator iter(0, true, this); return iter; };
+    iterator complete_bursts_end()   { iterator iter(CompleteBurstsCount, true, this); return iter; };
+};
+
+#endif /* _BURSTSSPILL_HPP_ */
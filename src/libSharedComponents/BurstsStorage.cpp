@@ -0,0 +1,169 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "BurstsStorage.hpp"
+
+#include <cstring>
+
+BurstsStorage::BurstsStorage(size_t ClusteringDimensions,
+                             size_t ExtrapolationDimensions)
+{
+  this->ClusteringDimensions    = ClusteringDimensions;
+  this->ExtrapolationDimensions = ExtrapolationDimensions;
+  this->RowWords                = RowWordsCount(ClusteringDimensions,
+                                                ExtrapolationDimensions);
+  this->TotalRows               = 0;
+  this->PrivateRowsWords        = 0;
+}
+
+BurstsStorage::~BurstsStorage(void)
+{
+  for (size_t i = 0; i < Blocks.size(); i++)
+  {
+    delete [] Blocks[i];
+  }
+
+  for (size_t i = 0; i < PrivateRows.size(); i++)
+  {
+    delete [] PrivateRows[i];
+  }
+}
+
+/**
+ * Reserves the space for a new burst
+ * \param Stride Output parameter: distance, in doubles, between two
+ *               consecutive columns of the returned row
+ * \result Pointer to the first column of the new row
+ */
+double* BurstsStorage::NewRow(UINT32& Stride)
+{
+  double* Row;
+
+  if (FreeRows.size() > 0)
+  {
+    Row    = FreeRows.back().first;
+    Stride = FreeRows.back().second;
+
+    FreeRows.pop_back();
+    TotalRows++;
+
+    return Row;
+  }
+
+  if (Blocks.size() == 0 || BlocksUsedRows.back() == BlocksCapacity.back())
+  { /* Blocks grow geometrically up to MAX_BLOCK_ROWS rows, so small traces
+     * do not pay for a full block */
+    UINT32 NewCapacity = FIRST_BLOCK_ROWS;
+
+    if (Blocks.size() > 0)
+    {
+      NewCapacity = BlocksCapacity.back()*2;
+
+      if (NewCapacity > MAX_BLOCK_ROWS)
+      {
+        NewCapacity = MAX_BLOCK_ROWS;
+      }
+    }
+
+    double* NewBlock = new double[RowWords*NewCapacity];
+    memset(NewBlock, 0, sizeof(double)*RowWords*NewCapacity);
+
+    Blocks.push_back(NewBlock);
+    BlocksCapacity.push_back(NewCapacity);
+    BlocksUsedRows.push_back(0);
+  }
+
+  Stride = BlocksCapacity.back();
+  Row    = Blocks.back() + BlocksUsedRows.back();
+
+  BlocksUsedRows.back()++;
+  TotalRows++;
+
+  return Row;
+}
+
+/**
+ * Reserves a contiguous row (stride 1) for a burst whose dimensions do not
+ * match the blocks layout. It is released along with the storage
+ * \param RowWords Number of doubles of the row
+ * \result Pointer to the first column of the new row
+ */
+double* BurstsStorage::NewPrivateRow(size_t RowWords)
+{
+  double* Row = new double[RowWords];
+
+  memset(Row, 0, sizeof(double)*RowWords);
+
+  PrivateRows.push_back(Row);
+  PrivateRowsWords += RowWords;
+
+  return Row;
+}
+
+/**
+ * Returns a block row to the storage, so the next 'NewRow' reuses it. Used
+ * when a burst is discarded before the storage is released
+ * \param Row    First column of the row, as returned by 'NewRow'
+ * \param Stride Stride of the row
+ */
+void BurstsStorage::ReleaseRow(double* Row, UINT32 Stride)
+{
+  FreeRows.push_back(std::make_pair(Row, Stride));
+  TotalRows--;
+}
+
+size_t BurstsStorage::GetAllocatedBytes(void) const
+{
+  size_t Result = sizeof(double)*PrivateRowsWords;
+
+  for (size_t i = 0; i < BlocksCapacity.size(); i++)
+  {
+    Result += sizeof(double)*RowWords*BlocksCapacity[i];
+  }
+
+  return Result;
+}
+
+size_t BurstsStorage::MaskWords(size_t ExtrapolationDimensions)
+{
+  return (ExtrapolationDimensions+63)/64;
+}
+
+size_t BurstsStorage::RowWordsCount(size_t ClusteringDimensions,
+                                    size_t ExtrapolationDimensions)
+{
+  return 2*ClusteringDimensions +
+         ExtrapolationDimensions +
+         MaskWords(ExtrapolationDimensions);
+}
@@ -0,0 +1,127 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _BURSTSSTORAGE_HPP_
+#define _BURSTSSTORAGE_HPP_
+
+#include "trace_clustering_types.h"
+
+#include <vector>
+using std::vector;
+
+#include <utility>
+using std::pair;
+
+/**
+ * Column-major container of the numeric data of the CPU bursts. Data is
+ * stored in blocks that never move once allocated, each one holding, for
+ * a given number of rows, the columns:
+ *
+ *   [ Processed clustering dimensions | Raw clustering dimensions |
+ *     Extrapolation dimensions        | Extrapolation presence bitmask ]
+ *
+ * A burst is a row of a block: a pointer to its first processed coordinate
+ * plus the block stride (number of rows) is enough to reach all its data.
+ */
+class BurstsStorage
+{
+  public:
+    /* Consecutive rows of a block: the columns of the segment are contiguous
+     * arrays of 'Rows' values, 'Stride' doubles apart from each other */
+    struct RowsSegment
+    {
+      double* First;
+      UINT32  Stride;
+      size_t  Rows;
+    };
+
+    static const size_t MAX_SEGMENT_ROWS = 4096;
+
+    static const UINT32 FIRST_BLOCK_ROWS = 1024;
+    static const UINT32 MAX_BLOCK_ROWS   = 65536;
+
+  private:
+    size_t ClusteringDimensions;
+    size_t ExtrapolationDimensions;
+    size_t RowWords;
+
+    vector<double*> Blocks;
+    vector<UINT32>  BlocksCapacity;
+    vector<UINT32>  BlocksUsedRows;
+
+    /* Rows released, reused before growing the blocks */
+    vector<pair<double*, UINT32> > FreeRows;
+
+    /* Rows that do not fit the blocks layout */
+    vector<double*> PrivateRows;
+    size_t          PrivateRowsWords;
+
+    size_t TotalRows;
+
+  public:
+    BurstsStorage(size_t ClusteringDimensions,
+                  size_t ExtrapolationDimensions);
+
+    ~BurstsStorage(void);
+
+    double* NewRow(UINT32& Stride);
+
+    double* NewPrivateRow(size_t RowWords);
+
+    void    ReleaseRow(double* Row, UINT32 Stride);
+
+    size_t GetClusteringDimensions(void) const    { return ClusteringDimensions; };
+    size_t GetExtrapolationDimensions(void) const { return ExtrapolationDimensions; };
+
+    size_t GetBlocksCount(void) const                  { return Blocks.size(); };
+    double* GetBlock(size_t i) const                   { return Blocks[i]; };
+    UINT32  GetBlockStride(size_t i) const             { return BlocksCapacity[i]; };
+    UINT32  GetBlockUsedRows(size_t i) const           { return BlocksUsedRows[i]; };
+
+    size_t GetRowsCount(void) const { return TotalRows; };
+
+    size_t GetAllocatedBytes(void) const;
+
+    static size_t MaskWords(size_t ExtrapolationDimensions);
+
+    static size_t RowWordsCount(size_t ClusteringDimensions,
+                                size_t ExtrapolationDimensions);
+
+  private:
+    /* Copies are not allowed, bursts keep pointers to the blocks */
+    BurstsStorage(const BurstsStorage&);
+    BurstsStorage& operator= (const BurstsStorage&);
+};
+
+#endif /* _BURSTSSTORAGE_HPP_ */
@@ -33,6 +33,9 @@
 \* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
 
 #include <CPUBurst.hpp>
+#include "BurstsStorage.hpp"
+
+#include <cstring>
 
 CPUBurst::CPUBurst(task_id_t            TaskId,
                    thread_id_t          ThreadId,
@@ -44,19 +47,15 @@ CPUBurst::CPUBurst(task_id_t            TaskId,
                    vector<double>&      ClusteringProcessedData,
                    map<size_t, double>& ExtrapolationData,
                    burst_type_t         BurstType,
+                   BurstsStorage*       Storage,
                    bool                 ToClassify)
-:Point (ClusteringProcessedData)
 {
-  this->TaskId                  = TaskId;
-  this->ThreadId                = ThreadId;
-  this->Line                    = Line;
-  this->BeginTime               = BeginTime;
-  this->EndTime                 = EndTime;
-  this->Duration                = Duration;
-  this->RawDimensions           = ClusteringRawData;
-  this->ExtrapolationDimensions = ExtrapolationData;
-  this->BurstType               = BurstType;
-  this->ToClassify              = ToClassify;
+  this->Instance   = (Point::InstanceNumber++);
+  this->Normalized = false;
+
+  Initialize(TaskId, ThreadId, Line, BeginTime, EndTime, Duration,
+             ClusteringRawData, ClusteringProcessedData, ExtrapolationData,
+             BurstType, Storage, ToClassify);
 }
 
 CPUBurst::CPUBurst(instance_t          Instance,
@@ -70,59 +69,105 @@ CPUBurst::CPUBurst(instance_t          Instance,
                    vector<double>&     ClusteringProcessedData,
                    map<size_t, double>& ExtrapolationData,
                    burst_type_t        BurstType,
+                   BurstsStorage*      Storage,
                    bool                ToClassify)
-:Point(Instance, ClusteringProcessedData)
 {
-  this->TaskId                  = TaskId;
-  this->ThreadId                = ThreadId;
-  this->Line                    = Line;
-  this->BeginTime               = BeginTime;
-  this->EndTime                 = EndTime;
-  this->Duration                = Duration;
-  this->RawDimensions           = ClusteringRawData;
-  this->ExtrapolationDimensions = ExtrapolationData;
-  this->BurstType               = BurstType;
-  this->ToClassify              = ToClassify;
+  this->Instance   = Instance;
+  this->Normalized = true;
+
+  Initialize(TaskId, ThreadId, Line, BeginTime, EndTime, Duration,
+             ClusteringRawData, ClusteringProcessedData, ExtrapolationData,
+             BurstType, Storage, ToClassify);
 }
 
 CPUBurst::~CPUBurst(void)
 {
-  /*
-  RawDimensions.clear();
-  Dimensions.clear();
-  ExtrapolationDimensions.clear();
-  */
+  /* The row (if owned) is released by the Point destructor */
 }
 
-double CPUBurst::GetRawDimension(size_t Index)
+double CPUBurst::GetRawDimension(size_t Index) const
 {
-  if (Index >= RawDimensions.size() || Index < 0)
+  if (Index >= RawDimensionsCount)
     return 0.0;
   else
-    return RawDimensions[Index];
+    return RawColumn(Index)[0];
+}
+
+vector<double> CPUBurst::GetRawDimensions(void) const
+{
+  vector<double> Result (RawDimensionsCount);
+
+  for (size_t i = 0; i < RawDimensionsCount; i++)
+  {
+    Result[i] = RawColumn(i)[0];
+  }
+
+  return Result;
 }
 
 size_t CPUBurst::GetExtrapolationDimensionsCount(void) const
 {
-  return ExtrapolationDimensions.size();
+  size_t Result = 0;
+
+  for (size_t i = 0; i < ExtrapolationColumns; i++)
+  {
+    if (IsExtrapolationPresent(i))
+    {
+      Result++;
+    }
+  }
+
+  return Result;
 };
 
+/**
+ * Retrieves the value of an extrapolation dimension
+ * \param Index Position of the extrapolation parameter
+ * \param Value Output parameter with the value, if present
+ * \result True if the burst contains the given extrapolation dimension
+ */
+bool CPUBurst::GetExtrapolationDimension(size_t Index, double& Value) const
+{
+  if (Index >= ExtrapolationColumns || !IsExtrapolationPresent(Index))
+  {
+    return false;
+  }
+
+  Value = ExtrapolationColumn(Index)[0];
+  return true;
+}
+
+map<size_t, double> CPUBurst::GetExtrapolationDimensions(void) const
+{
+  map<size_t, double> Result;
+
+  for (size_t i = 0; i < ExtrapolationColumns; i++)
+  {
+    if (IsExtrapolationPresent(i))
+    {
+      Result[i] = ExtrapolationColumn(i)[0];
+    }
+  }
+
+  return Result;
+}
+
 burst_type_t CPUBurst::GetBurstType(void) const
 {
-  return this->BurstType;
+  return (burst_type_t) this->BurstType;
 }
 
 bool CPUBurst::Scale(vector<double>& Mean, vector<double>& RMS)
 {
-  if ( Mean.size() != Dimensions.size() ||
-       RMS.size()  != Dimensions.size())
+  if ( Mean.size() != size() ||
+       RMS.size()  != size())
     return false;
 
 
-  for (size_t i = 0; i < Dimensions.size(); i++)
+  for (size_t i = 0; i < size(); i++)
   {
-    Dimensions[i] =
-      (Dimensions[i]-Mean[i])/RMS[i];
+    (*this)[i] =
+      ((*this)[i]-Mean[i])/RMS[i];
   }
 
   return true;
@@ -131,14 +176,33 @@ bool CPUBurst::Scale(vector<double>& Mean, vector<double>& RMS)
 bool
 CPUBurst::MeanAdjust(vector<double>& DimensionsAverage)
 {
-  if (DimensionsAverage.size() != RawDimensions.size())
+  if (DimensionsAverage.size() != RawDimensionsCount ||
+      DimensionsAverage.size() >  size())
     return false;
 
   for (INT32 i = 0; i < DimensionsAverage.size(); i++)
   {
-    Dimensions[i] = RawDimensions[i] - DimensionsAverage[i];
+    (*this)[i] = RawColumn(i)[0] - DimensionsAverage[i];
+  }
+
+  return true;
+}
+
+/**
+ * Changes the number of clustering dimensions of the burst, up to the
+ * number of clustering columns available on its row
+ * \param DimensionsCount The new number of dimensions
+ * \result True if the row has enough columns, false otherwise
+ */
+bool CPUBurst::SetDimensionsCount(size_t DimensionsCount)
+{
+  if (DimensionsCount > ClusteringColumns)
+  {
+    return false;
   }
 
+  this->DimensionsCount = (UINT32) DimensionsCount;
+
   return true;
 }
 
@@ -147,6 +211,12 @@ CPUBurst::BaseChange(vector< vector<double> >& BaseChangeMatrix)
 {
   vector<double> BaseChangedDimensions (BaseChangeMatrix.size());
 
+  /* The resulting dimensions are stored in the same row */
+  if (BaseChangeMatrix.size() > ClusteringColumns)
+  {
+    return false;
+  }
+
   /* DEBUG
   cout << "Original RawDimensions = {";
   for (INT32 i = 0; i < RawDimensions.size(); i++)
@@ -166,11 +236,11 @@ CPUBurst::BaseChange(vector< vector<double> >& BaseChangeMatrix)
 
   for (INT32 i = 0; i < BaseChangeMatrix.size(); i++)
   {
-    if (BaseChangeMatrix[i].size() != Dimensions.size())
+    if (BaseChangeMatrix[i].size() != size())
     {
       /* DEBUG */
       cout << "ERROR!: BaseChangeMatrix.size = " << BaseChangeMatrix[i].size();
-      cout << " NormalizedDimensions.size = " << Dimensions.size() << endl;
+      cout << " NormalizedDimensions.size = " << size() << endl;
       return false;
     }
 
@@ -179,11 +249,15 @@ CPUBurst::BaseChange(vector< vector<double> >& BaseChangeMatrix)
     for (INT32 j = 0; j < BaseChangeMatrix[i].size(); j++)
     {
       BaseChangedDimensions[i] +=
-        (Dimensions[j]*BaseChangeMatrix[i][j]);
+        ((*this)[j]*BaseChangeMatrix[i][j]);
     }
   }
 
-  Dimensions = BaseChangedDimensions;
+  DimensionsCount = (UINT32) BaseChangedDimensions.size();
+  for (size_t i = 0; i < BaseChangedDimensions.size(); i++)
+  {
+    (*this)[i] = BaseChangedDimensions[i];
+  }
 
   /* DEBUG
   cout << "Base changed NormalizedDimensions = {";
@@ -209,8 +283,6 @@ CPUBurst::Print(ostream&       str,
                  vector<bool>& ExtrapolationParametersPrecision,
                  cluster_id_t   ClusterId)
 {
-  map<size_t, double>::iterator ExtrapolationData;
-
   size_t TotalExtrapolationDimensions = ExtrapolationParametersPrecision.size();
 
   /* Common data */
@@ -220,7 +292,7 @@ CPUBurst::Print(ostream&       str,
   str.setf(ios::fixed,ios::floatfield);
 
   /* Clustering Dimensions Raw */
-  for (INT32 i = 0; i < RawDimensions.size(); i++)
+  for (UINT32 i = 0; i < RawDimensionsCount; i++)
   {
     if (ClusteringParametersPrecision[i])
     { /* High precision */
@@ -231,14 +303,14 @@ CPUBurst::Print(ostream&       str,
       str.precision(0);
     }
 
-    str << "," << RawDimensions[i];
+    str << "," << RawColumn(i)[0];
   }
 
   /* Clustering Dimensions Normalized */
   str.precision(6);
-  for (size_t i = 0; i < Dimensions.size(); i++)
+  for (size_t i = 0; i < size(); i++)
   {
-    str << ", " << Dimensions[i];
+    str << ", " << (*this)[i];
   }
 
   /* Extrapolation Dimensions */
@@ -246,8 +318,9 @@ CPUBurst::Print(ostream&       str,
   {
     str << ",";
 
-    ExtrapolationData = ExtrapolationDimensions.find(i);
-    if (ExtrapolationData != ExtrapolationDimensions.end())
+    double ExtrapolationData;
+
+    if (GetExtrapolationDimension(i, ExtrapolationData))
     {
 
       if (ExtrapolationParametersPrecision[i])
@@ -259,7 +332,7 @@ CPUBurst::Print(ostream&       str,
         str.precision(0);
       }
 
-      str << ExtrapolationData->second;
+      str << ExtrapolationData;
     }
     else
     {
@@ -303,3 +376,120 @@ string CPUBurst::BurstTypeStr(burst_type_t T)
       break;
   }
 }
+
+/*****************************************************************************
+ * Private methods
+ ****************************************************************************/
+
+void CPUBurst::Initialize(task_id_t            TaskId,
+                          thread_id_t          ThreadId,
+                          line_t               Line,
+                          timestamp_t          BeginTime,
+                          timestamp_t          EndTime,
+                          duration_t           Duration,
+                          vector<double>&      ClusteringRawData,
+                          vector<double>&      ClusteringProcessedData,
+                          map<size_t, double>& ExtrapolationData,
+                          burst_type_t         BurstType,
+                          BurstsStorage*       Storage,
+                          bool                 ToClassify)
+{
+  double* Row;
+  UINT32  RowStride;
+  size_t  NeededClusteringColumns    = ClusteringRawData.size();
+  size_t  NeededExtrapolationColumns = 0;
+
+  this->TaskId             = TaskId;
+  this->ThreadId           = ThreadId;
+  this->Line               = Line;
+  this->BeginTime          = BeginTime;
+  this->EndTime            = EndTime;
+  this->Duration           = Duration;
+  this->BurstType          = (UINT8) BurstType;
+  this->ToClassify         = ToClassify;
+  this->NeighbourhoodSize  = 0;
+
+  if (ClusteringProcessedData.size() > NeededClusteringColumns)
+  {
+    NeededClusteringColumns = ClusteringProcessedData.size();
+  }
+
+  if (ExtrapolationData.size() > 0)
+  {
+    NeededExtrapolationColumns = ExtrapolationData.rbegin()->first+1;
+  }
+
+  if (Storage != NULL &&
+      NeededClusteringColumns    <= Storage->GetClusteringDimensions() &&
+      NeededExtrapolationColumns <= Storage->GetExtrapolationDimensions())
+  {
+    ClusteringColumns    = Storage->GetClusteringDimensions();
+    ExtrapolationColumns = Storage->GetExtrapolationDimensions();
+
+    Row = Storage->NewRow(RowStride);
+    AttachDimensions(Row, ClusteringProcessedData.size(), RowStride);
+  }
+  else
+  { /* Contiguous row, owned by the storage (if any) or by the burst */
+    size_t RowWords;
+
+    ClusteringColumns    = NeededClusteringColumns;
+    ExtrapolationColumns = NeededExtrapolationColumns;
+
+    RowWords = BurstsStorage::RowWordsCount(ClusteringColumns,
+                                            ExtrapolationColumns);
+
+    if (Storage != NULL)
+    {
+      Row = Storage->NewPrivateRow(RowWords);
+      AttachDimensions(Row, ClusteringProcessedData.size(), 1);
+    }
+    else
+    {
+      Row = new double[RowWords];
+      memset(Row, 0, sizeof(double)*RowWords);
+      AttachDimensions(Row, ClusteringProcessedData.size(), 1, true);
+    }
+  }
+
+  RawDimensionsCount = ClusteringRawData.size();
+
+  for (size_t i = 0; i < ClusteringProcessedData.size(); i++)
+  {
+    (*this)[i] = ClusteringProcessedData[i];
+  }
+
+  for (size_t i = 0; i < ClusteringRawData.size(); i++)
+  {
+    RawColumn(i)[0] = ClusteringRawData[i];
+  }
+
+  for (size_t i = 0; i < BurstsStorage::MaskWords(ExtrapolationColumns); i++)
+  {
+    UINT64 Empty = 0;
+    memcpy(MaskColumn(i), &Empty, sizeof(UINT64));
+  }
+
+  for (map<size_t, double>::iterator it  = ExtrapolationData.begin();
+                                     it != ExtrapolationData.end();
+                                   ++it)
+  {
+    UINT64 Word;
+
+    ExtrapolationColumn(it->first)[0] = it->second;
+
+    /* Mask words are stored in 'double' slots: accessed through memcpy */
+    memcpy(&Word, MaskColumn(it->first/64), sizeof(UINT64));
+    Word |= ((UINT64) 1) << (it->first%64);
+    memcpy(MaskColumn(it->first/64), &Word, sizeof(UINT64));
+  }
+}
+
+bool CPUBurst::IsExtrapolationPresent(size_t Index) const
+{
+  UINT64 Word;
+
+  memcpy(&Word, MaskColumn(Index/64), sizeof(UINT64));
+
+  return ((Word >> (Index%64)) & 1) != 0;
+}
@@ -36,9 +36,6 @@
 
 #include "trace_clustering_types.h"
 
-#include <Error.hpp>
-using cepba_tools::Error;
-
 #include <Point.hpp>
 
 #include <sys/stat.h>
@@ -73,25 +70,33 @@ using std::fixed;
 #define LINE_CSV       "Line"
 #define CLUSTERID_CSV  "ClusterID"
 
-class CPUBurst: public Point, public Error
+class BurstsStorage;
+
+/**
+ * A CPU burst is a row of a 'BurstsStorage' block (or of a private block
+ * when created out of the trace data): the processed dimensions are the
+ * point coordinates, and the raw and extrapolation dimensions, plus the
+ * extrapolation presence bitmask, are the following columns of the same row.
+ * Bursts created with a storage never own memory, so they can be placed on
+ * an 'ObjectsArena' and released without running their destructors
+ */
+class CPUBurst: public Point
 {
   protected:
-    task_id_t    TaskId;
-    thread_id_t  ThreadId;
-
-    line_t       Line;
     timestamp_t  BeginTime;
     timestamp_t  EndTime;
-
     duration_t   Duration; /* Each point has always the (raw) duration */
+    line_t       Line;
 
-    burst_type_t BurstType;
+    task_id_t    TaskId;
+    thread_id_t  ThreadId;
 
-    vector<double>      RawDimensions;
-    map<size_t, double> ExtrapolationDimensions; /* Key:   Position
-                                                 * Value: DimensionValue */
+    UINT32       ClusteringColumns;
+    UINT32       RawDimensionsCount;
+    UINT32       ExtrapolationColumns;
 
-    bool ToClassify;
+    UINT8        BurstType;
+    bool         ToClassify;
 
   public:
 
@@ -109,6 +114,7 @@ class CPUBurst: public Point, public Error
              vector<double>&     ClusteringProcessedData,
              map<size_t, double>& ExtrapolationData,
              burst_type_t        BurstType,
+             BurstsStorage*      Storage    = NULL,
              bool                ToClassify = false);
 
     CPUBurst(instance_t          Instance,
@@ -122,9 +128,9 @@ class CPUBurst: public Point, public Error
              vector<double>&     ClusteringProcessedData,
              map<size_t, double>& ExtrapolationData,
              burst_type_t        BurstType,
+             BurstsStorage*      Storage    = NULL,
              bool                ToClassify = false);
 
-    CPUBurst(void);
     ~CPUBurst(void);
 
     bool Classified(void);
@@ -140,12 +146,17 @@ class CPUBurst: public Point, public Error
 
     // bool   WillBeClusterized(void) { return ToBeClusterized; }; //
 
-    vector<double>& GetRawDimensions(void) { return RawDimensions; };
-    double          GetRawDimension(size_t Index);
+    vector<double> GetRawDimensions(void) const;
+    double         GetRawDimension(size_t Index) const;
+    size_t         GetRawDimensionsCount(void) const { return RawDimensionsCount; };
+
+    bool   SetDimensionsCount(size_t DimensionsCount);
 
     size_t GetExtrapolationDimensionsCount(void) const;
 
-    map<size_t, double>& GetExtrapolationDimensions(void) { return ExtrapolationDimensions; };
+    bool   GetExtrapolationDimension(size_t Index, double& Value) const;
+
+    map<size_t, double> GetExtrapolationDimensions(void) const;
 
     burst_type_t GetBurstType(void) const;
 
@@ -173,6 +184,42 @@ class CPUBurst: public Point, public Error
     void PrintBurst(void);
 
     static string BurstTypeStr(burst_type_t T);
+
+  private:
+
+    void Initialize(task_id_t            TaskId,
+                    thread_id_t          ThreadId,
+                    line_t               Line,
+                    timestamp_t          BeginTime,
+                    timestamp_t          EndTime,
+                    duration_t           Duration,
+                    vector<double>&      ClusteringRawData,
+                    vector<double>&      ClusteringProcessedData,
+                    map<size_t, double>& ExtrapolationData,
+                    burst_type_t         BurstType,
+                    BurstsStorage*       Storage,
+                    bool                 ToClassify);
+
+    double* RawColumn(size_t Index) const
+    {
+      return Dimensions + (ClusteringColumns+Index)*Stride;
+    };
+
+    double* ExtrapolationColumn(size_t Index) const
+    {
+      return Dimensions + (2*ClusteringColumns+Index)*Stride;
+    };
+
+    double* MaskColumn(size_t Word) const
+    {
+      return Dimensions + (2*ClusteringColumns+ExtrapolationColumns+Word)*Stride;
+    };
+
+    bool    IsExtrapolationPresent(size_t Index) const;
+
+    /* Bursts are referenced by pointer everywhere, copies are not allowed */
+    CPUBurst(const CPUBurst&);
+    CPUBurst& operator= (const CPUBurst&);
 };
 
 inline ostream &operator<<(ostream &str, const CPUBurst &Burst)
@@ -35,17 +35,26 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
 #include <Utilities.hpp>
 
 #include "CSVDataExtractor.hpp"
 #include <CPUBurst.hpp>
 #include <TraceData.hpp>
 
+#include <ParallelFor.hpp>
+using cepba_tools::parallel_for;
+
 #include <cstring>
+#include <cstdlib>
 #include <cerrno>
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include <iostream>
@@ -57,6 +66,222 @@ using std::endl;
 using std::ostringstream;
 using std::istringstream;
 
+/**
+ * Heading fields and position of a burst parsed from a CSV line. The
+ * parameter values are stored contiguously in the block that contains it
+ */
+typedef struct
+{
+  instance_t   Instance;
+  task_id_t    TaskId;
+  thread_id_t  ThreadId;
+  line_t       Line;
+  timestamp_t  BeginTime;
+  timestamp_t  EndTime;
+  duration_t   BurstDuration;
+  cluster_id_t ClusterId;
+  size_t       LineInBlock;
+  size_t       Fields;  /* 0 if the line has to be parsed with 'PopulateRecord' */
+} CSVBurst;
+
+/**
+ * Bursts parsed from a contiguous set of lines of the CSV file
+ */
+class CSVBlock
+{
+  public:
+    const char      *Begin;
+    const char      *End;
+    size_t           Lines;
+    vector<CSVBurst> Bursts;
+    vector<double>   Values;
+    vector<char>     Present;  /* Extrapolation values different from 'nan' */
+    vector<string>   Unparsed; /* Lines that contain quoted fields */
+};
+
+/**
+ * Strips the blanks at both ends of the field [Begin, End)
+ */
+static inline void TrimField(const char* &Begin, const char* &End)
+{
+  while (Begin < End && (*Begin == ' ' || *Begin == '\t'))
+    Begin++;
+
+  while (End > Begin && (End[-1] == ' ' || End[-1] == '\t' || End[-1] == '\r'))
+    End--;
+}
+
+/**
+ * Converts the field [Begin, End) to an unsigned integer without copies
+ */
+static inline UINT64 ParseUnsignedField(const char* Begin, const char* End)
+{
+  UINT64 Value = 0;
+
+  TrimField(Begin, End);
+  while (Begin < End && *Begin >= '0' && *Begin <= '9')
+  {
+    Value = Value*10 + (*Begin - '0');
+    Begin++;
+  }
+  return Value;
+}
+
+/**
+ * Converts the field [Begin, End) to a signed integer without copies
+ */
+static inline INT64 ParseSignedField(const char* Begin, const char* End)
+{
+  TrimField(Begin, End);
+  if (Begin < End && *Begin == '-')
+  {
+    return -((INT64) ParseUnsignedField(Begin+1, End));
+  }
+  return (INT64) ParseUnsignedField(Begin, End);
+}
+
+/**
+ * Converts the field [Begin, End) to a double, using a stack buffer to
+ * terminate the string
+ */
+static inline double ParseDoubleField(const char* Begin, const char* End)
+{
+  char Buffer[64];
+
+  TrimField(Begin, End);
+  if ((size_t) (End - Begin) >= sizeof(Buffer))
+  {
+    return strtod(string(Begin, End).c_str(), NULL);
+  }
+
+  memcpy(Buffer, Begin, End - Begin);
+  Buffer[End - Begin] = '\0';
+  return strtod(Buffer, NULL);
+}
+
+/**
+ * Functor to parse the blocks of the CSV file through 'parallel_for'. The
+ * number of clustering, normalized and extrapolation parameters is known from
+ * the header
+ */
+class CSVParsingTask
+{
+  private:
+    vector<CSVBlock> &Blocks;
+    size_t            RecordSize;
+    size_t            ExtrapolationFirst;
+
+  public:
+    CSVParsingTask(vector<CSVBlock> &Blocks,
+                   size_t            RecordSize,
+                   size_t            ExtrapolationFirst)
+    : Blocks(Blocks),
+      RecordSize(RecordSize),
+      ExtrapolationFirst(ExtrapolationFirst)
+    {}
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      vector<const char*> Fields;
+
+      Fields.reserve(RecordSize+1);
+
+      for (size_t i = Begin; i < End; i++)
+      {
+        ParseBlock(Blocks[i], Fields);
+      }
+    }
+
+  private:
+    void ParseBlock(CSVBlock &Block, vector<const char*> &Fields)
+    {
+      const char *Current = Block.Begin;
+
+      Block.Lines = 0;
+
+      while (Current < Block.End)
+      {
+        const char *EndOfLine = (const char*) memchr(Current, '\n', Block.End - Current);
+        CSVBurst    Burst;
+
+        if (EndOfLine == NULL)
+        {
+          EndOfLine = Block.End;
+        }
+
+        Burst.LineInBlock = Block.Lines++;
+
+        if (*Current == '#')
+        {
+          Current = EndOfLine + 1;
+          continue;
+        }
+
+        if (memchr(Current, '"', EndOfLine - Current) != NULL)
+        {
+          Burst.Fields = 0;
+          Block.Bursts.push_back(Burst);
+          Block.Unparsed.push_back(string(Current, EndOfLine));
+          Current = EndOfLine + 1;
+          continue;
+        }
+
+        /* Field boundaries: each field spans [Fields[j], Fields[j+1]-1) */
+        Fields.clear();
+        Fields.push_back(Current);
+        for (const char *Comma = Current;
+             (Comma = (const char*) memchr(Comma, ',', EndOfLine - Comma)) != NULL;
+             Comma++)
+        {
+          Fields.push_back(Comma+1);
+        }
+        Fields.push_back(EndOfLine+1);
+
+        Burst.Fields = Fields.size()-1;
+
+        if (Burst.Fields != RecordSize)
+        {
+          Block.Bursts.push_back(Burst);
+          Current = EndOfLine + 1;
+          continue;
+        }
+
+        Burst.Instance      = ParseUnsignedField(Fields[0], Fields[1]-1);
+        Burst.TaskId        = ParseUnsignedField(Fields[1], Fields[2]-1);
+        Burst.ThreadId      = ParseUnsignedField(Fields[2], Fields[3]-1);
+        Burst.BeginTime     = ParseUnsignedField(Fields[3], Fields[4]-1);
+        Burst.EndTime       = ParseUnsignedField(Fields[4], Fields[5]-1);
+        Burst.BurstDuration = ParseUnsignedField(Fields[5], Fields[6]-1);
+        Burst.Line          = ParseUnsignedField(Fields[6], Fields[7]-1);
+        Burst.ClusterId     = ParseSignedField(Fields[RecordSize-1], Fields[RecordSize]-1);
+
+        for (size_t j = CSV_HEADING_FIELDS; j < RecordSize-1; j++)
+        {
+          const char *FieldBegin = Fields[j];
+          const char *FieldEnd   = Fields[j+1]-1;
+
+          if (j >= ExtrapolationFirst)
+          {
+            TrimField(FieldBegin, FieldEnd);
+
+            if (FieldEnd - FieldBegin == 3 && strncmp(FieldBegin, "nan", 3) == 0)
+            {
+              Block.Present.push_back(0);
+              Block.Values.push_back(0.0);
+              continue;
+            }
+            Block.Present.push_back(1);
+          }
+
+          Block.Values.push_back(ParseDoubleField(FieldBegin, FieldEnd));
+        }
+
+        Block.Bursts.push_back(Burst);
+        Current = EndOfLine + 1;
+      }
+    }
+};
+
 CSVDataExtractor::CSVDataExtractor(string CSVFileName)
 :DataExtractor(CSVFileName)
 {
@@ -120,45 +345,206 @@ bool CSVDataExtractor::SetEventsToDealWith(set<event_type_t>& EventsToDealWith,
 
 bool CSVDataExtractor::ExtractData(TraceData* TraceDataSet)
 {
-  ostringstream  ErrorMessage;
-  vector<string> Record;
-  string         Line;
+  ostringstream ErrorMessage;
+  struct stat   Info;
+  int           fd;
+  const char   *Data;
+  const char   *Body;
+  const char   *End;
 
-  system_messages::show_percentage_progress("Loading file "+CSVFileName,
-                                            0);
+  /* The header was read through the stream, the rest is mapped in memory */
+  CSVFile.close();
 
-  CurrentLine = 1;
-  while(getline(CSVFile, Line)  && CSVFile.good())
+  fd = open(CSVFileName.c_str(), O_RDONLY);
+  if (fd < 0 || fstat(fd, &Info) != 0)
   {
-    Record.clear();
-
-    if (Line.substr(0,1) != "#")
-    {
-      PopulateRecord (Record, Line, ',');
-      ParseRecord (Record, TraceDataSet);
-    }
-
-    int Percentage = static_cast<int>(CSVFile.tellg()) * 100 / EndPos;
-    system_messages::show_percentage_progress("Loading file '"+CSVFileName+"'",
-                                              Percentage);
+    ErrorMessage << "Error while loading " << CSVFileName;
+    SetError(true);
+    SetErrorMessage(ErrorMessage.str().c_str(),
+                    strerror(errno));
+    if (fd >= 0)
+      close(fd);
+    return false;
+  }
 
-    CurrentLine++;
+  if ((off_t) FirstPos >= Info.st_size)
+  {
+    /* Header only */
+    close(fd);
+    return true;
   }
 
-  if (!CSVFile.eof())
+  Data = (const char*) mmap(NULL, Info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (Data == (const char*) MAP_FAILED)
   {
-    ErrorMessage << "Error while loading " << CSVFileName;
+    ErrorMessage << "Unable to map file " << CSVFileName;
     SetError(true);
     SetErrorMessage(ErrorMessage.str().c_str(),
                     strerror(errno));
     return false;
   }
+  madvise((void*) Data, Info.st_size, MADV_SEQUENTIAL);
+
+  Body = Data + (off_t) FirstPos;
+  End  = Data + Info.st_size;
+
+  /* Split the file in blocks starting at line boundaries */
+  size_t BodySize  = End - Body;
+  size_t NumBlocks = BodySize / CSV_PARSING_MIN_BLOCK;
 
-  system_messages::show_percentage_end("Loading file '"+CSVFileName+"'");
+  if (NumBlocks > 4*cepba_tools::parallel_threads())
+  {
+    NumBlocks = 4*cepba_tools::parallel_threads();
+  }
+  if (NumBlocks == 0)
+  {
+    NumBlocks = 1;
+  }
+
+  vector<CSVBlock> Blocks (NumBlocks);
+  for (size_t i = 0; i < NumBlocks; i++)
+  {
+    const char *Begin = (i == 0 ? Body : Body + (BodySize / NumBlocks) * i);
+
+    if (i > 0 && Begin < Blocks[i-1].Begin)
+    {
+      Begin = Blocks[i-1].Begin;
+    }
+
+    if (Begin > Body && Begin[-1] != '\n')
+    {
+      Begin = (const char*) memchr(Begin, '\n', End - Begin);
+      Begin = (Begin == NULL ? End : Begin + 1);
+    }
+
+    Blocks[i].Begin = Begin;
+    if (i > 0)
+    {
+      Blocks[i-1].End = Begin;
+    }
+  }
+  Blocks[NumBlocks-1].End = End;
+
+  CSVParsingTask Task (Blocks,
+                       RecordSize,
+                       CSV_HEADING_FIELDS + ClusteringParameters.size() + NormalizedParameters.size());
+  parallel_for(Task, 0, NumBlocks);
+
+  /* Bursts are stored in the same order they appear in the file */
+  ProgressReporter Progress ("Loading file '"+CSVFileName+"'",
+                             NumBlocks,
+                             ProgressReporter::items);
+
+  CurrentLine = 1;
+  for (size_t i = 0; i < NumBlocks; i++)
+  {
+    StoreBlock(Blocks[i], TraceDataSet);
+
+    CurrentLine += Blocks[i].Lines;
+
+    vector<CSVBurst>().swap(Blocks[i].Bursts);
+    vector<double>().swap(Blocks[i].Values);
+    vector<char>().swap(Blocks[i].Present);
+    vector<string>().swap(Blocks[i].Unparsed);
+
+    Progress.increment();
+  }
+
+  munmap((void*) Data, Info.st_size);
+
+  Progress.end();
 
   return true;
 }
 
+/**
+ * Inserts in the data set the bursts parsed in a block of the CSV file
+ *
+ * \param  Block        Bursts parsed from a block of lines
+ * \param  TraceDataSet Container of the 'CPUBurst' collection
+ *
+ * \result True if all the bursts have been added to the data set, false
+ *         otherwise
+ *
+ */
+bool CSVDataExtractor::StoreBlock(CSVBlock &Block, TraceData* TraceDataSet)
+{
+  ostringstream       ErrorMessage;
+  vector<double>      ClusteringRawData;
+  vector<double>      ClusteringProcessedData;
+  map<size_t, double> ExtrapolationData;
+  vector<string>      Record;
+  size_t              NextValue    = 0;
+  size_t              NextPresent  = 0;
+  size_t              NextUnparsed = 0;
+  bool                Result       = true;
+  UINT32              FirstLine    = CurrentLine;
+
+  for (size_t i = 0; i < Block.Bursts.size(); i++)
+  {
+    CSVBurst &Burst = Block.Bursts[i];
+
+    CurrentLine = FirstLine + Burst.LineInBlock;
+
+    if (Burst.Fields == 0)
+    {
+      PopulateRecord(Record, Block.Unparsed[NextUnparsed++], ',');
+      Result = ParseRecord(Record, TraceDataSet) && Result;
+      continue;
+    }
+
+    if (Burst.Fields != RecordSize)
+    {
+      ErrorMessage.str("");
+      ErrorMessage << "wrong number of fields (" << Burst.Fields;
+      ErrorMessage << " found, " << RecordSize << " expected) in record on line ";
+      ErrorMessage << CurrentLine;
+
+      SetError(true);
+      SetErrorMessage(ErrorMessage.str());
+      Result = false;
+      continue;
+    }
+
+    ClusteringRawData.assign(Block.Values.begin() + NextValue,
+                             Block.Values.begin() + NextValue + ClusteringParameters.size());
+    NextValue += ClusteringParameters.size();
+
+    ClusteringProcessedData.assign(Block.Values.begin() + NextValue,
+                                   Block.Values.begin() + NextValue + NormalizedParameters.size());
+    NextValue += NormalizedParameters.size();
+
+    ExtrapolationData.clear();
+    for (size_t j = 0; j < ExtrapolationParameters.size(); j++)
+    {
+      if (Block.Present[NextPresent++])
+      {
+        ExtrapolationData[j] = Block.Values[NextValue];
+      }
+      NextValue++;
+    }
+
+    Result = StoreBurst(Burst.Instance,
+                        Burst.TaskId,
+                        Burst.ThreadId,
+                        Burst.Line,
+                        Burst.BeginTime,
+                        Burst.EndTime,
+                        Burst.BurstDuration,
+                        ClusteringRawData,
+                        ClusteringProcessedData,
+                        ExtrapolationData,
+                        Burst.ClusterId,
+                        TraceDataSet) && Result;
+  }
+
+  CurrentLine = FirstLine;
+
+  return Result;
+}
+
 bool CSVDataExtractor::GetPartition(Partition& ReadPartition)
 {
   /* Input file doesn't contain cluster information at all */
@@ -341,6 +727,36 @@ bool CSVDataExtractor::ParseHeader(vector<string> &Record)
     return false;
   }
 
+  /* Files written by 'TraceData::FlushPoints' prefix the clustering,
+   * normalized and extrapolation parameters with 'd_', 'n_' and 'x_' */
+  if (Record.size() > CSV_HEADING_FIELDS+1 &&
+      Record[CSV_HEADING_FIELDS].compare(0, 2, "d_") == 0)
+  {
+    for (vector<string>::size_type i = CSV_HEADING_FIELDS;
+         i < (Record.size()-1);
+         i++)
+    {
+      if (Record[i].compare(0, 2, "d_") == 0)
+      {
+        ClusteringParameters.push_back(Record[i].substr(2));
+      }
+      else if (Record[i].compare(0, 2, "n_") == 0)
+      {
+        NormalizedParameters.push_back(Record[i].substr(2));
+      }
+      else
+      {
+        ExtrapolationParameters.push_back(Record[i].compare(0, 2, "x_") == 0 ?
+                                          Record[i].substr(2) :
+                                          Record[i]);
+      }
+    }
+
+    RecordSize = Record.size();
+
+    return true;
+  }
+
   Clustering = true;
   Normalized = false;
   for (vector<string>::size_type i = 7;
@@ -438,13 +854,12 @@ bool CSVDataExtractor::ParseRecord(vector<string> &Record,
   vector<double>      ClusteringRawData;
   vector<double>      ClusteringProcessedData;
   map<size_t, double> ExtrapolationData;
-  burst_type_t        BurstType;
   cluster_id_t        ClusterId;
 
   if (Record.size() != RecordSize)
   {
     ErrorMessage << "wrong number of fields (" << Record.size();
-    ErrorMessage << " found, " << RecordSize << "expected) in record on line ";
+    ErrorMessage << " found, " << RecordSize << " expected) in record on line ";
     ErrorMessage << CurrentLine;
 
     SetError(true);
@@ -501,6 +916,46 @@ bool CSVDataExtractor::ParseRecord(vector<string> &Record,
 
   istringstream(Record[Record.size()-1]) >> ClusterId;
 
+  return StoreBurst(Instance,
+                    TaskId,
+                    ThreadId,
+                    Line,
+                    BeginTime,
+                    EndTime,
+                    BurstDuration,
+                    ClusteringRawData,
+                    ClusteringProcessedData,
+                    ExtrapolationData,
+                    ClusterId,
+                    TraceDataSet);
+}
+
+/**
+ * Adds a burst to the data set, classifying it by its cluster ID. Regular
+ * cluster IDs are kept to rebuild the partition present on the file
+ *
+ * \param  ClusterId    Cluster ID as written on the file
+ * \param  TraceDataSet Container of the 'CPUBurst' collection
+ *
+ * \result True if the burst has been added to the data set correctly, false
+ *         otherwise
+ *
+ */
+bool CSVDataExtractor::StoreBurst(instance_t           Instance,
+                                  task_id_t            TaskId,
+                                  thread_id_t          ThreadId,
+                                  line_t               Line,
+                                  timestamp_t          BeginTime,
+                                  timestamp_t          EndTime,
+                                  duration_t           BurstDuration,
+                                  vector<double>      &ClusteringRawData,
+                                  vector<double>      &ClusteringProcessedData,
+                                  map<size_t, double> &ExtrapolationData,
+                                  cluster_id_t         ClusterId,
+                                  TraceData*           TraceDataSet)
+{
+  burst_type_t BurstType;
+
   ClusterId -= PARAVER_OFFSET;
 
   switch(ClusterId)
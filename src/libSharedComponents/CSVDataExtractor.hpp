@@ -47,6 +47,11 @@
 #include <fstream>
 using std::ifstream;
 
+/* Minimum size of the blocks of the CSV file parsed by each thread */
+#define CSV_PARSING_MIN_BLOCK (1024*1024)
+
+class CSVBlock;
+
 class CSVDataExtractor: public DataExtractor
 {
   private:
@@ -90,6 +95,21 @@ class CSVDataExtractor: public DataExtractor
 
     bool ParseRecord(vector<string> &Record, TraceData* TraceDataSet);
 
+    bool StoreBlock(CSVBlock &Block, TraceData* TraceDataSet);
+
+    bool StoreBurst(instance_t           Instance,
+                    task_id_t            TaskId,
+                    thread_id_t          ThreadId,
+                    line_t               Line,
+                    timestamp_t          BeginTime,
+                    timestamp_t          EndTime,
+                    duration_t           BurstDuration,
+                    vector<double>      &ClusteringRawData,
+                    vector<double>      &ClusteringProcessedData,
+                    map<size_t, double> &ExtrapolationData,
+                    cluster_id_t         ClusterId,
+                    TraceData*           TraceDataSet);
+
 };
 
 #endif /* CSVDATAEXTRACTOR_H */
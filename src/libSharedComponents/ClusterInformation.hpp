@@ -44,6 +44,9 @@ using cepba_tools::Error;
 #include <vector>
 using std::vector;
 
+#include <utility>
+using std::pair;
+
 typedef UINT32 node_id_t;
 
 class ClusterInformation: public Error
@@ -159,4 +162,15 @@ class ClusterInformationIDOrder
     }
 };
 
+/* Orders the (instance, cluster ID) pairs of a refinement assignment */
+class AssignmentInstanceOrder
+{
+  public:
+    bool operator()(const pair<instance_t, cluster_id_t>& Assignment1,
+                    const pair<instance_t, cluster_id_t>& Assignment2) const
+    {
+      return Assignment1.first < Assignment2.first;
+    }
+};
+
 #endif /* _CLUSTERINFORMATION_HPP_ */
@@ -87,7 +87,7 @@ class ClusteredStatesPRVGenerator: public ClusteredTraceGenerator
 
     ~ClusteredStatesPRVGenerator (void);
 
-    ReconstructorType GetType(void) { return SemanticGuidedPRV; };
+    ReconstructorType GetType(void) { return PRVStates; };
 
     bool SetEventsToDealWith (set<event_type_t>& EventsToDealWith,
                               bool               ConsecutiveEvts);
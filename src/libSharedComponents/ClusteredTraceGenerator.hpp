@@ -46,9 +46,10 @@ using std::set;
 
 class ClusteredTraceGenerator: public Error
 {
-  protected:
+  public:
     enum   ReconstructorType { PRVStates, PRVEvents, SemanticGuidedPRV, TRF };
 
+  protected:
     string InputTraceName;
     FILE*  InputTraceFile;
     string OutputTraceName;
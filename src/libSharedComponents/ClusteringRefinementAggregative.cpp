@@ -35,6 +35,8 @@
 
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
+#include <Instrumentation.hpp>
+using cepba_tools::phase_scope;
 
 #include "ClusteringRefinementAggregative.hpp"
 
@@ -54,6 +56,7 @@ using std::setprecision;
 
 #include <algorithm>
 using std::sort;
+using std::stable_sort;
 
 /******************************************************************************
  * CLASS 'ClusteringRefinementAggregative'
@@ -222,6 +225,7 @@ bool ClusteringRefinementAggregative::Run(const vector<CPUBurst*>& Bursts,
 bool ClusteringRefinementAggregative::RunFirstAnalysis(const vector<CPUBurst*>& Bursts,
                                                        Partition&               FirstPartition)
 {
+  phase_scope          StepPhase("refinement_step");
   ostringstream        Messages;
   ClusteringStatistics Statistics;
   double               Epsilon = EpsilonPerLevel[0];
@@ -298,6 +302,7 @@ bool ClusteringRefinementAggregative::RunStep(size_t                   Step,
                                               Partition&               NewPartition,
                                               bool&                    Stop)
 {
+  phase_scope    StepPhase("refinement_step");
   ostringstream  Messages;
   double         Epsilon = EpsilonPerLevel[Step];
 
@@ -752,10 +757,10 @@ bool ClusteringRefinementAggregative::GenerateNodes(size_t
   {
     cluster_id_t CurrentID = (*IDsIterator);
 
-    ClusterInformation* NewNode =
-      new ClusterInformation(CurrentID,
-                             CurrentClustersDurations[CurrentID],
-                             CurrentClustersIndividuals[CurrentID]);
+    ClusterInformation* NewNode = new (NodesArena.Allocate())
+      ClusterInformation(CurrentID,
+                         CurrentClustersDurations[CurrentID],
+                         CurrentClustersIndividuals[CurrentID]);
 
     Nodes.push_back(NewNode);
     BurstsPerNode[CurrentID] = vector<instance_t> (0);
@@ -890,37 +895,34 @@ void ClusteringRefinementAggregative::LinkNodes(const vector<CPUBurst*>&     Bur
  */
 void ClusteringRefinementAggregative::GeneratePartition(Partition& NewPartition)
 {
-  map<instance_t, cluster_id_t>           Assignment;
-  map<instance_t, cluster_id_t>::iterator AssignmentIt;
-  vector<ClusterInformation*>             TopLevelNodes = NodesPerLevel[0];
+  vector<pair<instance_t, cluster_id_t> > Assignment;
+  vector<ClusterInformation*>&            TopLevelNodes = NodesPerLevel[0];
 
+  /* All the trees append their assignment to a single vector */
   for (size_t i = 0; i < TopLevelNodes.size(); i++)
   {
-    vector<pair<instance_t, cluster_id_t> > PartialAssignment;
-
-    PartialAssignment = GetAssignment(TopLevelNodes[i]);
-
-    /* DEBUG
-    cout << "PartialAssignment from ID = " << TopLevelNodes[i]->GetID();
-    cout << " sizes " << PartialAssignment.size() << endl; */
-
-    for (size_t j = 0; j < PartialAssignment.size(); j++)
-    {
-      Assignment[PartialAssignment[j].first] = PartialAssignment[j].second;
-    }
+    GetAssignment(TopLevelNodes[i], Assignment);
   }
 
+  /* Stable sort: when an instance appears twice, its last ID is kept */
+  stable_sort(Assignment.begin(), Assignment.end(), AssignmentInstanceOrder());
+
   vector<cluster_id_t>& CurrentAssignmentVector =
     NewPartition.GetAssignmentVector();
 
   set<cluster_id_t> DifferentIDs;
 
-  for (AssignmentIt  = Assignment.begin();
-       AssignmentIt != Assignment.end();
-       ++AssignmentIt)
+  CurrentAssignmentVector.reserve(CurrentAssignmentVector.size()+Assignment.size());
+
+  for (size_t i = 0; i < Assignment.size(); i++)
   {
-    CurrentAssignmentVector.push_back(AssignmentIt->second);
-    DifferentIDs.insert(AssignmentIt->second);
+    if (i+1 < Assignment.size() && Assignment[i+1].first == Assignment[i].first)
+    {
+      continue;
+    }
+
+    CurrentAssignmentVector.push_back(Assignment[i].second);
+    DifferentIDs.insert(Assignment[i].second);
   }
 
   NewPartition.SetIDs(DifferentIDs);
@@ -1020,19 +1022,16 @@ bool ClusteringRefinementAggregative::ComputeScores(size_t
 }
 
 /**
- * Returns an assignment vector based on instances for the tree which root is
- * the given node
+ * Appends the assignment based on instances for the tree which root is the
+ * given node
  *
- * \param Node The root of a tree where we want to extract the assignment
- *
- * \return A vector of pairs burst instance/ID correspondig to the refinement
- *         happened in the current tree
+ * \param Node       The root of a tree where we want to extract the assignment
+ * \param Assignment Vector of pairs burst instance/ID where the refinement
+ *                   happened in the current tree is appended
  */
-vector<pair<instance_t, cluster_id_t> > ClusteringRefinementAggregative::GetAssignment(ClusterInformation* Node)
+void ClusteringRefinementAggregative::GetAssignment(ClusterInformation*                      Node,
+                                                    vector<pair<instance_t, cluster_id_t> >& Assignment)
 {
-  vector<pair<instance_t, cluster_id_t> > Result =
-    vector<pair<instance_t, cluster_id_t> > (0);
-
   vector<ClusterInformation*>& Children = Node->GetChildren();
 
   if (Children.size() == 0)
@@ -1043,7 +1042,7 @@ vector<pair<instance_t, cluster_id_t> > ClusteringRefinementAggregative::GetAssi
     {
       if (!Node->IsDiscarded())
       {
-        Result.push_back(make_pair(Instances[i], Node->GetID()));
+        Assignment.push_back(make_pair(Instances[i], Node->GetID()));
 
         /* Update the history of id's */
         IDPerLevel[Instances[i]].push_back(Node->GetID());
@@ -1051,7 +1050,7 @@ vector<pair<instance_t, cluster_id_t> > ClusteringRefinementAggregative::GetAssi
       else
       {
         cluster_id_t LastID = IDPerLevel[Instances[i]].back();
-        Result.push_back(make_pair(Instances[i], LastID));
+        Assignment.push_back(make_pair(Instances[i], LastID));
         IDPerLevel[Instances[i]].push_back(LastID);
       }
     }
@@ -1060,27 +1059,14 @@ vector<pair<instance_t, cluster_id_t> > ClusteringRefinementAggregative::GetAssi
   {
     for (size_t i = 0; i < Children.size(); i++)
     {
-      vector<pair<instance_t, cluster_id_t> > PartialResult;
-
       // if (!Children[i]->IsDiscarded())
       // {
-        PartialResult = GetAssignment(Children[i]);
-
-        for (size_t j = 0; j < PartialResult.size(); j++)
-        {
-          Result.push_back(PartialResult[j]);
-        }
+        GetAssignment(Children[i], Assignment);
       // }
     }
-
-    /* DEBUG
-    cout << "NODE with ID = " << Node->GetID() << " has ";
-    cout << Result.size() << " instances in its assignment" << endl; */
-
-    return Result;
   }
 
-  return Result;
+  return;
 }
 
 /**
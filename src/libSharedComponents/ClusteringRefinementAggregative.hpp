@@ -42,6 +42,7 @@ using cepba_tools::Error;
 #include "Partition.hpp"
 #include "ClusteringStatistics.hpp"
 #include "ClusterInformation.hpp"
+#include "ObjectsArena.hpp"
 #include "SequenceScore.hpp"
 
 #include <list>
@@ -72,6 +73,7 @@ class ClusteringRefinementAggregative: public Error
 
     vector<ClusteringStatistics>           StatisticsHistory;
     vector<vector<ClusterInformation*> >   NodesPerLevel;
+    ObjectsArena<ClusterInformation>       NodesArena;
 
     cluster_id_t                           MaxIDAssigned;
 
@@ -132,7 +134,8 @@ class ClusteringRefinementAggregative: public Error
                        Partition&                   CurrentPartition,
                        bool                         LastPartition);
 
-    vector<pair<instance_t, cluster_id_t> > GetAssignment(ClusterInformation* Node);
+    void GetAssignment(ClusterInformation*                      Node,
+                       vector<pair<instance_t, cluster_id_t> >& Assignment);
 
     bool GenerateLastPartition(const vector<CPUBurst*>& Bursts,
                                Partition&               PreviousPartition,
@@ -35,6 +35,8 @@
 
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
+#include <Instrumentation.hpp>
+using cepba_tools::phase_scope;
 
 #include "ClusteringRefinementDivisive.hpp"
 #include "SequenceScore.hpp"
@@ -48,6 +50,9 @@ using std::ostringstream;
 using std::setw;
 using std::setprecision;
 
+#include <algorithm>
+using std::stable_sort;
+
 
 /******************************************************************************
  * CLASS 'ClusteringRefinementDivisive'
@@ -78,16 +83,7 @@ ClusteringRefinementDivisive::~ClusteringRefinementDivisive(void)
     delete ClusteringCore;
   }
 
-  for (size_t i = 0; i < NodesPerLevel.size(); i++)
-  {
-    for (size_t j = 0; j < NodesPerLevel[i].size(); j++)
-    {
-      if (NodesPerLevel[i][j] != NULL)
-      {
-        delete NodesPerLevel[i][j];
-      }
-    }
-  }
+  /* Tree nodes are released along with 'NodesArena' */
 }
 
 /**
@@ -245,6 +241,7 @@ bool ClusteringRefinementDivisive::Run(const vector<CPUBurst*>& Bursts,
 bool ClusteringRefinementDivisive::RunFirstStep(const vector<CPUBurst*>& Bursts,
                                                 Partition&               FirstPartition)
 {
+  phase_scope          StepPhase("refinement_step");
   ostringstream        Messages;
   ClusteringStatistics Statistics;
   double               Epsilon = EpsilonPerLevel[0];
@@ -310,6 +307,7 @@ bool ClusteringRefinementDivisive::RunStep(size_t                   Step,
                                            Partition&               NewPartition,
                                            bool&                    Stop)
 {
+  phase_scope    StepPhase("refinement_step");
   ostringstream  Messages;
   size_t         TotalParentOccurrences;
   timestamp_t    TotalParentDurations;
@@ -641,12 +639,12 @@ bool ClusteringRefinementDivisive::GenerateNodes(const vector<CPUBurst*>&     Bu
   {
     cluster_id_t CurrentID = CurrentClustersScores[i].GetID();
 
-    ClusterInformation* NewNode =
-      new ClusterInformation(CurrentClustersScores[i].GetID(),
-                             CurrentClustersScores[i].GetClusterScore(),
-                             CurrentClustersScores[i].GetOccurrences(),
-                             CurrentClustersDurations[CurrentID],
-                             CurrentClustersIndividuals[CurrentID]);
+    ClusterInformation* NewNode = new (NodesArena.Allocate())
+      ClusterInformation(CurrentClustersScores[i].GetID(),
+                         CurrentClustersScores[i].GetClusterScore(),
+                         CurrentClustersScores[i].GetOccurrences(),
+                         CurrentClustersDurations[CurrentID],
+                         CurrentClustersIndividuals[CurrentID]);
 
     Nodes.push_back(NewNode);
 
@@ -685,40 +683,37 @@ bool ClusteringRefinementDivisive::GenerateNodes(const vector<CPUBurst*>&     Bu
  */
 void ClusteringRefinementDivisive::GeneratePartition(Partition& NewPartition)
 {
-  map<instance_t, cluster_id_t>           Assignment;
-  map<instance_t, cluster_id_t>::iterator AssignmentIt;
-  vector<ClusterInformation*>             TopLevelNodes = NodesPerLevel[0];
+  vector<pair<instance_t, cluster_id_t> > Assignment;
+  vector<ClusterInformation*>&            TopLevelNodes = NodesPerLevel[0];
 
+  /* All the trees append their assignment to a single vector */
   for (size_t i = 0; i < TopLevelNodes.size(); i++)
   {
-    vector<pair<instance_t, cluster_id_t> > PartialAssignment;
-
-    PartialAssignment = GetAssignment(TopLevelNodes[i], 0);
-
-    /* DEBUG
-    cout << "PartialAssignment from ID = " << TopLevelNodes[i]->GetID();
-    cout << " sizes " << PartialAssignment.size() << endl; */
-
-    for (size_t j = 0; j < PartialAssignment.size(); j++)
-    {
-      Assignment[PartialAssignment[j].first] = PartialAssignment[j].second;
-    }
+    GetAssignment(TopLevelNodes[i], 0, Assignment);
   }
 
+  /* Stable sort: when an instance appears twice, its last ID is kept */
+  stable_sort(Assignment.begin(), Assignment.end(), AssignmentInstanceOrder());
+
   vector<cluster_id_t>& CurrentAssignmentVector =
     NewPartition.GetAssignmentVector();
 
   set<cluster_id_t> DifferentIDs;
 
-  for (AssignmentIt  = Assignment.begin();
-       AssignmentIt != Assignment.end();
-       ++AssignmentIt)
+  CurrentAssignmentVector.reserve(CurrentAssignmentVector.size()+Assignment.size());
+
+  for (size_t i = 0; i < Assignment.size(); i++)
   {
+    if (i+1 < Assignment.size() && Assignment[i+1].first == Assignment[i].first)
+    {
+      continue;
+    }
+
     /* DEBUG
-    cout << "Instance = " << AssignmentIt->first << " ID = " << AssignmentIt->second << endl; */
+    cout << "Instance = " << Assignment[i].first << " ID = " << Assignment[i].second << endl; */
 
-    CurrentAssignmentVector.push_back(AssignmentIt->second);
-    DifferentIDs.insert(AssignmentIt->second);
+    CurrentAssignmentVector.push_back(Assignment[i].second);
+    DifferentIDs.insert(Assignment[i].second);
   }
 
   NewPartition.SetIDs(DifferentIDs);
@@ -727,19 +722,18 @@ void ClusteringRefinementDivisive::GeneratePartition(Partition& NewPartition)
 }
 
 /**
- * Returns an assignment vector based on instances for the tree which root is
- * the given node
+ * Appends the assignment based on instances for the tree which root is the
+ * given node
  *
- * \param Node The root of a tree where we want to extract the assignment
- *
- * \return A vector of pairs burst instance/ID correspondig to the refinement
- *         happened in the current tree
+ * \param Node       The root of a tree where we want to extract the assignment
+ * \param Level      Depth of the node in the tree
+ * \param Assignment Vector of pairs burst instance/ID where the refinement
+ *                   happened in the current tree is appended
  */
-vector<pair<instance_t, cluster_id_t> > ClusteringRefinementDivisive::GetAssignment(ClusterInformation* Node,
-                                                                                    size_t              Level)
+void ClusteringRefinementDivisive::GetAssignment(ClusterInformation*                      Node,
+                                                 size_t                                   Level,
+                                                 vector<pair<instance_t, cluster_id_t> >& Assignment)
 {
-  vector<pair<instance_t, cluster_id_t> > Result = vector<pair<instance_t, cluster_id_t> > (0);
-
   bool LeafNode;
 
   /* Node not taken into account */
@@ -747,7 +741,7 @@ vector<pair<instance_t, cluster_id_t> > ClusteringRefinementDivisive::GetAssignm
   {
     /* DEBUG
     cout << "LEVEL " << Level+1 << " Node ID = " << Node->GetID() << " discarded" << endl; */
-    return Result;
+    return;
   }
 
   vector<ClusterInformation*>& Children = Node->GetChildren();
@@ -775,38 +769,25 @@ vector<pair<instance_t, cluster_id_t> > ClusteringRefinementDivisive::GetAssignm
 
     for (size_t i = 0; i < Instances.size(); i++)
     {
-      Result.push_back(make_pair(Instances[i], Node->GetID()));
+      Assignment.push_back(make_pair(Instances[i], Node->GetID()));
     }
 
     /* DEBUG
     cout << "LEVEL " << Level+1 << " Node ID = " << Node->GetID();
-    cout  << " adds " << Result.size() << " instances" << endl; */
-
-    return Result;
+    cout  << " adds " << Instances.size() << " instances" << endl; */
   }
   else
   { /* Join the assignments of each children */
     for (size_t i = 0; i < Children.size(); i++)
     {
-      vector<pair<instance_t, cluster_id_t> > PartialResult;
-
       if (!Children[i]->IsDiscarded())
       {
-        PartialResult = GetAssignment(Children[i], Level+1);
-
-        for (size_t j = 0; j < PartialResult.size(); j++)
-        {
-          Result.push_back(PartialResult[j]);
-        }
+        GetAssignment(Children[i], Level+1, Assignment);
       }
     }
-
-    /* DEBUG
-    cout << "NODE with ID = " << Node->GetID() << " has ";
-    cout << Result.size() << " instances in its assignment" << endl; */
-
-    return Result;
   }
+
+  return;
 }
 
 
@@ -1046,26 +1027,35 @@ void ClusteringRefinementDivisive::ReclassifyNoise(const vector<CPUBurst*>& Burs
       return;
     }
 
-    /* Reclassify points */
-    for (size_t i = 0; i < NoiseInstances.size(); i++)
+    /* Reclassify points, comparing squared distances against all the
+     * clustered points in a single batch */
+    vector<const Point*>                    ClusteredPoints;
+    vector<cluster_id_t>                    ClusteredIDs;
+    vector<double>                          Distances;
+    map<instance_t, cluster_id_t>::iterator ClusterInstancesIt;
+
+    for (ClusterInstancesIt  = ClusterInstances.begin();
+         ClusterInstancesIt != ClusterInstances.end();
+         ++ClusterInstancesIt)
     {
-      map<instance_t, cluster_id_t>::iterator ClusterInstancesIt;
+      ClusteredPoints.push_back(Bursts[Instance2Burst[ClusterInstancesIt->first]]);
+      ClusteredIDs.push_back(ClusterInstancesIt->second);
+    }
 
+    for (size_t i = 0; i < NoiseInstances.size(); i++)
+    {
       double       MinDistance = MAX_DOUBLE;
       cluster_id_t CandidateID = NOISE_CLUSTERID;
       CPUBurst*    NoisePoint  = Bursts[Instance2Burst[NoiseInstances[i]]];
 
-      for (ClusterInstancesIt  = ClusterInstances.begin();
-           ClusterInstancesIt != ClusterInstances.end();
-           ++ClusterInstancesIt)
-      {
-        CPUBurst* ClusteredPoint = Bursts[Instance2Burst[ClusterInstancesIt->first]];
-        double Distance = (*NoisePoint).EuclideanDistance((*ClusteredPoint));
+      NoisePoint->SquaredEuclideanDistances(ClusteredPoints, Distances);
 
-        if (Distance < MinDistance)
+      for (size_t j = 0; j < Distances.size(); j++)
+      {
+        if (Distances[j] < MinDistance)
         {
-          MinDistance = Distance;
-          CandidateID = ClusterInstancesIt->second;
+          MinDistance = Distances[j];
+          CandidateID = ClusteredIDs[j];
         }
       }
 
@@ -1367,7 +1357,13 @@ bool ClusteringRefinementDivisive::PrintTrees(size_t Step,
   /* DEBUG
   cout << "TOP LEVEL HAS " << ClustersHierarchy[0].size() << " NODES" << endl; */
 
-  Output->close();
+  /* Closing 'cout' through the cast leaves it in a failed state, silencing
+   * any later output of the application */
+  if (PrintStepsInformation)
+  {
+    Output->close();
+    delete Output;
+  }
 
   return true;
 }
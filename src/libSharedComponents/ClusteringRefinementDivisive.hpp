@@ -42,6 +42,7 @@ using cepba_tools::Error;
 #include "Partition.hpp"
 #include "ClusteringStatistics.hpp"
 #include "ClusterInformation.hpp"
+#include "ObjectsArena.hpp"
 
 #include <list>
 using std::list;
@@ -71,6 +72,7 @@ class ClusteringRefinementDivisive: public Error
 
     vector<ClusteringStatistics>         StatisticsHistory;
     vector<vector<ClusterInformation*> > NodesPerLevel;
+    ObjectsArena<ClusterInformation>     NodesArena;
 
   public:
 
@@ -118,8 +120,9 @@ class ClusteringRefinementDivisive: public Error
 
     void GeneratePartition(Partition& NewPartition);
 
-    vector<pair<instance_t, cluster_id_t> > GetAssignment(ClusterInformation* Node,
-                                                          size_t              Level);
+    void GetAssignment(ClusterInformation*                      Node,
+                       size_t                                   Level,
+                       vector<pair<instance_t, cluster_id_t> >& Assignment);
 
     size_t ColapseNonDividedSubtrees(ClusterInformation* Node);
 
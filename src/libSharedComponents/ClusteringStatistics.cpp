@@ -222,16 +222,16 @@ void StatisticsContainer::NewBurst(CPUBurst* Burst)
 
   if (ExtrapolationMetrics.size() > 0)
   {
-    map<size_t, double>::const_iterator Iterator;
-
-    for (Iterator  = Burst->GetExtrapolationDimensions().begin();
-         Iterator != Burst->GetExtrapolationDimensions().end();
-         ++Iterator)
+    for (size_t MetricPosition  = 0;
+                MetricPosition  < ExtrapolationMetrics.size();
+                MetricPosition++)
     {
-      size_t MetricPosition = Iterator->first;
-      double MetricValue    = Iterator->second;
+      double MetricValue;
 
-      ExtrapolationMetrics[MetricPosition].Update(MetricValue);
+      if (Burst->GetExtrapolationDimension(MetricPosition, MetricValue))
+      {
+        ExtrapolationMetrics[MetricPosition].Update(MetricValue);
+      }
     }
   }
 }
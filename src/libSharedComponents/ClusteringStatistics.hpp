@@ -38,6 +38,9 @@
 
 #include <Utilities.hpp>
 
+#include <Error.hpp>
+using cepba_tools::Error;
+
 #include "trace_clustering_types.h"
 
 #include "ClusteringStatistics.hpp"
@@ -38,6 +38,7 @@
 DataExtractor::DataExtractor(string InputTraceName)
 {
   this->InputTraceName = InputTraceName;
+  this->UseSelection   = false;
   
   /* Check TraceFile accesibility */
   this->InputTraceFile = fopen(this->InputTraceName.c_str(), "r");
@@ -54,3 +55,39 @@ DataExtractor::DataExtractor(string InputTraceName)
   }
 }
 
+/**
+ * Restricts the extraction to the bursts of the given tasks that lie entirely
+ * in the time window. Only the extractors of Paraver traces support it
+ *
+ * \param SelectedTasks  Tasks whose bursts are kept (0-based), empty for all
+ * \param SelectionBegin Initial time of the window, in trace time units
+ * \param SelectionEnd   Final time of the window, in trace time units
+ *
+ * \return True if the extractor supports the selection, false otherwise
+ */
+bool DataExtractor::SetSelection(const set<task_id_t>& SelectedTasks,
+                                 timestamp_t           SelectionBegin,
+                                 timestamp_t           SelectionEnd)
+{
+  SetError(true);
+  SetErrorMessage("tasks and time selection only available on Paraver traces");
+
+  return false;
+}
+
+bool DataExtractor::InSelection(task_id_t   TaskId,
+                                timestamp_t BeginTime,
+                                timestamp_t EndTime)
+{
+  if (!UseSelection)
+  {
+    return true;
+  }
+
+  if (SelectedTasks.size() > 0 && SelectedTasks.count(TaskId) == 0)
+  {
+    return false;
+  }
+
+  return (BeginTime >= SelectionBegin && EndTime <= SelectionEnd);
+}
@@ -58,6 +58,13 @@ class DataExtractor: public Error
     FILE*  InputTraceFile;
     string TraceDataFileName;
 
+    /* Bursts to keep when the extraction is restricted by 'SetSelection' */
+    bool           UseSelection;
+    set<task_id_t> SelectedTasks;
+    timestamp_t    SelectionBegin, SelectionEnd;
+
+    bool InSelection(task_id_t TaskId, timestamp_t BeginTime, timestamp_t EndTime);
+
 
   public:
     DataExtractor(string InputTraceName);
@@ -71,6 +78,10 @@ class DataExtractor: public Error
 
     virtual bool GetPartition(Partition& DataPartition) = 0;
 
+    virtual bool SetSelection(const set<task_id_t>& SelectedTasks,
+                              timestamp_t           SelectionBegin,
+                              timestamp_t           SelectionEnd);
+
     string GetTraceDataFileName(void) { return TraceDataFileName; };
 };
 
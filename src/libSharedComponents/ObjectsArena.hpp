@@ -0,0 +1,160 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _OBJECTSARENA_HPP_
+#define _OBJECTSARENA_HPP_
+
+#include <vector>
+using std::vector;
+
+#include <new>
+#include <cstddef>
+
+/**
+ * Region allocator for objects that share the lifetime of their owner.
+ * Objects are constructed in place on the slots returned by 'Allocate':
+ *
+ *   CPUBurst* Burst = new (Arena.Allocate()) CPUBurst(...);
+ *
+ * and they are never released one by one: 'Release' (or the arena
+ * destructor) returns all the blocks at once. When the objects do not own
+ * any other resource, the arena can be built with 'RunDestructors' set to
+ * false so the release costs just one deallocation per block.
+ */
+template <typename T>
+class ObjectsArena
+{
+  public:
+    enum { FIRST_BLOCK_OBJECTS = 256, MAX_BLOCK_OBJECTS = 65536 };
+
+  private:
+    bool           RunDestructors;
+
+    vector<char*>  Blocks;
+    vector<size_t> BlocksCapacity;
+    size_t         LastBlockUsed;
+
+    size_t         ObjectsCount;
+
+  public:
+    ObjectsArena(bool RunDestructors = true)
+    {
+      this->RunDestructors = RunDestructors;
+      this->LastBlockUsed  = 0;
+      this->ObjectsCount   = 0;
+    };
+
+    ~ObjectsArena(void) { Release(); };
+
+    /**
+     * Reserves the space for a new object, that must be constructed using
+     * placement new
+     * \result Pointer to uninitialized memory suitable to store a 'T'
+     */
+    void* Allocate(void)
+    {
+      if (Blocks.size() == 0 || LastBlockUsed == BlocksCapacity.back())
+      {
+        size_t NewCapacity = FIRST_BLOCK_OBJECTS;
+
+        if (Blocks.size() > 0)
+        {
+          NewCapacity = BlocksCapacity.back()*2;
+
+          if (NewCapacity > MAX_BLOCK_OBJECTS)
+          {
+            NewCapacity = MAX_BLOCK_OBJECTS;
+          }
+        }
+
+        Blocks.push_back(static_cast<char*>(::operator new(NewCapacity*sizeof(T))));
+        BlocksCapacity.push_back(NewCapacity);
+        LastBlockUsed = 0;
+      }
+
+      void* Result = Blocks.back() + LastBlockUsed*sizeof(T);
+
+      LastBlockUsed++;
+      ObjectsCount++;
+
+      return Result;
+    };
+
+    /**
+     * Destroys all the objects allocated (if required) and frees the blocks
+     */
+    void Release(void)
+    {
+      for (size_t i = 0; i < Blocks.size(); i++)
+      {
+        if (RunDestructors)
+        {
+          size_t Used = (i == Blocks.size()-1 ? LastBlockUsed : BlocksCapacity[i]);
+
+          for (size_t j = 0; j < Used; j++)
+          {
+            reinterpret_cast<T*>(Blocks[i] + j*sizeof(T))->~T();
+          }
+        }
+
+        ::operator delete(Blocks[i]);
+      }
+
+      Blocks.clear();
+      BlocksCapacity.clear();
+      LastBlockUsed = 0;
+      ObjectsCount  = 0;
+    };
+
+    size_t GetObjectsCount(void) const { return ObjectsCount; };
+
+    size_t GetAllocatedBytes(void) const
+    {
+      size_t Result = 0;
+
+      for (size_t i = 0; i < BlocksCapacity.size(); i++)
+      {
+        Result += BlocksCapacity[i]*sizeof(T);
+      }
+
+      return Result;
+    };
+
+  private:
+    /* Copies are not allowed, objects are referenced by their address */
+    ObjectsArena(const ObjectsArena&);
+    ObjectsArena& operator= (const ObjectsArena&);
+};
+
+#endif /* _OBJECTSARENA_HPP_ */
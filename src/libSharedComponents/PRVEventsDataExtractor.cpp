@@ -35,8 +35,16 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::counter_id;
+
 #include "PRVEventsDataExtractor.hpp"
 #include "ParaverTraceParser.hpp"
+#include "ParametersManager.hpp"
 
 #include <cstring>
 #include <cerrno>
@@ -102,11 +110,56 @@ bool PRVEventsDataExtractor::SetEventsToDealWith (set<event_type_t>& EventsToDea
   return true;
 }
 
+/**
+ * Restricts the extraction to the bursts of the given tasks that lie entirely
+ * in the time window. The trace index is loaded (or built) so the parser only
+ * reads the blocks with records of the selection
+ *
+ * \param SelectedTasks  Tasks whose bursts are kept (0-based), empty for all
+ * \param SelectionBegin Initial time of the window, in trace time units
+ * \param SelectionEnd   Final time of the window, in trace time units
+ *
+ * \return True if the trace index is available, false otherwise
+ */
+bool PRVEventsDataExtractor::SetSelection(const set<task_id_t>& SelectedTasks,
+                                          timestamp_t           SelectionBegin,
+                                          timestamp_t           SelectionEnd)
+{
+  if (SelectionBegin > SelectionEnd)
+  {
+    SetError(true);
+    SetErrorMessage("time window ends before it begins");
+    return false;
+  }
+
+  if (!TraceParser->LoadIndex())
+  {
+    SetError(true);
+    SetErrorMessage("unable to seek the selection", TraceParser->GetLastError());
+    return false;
+  }
+
+  this->UseSelection   = true;
+  this->SelectedTasks  = SelectedTasks;
+  this->SelectionBegin = SelectionBegin;
+  this->SelectionEnd   = SelectionEnd;
+
+  TraceParser->SetTasksSelection(set<INT32>(SelectedTasks.begin(),
+                                            SelectedTasks.end()));
+  TraceParser->SetTimeWindow(SelectionBegin, SelectionEnd);
+
+  return true;
+}
+
 bool PRVEventsDataExtractor::ExtractData(TraceData* TraceDataSet)
 {
   vector<ApplicationDescription_t> AppsDescription;
   vector<TaskDescription_t>        TaskInfo;
   size_t                           TraceObjects = 0;
+  set<event_type_t>                WantedEventTypes;
+
+  static counter_id RecordsCounter = instrumentation::counter("parser.records");
+  unsigned long long RecordsParsed = 0;
 
   ParaverRecord *CurrentRecord;
   State         *CurrentState;
@@ -173,10 +226,17 @@ bool PRVEventsDataExtractor::ExtractData(TraceData* TraceDataSet)
     }
   }
 
+  /* The parser only materializes the events read by the parameters and the
+   * ones that delimit the bursts */
+  WantedEventTypes = ParametersManager::GetInstance()->GetEventTypes();
+  WantedEventTypes.insert(EventsToDealWith.begin(), EventsToDealWith.end());
+  TraceParser->SetEventTypesFilter(set<INT32>(WantedEventTypes.begin(),
+                                              WantedEventTypes.end()));
+
   CurrentPercentage = TraceParser->GetFilePercentage();
 
-  system_messages::show_percentage_progress("Parsing Paraver Input Trace",
-                                            CurrentPercentage);
+  ProgressReporter Progress ("Parsing Paraver Input Trace", 100, ProgressReporter::percentage);
+  Progress.update(CurrentPercentage);
 
   while (true)
   {
@@ -187,6 +247,8 @@ bool PRVEventsDataExtractor::ExtractData(TraceData* TraceDataSet)
     if (CurrentRecord == NULL)
       break;
 
+    RecordsParsed++;
+
     if (!CheckEvent((Event*) CurrentRecord, TraceDataSet))
     {
       return false;
@@ -197,7 +259,7 @@ bool PRVEventsDataExtractor::ExtractData(TraceData* TraceDataSet)
     if (PercentageRead > CurrentPercentage)
     {
       CurrentPercentage = PercentageRead;
-      system_messages::show_percentage_progress("Parsing Paraver Input Trace", CurrentPercentage);
+      Progress.update(CurrentPercentage);
     }
 
     /* Free memory used by the parser */
@@ -211,7 +273,9 @@ bool PRVEventsDataExtractor::ExtractData(TraceData* TraceDataSet)
     return false;
   }
 
-  system_messages::show_percentage_end("Parsing Paraver Input Trace");
+  Progress.end();
+
+  instrumentation::add(RecordsCounter, RecordsParsed);
 
   if (ferror(InputTraceFile) != 0)
   {
@@ -227,7 +291,10 @@ bool PRVEventsDataExtractor::ExtractData(TraceData* TraceDataSet)
       {
         if (TaskData[i][j].OngoingBurst)
         { /* There is an ongoing burst.  */
-          if (!TraceDataSet->NewBurst(TaskData[i][j].TaskId,
+          if (InSelection(TaskData[i][j].TaskId,
+                          TaskData[i][j].BeginTime,
+                          TaskData[i][j].EndTime) &&
+              !TraceDataSet->NewBurst(TaskData[i][j].TaskId,
                                       TaskData[i][j].ThreadId,
                                       TaskData[i][j].Line,
                                       TaskData[i][j].BeginTime,
@@ -455,7 +522,8 @@ bool PRVEventsDataExtractor::GenerateBurst(TraceData*         TraceDataSet,
 
 
   /* Add it to the Trace Data Set */
-  if (!TraceDataSet->NewBurst(Data.TaskId,
+  if (InSelection(Data.TaskId, Data.BeginTime, Data.EndTime) &&
+      !TraceDataSet->NewBurst(Data.TaskId,
                               Data.ThreadId,
                               Data.Line,
                               Data.BeginTime,
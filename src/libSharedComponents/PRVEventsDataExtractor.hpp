@@ -140,6 +140,10 @@ class PRVEventsDataExtractor: public DataExtractor
     bool SetEventsToDealWith (set<event_type_t>& EventsToDealWith,
                               bool               ConsecutiveEvts);
 
+    bool SetSelection(const set<task_id_t>& SelectedTasks,
+                      timestamp_t           SelectionBegin,
+                      timestamp_t           SelectionEnd);
+
     bool GetPartition(Partition& DataPartition) { return false; };
 
     bool ExtractData(TraceData* TraceDataSet);
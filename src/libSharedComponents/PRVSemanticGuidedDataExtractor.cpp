@@ -35,6 +35,9 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
 #include "PRVSemanticGuidedDataExtractor.hpp"
 #include "ParaverTraceParser.hpp"
 
@@ -260,8 +263,8 @@ bool PRVSemanticGuidedDataExtractor::ExtractData(TraceData* TraceDataSet)
 
   CurrentPercentage = TraceParser->GetFilePercentage();
 
-  system_messages::show_percentage_progress("Parsing Paraver Input Trace",
-                                            CurrentPercentage);
+  ProgressReporter Progress ("Parsing Paraver Input Trace", 100, ProgressReporter::percentage);
+  Progress.update(CurrentPercentage);
 
   while (true)
   {
@@ -283,7 +286,7 @@ bool PRVSemanticGuidedDataExtractor::ExtractData(TraceData* TraceDataSet)
     if (PercentageRead > CurrentPercentage)
     {
       CurrentPercentage = PercentageRead;
-      system_messages::show_percentage_progress("Parsing Paraver Input Trace", CurrentPercentage);
+      Progress.update(CurrentPercentage);
     }
 
     /* Free memory used by the parser */
@@ -297,7 +300,7 @@ bool PRVSemanticGuidedDataExtractor::ExtractData(TraceData* TraceDataSet)
     return false;
   }
 
-  system_messages::show_percentage_end("Parsing Paraver Input Trace");
+  Progress.end();
 
   if (ferror(InputTraceFile) != 0)
   {
@@ -35,8 +35,16 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::counter_id;
+
 #include "PRVStatesDataExtractor.hpp"
 #include "ParaverTraceParser.hpp"
+#include "ParametersManager.hpp"
 
 #include <cstring>
 #include <cerrno>
@@ -127,11 +135,56 @@ bool PRVStatesDataExtractor::SetEventsToDealWith (set<event_type_t>& EventsToDea
   return false;
 }
 
+/**
+ * Restricts the extraction to the bursts of the given tasks that lie entirely
+ * in the time window. The trace index is loaded (or built) so the parser only
+ * reads the blocks with records of the selection
+ *
+ * \param SelectedTasks  Tasks whose bursts are kept (0-based), empty for all
+ * \param SelectionBegin Initial time of the window, in trace time units
+ * \param SelectionEnd   Final time of the window, in trace time units
+ *
+ * \return True if the trace index is available, false otherwise
+ */
+bool PRVStatesDataExtractor::SetSelection(const set<task_id_t>& SelectedTasks,
+                                          timestamp_t           SelectionBegin,
+                                          timestamp_t           SelectionEnd)
+{
+  if (SelectionBegin > SelectionEnd)
+  {
+    SetError(true);
+    SetErrorMessage("time window ends before it begins");
+    return false;
+  }
+
+  if (!TraceParser->LoadIndex())
+  {
+    SetError(true);
+    SetErrorMessage("unable to seek the selection", TraceParser->GetLastError());
+    return false;
+  }
+
+  this->UseSelection   = true;
+  this->SelectedTasks  = SelectedTasks;
+  this->SelectionBegin = SelectionBegin;
+  this->SelectionEnd   = SelectionEnd;
+
+  TraceParser->SetTasksSelection(set<INT32>(SelectedTasks.begin(),
+                                            SelectedTasks.end()));
+  TraceParser->SetTimeWindow(SelectionBegin, SelectionEnd);
+
+  return true;
+}
+
 bool PRVStatesDataExtractor::ExtractData(TraceData* TraceDataSet)
 {
   vector<ApplicationDescription_t> AppsDescription;
   vector<TaskDescription_t>        TaskInfo;
   size_t                           TraceObjects = 0;
+  set<event_type_t>                WantedEventTypes;
+
+  static counter_id RecordsCounter = instrumentation::counter("parser.records");
+  unsigned long long RecordsParsed = 0;
 
   ParaverRecord *CurrentRecord;
   State         *CurrentState;
@@ -203,10 +256,17 @@ bool PRVStatesDataExtractor::ExtractData(TraceData* TraceDataSet)
     }
   }
 
+  /* The parser only materializes the events read by the parameters and the
+   * hardware counters group changes */
+  WantedEventTypes = ParametersManager::GetInstance()->GetEventTypes();
+  WantedEventTypes.insert(HWC_GROUP_CHANGE_TYPE);
+  TraceParser->SetEventTypesFilter(set<INT32>(WantedEventTypes.begin(),
+                                              WantedEventTypes.end()));
+
   CurrentPercentage = TraceParser->GetFilePercentage();
 
-  system_messages::show_percentage_progress("Parsing Paraver Input Trace",
-                                            CurrentPercentage);
+  ProgressReporter Progress ("Parsing Paraver Input Trace", 100, ProgressReporter::percentage);
+  Progress.update(CurrentPercentage);
 
   while (true)
   {
@@ -217,6 +277,8 @@ bool PRVStatesDataExtractor::ExtractData(TraceData* TraceDataSet)
     if (CurrentRecord == NULL)
       break;
 
+    RecordsParsed++;
+
     if (CurrentRecord->GetRecordType() == PARAVER_STATE)
     {
       if (!CheckState((State*) CurrentRecord, TraceDataSet))
@@ -239,7 +301,7 @@ bool PRVStatesDataExtractor::ExtractData(TraceData* TraceDataSet)
     if (PercentageRead > CurrentPercentage)
     {
       CurrentPercentage = PercentageRead;
-      system_messages::show_percentage_progress("Parsing Paraver Input Trace", CurrentPercentage);
+      Progress.update(CurrentPercentage);
     }
 
     /* Free memory used by the parser */
@@ -253,7 +315,9 @@ bool PRVStatesDataExtractor::ExtractData(TraceData* TraceDataSet)
     return false;
   }
 
-  system_messages::show_percentage_end("Parsing Paraver Input Trace");
+  Progress.end();
+
+  instrumentation::add(RecordsCounter, RecordsParsed);
 
   if (ferror(InputTraceFile) != 0)
   {
@@ -275,7 +339,10 @@ bool PRVStatesDataExtractor::ExtractData(TraceData* TraceDataSet)
           cout << TaskData[i][j].toString() << endl;
 #endif
 
-          if (!TraceDataSet->NewBurst(TaskData[i][j].TaskId,
+          if (InSelection(TaskData[i][j].TaskId,
+                          TaskData[i][j].BeginTime,
+                          TaskData[i][j].EndTime) &&
+              !TraceDataSet->NewBurst(TaskData[i][j].TaskId,
                                       TaskData[i][j].ThreadId,
                                       TaskData[i][j].Line,
                                       TaskData[i][j].BeginTime,
@@ -375,7 +442,10 @@ bool PRVStatesDataExtractor::CheckState(State     *CurrentState,
         cout << CurrentTaskData.toString() << endl;
 #endif
 
-        if (!TraceDataSet->NewBurst(CurrentTaskData.TaskId,
+        if (InSelection(CurrentTaskData.TaskId,
+                        CurrentTaskData.BeginTime,
+                        CurrentTaskData.EndTime) &&
+            !TraceDataSet->NewBurst(CurrentTaskData.TaskId,
                                     CurrentTaskData.ThreadId,
                                     CurrentTaskData.Line,
                                     CurrentTaskData.BeginTime,
@@ -488,7 +558,10 @@ PRVStatesDataExtractor::CheckEvent(Event     *CurrentEvent,
       cout << CurrentTaskData.toString() << endl;
 #endif
 
-      if (!TraceDataSet->NewBurst(CurrentTaskData.TaskId,
+      if (InSelection(CurrentTaskData.TaskId,
+                      CurrentTaskData.BeginTime,
+                      CurrentTaskData.EndTime) &&
+          !TraceDataSet->NewBurst(CurrentTaskData.TaskId,
                                   CurrentTaskData.ThreadId,
                                   CurrentTaskData.Line,
                                   CurrentTaskData.BeginTime,
@@ -553,7 +626,10 @@ PRVStatesDataExtractor::CheckEvent(Event     *CurrentEvent,
           cout << CurrentTaskData.toString() << endl;
 #endif
 
-          if (!TraceDataSet->NewBurst(CurrentTaskData.TaskId,
+          if (InSelection(CurrentTaskData.TaskId,
+                          CurrentTaskData.BeginTime,
+                          CurrentTaskData.EndTime) &&
+              !TraceDataSet->NewBurst(CurrentTaskData.TaskId,
                                       CurrentTaskData.ThreadId,
                                       CurrentTaskData.Line,
                                       CurrentTaskData.BeginTime,
@@ -125,6 +125,10 @@ class PRVStatesDataExtractor: public DataExtractor
     bool SetEventsToDealWith(set<event_type_t>& EventsToDealWith,
                              bool               ConsecutivEvts);
 
+    bool SetSelection(const set<task_id_t>& SelectedTasks,
+                      timestamp_t           SelectionBegin,
+                      timestamp_t           SelectionEnd);
+
     bool GetPartition(Partition& DataPartition) { return false; };
 
     bool ExtractData(TraceData* TraceDataSet);
@@ -250,6 +250,40 @@ vector<double> ParametersManager::GetClusteringParametersFactors(void)
   return Result;
 }
 
+/**
+ * Returns the trace event types read by the clustering and extrapolation
+ * parameters, so the trace parsers can skip the rest
+ * \return A set containing the event types used by any parameter
+ */
+set<event_type_t> ParametersManager::GetEventTypes(void)
+{
+  set<event_type_t>            Result;
+  vector<ClusteringParameter*> AllParameters;
+
+  AllParameters = ClusteringParameters;
+  AllParameters.insert(AllParameters.end(),
+                       ExtrapolationParameters.begin(),
+                       ExtrapolationParameters.end());
+
+  for (size_t i = 0; i < AllParameters.size(); i++)
+  {
+    SingleEvent* CurrentSingleEvent = dynamic_cast<SingleEvent*>(AllParameters[i]);
+    MixedEvents* CurrentMixedEvents = dynamic_cast<MixedEvents*>(AllParameters[i]);
+
+    if (CurrentSingleEvent != NULL)
+    {
+      Result.insert(CurrentSingleEvent->GetEventType());
+    }
+    else if (CurrentMixedEvents != NULL)
+    {
+      Result.insert(CurrentMixedEvents->GetEventTypeA());
+      Result.insert(CurrentMixedEvents->GetEventTypeB());
+    }
+  }
+
+  return Result;
+}
+
 /******************************************************************************
  * Data Processing
  *****************************************************************************/
@@ -87,6 +87,8 @@ class ParametersManager: public Error
 
     vector<double> GetClusteringParametersFactors(void);
 
+    set<event_type_t> GetEventTypes(void);
+
     void Clear(void);
 
     void NewData(map<event_type_t, event_value_t>& EventsData,
@@ -0,0 +1,308 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include "SelfProfilePRVGenerator.hpp"
+
+#include <FileNameManipulator.hpp>
+using cepba_tools::FileNameManipulator;
+
+#include <ParaverHeader.hpp>
+#include <ParaverRecord.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+using std::stable_sort;
+
+#include <sstream>
+using std::ostringstream;
+
+#define IDLE_STATE          0
+#define RUNNING_STATE       1
+#define PHASE_EVENT_TYPE    90100000
+#define COUNTER_EVENT_BASE  90100100
+
+SelfProfilePRVGenerator::SelfProfilePRVGenerator(string OutputTraceName,
+                                                 string ToolName)
+{
+  string BaseName = FileNameManipulator(OutputTraceName, "prv").GetChoppedFileName();
+
+  this->OutputTraceName = BaseName+".prv";
+  this->OutputPCFName   = BaseName+".pcf";
+  this->OutputROWName   = BaseName+".row";
+  this->ToolName        = ToolName;
+}
+
+bool SelfProfilePRVGenerator::Run(void)
+{
+  vector<trace_event> Events;
+  vector<string>      Phases;
+  vector<string>      Counters;
+  unsigned int        Threads = 1;
+
+  if (!cepba_tools::instrumentation::tracing())
+  {
+    SetError(true);
+    SetErrorMessage("self-profiling timeline was not started");
+    return false;
+  }
+
+  cepba_tools::instrumentation::trace_events(Events, Phases, Counters);
+
+  for (size_t i = 0; i < Events.size(); i++)
+  {
+    if (Events[i].thread >= Threads)
+    {
+      Threads = Events[i].thread + 1;
+    }
+  }
+
+  if (!GeneratePRV(Events, Threads))
+  {
+    return false;
+  }
+
+  if (!GeneratePCF(Phases, Counters))
+  {
+    return false;
+  }
+
+  return GenerateROW(Threads);
+}
+
+bool SelfProfilePRVGenerator::GeneratePRV(vector<trace_event>& Events,
+                                          unsigned int         Threads)
+{
+  FILE*                   OutputTraceFile;
+  vector<ParaverRecord_t> Records;
+  vector<UINT64>          RunningSince (Threads, 0);
+  vector<bool>            Running      (Threads, false);
+  UINT64                  FinalTime = 1;
+  Event*                  CurrentEvent = NULL;
+  ostringstream           ASCIIHeader;
+  char                    Date[30];
+  time_t                  Now = time(NULL);
+  bool                    Result = true;
+
+  for (size_t i = 0; i < Events.size(); i++)
+  {
+    trace_event& Current = Events[i];
+
+    if (Current.time > FinalTime)
+    {
+      FinalTime = Current.time;
+    }
+
+    /* Changes of a thread at the same time share a single event record.
+     * Records take the identifiers 1-based and keep them 0-based */
+    if (CurrentEvent == NULL ||
+        CurrentEvent->GetTimestamp() != Current.time ||
+        CurrentEvent->GetThreadId()  != (INT32) Current.thread)
+    {
+      CurrentEvent = new Event(0, Current.time, Current.thread+1, 1, 1, Current.thread+1);
+      Records.push_back(CurrentEvent);
+    }
+
+    if (Current.type != 0)
+    {
+      CurrentEvent->AddTypeValue(COUNTER_EVENT_BASE + Current.type - 1, Current.value);
+      continue;
+    }
+
+    CurrentEvent->AddTypeValue(PHASE_EVENT_TYPE, Current.value);
+
+    if (Current.value != 0 && !Running[Current.thread])
+    {
+      Running[Current.thread]      = true;
+      RunningSince[Current.thread] = Current.time;
+    }
+    else if (Current.value == 0 && Running[Current.thread])
+    {
+      Running[Current.thread] = false;
+      Records.push_back(new State(0,
+                                  Current.thread+1, 1, 1, Current.thread+1,
+                                  RunningSince[Current.thread],
+                                  Current.time,
+                                  RUNNING_STATE));
+    }
+  }
+
+  /* Phases still open when the trace is written last until its end */
+  for (unsigned int i = 0; i < Threads; i++)
+  {
+    if (Running[i])
+    {
+      Records.push_back(new State(0, i+1, 1, 1, i+1, RunningSince[i], FinalTime, RUNNING_STATE));
+    }
+  }
+
+  stable_sort(Records.begin(), Records.end(), ParaverRecordCompare());
+
+  strftime(Date, sizeof(Date), "%d/%m/%y at %H:%M", localtime(&Now));
+
+  ASCIIHeader << "#Paraver (" << Date << "):" << FinalTime << "_ns:";
+  ASCIIHeader << "1(" << Threads << "):1:1(" << Threads << ":1)";
+
+  ParaverHeader Header((char*) ASCIIHeader.str().c_str(),
+                       (INT32) ASCIIHeader.str().size());
+
+  if ((OutputTraceFile = fopen(OutputTraceName.c_str(), "w")) == NULL)
+  {
+    SetError(true);
+    SetErrorMessage("unable to open self-profiling trace", strerror(errno));
+    Result = false;
+  }
+  else if (Header.GetError() || !Header.Flush(OutputTraceFile))
+  {
+    SetError(true);
+    SetErrorMessage("unable to write self-profiling trace header",
+                    Header.GetLastError());
+    Result = false;
+  }
+
+  for (size_t i = 0; i < Records.size(); i++)
+  {
+    if (Result && !Records[i]->Flush(OutputTraceFile))
+    {
+      SetError(true);
+      SetErrorMessage("unable to write self-profiling trace record",
+                      Records[i]->GetLastError());
+      Result = false;
+    }
+
+    delete Records[i];
+  }
+
+  if (OutputTraceFile != NULL && fclose(OutputTraceFile) != 0 && Result)
+  {
+    SetError(true);
+    SetErrorMessage("unable to close self-profiling trace", strerror(errno));
+    Result = false;
+  }
+
+  return Result;
+}
+
+bool SelfProfilePRVGenerator::GeneratePCF(vector<string>& Phases,
+                                          vector<string>& Counters)
+{
+  FILE* OutputPCFFile;
+
+  if ((OutputPCFFile = fopen(OutputPCFName.c_str(), "w")) == NULL)
+  {
+    SetError(true);
+    SetErrorMessage("unable to open self-profiling PCF", strerror(errno));
+    return false;
+  }
+
+  fprintf(OutputPCFFile, "DEFAULT_OPTIONS\n\n");
+  fprintf(OutputPCFFile, "LEVEL               THREAD\n");
+  fprintf(OutputPCFFile, "UNITS               NANOSEC\n");
+  fprintf(OutputPCFFile, "\n\n");
+
+  fprintf(OutputPCFFile, "STATES\n");
+  fprintf(OutputPCFFile, "%d\tIdle\n", IDLE_STATE);
+  fprintf(OutputPCFFile, "%d\tRunning\n", RUNNING_STATE);
+  fprintf(OutputPCFFile, "\n\n");
+
+  fprintf(OutputPCFFile, "EVENT_TYPE\n");
+  fprintf(OutputPCFFile, "9\t%d\t%s phase\n", PHASE_EVENT_TYPE, ToolName.c_str());
+  fprintf(OutputPCFFile, "VALUES\n");
+  fprintf(OutputPCFFile, "0\tEnd\n");
+
+  for (size_t i = 0; i < Phases.size(); i++)
+  {
+    fprintf(OutputPCFFile, "%u\t%s\n", (unsigned int) i+1, Phases[i].c_str());
+  }
+
+  for (size_t i = 0; i < Counters.size(); i++)
+  {
+    fprintf(OutputPCFFile, "\n\nEVENT_TYPE\n");
+    fprintf(OutputPCFFile, "1\t%u\t%s\n",
+            COUNTER_EVENT_BASE + (unsigned int) i,
+            Counters[i].c_str());
+  }
+
+  fprintf(OutputPCFFile, "\n");
+
+  if (fclose(OutputPCFFile) != 0)
+  {
+    SetError(true);
+    SetErrorMessage("unable to write self-profiling PCF", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+bool SelfProfilePRVGenerator::GenerateROW(unsigned int Threads)
+{
+  FILE* OutputROWFile;
+
+  if ((OutputROWFile = fopen(OutputROWName.c_str(), "w")) == NULL)
+  {
+    SetError(true);
+    SetErrorMessage("unable to open self-profiling ROW", strerror(errno));
+    return false;
+  }
+
+  fprintf(OutputROWFile, "LEVEL CPU SIZE %u\n", Threads);
+  for (unsigned int i = 1; i <= Threads; i++)
+  {
+    fprintf(OutputROWFile, "%u.%s\n", i, ToolName.c_str());
+  }
+  fprintf(OutputROWFile, "\n");
+
+  fprintf(OutputROWFile, "LEVEL NODE SIZE 1\n");
+  fprintf(OutputROWFile, "%s\n", ToolName.c_str());
+  fprintf(OutputROWFile, "\n");
+
+  fprintf(OutputROWFile, "LEVEL THREAD SIZE %u\n", Threads);
+  fprintf(OutputROWFile, "%s main\n", ToolName.c_str());
+  for (unsigned int i = 1; i < Threads; i++)
+  {
+    fprintf(OutputROWFile, "%s worker %u\n", ToolName.c_str(), i);
+  }
+
+  if (fclose(OutputROWFile) != 0)
+  {
+    SetError(true);
+    SetErrorMessage("unable to write self-profiling ROW", strerror(errno));
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,78 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _SELFPROFILEPRVGENERATOR_HPP_
+#define _SELFPROFILEPRVGENERATOR_HPP_
+
+#include <Error.hpp>
+using cepba_tools::Error;
+
+#include <Instrumentation.hpp>
+using cepba_tools::trace_event;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+/*
+ * Writes the timeline kept by the instrumentation registry as a Paraver
+ * trace (.prv/.pcf/.row) of the tool's own execution. Every thread shows
+ * the running state while inside a phase, an event with the active phase
+ * on each phase change, and one event type per counter with the increments
+ * accumulated since the previous phase change
+ */
+class SelfProfilePRVGenerator: public Error
+{
+  private:
+    string OutputTraceName;
+    string OutputPCFName;
+    string OutputROWName;
+    string ToolName;
+
+  public:
+    SelfProfilePRVGenerator(string OutputTraceName, string ToolName);
+
+    bool Run(void);
+
+  private:
+    bool GeneratePRV(vector<trace_event>& Events, unsigned int Threads);
+
+    bool GeneratePCF(vector<string>& Phases, vector<string>& Counters);
+
+    bool GenerateROW(unsigned int Threads);
+};
+
+#endif // _SELFPROFILEPRVGENERATOR_HPP_
@@ -52,6 +52,10 @@ using std::setprecision;
 using std::setw;
 using std::setfill;
 
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::counter_id;
+
 #include "kalign2/kalign2.h"
 
 /******************************************************************************
@@ -434,14 +438,26 @@ void SequenceScore::Kalign2Score(TSequenceMap&                    Sequences,
   }
 
   /* Perform the alignment */
+  static counter_id AlignmentCells = instrumentation::counter("sequence_score.alignment_cells");
+
+  unsigned long long LengthsSum = 0, SquaredLengthsSum = 0;
 
-  /* First step: pairwise alignment */
+  /* First step: pairwise alignment, a full DP matrix per pair of sequences */
   float** dm  = NULL;
   int**   map = NULL;
 
+  for (i = 0; i < numseq; i++)
+  {
+    LengthsSum        += aln->sl[i];
+    SquaredLengthsSum += (unsigned long long) aln->sl[i] * aln->sl[i];
+  }
+  instrumentation::add(AlignmentCells, (LengthsSum*LengthsSum - SquaredLengthsSum)/2);
+
+  instrumentation::phase_begin("pairwise_alignment");
   //dm    = protein_wu_distance (aln, dm, param, 0);
   dm    = protein_pairwise_alignment_distance(aln, dm, param, submatrix, 0);
   tree2 = real_upgma (dm, 2); // 2 trees
+  instrumentation::phase_end();
 
   tree = (int*) malloc (sizeof (int) * (numseq * 3 + 1) );
   for ( i = 1; i < (numseq * 3) + 1; i++)
@@ -462,7 +478,16 @@ void SequenceScore::Kalign2Score(TSequenceMap&                    Sequences,
   free (tree2);
 
   /* Second step: global alignment */
+  instrumentation::phase_begin("progressive_alignment");
   map =  default_alignment (aln, tree, submatrix, map);
+  instrumentation::phase_end();
+
+  /* Each merge of the guide tree aligns the two profiles lengths */
+  for (i = 0; i < (numseq - 1) * 3; i += 3)
+  {
+    instrumentation::add(AlignmentCells,
+                         (unsigned long long) aln->sl[tree[i]] * aln->sl[tree[i+1]]);
+  }
   /* map   =  hirschberg_alignment (aln,
                                  tree,
                                  submatrix,
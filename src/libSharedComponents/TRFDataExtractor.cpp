@@ -35,6 +35,9 @@
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
 #include "TRFDataExtractor.hpp"
 
 #include <cstring>
@@ -123,8 +126,8 @@ TRFDataExtractor::ExtractData(TraceData* TraceDataSet)
     return false;
   }
 
-  system_messages::show_percentage_progress("Parsing Dimemas Input Trace",
-                                            CurrentPercentage);
+  ProgressReporter Progress ("Parsing Dimemas Input Trace", 100, ProgressReporter::percentage);
+  Progress.update(CurrentPercentage);
   CurrentLine = 0;
   EventsData.clear();
   InIdleBlock  = false;
@@ -278,12 +281,11 @@ TRFDataExtractor::ExtractData(TraceData* TraceDataSet)
     if (PercentageRead > CurrentPercentage)
     {
       CurrentPercentage = PercentageRead;
-      system_messages::show_percentage_progress("Parsing Dimemas Input Trace",
-                                                CurrentPercentage);
+      Progress.update(CurrentPercentage);
     }
   }
 
-  system_messages::show_percentage_end("Parsing Dimemas Input Trace");
+  Progress.end();
 
   if (ferror(InputTraceFile) != 0)
   {
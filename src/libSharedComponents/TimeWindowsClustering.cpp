@@ -0,0 +1,547 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#include <SystemMessages.hpp>
+using cepba_tools::system_messages;
+
+#include <ParallelFor.hpp>
+
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::phase_scope;
+
+#include "TimeWindowsClustering.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+using std::sort;
+
+#include <sstream>
+using std::ostringstream;
+using std::endl;
+
+#include <utility>
+using std::pair;
+using std::make_pair;
+
+/**
+ * Functor to cluster the time windows through 'parallel_for'. Each window
+ * has its own clustering library, set up in advance
+ */
+class WindowsClusteringTask
+{
+  private:
+    const vector<CPUBurst*>& Bursts;
+    vector<TimeWindow>&      Windows;
+    vector<libClustering*>&  Cores;
+    vector<string>&          Errors;
+
+  public:
+    WindowsClusteringTask(const vector<CPUBurst*>& Bursts,
+                          vector<TimeWindow>&      Windows,
+                          vector<libClustering*>&  Cores,
+                          vector<string>&          Errors)
+    : Bursts(Bursts), Windows(Windows), Cores(Cores), Errors(Errors) {}
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        vector<const Point*> WindowPoints;
+
+        if (Windows[i].Bursts.size() == 0)
+        {
+          continue;
+        }
+
+        WindowPoints.reserve(Windows[i].Bursts.size());
+
+        for (size_t j = 0; j < Windows[i].Bursts.size(); j++)
+        {
+          WindowPoints.push_back(Bursts[Windows[i].Bursts[j]]);
+        }
+
+        if (!Cores[i]->ExecuteClustering(WindowPoints,
+                                         Windows[i].WindowPartition))
+        {
+          Errors[i] = Cores[i]->GetErrorMessage();
+        }
+      }
+    }
+};
+
+/**
+ * Constructor sets the clustering algorithm applied to each window
+ *
+ * \param ClusteringAlgorithmName       Name of the algorithm
+ * \param ClusteringAlgorithmParameters Parameters of the algorithm
+ * \param MatchDistance                 Maximum distance between the
+ *                                      centroids of two clusters of adjacent
+ *                                      windows to be considered the same
+ */
+TimeWindowsClustering::TimeWindowsClustering(string              ClusteringAlgorithmName,
+                                             map<string, string> ClusteringAlgorithmParameters,
+                                             double              MatchDistance)
+{
+  this->ClusteringAlgorithmName       = ClusteringAlgorithmName;
+  this->ClusteringAlgorithmParameters = ClusteringAlgorithmParameters;
+  this->MatchDistance                 = MatchDistance;
+}
+
+/**
+ * Clusters the bursts by time windows. Either the number of windows or their
+ * length should be provided
+ *
+ * \param Bursts          Bursts to analyze
+ * \param WindowsCount    Number of windows of the same length (0 to use the
+ *                        length)
+ * \param WindowLength    Length of each window (0 to use the count)
+ * \param GlobalPartition Resulting partition, with the global IDs of the
+ *                        clusters
+ *
+ * \return True if the analysis finished correctly, false otherwise
+ */
+bool TimeWindowsClustering::Run(const vector<CPUBurst*>& Bursts,
+                                size_t                   WindowsCount,
+                                timestamp_t              WindowLength,
+                                Partition&               GlobalPartition)
+{
+  vector<cluster_id_t>&           Assignment = GlobalPartition.GetAssignmentVector();
+  set<cluster_id_t>&              IDs        = GlobalPartition.GetIDs();
+  cluster_id_t                    NextGlobalID = MIN_CLUSTERID;
+  ostringstream                   Messages;
+
+  if (Bursts.size() == 0)
+  {
+    SetErrorMessage("no bursts to analyze");
+    return false;
+  }
+
+  if (!SplitWindows(Bursts, WindowsCount, WindowLength))
+  {
+    return false;
+  }
+
+  Messages << "*** " << Windows.size() << " TIME WINDOWS OF ";
+  Messages << (Windows[0].End - Windows[0].Begin) << " ns ***" << endl;
+  system_messages::information(Messages.str());
+
+  if (!ClusterWindows(Bursts))
+  {
+    return false;
+  }
+
+  phase_scope Phase ("windows_matching");
+
+  GlobalPartition.clear();
+  Assignment.assign(Bursts.size(), NOISE_CLUSTERID);
+  IDs.insert(NOISE_CLUSTERID);
+
+  for (size_t i = 0; i < Windows.size(); i++)
+  {
+    map<cluster_id_t, WindowCluster> LocalClusters;
+    map<cluster_id_t, cluster_id_t>  LocalToGlobal;
+    vector<cluster_id_t>&            LocalAssignment = Windows[i].WindowPartition.GetAssignmentVector();
+
+    ComputeClusters(Bursts, Windows[i], LocalClusters);
+
+    MatchClusters((i > 0 ? &Windows[i-1] : NULL),
+                  LocalClusters,
+                  Windows[i],
+                  LocalToGlobal,
+                  NextGlobalID);
+
+    for (size_t j = 0; j < LocalAssignment.size(); j++)
+    {
+      if (LocalAssignment[j] != NOISE_CLUSTERID)
+      {
+        Assignment[Windows[i].Bursts[j]] = LocalToGlobal[LocalAssignment[j]];
+        IDs.insert(LocalToGlobal[LocalAssignment[j]]);
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Prints the clusters present on each window, one line per window and
+ * cluster, using the final names of the clusters
+ *
+ * \param str            Output stream
+ * \param TranslationMap Final names of the global IDs
+ *
+ * \return True if the information was written correctly, false otherwise
+ */
+bool TimeWindowsClustering::Flush(ostream&                         str,
+                                  map<cluster_id_t, cluster_id_t>& TranslationMap)
+{
+  str << "Window,Begin,End,Cluster Name,Density,Total Duration,Previous Window Distance";
+  str << '\n';
+
+  for (size_t i = 0; i < Windows.size(); i++)
+  {
+    map<cluster_id_t, WindowCluster>::iterator ClustersIt;
+    map<cluster_id_t, WindowCluster*>          TranslatedClusters;
+    map<cluster_id_t, WindowCluster*>::iterator TranslatedIt;
+
+    str.precision(0);
+    str << fixed;
+
+    str << i+1 << "," << Windows[i].Begin << "," << Windows[i].End;
+    str << ",NOISE," << Windows[i].NoiseBursts << "," << Windows[i].NoiseDuration;
+    str << ",-" << '\n';
+
+    for (ClustersIt  = Windows[i].Clusters.begin();
+         ClustersIt != Windows[i].Clusters.end();
+         ++ClustersIt)
+    {
+      cluster_id_t ID = ClustersIt->first;
+
+      if (TranslationMap.count(ID) > 0)
+      {
+        ID = TranslationMap[ID];
+      }
+
+      TranslatedClusters[ID] = &(ClustersIt->second);
+    }
+
+    for (TranslatedIt  = TranslatedClusters.begin();
+         TranslatedIt != TranslatedClusters.end();
+         ++TranslatedIt)
+    {
+      WindowCluster* Cluster = TranslatedIt->second;
+
+      str.precision(0);
+      str << i+1 << "," << Windows[i].Begin << "," << Windows[i].End;
+      str << ",Cluster " << TranslatedIt->first;
+      str << "," << Cluster->Bursts << "," << Cluster->Duration;
+
+      if (Cluster->MatchDistance < 0)
+      {
+        str << ",-";
+      }
+      else
+      {
+        str.precision(6);
+        str << "," << Cluster->MatchDistance;
+      }
+      str << '\n';
+    }
+  }
+
+  if (str.fail())
+  {
+    SetError(true);
+    SetErrorMessage("error writing time windows information");
+    return false;
+  }
+
+  return true;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/**
+ * Creates the windows, covering from the first burst initial time to the
+ * last burst final time, and distributes the bursts by their initial time
+ */
+bool TimeWindowsClustering::SplitWindows(const vector<CPUBurst*>& Bursts,
+                                         size_t                   WindowsCount,
+                                         timestamp_t              WindowLength)
+{
+  timestamp_t FirstTime = Bursts[0]->GetBeginTime();
+  timestamp_t LastTime  = Bursts[0]->GetEndTime();
+  timestamp_t Span;
+
+  if (WindowsCount == 0 && WindowLength == 0)
+  {
+    SetErrorMessage("either the number of windows or their length is required");
+    return false;
+  }
+
+  for (size_t i = 1; i < Bursts.size(); i++)
+  {
+    if (Bursts[i]->GetBeginTime() < FirstTime)
+      FirstTime = Bursts[i]->GetBeginTime();
+
+    if (Bursts[i]->GetEndTime() > LastTime)
+      LastTime = Bursts[i]->GetEndTime();
+  }
+
+  Span = LastTime - FirstTime + 1;
+
+  if (WindowLength == 0)
+  {
+    WindowLength = (Span + WindowsCount - 1) / WindowsCount;
+  }
+  else
+  {
+    WindowsCount = (Span + WindowLength - 1) / WindowLength;
+  }
+
+  /* Each window needs its own analysis: more windows than bursts would only
+   * produce empty windows */
+  if (WindowsCount > Bursts.size())
+  {
+    ostringstream Message;
+
+    Message << "too many time windows (" << WindowsCount << ") for ";
+    Message << Bursts.size() << " bursts";
+
+    SetErrorMessage(Message.str());
+    return false;
+  }
+
+  Windows.clear();
+  Windows.resize(WindowsCount);
+
+  for (size_t i = 0; i < Windows.size(); i++)
+  {
+    Windows[i].Begin         = FirstTime + i*WindowLength;
+    Windows[i].End           = Windows[i].Begin + WindowLength;
+    Windows[i].NoiseBursts   = 0;
+    Windows[i].NoiseDuration = 0;
+  }
+
+  for (size_t i = 0; i < Bursts.size(); i++)
+  {
+    size_t Window = (Bursts[i]->GetBeginTime() - FirstTime) / WindowLength;
+
+    Windows[Window].Bursts.push_back(i);
+  }
+
+  return true;
+}
+
+/**
+ * Clusters all the windows concurrently. The set up of the clustering
+ * library is not thread safe, so it is done before, and only for the windows
+ * with bursts. Each window is clustered on a single thread: the loops of the
+ * algorithm run inside the windows loop, so they do not start new threads
+ */
+bool TimeWindowsClustering::ClusterWindows(const vector<CPUBurst*>& Bursts)
+{
+  vector<libClustering*> Cores (Windows.size(), (libClustering*) NULL);
+  vector<string>         Errors (Windows.size());
+  bool                   Verbose = system_messages::verbose;
+  bool                   Result  = true;
+
+  phase_scope            Phase ("windows_clustering");
+
+  for (size_t i = 0; i < Windows.size(); i++)
+  {
+    if (Windows[i].Bursts.size() == 0)
+    {
+      continue;
+    }
+
+    Cores[i] = new libClustering();
+
+    if (!Cores[i]->InitClustering(ClusteringAlgorithmName,
+                                  ClusteringAlgorithmParameters))
+    {
+      SetError(true);
+      SetErrorMessage(Cores[i]->GetErrorMessage());
+      Result = false;
+      break;
+    }
+  }
+
+  if (Result)
+  {
+    WindowsClusteringTask Task(Bursts, Windows, Cores, Errors);
+
+    /* The progress of each window is not shown */
+    system_messages::verbose = false;
+    cepba_tools::parallel_for(Task, 0, Windows.size());
+    system_messages::verbose = Verbose;
+  }
+
+  for (size_t i = 0; i < Windows.size(); i++)
+  {
+    if (Result && Errors[i].compare("") != 0)
+    {
+      ostringstream Message;
+
+      Message << "error clustering window " << i+1 << ": " << Errors[i];
+
+      SetError(true);
+      SetErrorMessage(Message.str());
+      Result = false;
+    }
+
+    if (Cores[i] != NULL)
+    {
+      delete Cores[i];
+    }
+  }
+
+  return Result;
+}
+
+/**
+ * Computes the size, duration and centroid of the clusters of a window,
+ * keyed by the IDs of the window analysis
+ */
+void TimeWindowsClustering::ComputeClusters(const vector<CPUBurst*>&          Bursts,
+                                            TimeWindow&                       Window,
+                                            map<cluster_id_t, WindowCluster>& LocalClusters)
+{
+  vector<cluster_id_t>& LocalAssignment = Window.WindowPartition.GetAssignmentVector();
+  map<cluster_id_t, WindowCluster>::iterator ClustersIt;
+
+  for (size_t i = 0; i < LocalAssignment.size(); i++)
+  {
+    CPUBurst* Burst = Bursts[Window.Bursts[i]];
+
+    if (LocalAssignment[i] == NOISE_CLUSTERID)
+    {
+      Window.NoiseBursts++;
+      Window.NoiseDuration += Burst->GetDuration();
+      continue;
+    }
+
+    ClustersIt = LocalClusters.find(LocalAssignment[i]);
+
+    if (ClustersIt == LocalClusters.end())
+    {
+      WindowCluster NewCluster;
+
+      NewCluster.Bursts        = 0;
+      NewCluster.Duration      = 0;
+      NewCluster.MatchDistance = -1;
+      NewCluster.Centroid.assign(Burst->size(), 0.0);
+
+      ClustersIt = LocalClusters.insert(make_pair(LocalAssignment[i], NewCluster)).first;
+    }
+
+    WindowCluster& Cluster = ClustersIt->second;
+
+    Cluster.Bursts++;
+    Cluster.Duration += Burst->GetDuration();
+
+    for (size_t j = 0; j < Cluster.Centroid.size(); j++)
+    {
+      Cluster.Centroid[j] += (*Burst)[j];
+    }
+  }
+
+  for (ClustersIt = LocalClusters.begin(); ClustersIt != LocalClusters.end(); ++ClustersIt)
+  {
+    WindowCluster& Cluster = ClustersIt->second;
+
+    for (size_t j = 0; j < Cluster.Centroid.size(); j++)
+    {
+      Cluster.Centroid[j] /= Cluster.Bursts;
+    }
+  }
+}
+
+/**
+ * Gives global IDs to the clusters of a window. Pairs of clusters from the
+ * previous window and the current one closer than the match distance are
+ * matched from the closest, each cluster at most once. The rest of clusters
+ * receive new global IDs
+ */
+void TimeWindowsClustering::MatchClusters(const TimeWindow*                 Previous,
+                                          map<cluster_id_t, WindowCluster>& LocalClusters,
+                                          TimeWindow&                       Current,
+                                          map<cluster_id_t, cluster_id_t>&  LocalToGlobal,
+                                          cluster_id_t&                     NextGlobalID)
+{
+  vector<pair<double, pair<cluster_id_t, cluster_id_t> > > Candidates;
+  set<cluster_id_t>                                        MatchedGlobals;
+  map<cluster_id_t, WindowCluster>::iterator               LocalIt;
+  map<cluster_id_t, WindowCluster>::const_iterator         PreviousIt;
+
+  if (Previous != NULL)
+  {
+    for (LocalIt = LocalClusters.begin(); LocalIt != LocalClusters.end(); ++LocalIt)
+    {
+      for (PreviousIt  = Previous->Clusters.begin();
+           PreviousIt != Previous->Clusters.end();
+           ++PreviousIt)
+      {
+        const vector<double>& A = LocalIt->second.Centroid;
+        const vector<double>& B = PreviousIt->second.Centroid;
+        double                Distance = 0.0;
+
+        for (size_t j = 0; j < A.size() && j < B.size(); j++)
+        {
+          Distance += (A[j]-B[j])*(A[j]-B[j]);
+        }
+        Distance = sqrt(Distance);
+
+        if (Distance <= MatchDistance)
+        {
+          Candidates.push_back(make_pair(Distance,
+                                         make_pair(LocalIt->first,
+                                                   PreviousIt->first)));
+        }
+      }
+    }
+
+    sort(Candidates.begin(), Candidates.end());
+
+    for (size_t i = 0; i < Candidates.size(); i++)
+    {
+      cluster_id_t LocalID  = Candidates[i].second.first;
+      cluster_id_t GlobalID = Candidates[i].second.second;
+
+      if (LocalToGlobal.count(LocalID) > 0 || MatchedGlobals.count(GlobalID) > 0)
+      {
+        continue;
+      }
+
+      LocalToGlobal[LocalID] = GlobalID;
+      MatchedGlobals.insert(GlobalID);
+
+      LocalClusters[LocalID].MatchDistance = Candidates[i].first;
+    }
+  }
+
+  for (LocalIt = LocalClusters.begin(); LocalIt != LocalClusters.end(); ++LocalIt)
+  {
+    if (LocalToGlobal.count(LocalIt->first) == 0)
+    {
+      LocalToGlobal[LocalIt->first] = NextGlobalID++;
+    }
+
+    Current.Clusters[LocalToGlobal[LocalIt->first]] = LocalIt->second;
+  }
+}
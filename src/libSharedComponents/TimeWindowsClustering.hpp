@@ -0,0 +1,129 @@
+/*****************************************************************************\
+ *                        ANALYSIS PERFORMANCE TOOLS                         *
+ *                             ClusteringSuite                               *
+ *   Infrastructure and tools to apply clustering analysis to Paraver and    *
+ *                              Dimemas traces                               *
+ *                                                                           *
+ *****************************************************************************
+ *     ___     This library is free software; you can redistribute it and/or *
+ *    /  __         modify it under the terms of the GNU LGPL as published   *
+ *   /  /  _____    by the Free Software Foundation; either version 2.1      *
+ *  /  /  /     \   of the License, or (at your option) any later version.   *
+ * (  (  ( B S C )                                                           *
+ *  \  \  \_____/   This library is distributed in hope that it will be      *
+ *   \  \__         useful but WITHOUT ANY WARRANTY; without even the        *
+ *    \___          implied warranty of MERCHANTABILITY or FITNESS FOR A     *
+ *                  PARTICULAR PURPOSE. See the GNU LGPL for more details.   *
+ *                                                                           *
+ * You should have received a copy of the GNU Lesser General Public License  *
+ * along with this library; if not, write to the Free Software Foundation,   *
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA          *
+ * The GNU LEsser General Public License is contained in the file COPYING.   *
+ *                                 ---------                                 *
+ *   Barcelona Supercomputing Center - Centro Nacional de Supercomputacion   *
+\*****************************************************************************/
+
+/* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- *\
+
+  $Id::                                           $:  Id
+  $Rev::                                          $:  Revision of last commit
+  $Author::                                       $:  Author of last commit
+  $Date::                                         $:  Date of last commit
+
+\* -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=- */
+
+#ifndef _TIMEWINDOWSCLUSTERING_HPP_
+#define _TIMEWINDOWSCLUSTERING_HPP_
+
+#include <Error.hpp>
+using cepba_tools::Error;
+
+#include <libClustering.hpp>
+#include "CPUBurst.hpp"
+#include "Partition.hpp"
+
+#include <trace_clustering_types.h>
+
+#include <vector>
+using std::vector;
+
+#include <map>
+using std::map;
+
+#include <ostream>
+using std::ostream;
+
+/* Default maximum distance between the centroids of two clusters of adjacent
+ * windows to consider them the same cluster */
+#define DEFAULT_WINDOWS_MATCH_DISTANCE 0.05
+
+/* Cluster found on a time window, identified by its global ID */
+struct WindowCluster
+{
+  size_t         Bursts;
+  double         Duration;
+  vector<double> Centroid;
+  double         MatchDistance; /* Distance to the cluster of the previous
+                                   window matched, -1 if it is a new one */
+};
+
+struct TimeWindow
+{
+  timestamp_t                      Begin;
+  timestamp_t                      End;
+  vector<size_t>                   Bursts;   /* Positions of its bursts */
+  Partition                        WindowPartition;
+  map<cluster_id_t, WindowCluster> Clusters; /* By global ID */
+  size_t                           NoiseBursts;
+  double                           NoiseDuration;
+};
+
+/* Splits the bursts in time windows (by their initial time) and clusters each
+ * window independently, in parallel. The clusters of adjacent windows are
+ * matched by the distance of their centroids, so a cluster keeps the same
+ * global ID while it is present on consecutive windows */
+class TimeWindowsClustering: public Error
+{
+  private:
+    string              ClusteringAlgorithmName;
+    map<string, string> ClusteringAlgorithmParameters;
+    double              MatchDistance;
+
+    vector<TimeWindow>  Windows;
+
+  public:
+
+    TimeWindowsClustering(string              ClusteringAlgorithmName,
+                          map<string, string> ClusteringAlgorithmParameters,
+                          double              MatchDistance = DEFAULT_WINDOWS_MATCH_DISTANCE);
+
+    bool Run(const vector<CPUBurst*>& Bursts,
+             size_t                   WindowsCount,
+             timestamp_t              WindowLength,
+             Partition&               GlobalPartition);
+
+    size_t GetWindowsCount(void) const { return Windows.size(); };
+
+    bool Flush(ostream&                         str,
+               map<cluster_id_t, cluster_id_t>& TranslationMap);
+
+  private:
+
+    bool SplitWindows(const vector<CPUBurst*>& Bursts,
+                      size_t                   WindowsCount,
+                      timestamp_t              WindowLength);
+
+    bool ClusterWindows(const vector<CPUBurst*>& Bursts);
+
+    void ComputeClusters(const vector<CPUBurst*>&          Bursts,
+                         TimeWindow&                       Window,
+                         map<cluster_id_t, WindowCluster>& LocalClusters);
+
+    void MatchClusters(const TimeWindow*                 Previous,
+                       map<cluster_id_t, WindowCluster>& LocalClusters,
+                       TimeWindow&                       Current,
+                       map<cluster_id_t, cluster_id_t>&  LocalToGlobal,
+                       cluster_id_t&                     NextGlobalID);
+};
+
+#endif // _TIMEWINDOWSCLUSTERING_HPP_
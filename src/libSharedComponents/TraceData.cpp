@@ -39,6 +39,10 @@ using cepba_tools::system_messages;
 
 #include <Utilities.hpp>
 
+#include <ParallelFor.hpp>
+using cepba_tools::parallel_for;
+using cepba_tools::parallel_threads;
+
 #include <ParametersManager.hpp>
 
 #include "TraceData.hpp"
@@ -60,6 +64,7 @@ using std::make_pair;
 
 #include <cmath>
 #include <cstdlib>
+#include <ctime>
 
 #ifdef HAVE_MPI
 #include <mpi.h>
@@ -94,6 +99,9 @@ TraceData::TraceData(void)
 {
   ClusteringConfiguration *Configuration;
 
+  Storage     = NULL;
+  BurstsArena = NULL;
+
   /* Get Configuration Manager */
   Configuration = ClusteringConfiguration::GetInstance();
   if (!Configuration->IsInitialized())
@@ -139,6 +147,14 @@ TraceData::TraceData(void)
 
   SumValues    = vector<double>(ClusteringDimensions, 0);
 
+  ExtrapolationDimensions = Parameters->GetExtrapolationParametersSize();
+
+  Storage = new BurstsStorage(ClusteringDimensions, ExtrapolationDimensions);
+
+  /* Bursts never own memory (their data lives in 'Storage'), so the arena
+   * can be released without running their destructors */
+  BurstsArena = new ObjectsArena<CPUBurst>(false);
+
   /* NO distribution defaults */
   ReadAllTasks = true;
   Master       = false;
@@ -146,6 +162,36 @@ TraceData::TraceData(void)
   /* NO sampling by default */
   SampleData    = false;
   NumberOfTasks = 0;
+
+  Spill               = NULL;
+  StreamingMaxSamples = 0;
+  StreamingFinished   = false;
+  StreamedBursts      = 0;
+
+  StreamedBurstsNormalized = false;
+}
+
+/****************************************************************************
+ * Destructor                                                               *
+ ***************************************************************************/
+
+TraceData::~TraceData(void)
+{
+  if (Spill != NULL)
+  {
+    delete Spill;
+  }
+
+  /* Both the burst objects and their data are released block by block */
+  if (BurstsArena != NULL)
+  {
+    delete BurstsArena;
+  }
+
+  if (Storage != NULL)
+  {
+    delete Storage;
+  }
 }
 
 
@@ -403,32 +449,61 @@ bool TraceData::NewBurst(instance_t           Instance,
 {
   CPUBurst *Burst;
 
+  if (!Master && !ReadThisTask(TaskId))
+  { /* Burst not stored: just consume its instance number */
+    if (Instance == std::numeric_limits<instance_t>::max())
+    {
+      Point::InstanceNumber++;
+    }
+
+    return true;
+  }
+
+  if (Spill != NULL)
+  {
+    return StreamBurst(Instance,
+                       TaskId,
+                       ThreadId,
+                       Line,
+                       BeginTime,
+                       EndTime,
+                       BurstDuration,
+                       ClusteringRawData,
+                       ClusteringProcessedData,
+                       ExtrapolationData,
+                       BurstType);
+  }
+
   if (Instance == std::numeric_limits<instance_t>::max())
   {
-    Burst = new CPUBurst (TaskId,
-                          ThreadId,
-                          Line,
-                          BeginTime,
-                          EndTime,
-                          BurstDuration,
-                          ClusteringRawData,
-                          ClusteringProcessedData,
-                          ExtrapolationData,
-                          BurstType);
+    Burst = new (BurstsArena->Allocate())
+      CPUBurst (TaskId,
+                ThreadId,
+                Line,
+                BeginTime,
+                EndTime,
+                BurstDuration,
+                ClusteringRawData,
+                ClusteringProcessedData,
+                ExtrapolationData,
+                BurstType,
+                Storage);
   }
   else
   {
-    Burst = new CPUBurst (Instance,
-                          TaskId,
-                          ThreadId,
-                          Line,
-                          BeginTime,
-                          EndTime,
-                          BurstDuration,
-                          ClusteringRawData,
-                          ClusteringProcessedData,
-                          ExtrapolationData,
-                          BurstType);
+    Burst = new (BurstsArena->Allocate())
+      CPUBurst (Instance,
+                TaskId,
+                ThreadId,
+                Line,
+                BeginTime,
+                EndTime,
+                BurstDuration,
+                ClusteringRawData,
+                ClusteringProcessedData,
+                ExtrapolationData,
+                BurstType,
+                Storage);
   }
 
   /* DEBUG
@@ -489,22 +564,7 @@ bool TraceData::NewBurst(instance_t           Instance,
     {
       ClusteringBursts.push_back(Burst);
 
-      for (size_t i = 0; i < ClusteringDimensions; i++)
-      {
-        if (ClusteringProcessedData[i] > MaxValues[i])
-        {
-          MaxValues[i]    = ClusteringProcessedData[i];
-          MaxInstances[i] = Burst->GetInstance();
-        }
-
-        if (ClusteringProcessedData[i] < MinValues[i])
-        {
-          MinValues[i]    = ClusteringProcessedData[i];
-          MinInstances[i] = Burst->GetInstance();
-        }
-
-        SumValues[i] += ClusteringProcessedData[i];
-      }
+      UpdateRanges(ClusteringProcessedData, Burst->GetInstance());
     }
 
     if (Master)
@@ -513,11 +573,6 @@ bool TraceData::NewBurst(instance_t           Instance,
     }
   }
 
-  if (!Master && !ReadThisTask(TaskId))
-  {
-    delete Burst;
-  }
-
   return true;
 }
 
@@ -527,6 +582,11 @@ bool TraceData::NewBurst(instance_t           Instance,
  ***************************************************************************/
 bool TraceData::DataExtractionFinished(void)
 {
+  if (!FinishStreamingSampling())
+  {
+    return false;
+  }
+
 #ifdef HAVE_SQLITE3
 
   if (!AllBurstsDB.CommitInserts())
@@ -558,6 +618,11 @@ bool TraceData::Sampling(size_t MaxSamples)
 {
   vector< vector<CPUBurst*> > BurstsPerTask (NumberOfTasks, vector<CPUBurst*>());
 
+  if (Spill != NULL)
+  { /* The sample was selected during the extraction */
+    return FinishStreamingSampling();
+  }
+
   /* DEBUG
   cout << "CompleteBursts.size() = " << CompleteBursts.size() << endl;
   */
@@ -628,6 +693,49 @@ bool TraceData::Sampling(size_t MaxSamples)
   return true;
 }
 
+/**
+ * Enables the sampling while the bursts are extracted. Each task keeps a
+ * reservoir of, at most, MaxSamples/Tasks complete bursts, so only the sample
+ * stays in memory. All the bursts are written to a spill file, to be read
+ * back when classifying the data and generating the outputs. Must be called
+ * before the data extraction
+ * \param MaxSamples    Maximum number of bursts to be sampled
+ * \param SpillFileName File where the extracted bursts are written
+ * \result True if the spill file was correctly created, false otherwise
+ */
+bool TraceData::SetStreamingSampling(size_t MaxSamples, string SpillFileName)
+{
+  if (AllBursts.size() > 0 || Spill != NULL)
+  {
+    SetError(true);
+    SetErrorMessage("streaming sampling must be set before the data extraction");
+    return false;
+  }
+
+  Spill = new BurstsSpill(SpillFileName,
+                          ClusteringDimensions,
+                          ExtrapolationDimensions);
+
+  if (Spill->GetError())
+  {
+    SetError(true);
+    SetErrorMessage(Spill->GetLastError());
+    delete Spill;
+    Spill = NULL;
+    return false;
+  }
+
+  StreamingMaxSamples = MaxSamples;
+  StreamingFinished   = false;
+  StreamedBursts      = 0;
+
+  SamplingState[0] = (unsigned short) time(NULL);
+  SamplingState[1] = (unsigned short) (time(NULL) >> 16);
+  SamplingState[2] = 0x330E;
+
+  return true;
+}
+
 /* This method avoids to call the normalization using the
  * internal ranges */
 bool TraceData::Normalize(void)
@@ -652,6 +760,246 @@ bool TraceData::Normalize(vector<double>& MinValues,
   return ActualNormalize();
 }
 
+/******************************************************************************
+ * Column-wise kernels
+ *
+ * The transformations of the data are applied over segments of consecutive
+ * rows of the bursts storage, so each dimension is a contiguous array the
+ * compiler can vectorize. Segments are distributed across threads with
+ * 'parallel_for', and the reductions are accumulated per thread and merged
+ * afterwards.
+ *****************************************************************************/
+
+typedef BurstsStorage::RowsSegment RowsSegment;
+
+class NormalizationKernel
+{
+  private:
+    const vector<RowsSegment>& Segments;
+    const vector<double>&      MaxValues;
+    const vector<double>&      MinValues;
+    const vector<double>&      Factors;
+
+  public:
+    NormalizationKernel(const vector<RowsSegment>& Segments,
+                        const vector<double>&      MaxValues,
+                        const vector<double>&      MinValues,
+                        const vector<double>&      Factors)
+    : Segments(Segments), MaxValues(MaxValues), MinValues(MinValues),
+      Factors(Factors) {};
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        for (size_t d = 0; d < MinValues.size(); d++)
+        {
+          double*      Column = Segments[i].First + d*Segments[i].Stride;
+          const size_t Rows   = Segments[i].Rows;
+          const double Min    = MinValues[d];
+          const double Range  = MaxValues[d] - MinValues[d];
+          const double Factor = Factors[d];
+
+          for (size_t r = 0; r < Rows; r++)
+          {
+            Column[r] = Factor*((Column[r] - Min) / Range);
+          }
+        }
+      }
+    }
+};
+
+/* Sum of the values (or of the squared differences to 'Mean', if given) */
+class ColumnsSumKernel
+{
+  private:
+    const vector<RowsSegment>& Segments;
+    const vector<double>*      Mean;
+
+  public:
+    vector<vector<double> >    Sums; /* One per thread */
+
+    ColumnsSumKernel(const vector<RowsSegment>& Segments,
+                     size_t                     Dimensions,
+                     const vector<double>*      Mean = NULL)
+    : Segments(Segments), Mean(Mean),
+      Sums(parallel_threads(), vector<double> (Dimensions, 0.0)) {};
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      vector<double>& Sum = Sums[Thread];
+
+      for (size_t i = Begin; i < End; i++)
+      {
+        for (size_t d = 0; d < Sum.size(); d++)
+        {
+          const double* Column = Segments[i].First + d*Segments[i].Stride;
+          const size_t  Rows   = Segments[i].Rows;
+          double        Acc    = 0.0;
+
+          if (Mean == NULL)
+          {
+            for (size_t r = 0; r < Rows; r++)
+            {
+              Acc += Column[r];
+            }
+          }
+          else
+          {
+            const double M = (*Mean)[d];
+
+            for (size_t r = 0; r < Rows; r++)
+            {
+              Acc += (Column[r] - M)*(Column[r] - M);
+            }
+          }
+
+          Sum[d] += Acc;
+        }
+      }
+    }
+
+    vector<double> Merge(void) const
+    {
+      vector<double> Result = Sums[0];
+
+      for (size_t t = 1; t < Sums.size(); t++)
+      {
+        for (size_t d = 0; d < Result.size(); d++)
+        {
+          Result[d] += Sums[t][d];
+        }
+      }
+
+      return Result;
+    }
+};
+
+class ScaleKernel
+{
+  private:
+    const vector<RowsSegment>& Segments;
+    const vector<double>&      Mean;
+    const vector<double>&      RMS;
+
+  public:
+    ScaleKernel(const vector<RowsSegment>& Segments,
+                const vector<double>&      Mean,
+                const vector<double>&      RMS)
+    : Segments(Segments), Mean(Mean), RMS(RMS) {};
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        for (size_t d = 0; d < Mean.size(); d++)
+        {
+          double*      Column = Segments[i].First + d*Segments[i].Stride;
+          const size_t Rows   = Segments[i].Rows;
+          const double M      = Mean[d];
+          const double R      = RMS[d];
+
+          for (size_t r = 0; r < Rows; r++)
+          {
+            Column[r] = (Column[r] - M)/R;
+          }
+        }
+      }
+    }
+};
+
+/* Processed dimension = raw dimension - average. Raw columns follow the
+ * processed ones on the storage rows */
+class MeanAdjustKernel
+{
+  private:
+    const vector<RowsSegment>& Segments;
+    const vector<double>&      Average;
+    size_t                     RawOffset;
+
+  public:
+    MeanAdjustKernel(const vector<RowsSegment>& Segments,
+                     const vector<double>&      Average,
+                     size_t                     RawOffset)
+    : Segments(Segments), Average(Average), RawOffset(RawOffset) {};
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      for (size_t i = Begin; i < End; i++)
+      {
+        for (size_t d = 0; d < Average.size(); d++)
+        {
+          double*       Column    = Segments[i].First + d*Segments[i].Stride;
+          const double* RawColumn = Segments[i].First + (RawOffset+d)*Segments[i].Stride;
+          const size_t  Rows      = Segments[i].Rows;
+          const double  A         = Average[d];
+
+          for (size_t r = 0; r < Rows; r++)
+          {
+            Column[r] = RawColumn[r] - A;
+          }
+        }
+      }
+    }
+};
+
+/* New dimension i = sum_j (dimension j * Matrix[i][j]), computed on a per
+ * thread buffer as all the input columns are needed for each output */
+class BaseChangeKernel
+{
+  private:
+    const vector<RowsSegment>&       Segments;
+    const vector< vector<double> >&  Matrix;
+    vector< vector<double> >         Buffers; /* One per thread */
+
+  public:
+    BaseChangeKernel(const vector<RowsSegment>&      Segments,
+                     const vector< vector<double> >& Matrix)
+    : Segments(Segments), Matrix(Matrix),
+      Buffers(parallel_threads(), vector<double>()) {};
+
+    void operator()(size_t Begin, size_t End, unsigned int Thread)
+    {
+      vector<double>& Buffer = Buffers[Thread];
+
+      for (size_t i = Begin; i < End; i++)
+      {
+        const size_t Rows   = Segments[i].Rows;
+        const UINT32 Stride = Segments[i].Stride;
+        double*      First  = Segments[i].First;
+
+        Buffer.assign(Matrix.size()*Rows, 0.0);
+
+        for (size_t o = 0; o < Matrix.size(); o++)
+        {
+          double* Output = &Buffer[o*Rows];
+
+          for (size_t d = 0; d < Matrix[o].size(); d++)
+          {
+            const double* Column = First + d*Stride;
+            const double  M      = Matrix[o][d];
+
+            for (size_t r = 0; r < Rows; r++)
+            {
+              Output[r] += Column[r]*M;
+            }
+          }
+        }
+
+        for (size_t o = 0; o < Matrix.size(); o++)
+        {
+          double*       Column = First + o*Stride;
+          const double* Output = &Buffer[o*Rows];
+
+          for (size_t r = 0; r < Rows; r++)
+          {
+            Column[r] = Output[r];
+          }
+        }
+      }
+    }
+};
+
 bool TraceData::ActualNormalize(void)
 {
   bool EmptyRanges = true;
@@ -708,51 +1056,22 @@ bool TraceData::ActualNormalize(void)
   */
 
 
-  if (Master)
-  {
-    for (DataIterator  = CompleteBursts.begin();
-         DataIterator != CompleteBursts.end();
-         DataIterator++)
-    {
-      if (!(*DataIterator)->IsNormalized())
-      {
-        (*DataIterator)->RangeNormalization(MaxValues, MinValues, Factors);
-      }
-    }
+  if (Spill != NULL)
+  { /* Bursts read back from the spill are normalized on load */
+    NormalizeBursts(ClusteringBursts, Factors);
+    Spill->SetNormalization(MaxValues, MinValues, Factors);
   }
-  else
+  else if (Master)
   {
-    for (DataIterator  = ClusteringBursts.begin();
-         DataIterator != ClusteringBursts.end();
-         DataIterator++)
-    {
-      if (!(*DataIterator)->IsNormalized())
-      {
-        (*DataIterator)->RangeNormalization(MaxValues, MinValues, Factors);
-      }
-    }
+    NormalizeBursts(CompleteBursts, Factors);
   }
-  /*
-  for (DataIterator  = CompleteBursts.begin();
-       DataIterator != CompleteBursts.end();
-       DataIterator++)
-  {
-    if (!(*DataIterator)->IsNormalized())
-    {
-      (*DataIterator)->RangeNormalization(MaxValues, MinValues, Factors);
-    }
-  }
-  */
-  for (DataIterator  = FilteredBursts.begin();
-       DataIterator != FilteredBursts.end();
-       DataIterator++)
+  else
   {
-    if (!(*DataIterator)->IsNormalized())
-    {
-      (*DataIterator)->RangeNormalization(MaxValues, MinValues, Factors);
-    }
+    NormalizeBursts(ClusteringBursts, Factors);
   }
 
+  NormalizeBursts(FilteredBursts, Factors);
+
   Normalized = true;
 
   return true;
@@ -930,30 +1249,54 @@ bool TraceData::ActualNormalize(void)
 
 }
 
+void TraceData::NormalizeBursts(vector<CPUBurst*>& Bursts,
+                                vector<double>&    Factors)
+{
+  vector<RowsSegment> Segments;
+  vector<CPUBurst*>   OtherBursts;
+
+  GetRowsSegments(Bursts, true, Segments, OtherBursts);
+
+  NormalizationKernel Kernel (Segments, MaxValues, MinValues, Factors);
+  parallel_for(Kernel, 0, Segments.size());
+
+  for (size_t i = 0; i < OtherBursts.size(); i++)
+  {
+    OtherBursts[i]->RangeNormalization(MaxValues, MinValues, Factors);
+  }
+
+  for (size_t i = 0; i < Bursts.size(); i++)
+  {
+    Bursts[i]->SetNormalized(true);
+  }
+}
+
 void TraceData::ScalePoints(void)
 {
-  TraceData::iterator DataIterator;
+  vector<RowsSegment> Segments;
+  vector<CPUBurst*>   OtherBursts;
 
   vector<double> Mean          (ClusteringDimensions);
   vector<double> SumDiffSquare (ClusteringDimensions);
   vector<double> RMS           (ClusteringDimensions);
 
+  GetRowsSegments(ClusteringBursts, false, Segments, OtherBursts);
+
   for (INT32 i = 0; i < Mean.size(); i++)
   {
-    Mean[i]          = SumValues[i]/ClusteringBursts.size();
-    SumDiffSquare[i] = 0.0;
-    RMS[i]           = 0.0;
+    Mean[i] = SumValues[i]/ClusteringBursts.size();
   }
 
   /* Compute the Root-Mean-Square */
-  for (DataIterator  = ClusteringBursts.begin();
-       DataIterator != ClusteringBursts.end();
-       DataIterator++)
+  ColumnsSumKernel SumKernel (Segments, ClusteringDimensions, &Mean);
+  parallel_for(SumKernel, 0, Segments.size());
+  SumDiffSquare = SumKernel.Merge();
+
+  for (size_t i = 0; i < OtherBursts.size(); i++)
   {
-    for (INT32 i = 0; i < ClusteringDimensions; i++)
+    for (INT32 j = 0; j < ClusteringDimensions; j++)
     {
-      SumDiffSquare[i] +=
-        pow((*(*DataIterator))[i] - Mean[i],2.0);
+      SumDiffSquare[j] += pow((*OtherBursts[i])[j] - Mean[j], 2.0);
     }
   }
 
@@ -963,31 +1306,32 @@ void TraceData::ScalePoints(void)
   }
 
   /* Scale the points */
-  for (DataIterator  = ClusteringBursts.begin();
-       DataIterator != ClusteringBursts.end();
-       DataIterator++)
+  ScaleKernel Kernel (Segments, Mean, RMS);
+  parallel_for(Kernel, 0, Segments.size());
+
+  for (size_t i = 0; i < OtherBursts.size(); i++)
   {
-    (*DataIterator)->Scale(Mean, RMS);
+    OtherBursts[i]->Scale(Mean, RMS);
   }
 }
 
 void TraceData::MeanAdjust(void)
 {
-  TraceData::iterator DataIterator;
-  vector<double> DimensionsAverage (ClusteringDimensions);
+  vector<RowsSegment> Segments;
+  vector<CPUBurst*>   OtherBursts;
+  vector<double>      DimensionsAverage;
 
-  for (INT32 i = 0; i < ClusteringDimensions; i++)
-  {
-    DimensionsAverage[i] = 0.0;
-  }
+  GetRowsSegments(ClusteringBursts, false, Segments, OtherBursts);
+
+  ColumnsSumKernel SumKernel (Segments, ClusteringDimensions);
+  parallel_for(SumKernel, 0, Segments.size());
+  DimensionsAverage = SumKernel.Merge();
 
-  for (DataIterator  = ClusteringBursts.begin();
-       DataIterator != ClusteringBursts.end();
-       DataIterator++)
+  for (size_t i = 0; i < OtherBursts.size(); i++)
   {
-    for (INT32 i = 0; i < ClusteringDimensions; i++)
+    for (INT32 j = 0; j < ClusteringDimensions; j++)
     {
-      DimensionsAverage[i] += (*(*DataIterator))[i];
+      DimensionsAverage[j] += (*OtherBursts[i])[j];
     }
   }
 
@@ -996,31 +1340,134 @@ void TraceData::MeanAdjust(void)
     DimensionsAverage[i] = DimensionsAverage[i]/ClusteringBursts.size();
   }
 
-  for (DataIterator  = ClusteringBursts.begin();
-       DataIterator != ClusteringBursts.end();
-       DataIterator++)
+  if (Segments.size() > 0)
   {
-    (*DataIterator)->MeanAdjust(DimensionsAverage);
+    MeanAdjustKernel Kernel (Segments,
+                             DimensionsAverage,
+                             Storage->GetClusteringDimensions());
+    parallel_for(Kernel, 0, Segments.size());
+  }
+
+  for (size_t i = 0; i < OtherBursts.size(); i++)
+  {
+    OtherBursts[i]->MeanAdjust(DimensionsAverage);
   }
 }
 
 void TraceData::BaseChange(vector< vector<double> >& BaseChangeMatrix)
 {
-  TraceData::iterator DataIterator;
+  vector<RowsSegment> Segments;
+  vector<CPUBurst*>   OtherBursts;
 
   /* TEST */
   cout << "Changing base of data set" << endl;
 
-  for (DataIterator  = ClusteringBursts.begin();
-       DataIterator != ClusteringBursts.end();
-       DataIterator++)
+  GetRowsSegments(ClusteringBursts, false, Segments, OtherBursts);
+
+  /* The same matrix applies to all the bursts of the storage */
+  if (BaseChangeMatrix.size() > ClusteringDimensions)
   {
-    (*DataIterator)->BaseChange(BaseChangeMatrix);
+    Segments.clear();
+  }
+
+  for (size_t i = 0; i < BaseChangeMatrix.size(); i++)
+  {
+    if (BaseChangeMatrix[i].size() != ClusteringDimensions)
+    {
+      /* DEBUG */
+      cout << "ERROR!: BaseChangeMatrix.size = " << BaseChangeMatrix[i].size();
+      cout << " NormalizedDimensions.size = " << ClusteringDimensions << endl;
+      Segments.clear();
+      break;
+    }
+  }
+
+  if (Segments.size() > 0)
+  {
+    BaseChangeKernel Kernel (Segments, BaseChangeMatrix);
+    parallel_for(Kernel, 0, Segments.size());
+
+    for (size_t i = 0; i < ClusteringBursts.size(); i++)
+    {
+      CPUBurst* Burst = ClusteringBursts[i];
+
+      if (Burst->GetStride() > 1                               &&
+          Burst->size() == ClusteringDimensions                &&
+          Burst->GetRawDimensionsCount() == ClusteringDimensions)
+      {
+        Burst->SetDimensionsCount(BaseChangeMatrix.size());
+      }
+    }
+  }
+
+  for (size_t i = 0; i < OtherBursts.size(); i++)
+  {
+    OtherBursts[i]->BaseChange(BaseChangeMatrix);
+  }
+}
+
+/**
+ * Groups the bursts that are consecutive rows of the storage blocks in
+ * segments, to be processed column-wise. Bursts with a private row (or
+ * with a different number of dimensions) are returned apart
+ * \param Bursts            Bursts to group
+ * \param NotNormalizedOnly Skip the bursts already normalized
+ * \param Segments          Output vector of segments
+ * \param OtherBursts       Output vector of bursts not in any segment
+ */
+void TraceData::GetRowsSegments(const vector<CPUBurst*>& Bursts,
+                                bool                     NotNormalizedOnly,
+                                vector<RowsSegment>&     Segments,
+                                vector<CPUBurst*>&       OtherBursts)
+{
+  for (size_t i = 0; i < Bursts.size(); i++)
+  {
+    CPUBurst* Burst = Bursts[i];
+    double*   First;
+
+    if (NotNormalizedOnly && Burst->IsNormalized())
+    {
+      continue;
+    }
+
+    /* Rows of the blocks have a stride greater than one */
+    if (Burst->GetStride() <= 1                        ||
+        Burst->size() != ClusteringDimensions          ||
+        Burst->GetRawDimensionsCount() != ClusteringDimensions)
+    {
+      OtherBursts.push_back(Burst);
+      continue;
+    }
+
+    First = Burst->GetDimensionsData();
+
+    if (Segments.size() > 0                                        &&
+        Segments.back().Stride == Burst->GetStride()               &&
+        Segments.back().First + Segments.back().Rows == First      &&
+        Segments.back().Rows < BurstsStorage::MAX_SEGMENT_ROWS)
+    {
+      Segments.back().Rows++;
+    }
+    else
+    {
+      RowsSegment NewSegment;
+
+      NewSegment.First  = First;
+      NewSegment.Stride = Burst->GetStride();
+      NewSegment.Rows   = 1;
+
+      Segments.push_back(NewSegment);
+    }
   }
 }
 
 size_t TraceData::GetAllBurstsSize(void) const
 {
+  if (Spill != NULL)
+  {
+    return Spill->AllBurstsSize();
+  }
+
 #ifdef HAVE_SQLITE3
   return AllBurstsDB.AllBurstsSize();
 #else
@@ -1030,6 +1477,11 @@ size_t TraceData::GetAllBurstsSize(void) const
 
 size_t TraceData::GetCompleteBurstsSize(void) const
 {
+  if (Spill != NULL)
+  {
+    return Spill->CompleteBurstsSize();
+  }
+
 #ifdef HAVE_SQLITE3
   return AllBurstsDB.CompleteBurstsSize();
 #else
@@ -1123,6 +1575,27 @@ bool TraceData::FlushPoints(ostream&             str,
     {
       /* DEBUG
       cout << "Printing Complete Bursts" << endl; */
+      if (Spill != NULL)
+      {
+        if (Cluster_IDs.size() != Spill->CompleteBurstsSize())
+        {
+          ostringstream Message;
+          Message << "number of IDs (" << Cluster_IDs.size() << ") ";
+          Message << "different from number of complete bursts (";
+          Message << Spill->CompleteBurstsSize() << ")";
+
+          SetErrorMessage(Message.str());
+          SetError(true);
+          return false;
+        }
+
+        return GenericFlushPoints(str,
+                                  Spill->complete_bursts_begin(),
+                                  Spill->complete_bursts_end(),
+                                  Spill->CompleteBurstsSize(),
+                                  Cluster_IDs);
+      }
+
 #ifdef HAVE_SQLITE3
       if (Cluster_IDs.size() != AllBurstsDB.CompleteBurstsSize())
       {
@@ -1170,6 +1643,26 @@ bool TraceData::FlushPoints(ostream&             str,
     {
       /* DEBUG
       cout << "Printint All Bursts" << endl; */
+      if (Spill != NULL)
+      {
+        if (!Unclassified && (Cluster_IDs.size() != Spill->CompleteBurstsSize()))
+        {
+          ostringstream Message;
+          Message << "number of IDs (" << Cluster_IDs.size() << ") ";
+          Message << "different from number of bursts (";
+          Message << Spill->CompleteBurstsSize() << ")";
+
+          SetErrorMessage(Message.str());
+          SetError(true);
+          return false;
+        }
+
+        return GenericFlushPoints(str,
+                                  Spill->all_bursts_begin(),
+                                  Spill->all_bursts_end(),
+                                  Spill->AllBurstsSize(),
+                                  Cluster_IDs);
+      }
 
 #ifdef HAVE_SQLITE3
       if (Cluster_IDs.size() != AllBurstsDB.AllBurstsSize())
@@ -1253,6 +1746,30 @@ TraceData::PrintTraceDataInformation(void)
   cerr << "Clustering Points Size = " << ClusteringBursts.size() << endl;
   cerr << "Filtered Points Size   = " << FilteredBursts.size() << endl;
 
+  if (AllBursts.size() > 0)
+  {
+    cerr << "Bursts Memory          = " << GetBurstsMemoryFootprint() << " bytes (";
+    cerr << GetBurstsMemoryFootprint()/AllBursts.size() << " bytes/burst)" << endl;
+  }
+
+}
+
+/**
+ * Computes the memory used by the bursts: the objects, the columnar storage
+ * and the containers that reference them
+ * \result Total number of bytes
+ */
+size_t TraceData::GetBurstsMemoryFootprint(void) const
+{
+  size_t Result;
+
+  Result  = BurstsArena->GetAllocatedBytes();
+  Result += Storage->GetAllocatedBytes();
+  Result += sizeof(CPUBurst*)*(AllBursts.capacity()      +
+                               CompleteBursts.capacity() +
+                               ClusteringBursts.capacity());
+
+  return Result;
 }
 
 /*****************************************************************************
@@ -1296,6 +1813,312 @@ bool TraceData::SampleSingleTask(vector<CPUBurst*>& TaskBursts,
   return true;
 }
 
+/**
+ * Streaming version of the burst storage: the burst is written to the spill
+ * and, if complete, offered to a reservoir of the whole trace (Vitter's
+ * algorithm R). A burst evicted from the reservoir gives its slot and
+ * storage row to the new one
+ */
+bool TraceData::StreamBurst(instance_t           Instance,
+                            task_id_t            TaskId,
+                            thread_id_t          ThreadId,
+                            line_t               Line,
+                            timestamp_t          BeginTime,
+                            timestamp_t          EndTime,
+                            duration_t           BurstDuration,
+                            vector<double>      &ClusteringRawData,
+                            vector<double>      &ClusteringProcessedData,
+                            map<size_t, double> &ExtrapolationData,
+                            burst_type_t         BurstType)
+{
+  bool   InstanceFromTrace = false;
+  size_t Stratum;
+  void*  Slot = NULL;
+
+  if (Instance == std::numeric_limits<instance_t>::max())
+  {
+    Instance          = Point::InstanceNumber++;
+    InstanceFromTrace = true;
+  }
+
+  /* Bursts coming from the trace have not been normalized yet */
+  StreamedBurstsNormalized = !InstanceFromTrace;
+
+  if (!Spill->NewBurst(Instance,
+                       TaskId,
+                       ThreadId,
+                       Line,
+                       BeginTime,
+                       EndTime,
+                       BurstDuration,
+                       ClusteringRawData,
+                       ClusteringProcessedData,
+                       ExtrapolationData,
+                       BurstType))
+  {
+    SetError(true);
+    SetErrorMessage(Spill->GetLastError());
+    return false;
+  }
+
+  if (BurstType != CompleteBurst)
+  {
+    return true;
+  }
+
+  UpdateRanges(ClusteringProcessedData, Instance);
+
+  /* The bursts per task give the proportional sizes of the final sample */
+  Stratum = SamplingStratum(TaskId);
+
+  if (Stratum >= StratumBursts.size())
+  {
+    StratumBursts.resize(Stratum+1, 0);
+  }
+
+  StratumBursts[Stratum]++;
+  StreamedBursts++;
+
+  if (Reservoir.size() < StreamingMaxSamples)
+  {
+    Slot = BurstsArena->Allocate();
+    Reservoir.push_back(NULL);
+  }
+  else
+  {
+    size_t Position = (size_t) (erand48(SamplingState) * StreamedBursts);
+
+    if (Position >= StreamingMaxSamples)
+    {
+      return true;
+    }
+
+    DiscardBurst(Reservoir[Position]);
+    Slot = DiscardedBursts.back();
+    DiscardedBursts.pop_back();
+
+    std::swap(Reservoir[Position], Reservoir.back());
+    Reservoir.back() = NULL;
+  }
+
+  Reservoir.back() = new (Slot)
+    CPUBurst (Instance,
+              TaskId,
+              ThreadId,
+              Line,
+              BeginTime,
+              EndTime,
+              BurstDuration,
+              ClusteringRawData,
+              ClusteringProcessedData,
+              ExtrapolationData,
+              BurstType,
+              Storage);
+
+  Reservoir.back()->SetNormalized(StreamedBurstsNormalized);
+
+  return true;
+}
+
+/**
+ * Closes the streaming sampling: the reservoir is reduced to the sizes a
+ * proportional stratified sampling would select per task, and its bursts
+ * become the clustering bursts. When the whole trace fits in the sample,
+ * the complete bursts are read back from the spill
+ */
+bool TraceData::FinishStreamingSampling(void)
+{
+  size_t TotalBursts;
+
+  if (Spill == NULL || StreamingFinished)
+  {
+    return true;
+  }
+
+  StreamingFinished = true;
+
+  if (!Spill->EndWrites())
+  {
+    SetError(true);
+    SetErrorMessage(Spill->GetLastError());
+    return false;
+  }
+
+  TotalBursts = Spill->CompleteBurstsSize();
+  ClusteringBursts.clear();
+
+  if (TotalBursts <= StreamingMaxSamples)
+  { /* No Sampling Needed! */
+    vector<CPUBurst*> Chunk;
+
+    SampleData = false;
+
+    for (size_t i = 0; i < Reservoir.size(); i++)
+    {
+      DiscardBurst(Reservoir[i]);
+    }
+
+    for (size_t First = 0; First < TotalBursts; First += Chunk.size())
+    {
+      if (!Spill->ReadBursts(true, First, Chunk) || Chunk.size() == 0)
+      {
+        SetError(true);
+        SetErrorMessage(Spill->GetLastError());
+        return false;
+      }
+
+      for (size_t i = 0; i < Chunk.size(); i++)
+      {
+        vector<double>      RawData       = Chunk[i]->GetRawDimensions();
+        vector<double>      ProcessedData;
+        map<size_t, double> ExtrapolationData = Chunk[i]->GetExtrapolationDimensions();
+        void*               Slot;
+
+        for (size_t d = 0; d < Chunk[i]->size(); d++)
+        {
+          ProcessedData.push_back((*Chunk[i])[d]);
+        }
+
+        if (DiscardedBursts.size() > 0)
+        {
+          Slot = DiscardedBursts.back();
+          DiscardedBursts.pop_back();
+        }
+        else
+        {
+          Slot = BurstsArena->Allocate();
+        }
+
+        CPUBurst* Burst = new (Slot)
+          CPUBurst (Chunk[i]->GetInstance(),
+                    Chunk[i]->GetTaskId(),
+                    Chunk[i]->GetThreadId(),
+                    Chunk[i]->GetLine(),
+                    Chunk[i]->GetBeginTime(),
+                    Chunk[i]->GetEndTime(),
+                    Chunk[i]->GetDuration(),
+                    RawData,
+                    ProcessedData,
+                    ExtrapolationData,
+                    CompleteBurst,
+                    Storage);
+
+        Burst->SetNormalized(StreamedBurstsNormalized);
+        ClusteringBursts.push_back(Burst);
+      }
+    }
+  }
+  else
+  {
+    vector<size_t>    TaskSampleSize (StratumBursts.size());
+    vector<size_t>    Taken (StratumBursts.size(), 0);
+    vector<CPUBurst*> Surplus;
+    size_t            Missing = 0;
+
+    SampleData = true;
+
+    for (size_t i = 0; i < StratumBursts.size(); i++)
+    {
+      TaskSampleSize[i] = (size_t) std::floor((StratumBursts[i]*StreamingMaxSamples)/TotalBursts);
+    }
+
+    /* Shuffle the reservoir, so the bursts taken of each task are a random
+     * subset of the ones it holds */
+    for (size_t i = 0; i + 1 < Reservoir.size(); i++)
+    {
+      size_t Selected = i + (size_t) (erand48(SamplingState) * (Reservoir.size()-i));
+      std::swap(Reservoir[i], Reservoir[Selected]);
+    }
+
+    for (size_t i = 0; i < Reservoir.size(); i++)
+    {
+      size_t Stratum = SamplingStratum(Reservoir[i]->GetTaskId());
+
+      if (Taken[Stratum] < TaskSampleSize[Stratum])
+      {
+        ClusteringBursts.push_back(Reservoir[i]);
+        Taken[Stratum]++;
+      }
+      else
+      {
+        Surplus.push_back(Reservoir[i]);
+      }
+    }
+
+    /* Tasks with fewer bursts in the reservoir than their share are completed
+     * with the surplus of the others, keeping the sample size */
+    for (size_t i = 0; i < StratumBursts.size(); i++)
+    {
+      Missing += TaskSampleSize[i] - Taken[i];
+    }
+
+    for (size_t i = 0; i < Surplus.size(); i++)
+    {
+      if (i < Missing)
+      {
+        ClusteringBursts.push_back(Surplus[i]);
+      }
+      else
+      {
+        DiscardBurst(Surplus[i]);
+      }
+    }
+
+    sort(ClusteringBursts.begin(), ClusteringBursts.end(), InstanceNumCompare());
+  }
+
+  Reservoir.clear();
+  StratumBursts.clear();
+
+  return true;
+}
+
+/* Tasks are the sampling strata. When the number of tasks is not known
+ * (e.g. CSV inputs) all the bursts belong to a single stratum */
+size_t TraceData::SamplingStratum(task_id_t TaskId) const
+{
+  return (NumberOfTasks > 0 ? TaskId % NumberOfTasks : 0);
+}
+
+/**
+ * Returns the storage row of a burst no longer used, and keeps its slot to
+ * be reused by the next burst
+ */
+void TraceData::DiscardBurst(CPUBurst* Burst)
+{
+  if (Burst->GetStride() > 1)
+  {
+    Storage->ReleaseRow(Burst->GetDimensionsData(), Burst->GetStride());
+  }
+
+  DiscardedBursts.push_back(Burst);
+}
+
+/**
+ * Updates the ranges and the sum of the clustering dimensions with the
+ * values of a new complete burst
+ */
+void TraceData::UpdateRanges(vector<double>& ClusteringProcessedData,
+                             instance_t      Instance)
+{
+  for (size_t i = 0; i < ClusteringDimensions; i++)
+  {
+    if (ClusteringProcessedData[i] > MaxValues[i])
+    {
+      MaxValues[i]    = ClusteringProcessedData[i];
+      MaxInstances[i] = Instance;
+    }
+
+    if (ClusteringProcessedData[i] < MinValues[i])
+    {
+      MinValues[i]    = ClusteringProcessedData[i];
+      MinInstances[i] = Instance;
+    }
+
+    SumValues[i] += ClusteringProcessedData[i];
+  }
+}
+
 bool CheckBurstEndEvents(map<event_type_t, event_value_t>& EventsData,
                          set<event_type_t>&                BurstEndEvents)
 {
@@ -44,7 +44,13 @@ using cepba_tools::Error;
 #include <SystemMessages.hpp>
 using cepba_tools::system_messages;
 
+#include <ProgressReporter.hpp>
+using cepba_tools::ProgressReporter;
+
 #include "CPUBurst.hpp"
+#include "BurstsStorage.hpp"
+#include "ObjectsArena.hpp"
+#include "BurstsSpill.hpp"
 
 #ifdef HAVE_SQLITE3
 #include "BurstsDB.hpp"
@@ -89,6 +95,12 @@ class TraceData: public Error
     vector<CPUBurst*> FilteredBursts;
     vector<CPUBurst*> MissingDataBursts;
 
+    /* Columnar storage of the bursts numeric data */
+    BurstsStorage*    Storage;
+
+    /* Region where the burst objects live, released at once */
+    ObjectsArena<CPUBurst>* BurstsArena;
+
 #ifdef HAVE_SQLITE3
     bool              DBInitialized;
     BurstsDB          AllBurstsDB;
@@ -102,6 +114,18 @@ class TraceData: public Error
     size_t             NumberOfTasks;
     bool               SampleData;
 
+    /* Streaming sampling: only a uniform reservoir of the whole trace stays
+     * in memory, all the bursts are written to the spill stream */
+    BurstsSpill*               Spill;
+    size_t                     StreamingMaxSamples;
+    bool                       StreamingFinished;
+    bool                       StreamedBurstsNormalized;
+    vector<CPUBurst*>          Reservoir;
+    vector<size_t>             StratumBursts;
+    size_t                     StreamedBursts;
+    unsigned short             SamplingState[3];
+    vector<CPUBurst*>          DiscardedBursts;
+
     size_t ClusteringDimensions;
     size_t ExtrapolationDimensions;
 
@@ -131,6 +155,8 @@ class TraceData: public Error
 
     static TraceData* GetInstance(void);
 
+    ~TraceData(void);
+
     void   SetTraceObjects(size_t TraceObjects) { this->TraceObjects = TraceObjects; };
     size_t GetTraceObjects(void) { return TraceObjects; };
 
@@ -169,6 +195,10 @@ class TraceData: public Error
 
     bool Sampling(size_t MaxSamples);
 
+    bool SetStreamingSampling(size_t MaxSamples, string SpillFileName);
+
+    BurstsSpill* GetBurstsSpill(void) { return Spill; };
+
     vector<const Point*>& GetClusteringPoints(void)
     {
       if (NormalizeData && !Normalized)
@@ -238,12 +268,43 @@ class TraceData: public Error
 
     void PrintTraceDataInformation(void);
 
+    size_t GetBurstsMemoryFootprint(void) const;
+
   private:
 
     bool ActualNormalize(void);
 
+    void NormalizeBursts(vector<CPUBurst*>& Bursts,
+                         vector<double>&    Factors);
+
+    void GetRowsSegments(const vector<CPUBurst*>&            Bursts,
+                         bool                                NotNormalizedOnly,
+                         vector<BurstsStorage::RowsSegment>& Segments,
+                         vector<CPUBurst*>&                  OtherBursts);
+
     bool SampleSingleTask(vector<CPUBurst*>& TaskBursts, size_t NumSamples);
 
+    bool StreamBurst(instance_t           Instance,
+                     task_id_t            TaskId,
+                     thread_id_t          ThreadId,
+                     line_t               Line,
+                     timestamp_t          BeginTime,
+                     timestamp_t          EndTime,
+                     duration_t           BurstDuration,
+                     vector<double>      &ClusteringRawData,
+                     vector<double>      &ClusteringProcessedData,
+                     map<size_t, double> &ExtrapolationData,
+                     burst_type_t         BurstType);
+
+    bool FinishStreamingSampling(void);
+
+    size_t SamplingStratum(task_id_t TaskId) const;
+
+    void DiscardBurst(CPUBurst* Burst);
+
+    void UpdateRanges(vector<double>& ClusteringProcessedData,
+                      instance_t      Instance);
+
     bool CheckBurstEndEvents(map<event_type_t, event_value_t>& EventsData,
                              set<event_type_t>&                BurstEndEvents);
 
@@ -323,7 +384,8 @@ bool TraceData::GenericFlushPoints(ostream&             str,
 
   str << ",ClusterID" << endl;
 
-  system_messages::show_progress("Writing point to disc", 0, DataSize);
+  ProgressReporter Progress ("Writing point to disc", DataSize);
+
   for (BurstsIterator  = begin, ClusteringBurstsCounter = 0, TotalPoints = 0;
        BurstsIterator != end;
      ++BurstsIterator)
@@ -337,6 +399,7 @@ bool TraceData::GenericFlushPoints(ostream&             str,
     cout << " Burst Type = " << (*BurstsIterator)->GetBurstType();
     */
     ++TotalPoints;
+    Progress.update(TotalPoints);
 
     CurrentBurst = (*BurstsIterator);
 
@@ -349,6 +412,13 @@ bool TraceData::GenericFlushPoints(ostream&             str,
     }
 #endif
 
+    if (CurrentBurst == NULL && Spill != NULL)
+    {
+      SetError(true);
+      SetErrorMessage(Spill->GetLastError());
+      return false;
+    }
+
     switch((*BurstsIterator)->GetBurstType())
     {
       case CompleteBurst:
@@ -387,10 +457,8 @@ bool TraceData::GenericFlushPoints(ostream&             str,
     /* When working with the data base, the bursts must be erased */
     delete CurrentBurst;
 #endif
-
-    system_messages::show_progress("Writing point to disc", TotalPoints, DataSize);
   }
-  system_messages::show_progress_end("Writing point to disc", DataSize);
+  Progress.end();
 
   return true;
 
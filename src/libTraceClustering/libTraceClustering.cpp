@@ -124,6 +124,56 @@ bool libTraceClustering::SetDBSCANParameters(double Eps, int MinPoints)
   return true;
 }
 
+/**
+ * Selects the data sample while the data is extracted, instead of after
+ * loading all the bursts. Only the sample stays in memory, the rest of the
+ * bursts are read from a spill file in the later phases. It only applies
+ * when the data extraction is called with 'SampleData' set
+ *
+ * \param SpillFileName Name of the temporary file where bursts are written
+ *
+ * \return True if the streaming sampling can be used, false otherwise
+ */
+bool libTraceClustering::SetStreamingSampling(string SpillFileName)
+{
+  if (!Implementation->SetStreamingSampling(SpillFileName))
+  {
+    Error        = true;
+    ErrorMessage = Implementation->GetLastError();
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Restricts the data extraction of a Paraver trace to the bursts of the given
+ * tasks that lie entirely in a time window. The trace index is used to read
+ * only the blocks holding records of the selection. The input trace can not
+ * be reconstructed from a selection of its bursts
+ *
+ * \param SelectedTasks  Tasks whose bursts are kept (0-based), empty for all
+ * \param SelectionBegin Initial time of the window, in trace time units
+ * \param SelectionEnd   Final time of the window, in trace time units
+ *
+ * \return True if the selection can be used, false otherwise
+ */
+bool libTraceClustering::SetTraceSelection(set<task_id_t> SelectedTasks,
+                                           timestamp_t    SelectionBegin,
+                                           timestamp_t    SelectionEnd)
+{
+  if (!Implementation->SetTraceSelection(SelectedTasks,
+                                         SelectionBegin,
+                                         SelectionEnd))
+  {
+    Error        = true;
+    ErrorMessage = Implementation->GetLastError();
+    return false;
+  }
+
+  return true;
+}
+
 /**
  * Load the data to memory from the provided input file. It could be a Paraver trace,
  * a Dimemas trace or a CSV previously generated by the clustering tool
@@ -294,6 +344,34 @@ bool libTraceClustering::ClusterAnalysis()
   return true;
 }
 
+/**
+ * Performs a cluster analysis per time window, matching the clusters of
+ * adjacent windows
+ *
+ * \param WindowsCount  Number of windows of the same length (0 to use the
+ *                      windows length)
+ * \param WindowLength  Length of each window, in ns (0 to use the count)
+ * \param MatchDistance Maximum distance between the centroids of two clusters
+ *                      of adjacent windows to consider them the same cluster
+ *
+ * \result True if the analysis finished correctly, false otherwise
+ */
+bool libTraceClustering::ClusterWindowsAnalysis(size_t             WindowsCount,
+                                                unsigned long long WindowLength,
+                                                double             MatchDistance)
+{
+  if (!Implementation->ClusterWindowsAnalysis(WindowsCount,
+                                              WindowLength,
+                                              MatchDistance))
+  {
+    Error = true;
+    ErrorMessage = Implementation->GetLastError();
+    return false;
+  }
+
+  return true;
+}
+
 /**
  * Performs a DBSCAN cluster analysis with auto refinement based on sequence
  * score. The exploration range is guessed automatically
@@ -378,6 +456,24 @@ bool libTraceClustering::FlushClustersInformation(string OutputClustersInfoFileN
   return true;
 }
 
+/**
+ * Write the clusters present on each time window to an output file
+ *
+ * \param OutputWindowsInfoFileName Name of the output file
+ *
+ * \result True if output file is written correctly, false otherwise
+ */
+bool libTraceClustering::FlushWindowsInformation(string OutputWindowsInfoFileName)
+{
+  if (!Implementation->FlushWindowsInformation(OutputWindowsInfoFileName))
+  {
+    Error        = true;
+    ErrorMessage = Implementation->GetLastError();
+    return false;
+  }
+  return true;
+}
+
 /**
  * Write data to output file (trace or CSV)
  *
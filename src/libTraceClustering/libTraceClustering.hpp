@@ -85,6 +85,12 @@ class libTraceClustering
 
     bool SetDBSCANParameters(double Eps, int MinPoints);
 
+    bool SetStreamingSampling(string SpillFileName);
+
+    bool SetTraceSelection(set<task_id_t> SelectedTasks,
+                           timestamp_t    SelectionBegin,
+                           timestamp_t    SelectionEnd);
+
     bool ExtractData(string            InputFileName,
                      bool              SampleData      = false,
                      unsigned int      MaxSamples      = 0,
@@ -112,6 +118,10 @@ class libTraceClustering
 
     bool ClusterAnalysis (void);
 
+    bool ClusterWindowsAnalysis(size_t             WindowsCount,
+                                unsigned long long WindowLength,
+                                double             MatchDistance);
+
     bool ClusterRefinementAnalysis(bool   Divisive,
                                    bool   PrintStepsInformation,
                                    string OutputFileNamePrefix = "");
@@ -126,6 +136,8 @@ class libTraceClustering
 
     bool FlushClustersInformation(string OutputClustersInfoFileName);
 
+    bool FlushWindowsInformation(string OutputWindowsInfoFileName);
+
     bool FlushData(string OutputCSVFileNamePrefix);
 
     bool ComputeSequenceScore(string OutputFilePrefix,
@@ -42,6 +42,9 @@
 using cepba_tools::system_messages;
 #include <FileNameManipulator.hpp>
 using cepba_tools::FileNameManipulator;
+#include <Instrumentation.hpp>
+using cepba_tools::instrumentation;
+using cepba_tools::phase_scope;
 
 #include <ClusteringConfiguration.hpp>
 #include "DataExtractor.hpp"
@@ -87,7 +90,7 @@ const string libTraceClusteringImplementation::SampledDataFilePostFix = ("SAMPLE
  */
 libTraceClusteringImplementation::libTraceClusteringImplementation(bool verbose,
                                                                    bool paraver_verbosity):
-Data(NULL), ClusteringCore(NULL)
+Data(NULL), ClusteringCore(NULL), WindowsAnalysis(NULL)
 {
   system_messages::verbose           = verbose;
   if (system_messages::paraver_verbosity = paraver_verbosity)
@@ -96,6 +99,8 @@ Data(NULL), ClusteringCore(NULL)
   }
   ClusteringExecuted                 = false;
   PRVEventsParsing                   = false;
+  SpillFileName                      = "";
+  UseTraceSelection                  = false;
 }
 
 /**
@@ -177,9 +182,6 @@ bool libTraceClusteringImplementation::InitTraceClustering(string        Cluster
 
   if (USE_CLUSTERING(UseFlags) || USE_PARAMETER_APPROXIMATION(UseFlags))
   {
-    string              ClusteringAlgorithmName;
-    map<string, string> ClusteringAlgorithmParameters;
-
     /* Check if clustering defined in the XML is correct */
     if (ConfigurationManager->GetClusteringAlgorithmError())
     {
@@ -290,6 +292,67 @@ bool libTraceClusteringImplementation::SetDBSCANParameters(double Eps, int MinPo
     return false;
   }
 
+  this->ClusteringAlgorithmName       = DBSCAN::NAME;
+  this->ClusteringAlgorithmParameters = ClusteringAlgorithmParameters;
+
+  return true;
+}
+
+/**
+ * Enables the sample selection during the data extraction. See
+ * 'TraceData::SetStreamingSampling'
+ *
+ * \param SpillFileName Name of the temporary file where bursts are written
+ *
+ * \return True if the streaming sampling can be used, false otherwise
+ */
+bool libTraceClusteringImplementation::SetStreamingSampling(string SpillFileName)
+{
+  if (USE_MPI(UseFlags))
+  {
+    SetError(true);
+    SetErrorMessage("streaming sampling not available on MPI executions");
+    return false;
+  }
+
+  if (SpillFileName.compare("") == 0)
+  {
+    SetError(true);
+    SetErrorMessage("empty spill file name");
+    return false;
+  }
+
+  this->SpillFileName = SpillFileName;
+
+  return true;
+}
+
+/**
+ * Restricts the next data extraction to the bursts of the given tasks that
+ * lie entirely in the time window. See 'DataExtractor::SetSelection'
+ *
+ * \param SelectedTasks  Tasks whose bursts are kept (0-based), empty for all
+ * \param SelectionBegin Initial time of the window, in trace time units
+ * \param SelectionEnd   Final time of the window, in trace time units
+ *
+ * \return True if the selection can be used, false otherwise
+ */
+bool libTraceClusteringImplementation::SetTraceSelection(set<task_id_t> SelectedTasks,
+                                                         timestamp_t    SelectionBegin,
+                                                         timestamp_t    SelectionEnd)
+{
+  if (USE_MPI(UseFlags))
+  {
+    SetError(true);
+    SetErrorMessage("trace selection not available on MPI executions");
+    return false;
+  }
+
+  UseTraceSelection    = true;
+  this->SelectedTasks  = SelectedTasks;
+  this->SelectionBegin = SelectionBegin;
+  this->SelectionEnd   = SelectionEnd;
+
   return true;
 }
 
@@ -322,6 +385,8 @@ libTraceClusteringImplementation::ExtractData(string            InputFileName,
   DataExtractorFactory*    ExtractorFactory;
   DataExtractor*           Extractor;
 
+  phase_scope              Phase ("extraction");
+
   /* Get the container */
   Data = TraceData::GetInstance();
 
@@ -364,24 +429,55 @@ libTraceClusteringImplementation::ExtractData(string            InputFileName,
     }
   }
 
+  if (UseTraceSelection &&
+      !Extractor->SetSelection(SelectedTasks, SelectionBegin, SelectionEnd))
+  {
+    SetError(true);
+    SetErrorMessage(Extractor->GetLastError());
+    return false;
+  }
+
   if (SampleData)
   { /* This is necessary to ensure that there will be two different
      * vectors, one with the clustering bursts and other with all
      * the bursts */
     Data->SetMaster(true);
+
+    if (SpillFileName.compare("") != 0 &&
+        !Data->SetStreamingSampling(MaxSamples, SpillFileName))
+    {
+      SetError(true);
+      SetErrorMessage(Data->GetLastError());
+      return false;
+    }
   }
 
+  instrumentation::phase_begin("parsing");
   if (!Extractor->ExtractData(Data))
   {
     SetError(true);
     SetErrorMessage(Extractor->GetLastError());
     return false;
   }
+  instrumentation::phase_end();
+
+  instrumentation::add(instrumentation::counter("trace.bursts"),
+                       Data->GetAllBurstsSize());
+  instrumentation::add(instrumentation::counter("trace.clustering_bursts"),
+                       Data->GetClusteringBurstsSize());
 
   if (SampleData)
   {
     this->SampleData = true;
-    Data->Sampling(MaxSamples);
+
+    instrumentation::phase_begin("sampling");
+    if (!Data->Sampling(MaxSamples))
+    {
+      SetError(true);
+      SetErrorMessage(Data->GetLastError());
+      return false;
+    }
+    instrumentation::phase_end();
   }
 
   if (Extractor->GetFileType() == ClusteringCSV)
@@ -392,8 +488,21 @@ libTraceClusteringImplementation::ExtractData(string            InputFileName,
 
       Statistics.InitStatistics(LastPartition.GetIDs());
 
-      if (!Statistics.ComputeStatistics(Data->GetCompleteBursts(),
-                                        LastPartition.GetAssignmentVector()))
+      if (Data->GetBurstsSpill() != NULL)
+      {
+        BurstsSpill* Spill = Data->GetBurstsSpill();
+
+        if (!Statistics.ComputeStatistics(Spill->complete_bursts_begin(),
+                                          Spill->complete_bursts_end(),
+                                          Spill->CompleteBurstsSize(),
+                                          LastPartition.GetAssignmentVector()))
+        {
+          SetErrorMessage(Statistics.GetLastError());
+          return false;
+        }
+      }
+      else if (!Statistics.ComputeStatistics(Data->GetCompleteBursts(),
+                                             LastPartition.GetAssignmentVector()))
       {
         SetErrorMessage(Statistics.GetLastError());
         return false;
@@ -449,6 +558,8 @@ bool libTraceClusteringImplementation::FlushData(string OutputCSVFileNamePrefix)
   Partition   &PartitionUsed = (SampleData ? ClassificationPartition : LastPartition);
   DataPrintSet WhatToPrint;
 
+  phase_scope  Phase ("flush_data");
+
   if (Data == NULL)
   {
     SetErrorMessage("data not initialized");
@@ -544,6 +655,8 @@ bool libTraceClusteringImplementation::ClusterAnalysis(void)
   ClusteringConfiguration* ConfigurationManager;
   ParametersManager*       Parameters;
 
+  phase_scope              Phase ("cluster_analysis");
+
   if (Data == NULL)
   {
     SetErrorMessage("data not initialized");
@@ -575,11 +688,13 @@ bool libTraceClusteringImplementation::ClusterAnalysis(void)
   */
 
   /* 'ClusteringCore' has been initialized in 'InitTraceClustering' method */
+  instrumentation::phase_begin("clustering");
   if (!ClusteringCore->ExecuteClustering(ClusteringPoints, LastPartition))
   {
     SetErrorMessage(ClusteringCore->GetErrorMessage());
     return false;
   }
+  instrumentation::phase_end();
 
   if (SampleData)
   {
@@ -603,15 +718,26 @@ bool libTraceClusteringImplementation::ClusterAnalysis(void)
 
   /* If cluster analysis was executed using sampling data, we must apply
      a classification */
-  if (SampleData)
+  if (SampleData && Data->GetBurstsSpill() != NULL)
+  {
+    instrumentation::phase_begin("classification");
+    if (!ClassifySpilledBursts())
+    {
+      return false;
+    }
+    instrumentation::phase_end();
+  }
+  else if (SampleData)
   {
     vector<const Point*> &CompletePoints = Data->GetCompletePoints();
 
+    instrumentation::phase_begin("classification");
     if (!ClusteringCore->ClassifyData(CompletePoints, ClassificationPartition))
     {
       SetErrorMessage(ClusteringCore->GetErrorMessage());
       return false;
     }
+    instrumentation::phase_end();
   }
 
   ClusteringExecuted = true;
@@ -627,6 +753,8 @@ bool libTraceClusteringImplementation::ClusterAnalysis(void)
 
   Partition& PartitionUsed = (SampleData ? ClassificationPartition : LastPartition);
 
+  phase_scope StatisticsPhase ("statistics");
+
   Statistics.InitStatistics(PartitionUsed.GetIDs(),
                             Parameters->GetClusteringParametersNames(),
                             Parameters->GetClusteringParametersPrecision(),
@@ -635,7 +763,20 @@ bool libTraceClusteringImplementation::ClusterAnalysis(void)
 
 
 
-  if (SampleData)
+  if (SampleData && Data->GetBurstsSpill() != NULL)
+  {
+    BurstsSpill* Spill = Data->GetBurstsSpill();
+
+    if (!Statistics.ComputeStatistics(Spill->complete_bursts_begin(),
+                                      Spill->complete_bursts_end(),
+                                      Spill->CompleteBurstsSize(),
+                                      PartitionUsed.GetAssignmentVector()))
+    {
+      SetErrorMessage(Statistics.GetLastError());
+      return false;
+    }
+  }
+  else if (SampleData)
   {
     if (!Statistics.ComputeStatistics(Data->GetCompleteBursts(),
                                       PartitionUsed.GetAssignmentVector()))
@@ -659,6 +800,119 @@ bool libTraceClusteringImplementation::ClusterAnalysis(void)
   return true;
 }
 
+/**
+ * Performs the cluster analysis splitting the bursts in time windows. Each
+ * window is clustered independently, in parallel, using the algorithm of the
+ * regular analysis, and the clusters of adjacent windows are matched by their
+ * centroids. The combined result is stored in LastPartition attribute
+ *
+ * \param WindowsCount  Number of windows of the same length (0 to use the
+ *                      windows length)
+ * \param WindowLength  Length of each window, in ns (0 to use the count)
+ * \param MatchDistance Maximum distance between the centroids of two clusters
+ *                      of adjacent windows to consider them the same cluster
+ *
+ * \result True if the analysis finished correctly, false otherwise
+ */
+bool libTraceClusteringImplementation::ClusterWindowsAnalysis(size_t      WindowsCount,
+                                                              timestamp_t WindowLength,
+                                                              double      MatchDistance)
+{
+  ParametersManager* Parameters;
+
+  phase_scope        Phase ("windows_analysis");
+
+  if (Data == NULL)
+  {
+    SetErrorMessage("data not initialized");
+    return false;
+  }
+
+  if (ClusteringRefinementExecution || SampleData || USE_MPI(UseFlags))
+  {
+    SetError(true);
+    SetErrorMessage("time windows analysis not available with refinement, sampling or MPI");
+    return false;
+  }
+
+  if (ClusteringCore == NULL)
+  {
+    SetErrorMessage("clustering algorithm not initialized");
+    return false;
+  }
+
+  if (WindowsAnalysis != NULL)
+  {
+    delete WindowsAnalysis;
+  }
+
+  WindowsAnalysis = new TimeWindowsClustering(ClusteringAlgorithmName,
+                                              ClusteringAlgorithmParameters,
+                                              MatchDistance);
+
+  if (!WindowsAnalysis->Run(Data->GetClusteringBursts(),
+                            WindowsCount,
+                            WindowLength,
+                            LastPartition))
+  {
+    SetErrorMessage(WindowsAnalysis->GetLastError());
+    return false;
+  }
+
+  ClusteringExecuted = true;
+
+  /* Statistics of the combined partition */
+  Parameters = ParametersManager::GetInstance();
+
+  phase_scope StatisticsPhase ("statistics");
+
+  Statistics.InitStatistics(LastPartition.GetIDs(),
+                            Parameters->GetClusteringParametersNames(),
+                            Parameters->GetClusteringParametersPrecision(),
+                            Parameters->GetExtrapolationParametersNames(),
+                            Parameters->GetExtrapolationParametersPrecision());
+
+  if (!Statistics.ComputeStatistics(Data->GetClusteringBursts(),
+                                    LastPartition.GetAssignmentVector()))
+  {
+    SetErrorMessage(Statistics.GetLastError());
+    return false;
+  }
+
+  Statistics.TranslatedIDs(LastPartition.GetAssignmentVector());
+
+  return true;
+}
+
+/**
+ * Write the clusters present on each time window to an output file
+ *
+ * \param OutputWindowsInfoFileName Name of the output file
+ *
+ * \result True if output file is written correctly, false otherwise
+ */
+bool libTraceClusteringImplementation::FlushWindowsInformation(string OutputWindowsInfoFileName)
+{
+  ofstream                        OutputStream (OutputWindowsInfoFileName.c_str(), ios_base::trunc);
+  map<cluster_id_t, cluster_id_t> TranslationMap;
+
+  if (WindowsAnalysis == NULL)
+  {
+    SetErrorMessage("time windows analysis not executed");
+    return false;
+  }
+
+  TranslationMap = Statistics.GetTranslationMap();
+
+  if (!WindowsAnalysis->Flush(OutputStream, TranslationMap))
+  {
+    SetErrorMessage(WindowsAnalysis->GetLastError());
+    return false;
+  }
+
+  return true;
+}
+
 /**
  * Performs a DBSCAN cluster analysis with auto refinement based on sequence
  * score. The exploration range is guessed automatically
@@ -1114,6 +1368,8 @@ bool libTraceClusteringImplementation::GenericRefinement(bool           Divisive
 {
   ostringstream Messages;
 
+  phase_scope   Phase ("refinement");
+
   if (SampleData)
   {
     SetErrorMessage("Refinement analysis plus sampling not implemented yet");
@@ -1347,6 +1603,8 @@ bool libTraceClusteringImplementation::ComputeSequenceScore(string OutputFilePre
   double                          GlobalScore;
   bool                            PrintScore;
 
+  phase_scope                     Phase ("sequence_score");
+
   if (OutputFilePrefix.compare("") == 0)
   {
     PrintScore = false;
@@ -1407,6 +1665,8 @@ bool libTraceClusteringImplementation::ReconstructInputTrace(string OutputTraceN
 
   ClusteredTraceGenerator* TraceReconstructor;
 
+  phase_scope Phase ("reconstruction");
+
   Partition& PartitionUsed = (SampleData ? ClassificationPartition : LastPartition);
 
   vector<cluster_id_t>& IDs = PartitionUsed.GetAssignmentVector();
@@ -1417,6 +1677,12 @@ bool libTraceClusteringImplementation::ReconstructInputTrace(string OutputTraceN
     return false;
   }
 
+  if (UseTraceSelection)
+  { /* The reconstruction assigns the IDs to the bursts by their position */
+    SetErrorMessage("unable to reconstruct the input trace from a selection of its bursts");
+    return false;
+  }
+
   switch(InputFileType)
   {
     case ParaverTrace:
@@ -1454,6 +1720,18 @@ bool libTraceClusteringImplementation::ReconstructInputTrace(string OutputTraceN
     return false;
   }
 
+  if (Data->GetBurstsSpill() != NULL)
+  {
+    BurstsSpill* Spill = Data->GetBurstsSpill();
+
+    return RunTraceReconstructor(TraceReconstructor,
+                                 Spill->all_bursts_begin(),
+                                 Spill->all_bursts_end(),
+                                 PartitionUsed,
+                                 PrintOnlyEventsOnOutputTrace,
+                                 DoNotPrintFilteredEventsOnOutputTrace);
+  }
+
   if (!TraceReconstructor->Run(Data->GetAllBursts(),
                                PartitionUsed.GetAssignmentVector(),
                                PartitionUsed.GetIDs(),
@@ -1566,6 +1844,116 @@ bool libTraceClusteringImplementation::ParametersApproximation(string
   return true;
 }
 
+/**
+ * Classifies the complete bursts kept on the spill file, chunk by chunk, so
+ * they never are all in memory. The resulting assignment follows the order
+ * of the complete bursts in the trace, as in the in-memory classification
+ *
+ * \result True if all the bursts were classified, false otherwise
+ */
+bool libTraceClusteringImplementation::ClassifySpilledBursts(void)
+{
+  BurstsSpill*          Spill = Data->GetBurstsSpill();
+  vector<CPUBurst*>     Chunk;
+  vector<cluster_id_t>& Assignment = ClassificationPartition.GetAssignmentVector();
+  set<cluster_id_t>&    IDs        = ClassificationPartition.GetIDs();
+
+  ClassificationPartition.clear();
+  Assignment.reserve(Spill->CompleteBurstsSize());
+
+  for (size_t First = 0; First < Spill->CompleteBurstsSize(); First += Chunk.size())
+  {
+    Partition ChunkPartition;
+
+    if (!Spill->ReadBursts(true, First, Chunk) || Chunk.size() == 0)
+    {
+      SetError(true);
+      SetErrorMessage(Spill->GetLastError());
+      return false;
+    }
+
+    if (!ClusteringCore->ClassifyData((vector<const Point*>&) Chunk,
+                                      ChunkPartition))
+    {
+      SetErrorMessage(ClusteringCore->GetErrorMessage());
+      return false;
+    }
+
+    Assignment.insert(Assignment.end(),
+                      ChunkPartition.GetAssignmentVector().begin(),
+                      ChunkPartition.GetAssignmentVector().end());
+
+    IDs.insert(ChunkPartition.GetIDs().begin(),
+               ChunkPartition.GetIDs().end());
+  }
+
+  return true;
+}
+
+/**
+ * Runs the trace reconstruction over a range of bursts not stored in a
+ * vector, using the iterators version of each trace generator
+ *
+ * \result True if the output trace was correctly generated, false otherwise
+ */
+template <typename T>
+bool libTraceClusteringImplementation::RunTraceReconstructor(ClusteredTraceGenerator* TraceReconstructor,
+                                                             T                        begin,
+                                                             T                        end,
+                                                             Partition&               PartitionUsed,
+                                                             bool                     PrintOnlyEvents,
+                                                             bool                     DoNotPrintFilteredBursts)
+{
+  bool Result;
+
+  switch (TraceReconstructor->GetType())
+  {
+    case ClusteredTraceGenerator::PRVStates:
+      Result = ((ClusteredStatesPRVGenerator*) TraceReconstructor)->Run(begin,
+                                                                        end,
+                                                                        PartitionUsed.GetAssignmentVector(),
+                                                                        PartitionUsed.GetIDs(),
+                                                                        PrintOnlyEvents,
+                                                                        DoNotPrintFilteredBursts);
+      break;
+    case ClusteredTraceGenerator::PRVEvents:
+      Result = ((ClusteredEventsPRVGenerator*) TraceReconstructor)->Run(begin,
+                                                                        end,
+                                                                        PartitionUsed.GetAssignmentVector(),
+                                                                        PartitionUsed.GetIDs(),
+                                                                        PrintOnlyEvents,
+                                                                        DoNotPrintFilteredBursts);
+      break;
+    case ClusteredTraceGenerator::SemanticGuidedPRV:
+      Result = ((SemanticGuidedPRVGenerator*) TraceReconstructor)->Run(begin,
+                                                                       end,
+                                                                       PartitionUsed.GetAssignmentVector(),
+                                                                       PartitionUsed.GetIDs(),
+                                                                       PrintOnlyEvents,
+                                                                       DoNotPrintFilteredBursts);
+      break;
+    case ClusteredTraceGenerator::TRF:
+      Result = ((ClusteredTRFGenerator*) TraceReconstructor)->Run(begin,
+                                                                  end,
+                                                                  PartitionUsed.GetAssignmentVector(),
+                                                                  PartitionUsed.GetIDs(),
+                                                                  PrintOnlyEvents,
+                                                                  DoNotPrintFilteredBursts);
+      break;
+    default:
+      SetErrorMessage("unknown trace reconstructor");
+      return false;
+  }
+
+  if (!Result)
+  {
+    SetErrorMessage(TraceReconstructor->GetLastError());
+    return false;
+  }
+
+  return true;
+}
+
 /**
  * When running the MPI version of the library, gathers the results distributed
  * accross the different tasks into the master task (rank 0 in MPI_COMM_WORLD).
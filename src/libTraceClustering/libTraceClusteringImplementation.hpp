@@ -44,6 +44,8 @@ using cepba_tools::Error;
 #include <libClustering.hpp>
 #include <TraceData.hpp>
 #include <ClusteringStatistics.hpp>
+#include <ClusteredTraceGenerator.hpp>
+#include <TimeWindowsClustering.hpp>
 
 #include "trace_clustering_types.h"
 
@@ -57,6 +59,9 @@ class libTraceClusteringImplementation: public Error
 
     TraceData           *Data;
     libClustering       *ClusteringCore;
+    string               ClusteringAlgorithmName;
+    map<string, string>  ClusteringAlgorithmParameters;
+    TimeWindowsClustering *WindowsAnalysis;
     Partition            LastPartition, ClassificationPartition;
     ClusteringStatistics Statistics;
 
@@ -64,6 +69,11 @@ class libTraceClusteringImplementation: public Error
     input_file_t         InputFileType;
 
     bool                 SampleData;
+    string               SpillFileName;
+
+    bool                 UseTraceSelection;
+    set<task_id_t>       SelectedTasks;
+    timestamp_t          SelectionBegin, SelectionEnd;
 
     bool                 ClusteringExecuted;
     bool                 ClusteringRefinementExecution;
@@ -86,6 +96,12 @@ class libTraceClusteringImplementation: public Error
 
     bool SetDBSCANParameters(double Eps, int MinPoints);
 
+    bool SetStreamingSampling(string SpillFileName);
+
+    bool SetTraceSelection(set<task_id_t> SelectedTasks,
+                           timestamp_t    SelectionBegin,
+                           timestamp_t    SelectionEnd);
+
     bool ExtractData(string            InputFileName,
                      bool              SampleData = false,
                      unsigned int      MaxSamples = 0,
@@ -97,6 +113,12 @@ class libTraceClusteringImplementation: public Error
 
     bool ClusterAnalysis(void);
 
+    bool ClusterWindowsAnalysis(size_t      WindowsCount,
+                                timestamp_t WindowLength,
+                                double      MatchDistance);
+
+    bool FlushWindowsInformation(string OutputWindowsInfoFileName);
+
     bool ClusterRefinementAnalysis(bool   Divisive,
                                    bool   PrintStepsInformation,
                                    string OutputFileNamePrefix);
@@ -133,6 +155,16 @@ class libTraceClusteringImplementation: public Error
 
     void GetTaskSet(size_t TotalTasksInTrace);
 
+    bool ClassifySpilledBursts(void);
+
+    template <typename T>
+    bool RunTraceReconstructor(ClusteredTraceGenerator* TraceReconstructor,
+                               T                        begin,
+                               T                        end,
+                               Partition&               PartitionUsed,
+                               bool                     PrintOnlyEvents,
+                               bool                     DoNotPrintFilteredBursts);
+
     bool GatherMPIPartition(void);
 
     bool GatherMaster(void);